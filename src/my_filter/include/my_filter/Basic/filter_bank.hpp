@@ -0,0 +1,193 @@
+#ifndef FILTER_BANK_
+#define FILTER_BANK_
+
+#include <math.h>
+#include <array>
+#include <Eigen/Dense>
+#include <my_filter/Basic/filters.hpp>
+
+// N channel versions of the filters in filters.hpp. The state of a tap is
+// one contiguous vector over the channels, so a sample of all the channels
+// is filtered in one call without virtual dispatch. The coefficients (of
+// the biquads, computed by the scalar filters) and the order of the
+// operations are the ones of the scalar filters, hence every channel gives
+// the same output as its scalar filter.
+// Nothing is allocated after the construction.
+
+template <int N>
+class biquad_filter_bank
+{
+public:
+    typedef Eigen::Matrix<double, N, 1> VectorType;
+
+    biquad_filter_bank(const double* coef)
+    {
+        Lpf_in1 = coef[0], Lpf_in2 = coef[1], Lpf_in3 = coef[2];
+        Lpf_out1 = coef[3], Lpf_out2 = coef[4];
+        lpf_out.setZero();
+        clear();
+    }
+    ~biquad_filter_bank(void) {}
+
+    void input(const Eigen::Ref<const VectorType>& lpf_in)
+    {
+        lpf_out = Lpf_in1*lpf_in + Lpf_in2*Lpf_in_prev[0] + Lpf_in3*Lpf_in_prev[1] + //input component
+            Lpf_out1*Lpf_out_prev[0] + Lpf_out2*Lpf_out_prev[1]; //output component
+        Lpf_in_prev[1] = Lpf_in_prev[0];
+        Lpf_in_prev[0] = lpf_in;
+        Lpf_out_prev[1] = Lpf_out_prev[0];
+        Lpf_out_prev[0] = lpf_out;
+    }
+    const VectorType& output(void) const { return lpf_out; }
+    void clear(void)
+    {
+        Lpf_in_prev[1].setZero();
+        Lpf_in_prev[0].setZero();
+        Lpf_out_prev[1].setZero();
+        Lpf_out_prev[0].setZero();
+    }
+    static constexpr int size() { return N; }
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+protected:
+    VectorType Lpf_in_prev[2];
+    VectorType Lpf_out_prev[2];
+    double Lpf_in1, Lpf_in2, Lpf_in3, Lpf_out1, Lpf_out2;
+    VectorType lpf_out;
+};
+
+// digital_lp_filter
+template <int N>
+class digital_lp_filter_bank : public biquad_filter_bank<N>
+{
+public:
+    digital_lp_filter_bank(double w_c, double t_s)
+        : biquad_filter_bank<N>(coefficients(w_c, t_s).data()) {}
+
+private:
+    static std::array<double, 5> coefficients(double w_c, double t_s)
+    {
+        std::array<double, 5> coef;
+        digital_lp_filter::coefficients(w_c, t_s, coef.data());
+        return coef;
+    }
+};
+
+// deriv_lp_filter
+template <int N>
+class deriv_lp_filter_bank : public biquad_filter_bank<N>
+{
+public:
+    deriv_lp_filter_bank(double w_c, double t_s)
+        : biquad_filter_bank<N>(coefficients(w_c, t_s).data()) {}
+
+private:
+    static std::array<double, 5> coefficients(double w_c, double t_s)
+    {
+        std::array<double, 5> coef;
+        deriv_lp_filter::coefficients(w_c, t_s, coef.data());
+        return coef;
+    }
+};
+
+// moving_average_filter, the window is a ring of samples
+template <int N>
+class moving_average_filter_bank
+{
+public:
+    typedef Eigen::Matrix<double, N, 1> VectorType;
+
+    moving_average_filter_bank(int num_data): num_data_(num_data), idx_(0)
+    {
+        buffer_ = Eigen::Matrix<double, N, Eigen::Dynamic>::Zero(N, num_data_);
+        sum_.setZero();
+        out_.setZero();
+    }
+    ~moving_average_filter_bank() {}
+
+    void input(const Eigen::Ref<const VectorType>& input_value)
+    {
+        sum_ -= buffer_.col(idx_);
+        sum_ += input_value;
+        buffer_.col(idx_) = input_value;
+        ++idx_;
+        idx_%=num_data_;
+        out_ = sum_/num_data_;
+    }
+    const VectorType& output(void) const { return out_; }
+    void clear(void)
+    {
+        sum_.setZero();
+        buffer_.setZero();
+        out_.setZero();
+    }
+    static constexpr int size() { return N; }
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+private:
+    Eigen::Matrix<double, N, Eigen::Dynamic> buffer_;
+    int num_data_;
+    int idx_;
+    VectorType sum_;
+    VectorType out_;
+};
+
+// butterworth_filter, the impulse response is tabulated at the
+// construction instead of being evaluated at every input
+template <int N>
+class butterworth_filter_bank
+{
+public:
+    typedef Eigen::Matrix<double, N, 1> VectorType;
+
+    butterworth_filter_bank(int num_sample, double dt, double cutoff_frequency)
+    {
+        mNumSample = num_sample;
+        mDt = dt;
+        mCutoffFreq = cutoff_frequency;
+        mCurIdx = 0;
+
+        double sqrt_2 = sqrt(2);
+        mGain = sqrt_2 / mCutoffFreq;
+        mExp.resize(mNumSample);
+        mSin.resize(mNumSample);
+        for (int j = 0; j < mNumSample; j++) {
+            double t = (double)j*mDt;
+            mExp[j] = exp(-1./sqrt_2*t);
+            mSin[j] = sin(mCutoffFreq/sqrt_2*t);
+        }
+        mBuffer = Eigen::Matrix<double, N, Eigen::Dynamic>::Zero(N, mNumSample);
+        mValue.setZero();
+    }
+    ~butterworth_filter_bank(void) {}
+
+    // mBuffer.col((mCurIdx + j) % mNumSample) is the input j samples ago
+    void input(const Eigen::Ref<const VectorType>& input_value)
+    {
+        mCurIdx = (mCurIdx + mNumSample - 1) % mNumSample;
+        mBuffer.col(mCurIdx) = input_value;
+
+        mValue.setZero();
+        for (int j = 0, k = mCurIdx; j < mNumSample; j++) {
+            mValue += mGain * mBuffer.col(k) * mExp[j] * mSin[j] * mDt;
+            if (++k == mNumSample) k = 0;
+        }
+    }
+    const VectorType& output(void) const { return mValue; }
+    void clear(void) { mBuffer.setZero(); }
+    static constexpr int size() { return N; }
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+private:
+    Eigen::Matrix<double, N, Eigen::Dynamic> mBuffer;
+    Eigen::VectorXd mExp;
+    Eigen::VectorXd mSin;
+    int mCurIdx;
+    int mNumSample;
+    double mDt;
+    double mCutoffFreq;
+    double mGain;
+    VectorType mValue;
+};
+
+#endif
@@ -36,6 +36,8 @@ public:
 	virtual void input(double input_value);
 	virtual double output(void);
 	virtual void clear(void);
+	// [in1, in2, in3, out1, out2], shared with the filter bank
+	static void coefficients(double w_c, double t_s, double* coef);
 private:
 	double Lpf_in_prev[2];
 	double Lpf_out_prev[2];
@@ -66,6 +68,8 @@ public:
 	virtual void input(double input_value);
 	virtual double output(void);
 	virtual void clear(void);
+	// [in1, in2, in3, out1, out2], shared with the filter bank
+	static void coefficients(double w_c, double t_s, double* coef);
 private:
 	double Lpf_in_prev[2];
 	double Lpf_out_prev[2];
@@ -22,10 +22,10 @@
 #ifndef KALMAN_EXTENDEDKALMANFILTER_HPP_
 #define KALMAN_EXTENDEDKALMANFILTER_HPP_
 
-#include "Filters/src/Kalman/KalmanFilterBase.hpp"
-#include "Filters/src/Kalman/StandardFilterBase.hpp"
-#include "Filters/src/Kalman/LinearizedSystemModel.hpp"
-#include "Filters/src/Kalman/LinearizedMeasurementModel.hpp"
+#include "my_filter/Kalman/KalmanFilterBase.hpp"
+#include "my_filter/Kalman/StandardFilterBase.hpp"
+#include "my_filter/Kalman/LinearizedSystemModel.hpp"
+#include "my_filter/Kalman/LinearizedMeasurementModel.hpp"
 
 namespace Kalman {
     
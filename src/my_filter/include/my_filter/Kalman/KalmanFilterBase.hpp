@@ -22,8 +22,8 @@
 #ifndef KALMAN_KALMANFILTERBASE_HPP_
 #define KALMAN_KALMANFILTERBASE_HPP_
 
-#include "Filters/src/Kalman/Matrix.hpp"
-#include "Filters/src/Kalman/Types.hpp"
+#include "my_filter/Kalman/Matrix.hpp"
+#include "my_filter/Kalman/Types.hpp"
 
 namespace Kalman {
     
@@ -22,7 +22,7 @@
 #ifndef KALMAN_LINEARIZEDMEASUREMENTMODEL_HPP_
 #define KALMAN_LINEARIZEDMEASUREMENTMODEL_HPP_
 
-#include "Filters/src/Kalman/MeasurementModel.hpp"
+#include "my_filter/Kalman/MeasurementModel.hpp"
 
 namespace Kalman {
     template<class StateType>
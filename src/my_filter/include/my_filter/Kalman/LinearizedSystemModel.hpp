@@ -22,7 +22,7 @@
 #ifndef KALMAN_LINEARIZEDSYSTEMMODEL_HPP_
 #define KALMAN_LINEARIZEDSYSTEMMODEL_HPP_
 
-#include "Filters/src/Kalman/SystemModel.hpp"
+#include "my_filter/Kalman/SystemModel.hpp"
 
 namespace Kalman {
     template<class StateType>
@@ -24,7 +24,7 @@
 
 #include <type_traits>
 
-#include "Filters/src/Kalman/StandardBase.hpp"
+#include "my_filter/Kalman/StandardBase.hpp"
 
 namespace Kalman {
     /**
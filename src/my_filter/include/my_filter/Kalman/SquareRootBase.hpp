@@ -22,7 +22,7 @@
 #ifndef KALMAN_SQUAREROOTBASE_HPP_
 #define KALMAN_SQUAREROOTBASE_HPP_
 
-#include "Filters/src/Kalman/Types.hpp"
+#include "my_filter/Kalman/Types.hpp"
 
 namespace Kalman {
     
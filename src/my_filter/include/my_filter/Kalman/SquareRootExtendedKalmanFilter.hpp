@@ -22,10 +22,10 @@
 #ifndef KALMAN_SQUAREROOTEXTENDEDKALMANFILTER_HPP_
 #define KALMAN_SQUAREROOTEXTENDEDKALMANFILTER_HPP_
 
-#include "Filters/src/Kalman/KalmanFilterBase.hpp"
-#include "Filters/src/Kalman/SquareRootFilterBase.hpp"
-#include "Filters/src/Kalman/LinearizedSystemModel.hpp"
-#include "Filters/src/Kalman/LinearizedMeasurementModel.hpp"
+#include "my_filter/Kalman/KalmanFilterBase.hpp"
+#include "my_filter/Kalman/SquareRootFilterBase.hpp"
+#include "my_filter/Kalman/LinearizedSystemModel.hpp"
+#include "my_filter/Kalman/LinearizedMeasurementModel.hpp"
 
 namespace Kalman {
     
@@ -22,7 +22,7 @@
 #ifndef KALMAN_SQUAREROOTFILTERBASE_HPP_
 #define KALMAN_SQUAREROOTFILTERBASE_HPP_
 
-#include "Filters/src/Kalman/SquareRootBase.hpp"
+#include "my_filter/Kalman/SquareRootBase.hpp"
 
 namespace Kalman {
     
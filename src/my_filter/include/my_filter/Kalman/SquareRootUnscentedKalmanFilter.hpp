@@ -22,8 +22,8 @@
 #ifndef KALMAN_SQUAREROOTUNSCENTEDKALMANFILTER_HPP_
 #define KALMAN_SQUAREROOTUNSCENTEDKALMANFILTER_HPP_
 
-#include "Filters/src/Kalman/UnscentedKalmanFilterBase.hpp"
-#include "Filters/src/Kalman/SquareRootFilterBase.hpp"
+#include "my_filter/Kalman/UnscentedKalmanFilterBase.hpp"
+#include "my_filter/Kalman/SquareRootFilterBase.hpp"
 
 namespace Kalman {
     
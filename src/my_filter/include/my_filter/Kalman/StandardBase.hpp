@@ -22,7 +22,7 @@
 #ifndef KALMAN_STANDARDBASE_HPP_
 #define KALMAN_STANDARDBASE_HPP_
 
-#include "Filters/src/Kalman/Types.hpp"
+#include "my_filter/Kalman/Types.hpp"
 
 namespace Kalman {
     
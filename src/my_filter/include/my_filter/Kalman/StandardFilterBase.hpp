@@ -22,7 +22,7 @@
 #ifndef KALMAN_STANDARDFILTERBASE_HPP_
 #define KALMAN_STANDARDFILTERBASE_HPP_
 
-#include "Filters/src/Kalman/StandardBase.hpp"
+#include "my_filter/Kalman/StandardBase.hpp"
 
 namespace Kalman {
     
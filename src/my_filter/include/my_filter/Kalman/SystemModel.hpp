@@ -24,8 +24,8 @@
 
 #include <type_traits>
 
-#include "Filters/src/Kalman/Matrix.hpp"
-#include "Filters/src/Kalman/StandardBase.hpp"
+#include "my_filter/Kalman/Matrix.hpp"
+#include "my_filter/Kalman/StandardBase.hpp"
 
 namespace Kalman {
 /**
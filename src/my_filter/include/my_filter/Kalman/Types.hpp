@@ -22,7 +22,7 @@
 #ifndef KALMAN_TYPES_HPP_
 #define KALMAN_TYPES_HPP_
 
-#include "Filters/src/Kalman/Matrix.hpp"
+#include "my_filter/Kalman/Matrix.hpp"
 
 namespace Kalman
 {
@@ -22,8 +22,8 @@
 #ifndef KALMAN_UNSCENTEDKALMANFILTER_HPP_
 #define KALMAN_UNSCENTEDKALMANFILTER_HPP_
 
-#include "Filters/src/Kalman/UnscentedKalmanFilterBase.hpp"
-#include "Filters/src/Kalman/StandardFilterBase.hpp"
+#include "my_filter/Kalman/UnscentedKalmanFilterBase.hpp"
+#include "my_filter/Kalman/StandardFilterBase.hpp"
 
 namespace Kalman {
     
@@ -24,9 +24,9 @@
 
 #include <cassert>
 
-#include "Filters/src/Kalman/KalmanFilterBase.hpp"
-#include "Filters/src/Kalman/SystemModel.hpp"
-#include "Filters/src/Kalman/MeasurementModel.hpp"
+#include "my_filter/Kalman/KalmanFilterBase.hpp"
+#include "my_filter/Kalman/SystemModel.hpp"
+#include "my_filter/Kalman/MeasurementModel.hpp"
 
 namespace Kalman {
     
@@ -95,15 +95,21 @@ digital_lp_filter::digital_lp_filter(double w_c, double t_s)
 {
     Lpf_in_prev[0] = Lpf_in_prev[1] = 0;
     Lpf_out_prev[0] = Lpf_out_prev[1] = 0;
-    Lpf_in1=0, Lpf_in2=0, Lpf_in3=0, Lpf_out1=0, Lpf_out2=0;
-    float den = 2500*t_s*t_s*w_c*w_c  + 7071*t_s*w_c + 10000;
+    double coef[5];
+    digital_lp_filter::coefficients(w_c, t_s, coef);
+    Lpf_in1 = coef[0], Lpf_in2 = coef[1], Lpf_in3 = coef[2];
+    Lpf_out1 = coef[3], Lpf_out2 = coef[4];
+}
 
-    Lpf_in1 = 2500*t_s*t_s*w_c*w_c / den;
-    Lpf_in2 = 5000*t_s*t_s*w_c*w_c / den;
-    Lpf_in3 = 2500*t_s*t_s*w_c*w_c / den;
-    Lpf_out1 = -(5000*t_s*t_s*w_c*w_c  - 20000) / den;
-    Lpf_out2 = -(2500*t_s*t_s*w_c*w_c  - 7071*t_s*w_c + 10000) / den;
+void digital_lp_filter::coefficients(double w_c, double t_s, double* coef)
+{
+    float den = 2500*t_s*t_s*w_c*w_c  + 7071*t_s*w_c + 10000;
 
+    coef[0] = 2500*t_s*t_s*w_c*w_c / den;
+    coef[1] = 5000*t_s*t_s*w_c*w_c / den;
+    coef[2] = 2500*t_s*t_s*w_c*w_c / den;
+    coef[3] = -(5000*t_s*t_s*w_c*w_c  - 20000) / den;
+    coef[4] = -(2500*t_s*t_s*w_c*w_c  - 7071*t_s*w_c + 10000) / den;
 }
 
 digital_lp_filter::~digital_lp_filter(void)
@@ -140,21 +146,24 @@ deriv_lp_filter::deriv_lp_filter(double w_c, double t_s)
     Lpf_in_prev[1] = 0;
     Lpf_out_prev[0] = 0;
     Lpf_out_prev[1] = 0;
-    Lpf_in1=0;
-    Lpf_in2=0;
-    Lpf_in3=0;
-    Lpf_out1=0;
-    Lpf_out2=0;
+    double coef[5];
+    deriv_lp_filter::coefficients(w_c, t_s, coef);
+    Lpf_in1 = coef[0], Lpf_in2 = coef[1], Lpf_in3 = coef[2];
+    Lpf_out1 = coef[3], Lpf_out2 = coef[4];
+    lpf_out = 0.0;
+    clear();
+}
+
+void deriv_lp_filter::coefficients(double w_c, double t_s, double* coef)
+{
     double a = 1.4142;
     double den = 4 + 2*a*w_c*t_s + t_s*t_s*w_c*w_c;
 
-    Lpf_in1 = 2*t_s*w_c*w_c / den;
-    Lpf_in2 = 0;
-    Lpf_in3 = -2.*t_s*w_c*w_c / den;
-    Lpf_out1 = -1. *(-8 + t_s*t_s*w_c*w_c*2) / den; 
-    Lpf_out2 = -1. *(4 - 2*a * w_c*t_s + t_s*t_s*w_c*w_c) / den;
-    lpf_out = 0.0;
-    clear();
+    coef[0] = 2*t_s*w_c*w_c / den;
+    coef[1] = 0;
+    coef[2] = -2.*t_s*w_c*w_c / den;
+    coef[3] = -1. *(-8 + t_s*t_s*w_c*w_c*2) / den; 
+    coef[4] = -1. *(4 - 2*a * w_c*t_s + t_s*t_s*w_c*w_c) / den;
 }
 
 deriv_lp_filter::~deriv_lp_filter(void)
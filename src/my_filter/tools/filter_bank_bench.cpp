@@ -0,0 +1,135 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <my_filter/Basic/filter_bank.hpp>
+#include <my_filter/Basic/filters.hpp>
+
+// filter_bank_bench [-n ticks]
+// filters 18 channels of white noise, as the joints of a robot, through
+// one scalar filter per channel and through the filter bank of the same
+// kind, for the low pass, derivative, moving average and butterworth
+// filters. Prints the time per tick of both and checks that the bank
+// gives bitwise the same outputs as the scalar filters, exits with 1
+// otherwise.
+static const int num_channels = 18;
+typedef Eigen::Matrix<double, num_channels, 1> Sample;
+
+template <typename Bank>
+struct DigitalLp {
+    static const char* name() { return "digital_lp"; }
+    static filter* scalar() { return new digital_lp_filter(2 * M_PI * 30, 0.001); }
+    static Bank* bank() { return new Bank(2 * M_PI * 30, 0.001); }
+};
+
+template <typename Bank>
+struct DerivLp {
+    static const char* name() { return "deriv_lp"; }
+    static filter* scalar() { return new deriv_lp_filter(2 * M_PI * 30, 0.001); }
+    static Bank* bank() { return new Bank(2 * M_PI * 30, 0.001); }
+};
+
+template <typename Bank>
+struct MovingAverage {
+    static const char* name() { return "moving_average(20)"; }
+    static filter* scalar() { return new moving_average_filter(20); }
+    static Bank* bank() { return new Bank(20); }
+};
+
+template <typename Bank>
+struct Butterworth {
+    static const char* name() { return "butterworth(20)"; }
+    static filter* scalar() { return new butterworth_filter(20, 0.001, 2 * M_PI * 30); }
+    static Bank* bank() { return new Bank(20, 0.001, 2 * M_PI * 30); }
+};
+
+static double elapsedNs(const std::chrono::steady_clock::time_point& t_start) {
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t_start)
+        .count();
+}
+
+// number of outputs that differ
+template <typename Maker, typename Bank>
+static long run(const std::vector<Sample>& in, int num) {
+    std::vector<filter*> filters;
+    for (int i(0); i < num_channels; ++i) filters.push_back(Maker::scalar());
+    Bank* bank = Maker::bank();
+
+    double sum = 0.;
+    auto t_start = std::chrono::steady_clock::now();
+    for (int k(0); k < num; ++k) {
+        for (int i(0); i < num_channels; ++i) {
+            filters[i]->input(in[k][i]);
+            sum += filters[i]->output();
+        }
+    }
+    double t_scalar = elapsedNs(t_start) / num;
+    t_start = std::chrono::steady_clock::now();
+    for (int k(0); k < num; ++k) {
+        bank->input(in[k]);
+        sum += bank->output()[0];
+    }
+    double t_bank = elapsedNs(t_start) / num;
+
+    // again from the start, side by side
+    for (int i(0); i < num_channels; ++i) {
+        delete filters[i];
+        filters[i] = Maker::scalar();
+    }
+    delete bank;
+    bank = Maker::bank();
+    long num_differ = 0;
+    for (int k(0); k < num; ++k) {
+        bank->input(in[k]);
+        for (int i(0); i < num_channels; ++i) {
+            filters[i]->input(in[k][i]);
+            double a = filters[i]->output();
+            double b = bank->output()[i];
+            if (memcmp(&a, &b, sizeof(double)) != 0) ++num_differ;
+        }
+    }
+    printf("%-22s %9.1f %9.1f %9.1f %9ld (%.0f)\n", Maker::name(), t_scalar, t_bank,
+           t_scalar / t_bank, num_differ, sum);
+
+    for (int i(0); i < num_channels; ++i) delete filters[i];
+    delete bank;
+    return num_differ;
+}
+
+int main(int argc, char** argv) {
+    int num = 200000;
+    for (int i(1); i < argc; ++i) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            num = atoi(argv[++i]);
+        } else {
+            printf("usage: filter_bank_bench [-n ticks]\n");
+            return 1;
+        }
+    }
+
+    std::mt19937 gen(1);
+    std::normal_distribution<double> normal(0., 1.);
+    std::vector<Sample> in(num);
+    for (int k(0); k < num; ++k)
+        for (int i(0); i < num_channels; ++i) in[k][i] = normal(gen);
+
+    printf("%d channels, %d ticks\n", num_channels, num);
+    printf("%-22s %9s %9s %9s %9s\n", "[ns] per tick", "scalar", "bank", "speedup",
+           "differ");
+    long num_differ = 0;
+    num_differ += run<DigitalLp<digital_lp_filter_bank<num_channels> >,
+                      digital_lp_filter_bank<num_channels> >(in, num);
+    num_differ += run<DerivLp<deriv_lp_filter_bank<num_channels> >,
+                      deriv_lp_filter_bank<num_channels> >(in, num);
+    num_differ += run<MovingAverage<moving_average_filter_bank<num_channels> >,
+                      moving_average_filter_bank<num_channels> >(in, num);
+    // the butterworth filter is slow, fewer ticks
+    num_differ += run<Butterworth<butterworth_filter_bank<num_channels> >,
+                      butterworth_filter_bank<num_channels> >(in, std::max(1, num / 10));
+    printf("%s\n", num_differ == 0 ? "OK" : "FAILED");
+    return num_differ == 0 ? 0 : 1;
+}
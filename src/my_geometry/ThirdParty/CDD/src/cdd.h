@@ -29,24 +29,24 @@
 #endif
 
 /* GLOBAL CONSTANTS and STATISTICS VARIABLES (to be set by dd_set_global_constants() */
-extern mytype dd_zero;
-extern mytype dd_one;
-extern mytype dd_purezero;
-extern mytype dd_minuszero;
-extern mytype dd_minusone;
-
-extern time_t dd_statStartTime; /* cddlib starting time */
-extern long dd_statBApivots;  /* basis finding pivots */
-extern long dd_statCCpivots;  /* criss-cross pivots */
-extern long dd_statDS1pivots; /* phase 1 pivots */
-extern long dd_statDS2pivots; /* phase 2 pivots */
-extern long dd_statACpivots;  /* anticycling (cc) pivots */
+extern dd_THREAD_LOCAL mytype dd_zero;
+extern dd_THREAD_LOCAL mytype dd_one;
+extern dd_THREAD_LOCAL mytype dd_purezero;
+extern dd_THREAD_LOCAL mytype dd_minuszero;
+extern dd_THREAD_LOCAL mytype dd_minusone;
+
+extern dd_THREAD_LOCAL time_t dd_statStartTime; /* cddlib starting time */
+extern dd_THREAD_LOCAL long dd_statBApivots;  /* basis finding pivots */
+extern dd_THREAD_LOCAL long dd_statCCpivots;  /* criss-cross pivots */
+extern dd_THREAD_LOCAL long dd_statDS1pivots; /* phase 1 pivots */
+extern dd_THREAD_LOCAL long dd_statDS2pivots; /* phase 2 pivots */
+extern dd_THREAD_LOCAL long dd_statACpivots;  /* anticycling (cc) pivots */
 #ifdef GMPRATIONAL
-extern long dd_statBSpivots;  /* basis status checking pivots */
+extern dd_THREAD_LOCAL long dd_statBSpivots;  /* basis status checking pivots */
 #endif
-extern dd_LPSolverType dd_choiceLPSolverDefault;  /* Default LP solver Algorithm */
-extern dd_LPSolverType dd_choiceRedcheckAlgorithm;  /* Redundancy Checking Algorithm */
-extern dd_boolean dd_choiceLexicoPivotQ;    /* whether to use the lexicographic pivot */
+extern dd_THREAD_LOCAL dd_LPSolverType dd_choiceLPSolverDefault;  /* Default LP solver Algorithm */
+extern dd_THREAD_LOCAL dd_LPSolverType dd_choiceRedcheckAlgorithm;  /* Redundancy Checking Algorithm */
+extern dd_THREAD_LOCAL dd_boolean dd_choiceLexicoPivotQ;    /* whether to use the lexicographic pivot */
 
    /* to be used to avoid creating temporary spaces for mytype */
 #define dd_almostzero  1.0E-7
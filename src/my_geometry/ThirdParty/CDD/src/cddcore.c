@@ -23,8 +23,8 @@ void dd_CheckAdjacency(dd_ConePtr cone,
 {
   dd_RayPtr TempRay;
   dd_boolean localdebug=dd_FALSE;
-  static dd_rowset Face, Face1;
-  static dd_rowrange last_m=0;
+  static dd_THREAD_LOCAL dd_rowset Face, Face1;
+  static dd_THREAD_LOCAL dd_rowrange last_m=0;
   
   if (last_m!=cone->m) {
     if (last_m>0){
@@ -33,6 +33,8 @@ void dd_CheckAdjacency(dd_ConePtr cone,
     set_initialize(&Face, cone->m); 
     set_initialize(&Face1, cone->m); 
     last_m=cone->m;
+    dd_register_thread_buffer((void **)&Face, &last_m);
+    dd_register_thread_buffer((void **)&Face1, &last_m);
   }
 
   if (dd_debug) localdebug=dd_TRUE;
@@ -291,8 +293,8 @@ void dd_ConditionalAddEdge(dd_ConePtr cone,
   dd_AdjacencyType *NewEdge;
   dd_boolean localdebug=dd_FALSE;
   dd_rowset ZSmin, ZSmax;
-  static dd_rowset Face, Face1;
-  static dd_rowrange last_m=0;
+  static dd_THREAD_LOCAL dd_rowset Face, Face1;
+  static dd_THREAD_LOCAL dd_rowrange last_m=0;
   
   if (last_m!=cone->m) {
     if (last_m>0){
@@ -301,6 +303,8 @@ void dd_ConditionalAddEdge(dd_ConePtr cone,
     set_initialize(&Face, cone->m);
     set_initialize(&Face1, cone->m);
     last_m=cone->m;
+    dd_register_thread_buffer((void **)&Face, &last_m);
+    dd_register_thread_buffer((void **)&Face1, &last_m);
   }
   
   fii1=Ray1->FirstInfeasIndex;
@@ -1068,8 +1072,8 @@ void dd_CreateNewRay(dd_ConePtr cone,
   /*Create a new ray by taking a linear combination of two rays*/
   dd_colrange j;
   mytype a1, a2, v1, v2;
-  static dd_Arow NewRay;
-  static dd_colrange last_d=0;
+  static dd_THREAD_LOCAL dd_Arow NewRay;
+  static dd_THREAD_LOCAL dd_colrange last_d=0;
   dd_boolean localdebug=dd_debug;
 
   dd_init(a1); dd_init(a2); dd_init(v1); dd_init(v2);
@@ -1081,6 +1085,7 @@ void dd_CreateNewRay(dd_ConePtr cone,
     NewRay=(mytype*)calloc(cone->d,sizeof(mytype));
     for (j=0; j<cone->d; j++) dd_init(NewRay[j]);
     last_d=cone->d;
+    dd_register_thread_buffer((void **)&NewRay, &last_d);
   }
 
   dd_AValue(&a1, cone->d, cone->A, Ptr1->Ray, ii);
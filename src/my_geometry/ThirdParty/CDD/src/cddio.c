@@ -1077,13 +1077,14 @@ void dd_CopyRay(mytype *a, dd_colrange d_origsize, dd_RayPtr RR,
 void dd_WriteRay(FILE *f, dd_colrange d_origsize, dd_RayPtr RR, dd_RepresentationType rep, dd_colindex reducedcol)
 {
   dd_colrange j;
-  static dd_colrange d_last=0;
-  static dd_Arow a;
+  static dd_THREAD_LOCAL dd_colrange d_last=0;
+  static dd_THREAD_LOCAL dd_Arow a;
 
   if (d_last< d_origsize){
     if (d_last>0) free(a);
     dd_InitializeArow(d_origsize+1, &a);
     d_last=d_origsize+1;
+    dd_register_thread_buffer((void **)&a, &d_last);
   }
 
  dd_CopyRay(a, d_origsize, RR, rep, reducedcol);
@@ -1402,14 +1403,15 @@ dd_boolean dd_InputAdjacentQ(dd_PolyhedraPtr poly,
 {
   dd_boolean adj=dd_TRUE;
   dd_rowrange i;
-  static set_type common;
-  static long lastn=0;
+  static dd_THREAD_LOCAL set_type common;
+  static dd_THREAD_LOCAL long lastn=0;
 
   if (poly->AincGenerated==dd_FALSE) dd_ComputeAinc(poly);
   if (lastn!=poly->n){
     if (lastn >0) set_free(common);
     set_initialize(&common, poly->n);
     lastn=poly->n;
+    dd_register_thread_buffer((void **)&common, &lastn);
   }
   if (set_member(i1, poly->Ared) || set_member(i2, poly->Ared)){
     adj=dd_FALSE;
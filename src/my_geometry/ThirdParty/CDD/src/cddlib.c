@@ -44,24 +44,24 @@
 dd_boolean dd_debug               =dd_FALSE;
 dd_boolean dd_log                 =dd_FALSE;
 /* GLOBAL CONSTANTS and STATICS VARIABLES (to be set by dd_set_global_constants() */
-mytype dd_zero;
-mytype dd_one;
-mytype dd_purezero;
-mytype dd_minuszero;
-mytype dd_minusone;
-
-time_t dd_statStartTime; /* cddlib starting time */
-long dd_statBApivots;  /* basis finding pivots */
-long dd_statCCpivots;  /* criss-cross pivots */
-long dd_statDS1pivots; /* phase 1 pivots */
-long dd_statDS2pivots; /* phase 2 pivots */
-long dd_statACpivots;  /* anticycling (cc) pivots */
+dd_THREAD_LOCAL mytype dd_zero;
+dd_THREAD_LOCAL mytype dd_one;
+dd_THREAD_LOCAL mytype dd_purezero;
+dd_THREAD_LOCAL mytype dd_minuszero;
+dd_THREAD_LOCAL mytype dd_minusone;
+
+dd_THREAD_LOCAL time_t dd_statStartTime; /* cddlib starting time */
+dd_THREAD_LOCAL long dd_statBApivots;  /* basis finding pivots */
+dd_THREAD_LOCAL long dd_statCCpivots;  /* criss-cross pivots */
+dd_THREAD_LOCAL long dd_statDS1pivots; /* phase 1 pivots */
+dd_THREAD_LOCAL long dd_statDS2pivots; /* phase 2 pivots */
+dd_THREAD_LOCAL long dd_statACpivots;  /* anticycling (cc) pivots */
 #ifdef GMPRATIONAL
-long dd_statBSpivots;  /* basis status checking pivots */
+dd_THREAD_LOCAL long dd_statBSpivots;  /* basis status checking pivots */
 #endif
-dd_LPSolverType dd_choiceLPSolverDefault;  /* Default LP solver Algorithm */
-dd_LPSolverType dd_choiceRedcheckAlgorithm;  /* Redundancy Checking Algorithm */
-dd_boolean dd_choiceLexicoPivotQ;    /* whether to use the lexicographic pivot */
+dd_THREAD_LOCAL dd_LPSolverType dd_choiceLPSolverDefault;  /* Default LP solver Algorithm */
+dd_THREAD_LOCAL dd_LPSolverType dd_choiceRedcheckAlgorithm;  /* Redundancy Checking Algorithm */
+dd_THREAD_LOCAL dd_boolean dd_choiceLexicoPivotQ;    /* whether to use the lexicographic pivot */
 
 /* #include <profile.h>    THINK C PROFILER */
 /* #include <console.h>    THINK C PROFILER */
@@ -146,8 +146,8 @@ void dd_InitialDataSetup(dd_ConePtr cone)
 {
   long j, r;
   dd_rowset ZSet;
-  static dd_Arow Vector1,Vector2;
-  static dd_colrange last_d=0;
+  static dd_THREAD_LOCAL dd_Arow Vector1,Vector2;
+  static dd_THREAD_LOCAL dd_colrange last_d=0;
 
   if (last_d < cone->d){
     if (last_d>0) {
@@ -164,6 +164,8 @@ void dd_InitialDataSetup(dd_ConePtr cone)
       dd_init(Vector2[j]);
     }
     last_d=cone->d;
+    dd_register_thread_buffer((void **)&Vector1, &last_d);
+    dd_register_thread_buffer((void **)&Vector2, &last_d);
   }
 
   cone->RecomputeRowOrder=dd_FALSE;
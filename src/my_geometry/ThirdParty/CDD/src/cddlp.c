@@ -541,9 +541,9 @@ void dd_SelectDualSimplexPivot(dd_rowrange m_size,dd_colrange d_size,
   dd_rowrange i,iref;
   dd_colrange j,k;
   mytype val,valn, minval,rat,minrat;
-  static dd_Arow rcost;
-  static dd_colrange d_last=0;
-  static dd_colset tieset,stieset;  /* store the column indices with tie */
+  static dd_THREAD_LOCAL dd_Arow rcost;
+  static dd_THREAD_LOCAL dd_colrange d_last=0;
+  static dd_THREAD_LOCAL dd_colset tieset,stieset;  /* store the column indices with tie */
 
   dd_init(val); dd_init(valn); dd_init(minval); dd_init(rat); dd_init(minrat);
   if (d_last<d_size) {
@@ -558,6 +558,9 @@ void dd_SelectDualSimplexPivot(dd_rowrange m_size,dd_colrange d_size,
     set_initialize(&tieset,d_size);
     set_initialize(&stieset,d_size);
     d_last=d_size;
+    dd_register_thread_buffer((void **)&rcost, &d_last);
+    dd_register_thread_buffer((void **)&tieset, &d_last);
+    dd_register_thread_buffer((void **)&stieset, &d_last);
   }
 
   *r=0; *s=0;
@@ -752,8 +755,8 @@ void dd_GaussianColumnPivot(dd_rowrange m_size, dd_colrange d_size,
 {
   dd_colrange j, j1;
   mytype Xtemp0, Xtemp1, Xtemp;
-  static dd_Arow Rtemp;
-  static dd_colrange last_d=0;
+  static dd_THREAD_LOCAL dd_Arow Rtemp;
+  static dd_THREAD_LOCAL dd_colrange last_d=0;
 
   dd_init(Xtemp0); dd_init(Xtemp1); dd_init(Xtemp);
   if (last_d!=d_size){
@@ -764,6 +767,7 @@ void dd_GaussianColumnPivot(dd_rowrange m_size, dd_colrange d_size,
     Rtemp=(mytype*)calloc(d_size,sizeof(mytype));
     for (j=1; j<=d_size; j++) dd_init(Rtemp[j-1]);
     last_d=d_size;
+    dd_register_thread_buffer((void **)&Rtemp, &last_d);
   }
 
   for (j=1; j<=d_size; j++) {
@@ -1182,9 +1186,9 @@ void dd_FindDualFeasibleBasis(dd_rowrange m_size,dd_colrange d_size,
   dd_rowrange i,r_val;
   dd_colrange j,l,ms=0,s_val,local_m_size;
   mytype x,val,maxcost,axvalue,maxratio;
-  static dd_colrange d_last=0;
-  static dd_Arow rcost;
-  static dd_colindex nbindex_ref; /* to be used to store the initial feasible basis for lexico rule */
+  static dd_THREAD_LOCAL dd_colrange d_last=0;
+  static dd_THREAD_LOCAL dd_Arow rcost;
+  static dd_THREAD_LOCAL dd_colindex nbindex_ref; /* to be used to store the initial feasible basis for lexico rule */
 
   mytype scaling,svalue;  /* random scaling mytype value */
   mytype minval;
@@ -1203,6 +1207,8 @@ void dd_FindDualFeasibleBasis(dd_rowrange m_size,dd_colrange d_size,
     nbindex_ref=(long*) calloc(d_size+1,sizeof(long));
     for (j=1; j<=d_size; j++){ dd_init(rcost[j-1]);}
     d_last=d_size;
+    dd_register_thread_buffer((void **)&rcost, &d_last);
+    dd_register_thread_buffer((void **)&nbindex_ref, &d_last);
   }
 
   *err=dd_NoError; *lps=dd_LPSundecided; *s=0;
@@ -1413,10 +1419,10 @@ When LP is dual-inconsistent then lp->se returns the evidence column.
 
   dd_rowrange i,r;
   dd_colrange j,s;
-  static dd_rowindex bflag;
-  static long mlast=0,nlast=0;
-  static dd_rowindex OrderVector;  /* the permutation vector to store a preordered row indeces */
-  static dd_colindex nbindex_ref; /* to be used to store the initial feasible basis for lexico rule */
+  static dd_THREAD_LOCAL dd_rowindex bflag;
+  static dd_THREAD_LOCAL long mlast=0,nlast=0;
+  static dd_THREAD_LOCAL dd_rowindex OrderVector;  /* the permutation vector to store a preordered row indeces */
+  static dd_THREAD_LOCAL dd_colindex nbindex_ref; /* to be used to store the initial feasible basis for lexico rule */
 
   double redpercent=0,redpercent_prev=0,redgain=0;
   unsigned int rseed=1;
@@ -1439,6 +1445,9 @@ When LP is dual-inconsistent then lp->se returns the evidence column.
      bflag=(long *) calloc(lp->m+2,sizeof(*bflag));  /* one more element for an auxiliary variable  */
      nbindex_ref=(long*) calloc(lp->d+1,sizeof(long));
      mlast=lp->m;nlast=lp->d;
+     dd_register_thread_buffer((void **)&OrderVector, &mlast);
+     dd_register_thread_buffer((void **)&bflag, &mlast);
+     dd_register_thread_buffer((void **)&nbindex_ref, &mlast);
   }
   /* Initializing control variables. */
   dd_ComputeRowOrderVector2(lp->m,lp->d,lp->A,OrderVector,dd_MinIndex,rseed);
@@ -1595,9 +1604,9 @@ When LP is dual-inconsistent then lp->se returns the evidence column.
 
   dd_rowrange i,r;
   dd_colrange s;
-  static dd_rowindex bflag;
-  static long mlast=0;
-  static dd_rowindex OrderVector;  /* the permutation vector to store a preordered row indeces */
+  static dd_THREAD_LOCAL dd_rowindex bflag;
+  static dd_THREAD_LOCAL long mlast=0;
+  static dd_THREAD_LOCAL dd_rowindex OrderVector;  /* the permutation vector to store a preordered row indeces */
   unsigned int rseed=1;
   dd_colindex nbtemp;
 
@@ -1617,6 +1626,8 @@ When LP is dual-inconsistent then lp->se returns the evidence column.
      /* initialize only for the first time or when a larger space is needed */
      
      mlast=lp->m;
+     dd_register_thread_buffer((void **)&bflag, &mlast);
+     dd_register_thread_buffer((void **)&OrderVector, &mlast);
   }
   /* Initializing control variables. */
   dd_ComputeRowOrderVector2(lp->m,lp->d,lp->A,OrderVector,dd_MinIndex,rseed);
@@ -3595,9 +3606,9 @@ arithmetics.
   long pivots0,pivots1,fbasisrank;
   dd_rowrange i,is;
   dd_colrange s,senew,j;
-  static dd_rowindex bflag;
-  static long mlast=0;
-  static dd_rowindex OrderVector;  /* the permutation vector to store a preordered row indices */
+  static dd_THREAD_LOCAL dd_rowindex bflag;
+  static dd_THREAD_LOCAL long mlast=0;
+  static dd_THREAD_LOCAL dd_rowindex OrderVector;  /* the permutation vector to store a preordered row indices */
   unsigned int rseed=1;
   mytype val;
   dd_colindex nbtemp;
@@ -3620,6 +3631,8 @@ arithmetics.
      OrderVector=(long *)calloc(m_size+1,sizeof(long)); 
      /* initialize only for the first time or when a larger space is needed */
       mlast=m_size;
+      dd_register_thread_buffer((void **)&bflag, &mlast);
+      dd_register_thread_buffer((void **)&OrderVector, &mlast);
   }
 
   /* Initializing control variables. */
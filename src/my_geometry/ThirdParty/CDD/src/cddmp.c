@@ -85,6 +85,35 @@ void dd_free_global_constants()
 #endif
 }
 
+#define dd_MAX_THREAD_BUFFERS 32
+static dd_THREAD_LOCAL void **dd_thread_buffer[dd_MAX_THREAD_BUFFERS];
+static dd_THREAD_LOCAL long *dd_thread_buffer_size[dd_MAX_THREAD_BUFFERS];
+static dd_THREAD_LOCAL int dd_num_thread_buffers=0;
+
+void dd_register_thread_buffer(void **ptr, long *size)
+{
+ int i;
+ for (i=0; i<dd_num_thread_buffers; i++){
+   if (dd_thread_buffer[i]==ptr) return;
+ }
+ if (dd_num_thread_buffers<dd_MAX_THREAD_BUFFERS){
+   dd_thread_buffer[dd_num_thread_buffers]=ptr;
+   dd_thread_buffer_size[dd_num_thread_buffers]=size;
+   dd_num_thread_buffers++;
+ }
+}
+
+void dd_free_thread_buffers()
+/* the entries of mytype are not cleared, which is only needed with gmp */
+{
+ int i;
+ for (i=0; i<dd_num_thread_buffers; i++){
+   free(*dd_thread_buffer[i]);
+   *dd_thread_buffer[i]=NULL;
+   *dd_thread_buffer_size[i]=0;
+ }
+ dd_num_thread_buffers=0;
+}
 
 #if defined GMPRATIONAL
 void ddd_mpq_set_si(mytype a,signed long b)
@@ -119,6 +119,11 @@ void ddd_mpq_set_si(mytype,signed long);
 
 void dd_set_global_constants(void);
 void dd_free_global_constants(void);  /* 094d */
+/* scratch buffers kept by the conversion routines in static variables of
+   the thread, registered with their size variable at the allocation and
+   freed by dd_free_thread_buffers, e.g. at the exit of the thread */
+void dd_register_thread_buffer(void **ptr, long *size);
+void dd_free_thread_buffers(void);
 
 #if defined(__cplusplus)
 }
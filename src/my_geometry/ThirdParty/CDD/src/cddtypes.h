@@ -26,6 +26,17 @@
 #define dd_FALSE 0
 #define dd_TRUE 1
 
+/* the global constants, statistics and the scratch buffers of the
+   conversion routines are kept per thread, so that independent
+   conversions can run in parallel threads */
+#if defined(__GNUC__) || defined(__clang__)
+#define dd_THREAD_LOCAL __thread
+#elif defined(__cplusplus)
+#define dd_THREAD_LOCAL thread_local
+#else
+#define dd_THREAD_LOCAL _Thread_local
+#endif
+
 typedef int dd_boolean;
 
 typedef long dd_rowrange;
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <vector>
+#include <Eigen/Core>
+#include <Eigen/StdVector>
+
+/* Convex hull of 2D contact points, updated incrementally.
+ * Points are identified by an id in [0, maxPoints), e.g. the foot index.
+ * Inserting or removing a point only touches the hull vertices and the
+ * half-planes next to it, so a contact change costs O(n) on a handful of
+ * points with no allocation after construction. The hull is kept in
+ * counterclockwise order with the half-planes n_i' x <= b_i of its edges.
+ */
+class SupportPolygon {
+public:
+    /* Reserve the storage for maxPoints points. */
+    SupportPolygon(int maxPoints = 4);
+    ~SupportPolygon();
+
+    /* Insert the point id at p, an existing point id is moved to p. */
+    void insert(int id, const Eigen::Vector2d& p);
+    /* Remove the point id, nothing happens if it is not inserted. */
+    void remove(int id);
+    void clear();
+
+    bool hasPoint(int id) const { return active_[id]; }
+    int getNumPoints() const { return numPoints_; }
+
+    /* True if p is in the polygon, tol > 0 extends it by tol. */
+    bool contains(const Eigen::Vector2d& p, double tol = 0.) const;
+    /* Signed stability margin of p:
+     * the distance to the closest edge if p is inside,
+     * minus the distance to the polygon if p is outside.
+     * With less than 3 hull vertices, minus the distance to the hull.
+     */
+    double stabilityMargin(const Eigen::Vector2d& p) const;
+
+    /* Hull vertices in counterclockwise order. */
+    int getNumVertices() const { return (int)hull_.size(); }
+    const Eigen::Vector2d& getVertex(int i) const { return pos_[hull_[i]]; }
+    int getVertexId(int i) const { return hull_[i]; }
+
+    /* Half-plane of the edge from vertex i to vertex i+1, n' x <= b,
+     * n is the outward unit normal. Empty with less than 3 vertices.
+     */
+    int getNumHalfPlanes() const { return (int)normal_.size(); }
+    const Eigen::Vector2d& getNormal(int i) const { return normal_[i]; }
+    double getOffset(int i) const { return offset_[i]; }
+    /* Stacked half-planes, A x <= b as Polyhedron::hrep(). */
+    void getHalfPlanes(Eigen::MatrixXd& A, Eigen::VectorXd& b) const;
+
+private:
+    using Vector2dList = std::vector<Eigen::Vector2d, Eigen::aligned_allocator<Eigen::Vector2d>>;
+
+    void insertHull(int id);
+    void removeHull(int k);
+    void rebuild();
+    void spliceHull(int first, int last, const std::vector<int>& chain);
+    void edgeHalfPlane(int a, int b, Eigen::Vector2d& n, double& offset) const;
+    double cross(int a, int b, const Eigen::Vector2d& p) const;
+    double distanceToHull(const Eigen::Vector2d& p) const;
+
+private:
+    int maxPoints_;
+    int numPoints_;
+
+    // points, indexed by id
+    Vector2dList pos_;
+    std::vector<bool> active_;
+    std::vector<bool> onHull_;
+
+    // hull vertex ids (ccw) and the half-planes of their edges
+    std::vector<int> hull_;
+    Vector2dList normal_;
+    std::vector<double> offset_;
+
+    // scratch
+    std::vector<int> chain_;
+    std::vector<int> newHull_;
+    Vector2dList newNormal_;
+    std::vector<double> newOffset_;
+};
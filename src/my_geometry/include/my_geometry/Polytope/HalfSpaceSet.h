@@ -0,0 +1,62 @@
+#pragma once
+
+#include <utility>
+#include <vector>
+#include <Eigen/Core>
+
+/* Half-space representation Ax <= b for batched membership queries.
+ * The rows are normalized, so a margin b_i - a_i'x is the signed distance
+ * to the i-th hyperplane (positive inside). Points are given stacked in
+ * the rows of a column-major N x dim matrix, i.e. one contiguous array per
+ * coordinate, and are processed four at a time by an AVX2 kernel when the
+ * cpu supports it (checked at runtime) or by the scalar kernel otherwise.
+ * Typical use: hs.setHrep(poly.hrep()) and then query many points.
+ */
+class HalfSpaceSet {
+public:
+    HalfSpaceSet();
+    ~HalfSpaceSet();
+
+    /* Set Ax <= b, the zero rows of A are dropped.
+     * \return false if the sizes do not match.
+     */
+    bool setHrep(const Eigen::MatrixXd& A, const Eigen::VectorXd& b);
+    bool setHrep(const std::pair<Eigen::MatrixXd, Eigen::VectorXd>& hrep) { return setHrep(hrep.first, hrep.second); }
+
+    int getDim() const { return dim_; }
+    int getNumHalfSpaces() const { return numHalfSpaces_; }
+
+    /* Minimum signed margin over the half-spaces of each point,
+     * +inf with no half-space.
+     * \param X N x dim matrix of stacked points.
+     * \return false if X does not have dim columns.
+     */
+    bool margins(const Eigen::MatrixXd& X, Eigen::VectorXd& margin) const;
+    /* inside[k] = 1 if margin[k] >= -tol, 0 otherwise. */
+    bool contains(const Eigen::MatrixXd& X, std::vector<char>& inside, Eigen::VectorXd& margin, double tol = 0.) const;
+    /* Same on the first n rows of X. margin and inside are only resized
+     * if they have less than n entries, so buffers sized once for the
+     * largest batch are not reallocated.
+     * \return false if X does not have dim columns or n rows.
+     */
+    bool margins(const Eigen::MatrixXd& X, int n, Eigen::VectorXd& margin) const;
+    bool contains(const Eigen::MatrixXd& X, int n, std::vector<char>& inside, Eigen::VectorXd& margin, double tol = 0.) const;
+
+    /* Single point queries */
+    double margin(const Eigen::VectorXd& p) const;
+    bool contains(const Eigen::VectorXd& p, double tol = 0.) const { return margin(p) >= -tol; }
+
+    /* The AVX2 kernel is used if available and enabled (default). */
+    static bool hasAvx2();
+    void setUseSimd(bool useSimd) { useSimd_ = useSimd; }
+    bool isUsingSimd() const { return useSimd_ && hasAvx2(); }
+
+private:
+    int dim_;
+    int numHalfSpaces_;
+    bool useSimd_;
+
+    // normalized rows, a_[i * dim_ + j] = A(i, j) / |A.row(i)|
+    std::vector<double> a_;
+    std::vector<double> b_;
+};
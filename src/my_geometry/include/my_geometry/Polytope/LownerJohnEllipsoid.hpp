@@ -1,37 +1,95 @@
-#include <string>
-#include <iostream>
-#include <iomanip>
-#include <cmath>
-#include "fusion.h"
-#include <cassert>
+#pragma once
 
+#include <vector>
+#include <utility>
 #include <Eigen/Dense>
 
-using namespace mosek::fusion;
-using namespace monty;
-
 namespace LownerJohnEllipsoid
 {
-    std::shared_ptr<ndarray<int, 1>> range(int start, int stop); int pow2(int n);
-    void geometric_mean(Model::t M, Variable::t x, Variable::t t);
-    void det_rootn(Model::t M, int n, Variable::t X, Variable::t t);
-
-    std::pair<std::shared_ptr<ndarray<double,1>>,std::shared_ptr<ndarray<double,1> > >
-        lownerjohn_inner
-        ( std::shared_ptr<ndarray<double,2>> A,
-          std::shared_ptr<ndarray<double,1>> b );
+    /*
+     * Maximum volume ellipsoid inscribed in S = { x | Ax <= b },
+     * { x | x = C*u + d, || u ||_2 <= 1 }
+     * Return (C, d), C is symmetric positive definite
+     */
+    std::pair<Eigen::MatrixXd, Eigen::VectorXd>
+        lownerjohn_inner(const Eigen::MatrixXd& A, const Eigen::VectorXd& b);
 
     /*
+     * Minimum volume ellipsoid enclosing conv{ x1, ..., xm },
+     * points are stacked in the rows of x
      * (Qx - c)'(Qx - c) = 1
      * In order to write with |x - b|_{P} = 1,
      * P = Q.transpose()*Q, b = Q.inverse()*c
+     * Return (Q, c)
      */
-    std::pair<std::shared_ptr<ndarray<double,1>>,std::shared_ptr<ndarray<double,1 > > >
-        lownerjohn_outer(std::shared_ptr<ndarray<double,2>> x);
-
-    std::ostream & operator<<(std::ostream & os, ndarray<double,1> & a);
+    std::pair<Eigen::MatrixXd, Eigen::VectorXd>
+        lownerjohn_outer(const Eigen::MatrixXd& x);
 } /* LownerJohnEllipsoid */
 
+ /*
+  * Lowner-John ellipsoid solver with no external dependency.
+  * outer : Khachiyan's algorithm with away steps (Todd-Yildirim),
+  *         warm started from the weights of the previous solve
+  * inner : log-det barrier method with Newton centering steps,
+  *         warm started from the previous ellipsoid if it is still inside
+  * Keep an instance to warm start across slowly changing polytopes.
+  */
+class LJEllipsoidSolver
+{
+public:
+    LJEllipsoidSolver();
+    virtual ~LJEllipsoidSolver();
+
+    void setTolerance(double tol) { mTol = tol; }
+    void setMaxIteration(int maxIter) { mMaxIter = maxIter; }
+    void setWarmStart(bool bWarmStart) { mbWarmStart = bWarmStart; }
+    void resetWarmStart();
+
+    /*
+     * Ellipsoid { x = C*u + d, |u| <= 1 } of maximum volume in Ax <= b
+     * return false if Ax < b is empty or unbounded,
+     * or the solve does not converge
+     */
+    bool solveInner(const Eigen::MatrixXd& A, const Eigen::VectorXd& b,
+                    Eigen::MatrixXd& C, Eigen::VectorXd& d);
+    /*
+     * Ellipsoid { x | |Qx - c| <= 1 } of minimum volume
+     * containing the rows of x, x has to span the whole space
+     */
+    bool solveOuter(const Eigen::MatrixXd& x,
+                    Eigen::MatrixXd& Q, Eigen::VectorXd& c);
+
+    // last call
+    double getSolveTime() { return mSolveTime; } // [ms]
+    int getNumIteration() { return mNumIter; }
+    bool isWarmStarted() { return mbWarmStarted; }
+
+private:
+    bool _findInteriorPoint(const Eigen::MatrixXd& A, const Eigen::VectorXd& b,
+                            Eigen::VectorXd& d);
+    bool _centerInner(const Eigen::MatrixXd& A, const Eigen::VectorXd& b,
+                      double t, Eigen::VectorXd& z);
+    bool _evalInner(const Eigen::MatrixXd& A, const Eigen::VectorXd& b,
+                    double t, const Eigen::VectorXd& z, double& f,
+                    Eigen::VectorXd* grad, Eigen::MatrixXd* hess);
+    void _zToEllipsoid(const Eigen::VectorXd& z, int n,
+                       Eigen::MatrixXd& C, Eigen::VectorXd& d);
+
+private:
+    double mTol;
+    int mMaxIter;
+    bool mbWarmStart;
+
+    // previous solutions
+    Eigen::VectorXd mOuterWeight;
+    Eigen::MatrixXd mInnerC;
+    Eigen::VectorXd mInnerD;
+
+    double mSolveTime;
+    int mNumIter;
+    bool mbWarmStarted;
+};
+
  /*
   * Class for Computing LownerJohnEllipsoid with Points and Normal Vector in
   * Global Coordinate
@@ -43,15 +101,24 @@ public:
                                     Eigen::VectorXd normalVector_);
     virtual ~LJEllipsoidWithPointsAndNormal ();
 
+    // new points of the same polytope, the next solve is warm started
+    void updatePoints(std::vector<Eigen::VectorXd> pointsList_,
+                      Eigen::VectorXd normalVector_);
+
     /*
      * Return Spectral Matrix P and Center b
      * Such that (x - b)'P(x - b) = 1
      * Note that P, b is in local coordinate
+     * P, b are zero if the solve does not converge, see isSolved()
      */
     std::pair<Eigen::MatrixXd, Eigen::VectorXd> computeLJEllipsoid();
     double getNullDimVal();
     // local coordinate w.r.t global
     Eigen::MatrixXd getSO();
+    // [ms], last computeLJEllipsoid
+    double getSolveTime() { return mSolver.getSolveTime(); }
+    // false if the last computeLJEllipsoid did not converge
+    bool isSolved() { return mbSolved; }
 
 private:
     std::vector<Eigen::VectorXd> mPointsList;
@@ -60,4 +127,7 @@ private:
     int mNumPoints;
     double mNullDimVal;
     Eigen::MatrixXd mSO;
+    bool mbSolved;
+
+    LJEllipsoidSolver mSolver;
 };
@@ -19,10 +19,8 @@
 
 #include "typedefs.h"
 #include <Eigen/Core>
-#include <atomic>
 #include <setoper.h> // Must be included before cdd.h (wtf)
 #include <cdd.h>
-#include <mutex>
 #include <utility>
 
 using HrepXd = std::pair<Eigen::MatrixXd, Eigen::VectorXd>;
@@ -31,12 +29,15 @@ using VrepXd = std::pair<Eigen::MatrixXd, Eigen::VectorXd>;
 /* Wrapper of Convex Polyhedron
  * This class aims to translate eigen matrix into cddlib matrix.
  * It automatically transforms a v-polyhedron into an h-polyhedron and vice-versa.
+ * The cdd arithmetic constants and scratch buffers are thread local, so
+ * different instances can be converted in parallel threads. A single
+ * instance is not meant to be shared between threads.
  */
 class Polyhedron {
 public:
-    /* Default constructor that set cdd global constants. */
+    /* Default constructor that set the cdd constants of the calling thread. */
     Polyhedron();
-    /* Free the pointers and unset the cdd global constants. */
+    /* Free the pointers. */
     ~Polyhedron();
 
     /* Treat the inputs as an H-representation and compute its V-representation.
@@ -99,8 +100,4 @@ private:
     dd_MatrixPtr matPtr_;
     dd_PolyhedraPtr polytope_;
     dd_ErrorType err_;
-
-private:
-    static std::atomic_int counter;
-    static std::mutex mtx;
 };
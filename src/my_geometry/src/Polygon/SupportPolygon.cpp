@@ -0,0 +1,332 @@
+#include "my_geometry/Polygon/SupportPolygon.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+// cross product tolerance, collinear points are not hull vertices
+const double kEps = 1e-12;
+
+double crossProduct(const Eigen::Vector2d& a, const Eigen::Vector2d& b, const Eigen::Vector2d& p)
+{
+    return (b(0) - a(0)) * (p(1) - a(1)) - (b(1) - a(1)) * (p(0) - a(0));
+}
+
+double distanceToSegment(const Eigen::Vector2d& a, const Eigen::Vector2d& b, const Eigen::Vector2d& p)
+{
+    Eigen::Vector2d d = b - a;
+    double len2 = d.squaredNorm();
+    double s = len2 > 0. ? std::min(1., std::max(0., d.dot(p - a) / len2)) : 0.;
+    return (a + s * d - p).norm();
+}
+} // namespace
+
+SupportPolygon::SupportPolygon(int maxPoints)
+    : maxPoints_(maxPoints)
+    , numPoints_(0)
+{
+    pos_.resize(maxPoints_, Eigen::Vector2d::Zero());
+    active_.resize(maxPoints_, false);
+    onHull_.resize(maxPoints_, false);
+
+    hull_.reserve(maxPoints_);
+    normal_.reserve(maxPoints_);
+    offset_.reserve(maxPoints_);
+    // monotone chain keeps up to 2n ids
+    chain_.reserve(2 * maxPoints_ + 1);
+    newHull_.reserve(2 * maxPoints_ + 1);
+    newNormal_.reserve(maxPoints_);
+    newOffset_.reserve(maxPoints_);
+}
+
+SupportPolygon::~SupportPolygon() {}
+
+void SupportPolygon::insert(int id, const Eigen::Vector2d& p)
+{
+    if (id < 0 || id >= maxPoints_)
+        return;
+    if (active_[id]) {
+        if ((pos_[id] - p).squaredNorm() < kEps * kEps)
+            return;
+        remove(id);
+    }
+
+    pos_[id] = p;
+    active_[id] = true;
+    onHull_[id] = false;
+    ++numPoints_;
+
+    if (hull_.size() < 3)
+        rebuild();
+    else
+        insertHull(id);
+}
+
+void SupportPolygon::remove(int id)
+{
+    if (id < 0 || id >= maxPoints_ || !active_[id])
+        return;
+
+    active_[id] = false;
+    --numPoints_;
+    if (!onHull_[id])
+        return;
+
+    onHull_[id] = false;
+    int k = (int)(std::find(hull_.begin(), hull_.end(), id) - hull_.begin());
+    if (hull_.size() <= 3)
+        rebuild();
+    else
+        removeHull(k);
+}
+
+void SupportPolygon::clear()
+{
+    std::fill(active_.begin(), active_.end(), false);
+    std::fill(onHull_.begin(), onHull_.end(), false);
+    numPoints_ = 0;
+    hull_.clear();
+    normal_.clear();
+    offset_.clear();
+}
+
+bool SupportPolygon::contains(const Eigen::Vector2d& p, double tol) const
+{
+    if (hull_.size() < 3)
+        return distanceToHull(p) <= tol;
+
+    for (size_t i = 0; i < normal_.size(); ++i)
+        if (normal_[i].dot(p) - offset_[i] > tol)
+            return false;
+    return true;
+}
+
+double SupportPolygon::stabilityMargin(const Eigen::Vector2d& p) const
+{
+    if (hull_.size() < 3)
+        return -distanceToHull(p);
+
+    double margin = std::numeric_limits<double>::infinity();
+    for (size_t i = 0; i < normal_.size(); ++i)
+        margin = std::min(margin, offset_[i] - normal_[i].dot(p));
+    // outside, the closest half-plane underestimates the distance
+    if (margin < 0.)
+        margin = -distanceToHull(p);
+    return margin;
+}
+
+void SupportPolygon::getHalfPlanes(Eigen::MatrixXd& A, Eigen::VectorXd& b) const
+{
+    int n = (int)normal_.size();
+    A.resize(n, 2);
+    b.resize(n);
+    for (int i = 0; i < n; ++i) {
+        A.row(i) = normal_[i].transpose();
+        b(i) = offset_[i];
+    }
+}
+
+/**
+ * Private functions
+ */
+
+void SupportPolygon::insertHull(int id)
+{
+    const Eigen::Vector2d& p = pos_[id];
+    int h = (int)hull_.size();
+
+    // edges that see p form one cyclic run [s, e]
+    int s = -1;
+    for (int i = 0; i < h; ++i) {
+        bool visible = cross(hull_[i], hull_[(i + 1) % h], p) < -kEps;
+        bool prevVisible = cross(hull_[(i + h - 1) % h], hull_[i], p) < -kEps;
+        if (visible && !prevVisible) {
+            s = i;
+            break;
+        }
+    }
+    // inside
+    if (s < 0)
+        return;
+
+    int e = s;
+    while (cross(hull_[(e + 1) % h], hull_[(e + 2) % h], p) < -kEps)
+        e = (e + 1) % h;
+    // vertices that end up on a straight line through p are dropped too
+    while ((e + 2) % h != s && cross(hull_[(e + 1) % h], hull_[(e + 2) % h], p) <= kEps)
+        e = (e + 1) % h;
+    while ((s + h - 1) % h != (e + 1) % h && cross(hull_[(s + h - 1) % h], hull_[s], p) <= kEps)
+        s = (s + h - 1) % h;
+
+    chain_.clear();
+    chain_.push_back(id);
+    spliceHull(s, (e + 1) % h, chain_);
+}
+
+void SupportPolygon::removeHull(int k)
+{
+    int h = (int)hull_.size();
+    int prev = (k + h - 1) % h;
+    int next = (k + 1) % h;
+    const Eigen::Vector2d& a = pos_[hull_[prev]];
+    const Eigen::Vector2d& b = pos_[hull_[next]];
+
+    // inner points uncovered by the removed vertex, sorted by the angle
+    // around a starting from the outermost one (Graham order)
+    auto before = [&](int i, int j) {
+        double c = crossProduct(a, pos_[i], pos_[j]);
+        if (std::abs(c) > kEps)
+            return c > 0.;
+        return (pos_[i] - a).squaredNorm() < (pos_[j] - a).squaredNorm();
+    };
+    chain_.clear();
+    for (int id = 0; id < maxPoints_; ++id) {
+        if (!active_[id] || onHull_[id])
+            continue;
+        if (crossProduct(a, b, pos_[id]) >= -kEps)
+            continue;
+        int j = (int)chain_.size();
+        chain_.push_back(id);
+        while (j > 0 && before(id, chain_[j - 1])) {
+            chain_[j] = chain_[j - 1];
+            --j;
+        }
+        chain_[j] = id;
+    }
+
+    // convex chain from a to b, in place
+    int top = 0;
+    for (size_t i = 0; i < chain_.size(); ++i) {
+        const Eigen::Vector2d& p = pos_[chain_[i]];
+        while (top > 0 && crossProduct(top > 1 ? pos_[chain_[top - 2]] : a, pos_[chain_[top - 1]], p) <= kEps)
+            --top;
+        chain_[top++] = chain_[i];
+    }
+    while (top > 0 && crossProduct(top > 1 ? pos_[chain_[top - 2]] : a, pos_[chain_[top - 1]], b) <= kEps)
+        --top;
+    chain_.resize(top);
+
+    spliceHull(prev, next, chain_);
+}
+
+void SupportPolygon::rebuild()
+{
+    // Andrew's monotone chain over all the points
+    chain_.clear();
+    for (int id = 0; id < maxPoints_; ++id) {
+        onHull_[id] = false;
+        if (active_[id])
+            chain_.push_back(id);
+    }
+    std::sort(chain_.begin(), chain_.end(), [this](int i, int j) {
+        return pos_[i](0) < pos_[j](0) || (pos_[i](0) == pos_[j](0) && pos_[i](1) < pos_[j](1));
+    });
+
+    newHull_.clear();
+    int n = (int)chain_.size();
+    for (int i = 0; i < n; ++i) {
+        while (newHull_.size() >= 2 && crossProduct(pos_[newHull_[newHull_.size() - 2]], pos_[newHull_.back()], pos_[chain_[i]]) <= kEps)
+            newHull_.pop_back();
+        newHull_.push_back(chain_[i]);
+    }
+    size_t lower = newHull_.size() + 1;
+    for (int i = n - 2; i >= 0; --i) {
+        while (newHull_.size() >= lower && crossProduct(pos_[newHull_[newHull_.size() - 2]], pos_[newHull_.back()], pos_[chain_[i]]) <= kEps)
+            newHull_.pop_back();
+        newHull_.push_back(chain_[i]);
+    }
+    // the first point is repeated at the end
+    if (newHull_.size() > 1)
+        newHull_.pop_back();
+    // coincident points
+    if (newHull_.size() == 2 && (pos_[newHull_[0]] - pos_[newHull_[1]]).squaredNorm() < kEps * kEps)
+        newHull_.pop_back();
+
+    hull_.swap(newHull_);
+    normal_.clear();
+    offset_.clear();
+    for (size_t i = 0; i < hull_.size(); ++i)
+        onHull_[hull_[i]] = true;
+    if (hull_.size() < 3)
+        return;
+
+    int h = (int)hull_.size();
+    normal_.resize(h);
+    offset_.resize(h);
+    for (int i = 0; i < h; ++i)
+        edgeHalfPlane(hull_[i], hull_[(i + 1) % h], normal_[i], offset_[i]);
+}
+
+void SupportPolygon::spliceHull(int first, int last, const std::vector<int>& chain)
+{
+    // keep the vertices last, ..., first (cyclic) with the edges between
+    // them, the vertices strictly between first and last are replaced
+    // by chain and only the edges around chain are computed
+    int h = (int)hull_.size();
+    for (int i = (first + 1) % h; i != last; i = (i + 1) % h)
+        onHull_[hull_[i]] = false;
+
+    newHull_.clear();
+    newNormal_.clear();
+    newOffset_.clear();
+    for (int i = last;; i = (i + 1) % h) {
+        newHull_.push_back(hull_[i]);
+        if (i == first)
+            break;
+        newNormal_.push_back(normal_[i]);
+        newOffset_.push_back(offset_[i]);
+    }
+    for (size_t i = 0; i < chain.size(); ++i) {
+        onHull_[chain[i]] = true;
+        newHull_.push_back(chain[i]);
+    }
+
+    if (newHull_.size() < 3) {
+        rebuild();
+        return;
+    }
+
+    Eigen::Vector2d n;
+    double offset;
+    int prev = hull_[first];
+    for (size_t i = 0; i <= chain.size(); ++i) {
+        int next = i < chain.size() ? chain[i] : hull_[last];
+        edgeHalfPlane(prev, next, n, offset);
+        newNormal_.push_back(n);
+        newOffset_.push_back(offset);
+        prev = next;
+    }
+
+    hull_.swap(newHull_);
+    normal_.swap(newNormal_);
+    offset_.swap(newOffset_);
+}
+
+void SupportPolygon::edgeHalfPlane(int a, int b, Eigen::Vector2d& n, double& offset) const
+{
+    // ccw hull, the interior is on the left of a -> b
+    Eigen::Vector2d d = pos_[b] - pos_[a];
+    n << d(1), -d(0);
+    n.normalize();
+    offset = n.dot(pos_[a]);
+}
+
+double SupportPolygon::cross(int a, int b, const Eigen::Vector2d& p) const
+{
+    return crossProduct(pos_[a], pos_[b], p);
+}
+
+double SupportPolygon::distanceToHull(const Eigen::Vector2d& p) const
+{
+    int h = (int)hull_.size();
+    if (h == 0)
+        return std::numeric_limits<double>::infinity();
+    if (h == 1)
+        return (pos_[hull_[0]] - p).norm();
+
+    double dist = std::numeric_limits<double>::infinity();
+    for (int i = 0; i < h; ++i)
+        dist = std::min(dist, distanceToSegment(pos_[hull_[i]], pos_[hull_[(i + 1) % h]], p));
+    return dist;
+}
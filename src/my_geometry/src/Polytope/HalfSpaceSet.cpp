@@ -0,0 +1,201 @@
+#include "my_geometry/Polytope/HalfSpaceSet.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define HALFSPACE_AVX2_DISPATCH
+#include <immintrin.h>
+#endif
+
+namespace {
+
+/* margin[k] = min_i b_i - a_i'x_k for the points k in [begin, end),
+ * coordinate j of point k is X[j * ld + k].
+ * Four points at a time keep four independent min chains. */
+void marginScalar(const double* a, const double* b, int m, int dim,
+    const double* X, int ld, int begin, int end, double* margin)
+{
+    const double inf = std::numeric_limits<double>::infinity();
+    int k = begin;
+    for (; k + 4 <= end; k += 4) {
+        double m0 = inf, m1 = inf, m2 = inf, m3 = inf;
+        for (int i = 0; i < m; ++i) {
+            const double* ai = a + i * dim;
+            double s0 = b[i], s1 = b[i], s2 = b[i], s3 = b[i];
+            for (int j = 0; j < dim; ++j) {
+                const double* xj = X + j * ld + k;
+                s0 -= ai[j] * xj[0];
+                s1 -= ai[j] * xj[1];
+                s2 -= ai[j] * xj[2];
+                s3 -= ai[j] * xj[3];
+            }
+            m0 = std::min(m0, s0);
+            m1 = std::min(m1, s1);
+            m2 = std::min(m2, s2);
+            m3 = std::min(m3, s3);
+        }
+        margin[k] = m0;
+        margin[k + 1] = m1;
+        margin[k + 2] = m2;
+        margin[k + 3] = m3;
+    }
+    for (; k < end; ++k) {
+        double mk = inf;
+        for (int i = 0; i < m; ++i) {
+            const double* ai = a + i * dim;
+            double s = b[i];
+            for (int j = 0; j < dim; ++j)
+                s -= ai[j] * X[j * ld + k];
+            mk = std::min(mk, s);
+        }
+        margin[k] = mk;
+    }
+}
+
+#ifdef HALFSPACE_AVX2_DISPATCH
+/* 8 points per iteration in two registers, the rest is left to the
+ * scalar kernel. \return the first point not processed */
+__attribute__((target("avx2,fma"))) int marginAvx2(const double* a, const double* b, int m, int dim,
+    const double* X, int ld, int n, double* margin)
+{
+    const __m256d inf = _mm256_set1_pd(std::numeric_limits<double>::infinity());
+    int k = 0;
+    for (; k + 8 <= n; k += 8) {
+        __m256d m0 = inf;
+        __m256d m1 = inf;
+        for (int i = 0; i < m; ++i) {
+            const double* ai = a + i * dim;
+            __m256d s0 = _mm256_set1_pd(b[i]);
+            __m256d s1 = s0;
+            for (int j = 0; j < dim; ++j) {
+                __m256d aij = _mm256_set1_pd(ai[j]);
+                const double* xj = X + j * ld + k;
+                s0 = _mm256_fnmadd_pd(aij, _mm256_loadu_pd(xj), s0);
+                s1 = _mm256_fnmadd_pd(aij, _mm256_loadu_pd(xj + 4), s1);
+            }
+            m0 = _mm256_min_pd(m0, s0);
+            m1 = _mm256_min_pd(m1, s1);
+        }
+        _mm256_storeu_pd(margin + k, m0);
+        _mm256_storeu_pd(margin + k + 4, m1);
+    }
+    for (; k + 4 <= n; k += 4) {
+        __m256d m0 = inf;
+        for (int i = 0; i < m; ++i) {
+            const double* ai = a + i * dim;
+            __m256d s0 = _mm256_set1_pd(b[i]);
+            for (int j = 0; j < dim; ++j)
+                s0 = _mm256_fnmadd_pd(_mm256_set1_pd(ai[j]), _mm256_loadu_pd(X + j * ld + k), s0);
+            m0 = _mm256_min_pd(m0, s0);
+        }
+        _mm256_storeu_pd(margin + k, m0);
+    }
+    return k;
+}
+#endif
+
+} // namespace
+
+HalfSpaceSet::HalfSpaceSet()
+    : dim_(0)
+    , numHalfSpaces_(0)
+    , useSimd_(true)
+{
+}
+
+HalfSpaceSet::~HalfSpaceSet() {}
+
+bool HalfSpaceSet::setHrep(const Eigen::MatrixXd& A, const Eigen::VectorXd& b)
+{
+    if (A.rows() != b.size())
+        return false;
+
+    dim_ = (int)A.cols();
+    numHalfSpaces_ = 0;
+    a_.resize(A.rows() * A.cols());
+    b_.resize(A.rows());
+    for (Eigen::Index i = 0; i < A.rows(); ++i) {
+        double norm = A.row(i).norm();
+        if (norm <= 0.)
+            continue;
+        for (int j = 0; j < dim_; ++j)
+            a_[numHalfSpaces_ * dim_ + j] = A(i, j) / norm;
+        b_[numHalfSpaces_] = b(i) / norm;
+        ++numHalfSpaces_;
+    }
+    a_.resize(numHalfSpaces_ * dim_);
+    b_.resize(numHalfSpaces_);
+    return true;
+}
+
+bool HalfSpaceSet::margins(const Eigen::MatrixXd& X, Eigen::VectorXd& margin) const
+{
+    if (X.cols() != dim_)
+        return false;
+
+    margin.resize(X.rows());
+    return margins(X, (int)X.rows(), margin);
+}
+
+bool HalfSpaceSet::margins(const Eigen::MatrixXd& X, int n, Eigen::VectorXd& margin) const
+{
+    if (X.cols() != dim_ || n < 0 || n > X.rows())
+        return false;
+
+    if (margin.size() < n)
+        margin.resize(n);
+    // coordinate j of point k is X(k, j), X.rows() apart
+    int ld = (int)X.rows();
+    int k = 0;
+#ifdef HALFSPACE_AVX2_DISPATCH
+    if (isUsingSimd())
+        k = marginAvx2(a_.data(), b_.data(), numHalfSpaces_, dim_, X.data(), ld, n, margin.data());
+#endif
+    marginScalar(a_.data(), b_.data(), numHalfSpaces_, dim_, X.data(), ld, k, n, margin.data());
+    return true;
+}
+
+bool HalfSpaceSet::contains(const Eigen::MatrixXd& X, std::vector<char>& inside, Eigen::VectorXd& margin, double tol) const
+{
+    if (!margins(X, margin))
+        return false;
+
+    inside.resize(margin.size());
+    for (Eigen::Index k = 0; k < margin.size(); ++k)
+        inside[k] = margin(k) >= -tol ? 1 : 0;
+    return true;
+}
+
+bool HalfSpaceSet::contains(const Eigen::MatrixXd& X, int n, std::vector<char>& inside, Eigen::VectorXd& margin, double tol) const
+{
+    if (!margins(X, n, margin))
+        return false;
+
+    if ((int)inside.size() < n)
+        inside.resize(n);
+    for (int k = 0; k < n; ++k)
+        inside[k] = margin(k) >= -tol ? 1 : 0;
+    return true;
+}
+
+double HalfSpaceSet::margin(const Eigen::VectorXd& p) const
+{
+    // a point of another dimension is outside
+    if (p.size() != dim_)
+        return -std::numeric_limits<double>::infinity();
+    double margin;
+    marginScalar(a_.data(), b_.data(), numHalfSpaces_, dim_, p.data(), 1, 0, 1, &margin);
+    return margin;
+}
+
+bool HalfSpaceSet::hasAvx2()
+{
+#ifdef HALFSPACE_AVX2_DISPATCH
+    static const bool avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    return avx2;
+#else
+    return false;
+#endif
+}
@@ -1,14 +1,9 @@
 /*
-Copyright: Copyright (c) MOSEK ApS, Denmark. All rights reserved.
-
-File:      lownerjohn_ellipsoid.cc
-
-Purpose: 
-Computes the Lowner-John inner and outer ellipsoidal 
+Computes the Lowner-John inner and outer ellipsoidal
 approximations of a polytope.
 
 
-The inner ellipsoidal approximation to a polytope 
+The inner ellipsoidal approximation to a polytope
 
 S = { x \in R^n | Ax < b }.
 
@@ -16,252 +11,456 @@ maximizes the volume of the inscribed ellipsoid,
 
 { x | x = C*u + d, || u ||_2 <= 1 }.
 
-The volume is proportional to det(C)^(1/n), so the
-problem can be solved as 
+The volume is proportional to det(C), so the problem is
 
-maximize         t
-subject to       t       <= det(C)^(1/n)
-|| C*ai ||_2 <= bi - ai^T * d,  i=1,...,m
-C is PSD
+minimize         -log det(C)
+subject to       || C*ai ||_2 <= bi - ai^T * d,  i=1,...,m
+C is PD
 
-which is equivalent to a mixed conic quadratic and semidefinite
-programming problem.
+and it is solved with the barrier method, the i-th constraint
+contributes -log((bi - ai^T*d)^2 - ||C*ai||^2).
 
 
-The outer ellipsoidal approximation to a polytope given 
+The outer ellipsoidal approximation to a polytope given
 as the convex hull of a set of points
 
 S = conv{ x1, x2, ... , xm }
 
 minimizes the volume of the enclosing ellipsoid,
 
-{ x | || P*(x-c) ||_2 <= 1 }
-
-The volume is proportional to det(P)^{-1/n}, so the problem can
-be solved as
+{ x | || P*x - c ||_2 <= 1 }
 
-minimize         t
-subject to       t       >= det(P)^(-1/n)
-|| P*xi + c ||_2 <= 1,  i=1,...,m
-P is PSD.
+It is solved with Khachiyan's algorithm on the lifted points
+qi = [xi; 1], with the away steps of Todd and Yildirim so that
+the weights of a previous solve can be reused.
 
 References:
-[1] "Lectures on Modern Optimization", Ben-Tal and Nemirovski, 2000. 
+[1] "Convex Optimization", Boyd and Vandenberghe, 2004.
+[2] "On Khachiyan's algorithm for the computation of minimum-volume
+    enclosing ellipsoids", Todd and Yildirim, 2007.
 */
 
-//#include <string>
-//#include <iostream>
-//#include <iomanip>
-//#include <cmath>
-//#include "fusion.h"
-//#include <cassert>
-#include "LownerJohnEllipsoid.hpp"
+#include "my_geometry/Polytope/LownerJohnEllipsoid.hpp"
 
-using namespace mosek::fusion;
-using namespace monty;
+#include <chrono>
+#include <cmath>
+#include <limits>
 
-namespace LownerJohnEllipsoid
+namespace
 {
-    std::shared_ptr<ndarray<int,1>> range (int start, int stop)
-    { 
-        if (start < stop)
-            return std::shared_ptr<ndarray<int,1>>(new ndarray<int,1>(shape_t<1>(stop-start),iterable(range_t<int>(start,stop))));
-        else
-            return new_array_ptr<int,1>(0);
+    const double kInf = std::numeric_limits<double>::infinity();
+    // newton decrement^2/2 to stop centering
+    const double kNewtonTol = 1e-9;
+    const int kMaxNewtonIter = 50;
+    const double kBarrierMu = 10.;
+    // line search
+    const double kAlpha = 0.01;
+    const double kBeta = 0.5;
+
+    // upper triangle (j <= k) of a symmetric n x n matrix
+    int numSymEntries(int n) { return n*(n+1)/2; }
+
+    double elapsedMs(const std::chrono::steady_clock::time_point& from) {
+        return std::chrono::duration<double, std::milli>(
+                        std::chrono::steady_clock::now() - from).count();
     }
+}
 
-
-    int pow2(int n) { return (int) (1 << n); }
-    /** 
-Purpose: Models the convex set 
-
-S = { (x, t) \in R^n x R | x >= 0, t <= (x1 * x2 * ... *xn)^(1/n) }.
-
-as the intersection of rotated quadratic cones and affine hyperplanes,
-see [1, p. 105].  This set can be interpreted as the hypograph of the 
-geometric mean of x.
-
-We illustrate the modeling procedure using the following example.
-Suppose we have 
-
-t <= (x1 * x2 * x3)^(1/3)
-
-for some t >= 0, x >= 0. We rewrite it as
-
-t^4 <= x1 * x2 * x3 * x4,   x4 = t
-
-which is equivalent to (see [1])
-
-x11^2 <= 2*x1*x2,   x12^2 <= 2*x3*x4,
-
-x21^2 <= 2*x11*x12,
-
-sqrt(8)*x21 = t, x4 = t.
-
-References:
-[1] "Lectures on Modern Optimization", Ben-Tal and Nemirovski, 2000. 
-*/ 
-    void geometric_mean(Model::t M, Variable::t x, Variable::t t)
-    {
-        int n = (int) x->size();
-        int l = (int)std::ceil(std::log(n)/std::log(2));
-        int m = pow2(l) - n;
-
-        Variable::t x0 =
-            m == 0 ? x : Var::vstack(x, M->variable(m, Domain::greaterThan(0.0)));
-
-        Variable::t z = x0;
-
-        for (int i = 0; i < l-1; ++i)
+namespace LownerJohnEllipsoid
+{
+    std::pair<Eigen::MatrixXd, Eigen::VectorXd>
+        lownerjohn_inner(const Eigen::MatrixXd& A, const Eigen::VectorXd& b)
         {
-            Variable::t xi = M->variable(pow2(l-i-1), Domain::greaterThan(0.0));
-            for (int k = 0; k < pow2(l-i-1); ++k)
-                M->constraint(Var::vstack(z->index(2*k),z->index(2*k+1),xi->index(k)),
-                        Domain::inRotatedQCone());
-            z = xi;
+            LJEllipsoidSolver solver;
+            Eigen::MatrixXd C;
+            Eigen::VectorXd d;
+            solver.solveInner(A, b, C, d);
+            return std::make_pair(C, d);
         }
 
-        Variable::t t0 = M->variable(1, Domain::greaterThan(0.0));
-        M->constraint(Var::vstack(z, t0), Domain::inRotatedQCone());
-
-        M->constraint(Expr::sub(Expr::mul(std::pow(2,0.5*l),t),t0), Domain::equalsTo(0.0));
-
-        for (int i = pow2(l-m); i < pow2(l); ++i)
-            M->constraint(Expr::sub(x0->index(i), t), Domain::equalsTo(0.0));
-    }
-
-    /**
-Purpose: Models the hypograph of the n-th power of the
-determinant of a positive definite matrix.
-
-The convex set (a hypograph)
+    std::pair<Eigen::MatrixXd, Eigen::VectorXd>
+        lownerjohn_outer(const Eigen::MatrixXd& x)
+        {
+            LJEllipsoidSolver solver;
+            Eigen::MatrixXd Q;
+            Eigen::VectorXd c;
+            solver.solveOuter(x, Q, c);
+            return std::make_pair(Q, c);
+        }
+} /* LownerJohnEllipsoid */
 
-C = { (X, t) \in S^n_+ x R |  t <= det(X)^{1/n} },
+LJEllipsoidSolver::LJEllipsoidSolver() {
+    mTol = 1e-6;
+    mMaxIter = 1000;
+    mbWarmStart = true;
 
-can be modeled as the intersection of a semidefinite cone
+    mSolveTime = 0.;
+    mNumIter = 0;
+    mbWarmStarted = false;
+}
 
-[ X, Z; Z^T Diag(Z) ] >= 0  
+LJEllipsoidSolver::~LJEllipsoidSolver() {}
 
-and a number of rotated quadratic cones and affine hyperplanes,
+void LJEllipsoidSolver::resetWarmStart() {
+    mOuterWeight.resize(0);
+    mInnerC.resize(0, 0);
+    mInnerD.resize(0);
+}
 
-t <= (Z11*Z22*...*Znn)^{1/n}  (see geometric_mean).
+bool LJEllipsoidSolver::solveOuter(const Eigen::MatrixXd& x,
+                                   Eigen::MatrixXd& Q, Eigen::VectorXd& c) {
+    auto start = std::chrono::steady_clock::now();
+    int m = x.rows();
+    int n = x.cols();
+    double dim = n + 1;
+
+    // lifted points, qi = [xi; 1]
+    Eigen::MatrixXd q(n+1, m);
+    q.topRows(n) = x.transpose();
+    q.row(n).setOnes();
+
+    // weights, keep every point slightly active in the warm start
+    // so that the first X is not singular
+    Eigen::VectorXd u;
+    mbWarmStarted = mbWarmStart && mOuterWeight.size() == m;
+    if (mbWarmStarted)
+        u = 0.95 * mOuterWeight + Eigen::VectorXd::Constant(m, 0.05/m);
+    else
+        u = Eigen::VectorXd::Constant(m, 1./m);
+
+    Eigen::MatrixXd X(n+1, n+1);
+    Eigen::VectorXd M(m);
+    bool bSuccess(false);
+    for (mNumIter = 0; mNumIter < mMaxIter; ++mNumIter) {
+        X.noalias() = q * u.asDiagonal() * q.transpose();
+        Eigen::LLT<Eigen::MatrixXd> llt(X);
+        if (llt.info() != Eigen::Success) break;
+        M = (q.array() * llt.solve(q).array()).colwise().sum().transpose();
+
+        // toward the most violating point, away from the least one
+        int j(0), k(-1);
+        M.maxCoeff(&j);
+        for (int i = 0; i < m; ++i)
+            if (u[i] > 0. && (k < 0 || M[i] < M[k])) k = i;
+        double epsPlus = M[j]/dim - 1.;
+        double epsMinus = 1. - M[k]/dim;
+        if (epsPlus <= mTol && epsMinus <= mTol) {
+            bSuccess = true;
+            break;
+        }
 
-References:
-[1] "Lectures on Modern Optimization", Ben-Tal and Nemirovski, 2000. 
-*/
-    void det_rootn(Model::t M, int n, Variable::t X, Variable::t t)
-    {
-        //int n = X->get_shape()->dim(0);
+        if (epsPlus > epsMinus) {
+            double beta = (M[j] - dim) / (dim * (M[j] - 1.));
+            u *= (1. - beta);
+            u[j] += beta;
+        } else {
+            // drop the point if the step would take its weight below zero
+            double betaMax = u[k] / (1. - u[k]);
+            double beta = M[k] > 1. ? (dim - M[k]) / (dim * (M[k] - 1.)) : kInf;
+            if (beta >= betaMax) {
+                beta = betaMax;
+                u *= (1. + beta);
+                u[k] = 0.;
+            } else {
+                u *= (1. + beta);
+                u[k] -= beta;
+            }
+        }
+    }
 
-        // Setup variables
-        Variable::t Y = M->variable(Domain::inPSDCone(2*n));
+    if (bSuccess) {
+        // (p - center)' E (p - center) <= 1
+        Eigen::VectorXd center = x.transpose() * u;
+        Eigen::MatrixXd S = x.transpose() * u.asDiagonal() * x
+                            - center * center.transpose();
+        Eigen::MatrixXd E = S.inverse() / n;
+        // scale so that every point is inside
+        double scale(0.);
+        for (int i = 0; i < m; ++i) {
+            Eigen::VectorXd dp = x.row(i).transpose() - center;
+            scale = std::max(scale, dp.dot(E * dp));
+        }
+        E /= scale;
+
+        Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> es(E);
+        Q = es.eigenvectors() * es.eigenvalues().cwiseSqrt().asDiagonal()
+            * es.eigenvectors().transpose();
+        c = Q * center;
+        mOuterWeight = u;
+    } else {
+        mOuterWeight.resize(0);
+    }
 
-        // Setup Y = [X, Z; Z^T diag(Z)] 
-        Variable::t Y11 = Y->slice(new_array_ptr<int,1>({0, 0}), new_array_ptr<int,1>({n, n}));
-        Variable::t Y21 = Y->slice(new_array_ptr<int,1>({n, 0}), new_array_ptr<int,1>({2*n, n}));
-        Variable::t Y22 = Y->slice(new_array_ptr<int,1>({n, n}), new_array_ptr<int,1>({2*n, 2*n}));
+    mSolveTime = elapsedMs(start);
+    return bSuccess;
+}
 
-        M->constraint( Expr::sub(Expr::mulElm( Matrix::eye(n) ,Y21), Y22), Domain::equalsTo(0.0));
-        M->constraint( Expr::sub(X, Y11), Domain::equalsTo(0.0) );
+bool LJEllipsoidSolver::solveInner(const Eigen::MatrixXd& A,
+                                   const Eigen::VectorXd& b,
+                                   Eigen::MatrixXd& C, Eigen::VectorXd& d) {
+    auto start = std::chrono::steady_clock::now();
+    int m = A.rows();
+    int n = A.cols();
+    int ns = numSymEntries(n);
+    // barrier parameter of the m second order cones
+    double nu = 2.*m;
+    double tFinal = nu / mTol;
+
+    Eigen::VectorXd z(ns + n);
+    double t(1.);
+    mNumIter = 0;
+
+    // previous ellipsoid, shrunk so that it is strictly inside
+    mbWarmStarted = false;
+    if (mbWarmStart && mInnerD.size() == n) {
+        z.tail(n) = mInnerD;
+        int p(0);
+        for (int j = 0; j < n; ++j)
+            for (int k = j; k < n; ++k)
+                z[p++] = 0.99 * mInnerC(j, k);
+        double f;
+        if (_evalInner(A, b, 1., z, f, nullptr, nullptr)) {
+            mbWarmStarted = true;
+            // close to the central path of the previous problem
+            t = tFinal / kBarrierMu;
+        }
+    }
 
-        // t^n <= (Z11*Z22*...*Znn)
+    if (!mbWarmStarted) {
+        Eigen::VectorXd d0 = mInnerD.size() == n ? mInnerD
+                                                 : Eigen::VectorXd::Zero(n);
+        if (!_findInteriorPoint(A, b, d0)) {
+            mSolveTime = elapsedMs(start);
+            return false;
+        }
+        // ball inside S
+        double r(kInf);
+        for (int i = 0; i < m; ++i)
+            r = std::min(r, (b[i] - A.row(i).dot(d0)) / A.row(i).norm());
+        z.setZero();
+        int p(0);
+        for (int j = 0; j < n; ++j)
+            for (int k = j; k < n; ++k)
+                z[p++] = (j == k) ? 0.5 * r : 0.;
+        z.tail(n) = d0;
+    }
 
-        geometric_mean(M, Y22->diag(), t);
+    bool bSuccess(false);
+    while (true) {
+        if (!_centerInner(A, b, t, z)) break;
+        if (nu / t < mTol) {
+            bSuccess = true;
+            break;
+        }
+        t *= kBarrierMu;
     }
 
-    std::pair<std::shared_ptr<ndarray<double,1>>,std::shared_ptr<ndarray<double,1>>>
-        lownerjohn_inner
-        ( std::shared_ptr<ndarray<double,2>> A, 
-          std::shared_ptr<ndarray<double,1>> b)
-        {
-            Model::t M = new Model("lownerjohn_inner"); auto _M = finally([&]() { M->dispose(); });
-            int m = A->size(0);
-            int n = A->size(1);
-
-            // Setup variables
-            Variable::t t = M->variable("t", 1, Domain::greaterThan(0.0));   
-            Variable::t C = M->variable("C", Set::make(n,n), Domain::unbounded());
-            Variable::t d = M->variable("d", n, Domain::unbounded());        
-
-            // qc_i : (bi - ai^T*d, C*ai) \in Q 
-            for (int i = 0; i < m; ++i)
-            {
-                std::shared_ptr<ndarray<double,1>> ai = new_array_ptr<double,1>({(*A)(i,0),(*A)(i,1)});
-                M->constraint(Expr::vstack(Expr::sub((*b)[i],Expr::dot(ai,d)), Expr::mul(C,ai)), Domain::inQCone() );
-            }
+    if (bSuccess) {
+        _zToEllipsoid(z, n, C, d);
+        mInnerC = C;
+        mInnerD = d;
+    } else {
+        mInnerC.resize(0, 0);
+        mInnerD.resize(0);
+    }
 
-            // t <= det(C)^{1/n}
-            //model_utils.det_rootn(M, C, t);
-            det_rootn(M,n,C,t);
+    mSolveTime = elapsedMs(start);
+    return bSuccess;
+}
 
-            // Objective: Maximize t
-            M->objective(ObjectiveSense::Maximize, t);
-            M->solve();
+bool LJEllipsoidSolver::_findInteriorPoint(const Eigen::MatrixXd& A,
+                                           const Eigen::VectorXd& b,
+                                           Eigen::VectorXd& d) {
+    // phase I : minimize s s.t. Ad - b <= s, until s < 0
+    int m = A.rows();
+    int n = A.cols();
+    Eigen::VectorXd w(n+1);
+    w.head(n) = d;
+    double viol = (A * d - b).maxCoeff();
+    if (viol < 0.) return true;
+    w[n] = viol + 1.;
+
+    // f = t*s - sum log(s + bi - ai'd)
+    auto slack = [&](const Eigen::VectorXd& w_) -> Eigen::VectorXd {
+        return (b - A * w_.head(n)).array() + w_[n];
+    };
+
+    double t(1.);
+    Eigen::VectorXd g(n+1), dw(n+1);
+    Eigen::MatrixXd H(n+1, n+1);
+    Eigen::MatrixXd Ae(m, n+1);
+    Ae.leftCols(n) = -A;
+    Ae.col(n).setOnes();
+    for (int outer = 0; outer < 100; ++outer) {
+        for (int iter = 0; iter < kMaxNewtonIter; ++iter, ++mNumIter) {
+            if (w[n] < 0.) {
+                d = w.head(n);
+                return true;
+            }
+            Eigen::VectorXd s = slack(w);
+            Eigen::VectorXd sinv = s.cwiseInverse();
+            g = -Ae.transpose() * sinv;
+            g[n] += t;
+            H.noalias() = Ae.transpose() * sinv.cwiseAbs2().asDiagonal() * Ae;
+            dw = H.ldlt().solve(-g);
+            double lambda2 = -g.dot(dw);
+            if (!std::isfinite(lambda2)) return false;
+            if (lambda2 * 0.5 < kNewtonTol) break;
+
+            double f0 = t * w[n] - s.array().log().sum();
+            double step(1.);
+            while (step > 1e-12) {
+                Eigen::VectorXd wn = w + step * dw;
+                Eigen::VectorXd sn = slack(wn);
+                if (sn.minCoeff() > 0. &&
+                    t * wn[n] - sn.array().log().sum()
+                        <= f0 - kAlpha * step * lambda2)
+                    break;
+                step *= kBeta;
+            }
+            w += step * dw;
+        }
+        // s stays positive at the optimum, S has no interior
+        if (m / t < 1e-9) return false;
+        t *= kBarrierMu;
+    }
+    return false;
+}
 
-            return std::make_pair(C->level(),d->level());
+bool LJEllipsoidSolver::_centerInner(const Eigen::MatrixXd& A,
+                                     const Eigen::VectorXd& b,
+                                     double t, Eigen::VectorXd& z) {
+    int nz = z.size();
+    double f, fn;
+    Eigen::VectorXd g(nz), dz(nz);
+    Eigen::MatrixXd H(nz, nz);
+    for (int iter = 0; iter < kMaxNewtonIter; ++iter, ++mNumIter) {
+        if (mNumIter >= mMaxIter) return false;
+        if (!_evalInner(A, b, t, z, f, &g, &H)) return false;
+        dz = H.ldlt().solve(-g);
+        double lambda2 = -g.dot(dz);
+        if (!std::isfinite(lambda2)) return false;
+        if (lambda2 * 0.5 < kNewtonTol) return true;
+
+        double step(1.);
+        while (step > 1e-12) {
+            if (_evalInner(A, b, t, z + step * dz, fn, nullptr, nullptr) &&
+                fn <= f - kAlpha * step * lambda2)
+                break;
+            step *= kBeta;
         }
+        // no progress, at the numerical limit
+        if (step <= 1e-12 || f - fn <= 1e-12 * std::fabs(f)) return true;
+        z += step * dz;
+    }
+    // C or d still growing, S is unbounded in some direction
+    return false;
+}
 
-    std::pair<std::shared_ptr<ndarray<double,1>>,std::shared_ptr<ndarray<double,1>>>
-        lownerjohn_outer(std::shared_ptr<ndarray<double,2>> x)
-        {
-            Model::t M = new Model("lownerjohn_outer");
-            int m = x->size(0);
-            int n = x->size(1);
-
-            // Setup variables
-            Variable::t t = M->variable("t", 1, Domain::greaterThan(0.0));
-            Variable::t P = M->variable("P", Set::make(n,n), Domain::unbounded());
-            Variable::t c = M->variable("c", n, Domain::unbounded());
-
-            // (1, P(*xi+c)) \in Q 
-            for (int i = 0; i < m; ++i)
-            {
-                auto xi = new_array_ptr<double,1>({ (*x)(i,0), (*x)(i,1),
-                                                    (*x)(i,2), (*x)(i,3),
-                                                    (*x)(i,4)}); //TODO use for loop
-
-                //auto xi= std::shared_ptr<ndarray<double,1>> (new ndarray<double,1>
-                        //(shape_t<1>(n)));
-                //for (int j = 0; j < n; ++j) (xi)[j] = (*x)(i, j);
-
-                M->constraint(Expr::vstack(Expr::ones(1), Expr::sub(Expr::mul(P,xi), c)), Domain::inQCone() );
+bool LJEllipsoidSolver::_evalInner(const Eigen::MatrixXd& A,
+                                   const Eigen::VectorXd& b,
+                                   double t, const Eigen::VectorXd& z,
+                                   double& f, Eigen::VectorXd* grad,
+                                   Eigen::MatrixXd* hess) {
+    int m = A.rows();
+    int n = A.cols();
+    int ns = numSymEntries(n);
+    int nz = ns + n;
+
+    Eigen::MatrixXd C;
+    Eigen::VectorXd d;
+    _zToEllipsoid(z, n, C, d);
+    Eigen::LLT<Eigen::MatrixXd> llt(C);
+    if (llt.info() != Eigen::Success) return false;
+    const Eigen::MatrixXd& L = llt.matrixL();
+    if (L.diagonal().minCoeff() <= 0.) return false;
+
+    // t*(-log det C)
+    f = -2. * t * L.diagonal().array().log().sum();
+
+    Eigen::MatrixXd Cinv;
+    if (grad) {
+        Cinv = llt.solve(Eigen::MatrixXd::Identity(n, n));
+        grad->setZero(nz);
+        hess->setZero(nz, nz);
+        // d/dz_p = -t*tr(Cinv*Ep), d2/dz_p dz_q = t*tr(Cinv*Ep*Cinv*Eq)
+        // with Ep = e_j e_k' + e_k e_j' (j < k) or e_j e_j'
+        int p(0);
+        for (int j = 0; j < n; ++j) {
+            for (int k = j; k < n; ++k, ++p) {
+                (*grad)[p] = -t * (j == k ? Cinv(j, j) : 2. * Cinv(j, k));
+                int q(0);
+                for (int jj = 0; jj < n; ++jj) {
+                    for (int kk = jj; kk < n; ++kk, ++q) {
+                        double h = Cinv(k, jj) * Cinv(kk, j);
+                        if (j != k) h += Cinv(j, jj) * Cinv(kk, k);
+                        if (jj != kk) h += Cinv(k, kk) * Cinv(jj, j);
+                        if (j != k && jj != kk) h += Cinv(j, kk) * Cinv(jj, k);
+                        (*hess)(p, q) = t * h;
+                    }
+                }
             }
-
-            // t <= det(P)^{1/n}
-            //model_utils.det_rootn(M, P, t);
-            det_rootn(M,n,P,t);
-
-            // Objective: Maximize t
-            M->objective(ObjectiveSense::Maximize, t);
-            M->solve();
-
-            return std::make_pair(P->level(),c->level());
         }
+    }
 
-    std::ostream & operator<<(std::ostream & os, ndarray<double,1> & a)
-    {
-        os << "[ ";
-        if (a.size() > 0) 
-        {
-            os << a[0];
-            for (int i = 1; i < a.size(); ++i)
-                os << "," << a[i];
+    Eigen::MatrixXd G(n, nz); // d(C*ai)/dz
+    Eigen::VectorXd gt(nz), gs(nz);
+    for (int i = 0; i < m; ++i) {
+        Eigen::VectorXd a = A.row(i).transpose();
+        double ti = b[i] - a.dot(d);
+        if (ti <= 0.) return false;
+        Eigen::VectorXd yi = C * a;
+        double si = ti * ti - yi.squaredNorm();
+        if (si <= 0.) return false;
+        f -= std::log(si);
+
+        if (grad) {
+            G.setZero();
+            int p(0);
+            for (int j = 0; j < n; ++j) {
+                for (int k = j; k < n; ++k, ++p) {
+                    G(j, p) += a[k];
+                    if (j != k) G(k, p) += a[j];
+                }
+            }
+            gt.setZero();
+            gt.tail(n) = -a;
+            gs = 2. * ti * gt - 2. * G.transpose() * yi;
+            *grad -= gs / si;
+            *hess += gs * gs.transpose() / (si * si)
+                     - (2. * gt * gt.transpose()
+                        - 2. * G.transpose() * G) / si;
         }
-        os << " ]";
-        return os;
     }
-} /* LownerJohnEllipsoid */
+    return true;
+}
+
+void LJEllipsoidSolver::_zToEllipsoid(const Eigen::VectorXd& z, int n,
+                                      Eigen::MatrixXd& C, Eigen::VectorXd& d) {
+    C.resize(n, n);
+    int p(0);
+    for (int j = 0; j < n; ++j)
+        for (int k = j; k < n; ++k, ++p)
+            C(j, k) = C(k, j) = z[p];
+    d = z.tail(n);
+}
 
 LJEllipsoidWithPointsAndNormal::LJEllipsoidWithPointsAndNormal(std::vector<Eigen::VectorXd> pointsList_,
                                                                Eigen::VectorXd normalVector_) {
+    updatePoints(pointsList_, normalVector_);
+}
+
+LJEllipsoidWithPointsAndNormal::~LJEllipsoidWithPointsAndNormal() {}
+
+void LJEllipsoidWithPointsAndNormal::updatePoints(std::vector<Eigen::VectorXd> pointsList_,
+                                                  Eigen::VectorXd normalVector_) {
     mPointsList = pointsList_;
     mNormalVector = normalVector_;
     mDim = normalVector_.size();
     mNumPoints = pointsList_.size();
+    mbSolved = false;
 }
 
-LJEllipsoidWithPointsAndNormal::~LJEllipsoidWithPointsAndNormal() {}
-
 std::pair<Eigen::MatrixXd, Eigen::VectorXd> LJEllipsoidWithPointsAndNormal::computeLJEllipsoid() {
 
     Eigen::MatrixXd indepMat = Eigen::MatrixXd::Identity(mDim, mDim);
@@ -273,22 +472,21 @@ std::pair<Eigen::MatrixXd, Eigen::VectorXd> LJEllipsoidWithPointsAndNormal::comp
     mSO = SO;
     // TODO : Should I assert something here?
 
-    auto p= std::shared_ptr<ndarray<double,2>> (new ndarray<double,2>
-            (shape_t<2>(mNumPoints,mDim-1)));
+    Eigen::MatrixXd p(mNumPoints, mDim-1);
     std::vector< Eigen::VectorXd > pointsListLocal(mNumPoints);
     for (int i = 0; i < mNumPoints; ++i) {
         pointsListLocal[i] = SO.transpose() * mPointsList[i];
-        for (int j = 0; j < mDim-1; ++j) (*p)(i, j) = (pointsListLocal[i])[j+1];
+        p.row(i) = pointsListLocal[i].tail(mDim-1).transpose();
     }
     double nullDimVal(pointsListLocal[0](0));
     mNullDimVal = nullDimVal;
-    auto Pc = LownerJohnEllipsoid::lownerjohn_outer(p);
 
-    Eigen::MatrixXd Q = Eigen::MatrixXd::Zero(mDim-1, mDim-1);
-    Eigen::VectorXd c = Eigen::VectorXd::Zero(mDim-1);
-    for (int i = 0; i < mDim-1; ++i) {
-        for (int j = 0; j < mDim-1; ++j) Q(i, j) = (*Pc.first)(i*(mDim-1)+j);
-        c[i] = (*Pc.second)(i);
+    Eigen::MatrixXd Q;
+    Eigen::VectorXd c;
+    mbSolved = mSolver.solveOuter(p, Q, c);
+    if (!mbSolved) {
+        return std::make_pair(Eigen::MatrixXd::Zero(mDim-1, mDim-1),
+                              Eigen::VectorXd::Zero(mDim-1));
     }
 
     Eigen::MatrixXd P = Q.transpose() * Q;
@@ -18,67 +18,81 @@
 #include "my_geometry/Polytope/Polytope.h"
 #include <fstream>
 
-std::atomic_int Polyhedron::counter(0);
-std::mutex Polyhedron::mtx;
+namespace {
+
+/* cdd constants of a thread, set at the first use in the thread.
+ * They are freed with the scratch buffers of cdd when the thread exits. */
+class CddThreadContext {
+public:
+    CddThreadContext() { dd_set_global_constants(); }
+    ~CddThreadContext()
+    {
+        dd_free_thread_buffers();
+        dd_free_global_constants();
+    }
+};
+
+void useCddThreadContext()
+{
+    static thread_local CddThreadContext context;
+    (void)context;
+}
+
+} // namespace
 
 Polyhedron::Polyhedron()
     : matPtr_(nullptr)
     , polytope_(nullptr)
 {
-    if (counter == 0)
-        dd_set_global_constants();
-    counter++;
+    useCddThreadContext();
 }
 
 Polyhedron::~Polyhedron()
 {
-    counter--;
+    useCddThreadContext();
 
     if (matPtr_ != nullptr)
         dd_FreeMatrix(matPtr_);
     if (polytope_ != nullptr)
         dd_FreePolyhedra(polytope_);
-
-    if (counter == 0)
-        dd_free_global_constants();
 }
 
 bool Polyhedron::setHrep(const Eigen::MatrixXd& A, const Eigen::VectorXd& b)
 {
-    std::unique_lock<std::mutex> lock(mtx);
+    useCddThreadContext();
     return hvrep(A, b, false);
 }
 
 bool Polyhedron::setVrep(const Eigen::MatrixXd& A, const Eigen::VectorXd& b)
 {
-    std::unique_lock<std::mutex> lock(mtx);
+    useCddThreadContext();
     return hvrep(A, b, true);
 }
 
 std::pair<Eigen::MatrixXd, Eigen::VectorXd> Polyhedron::vrep() const
 {
-    std::unique_lock<std::mutex> lock(mtx);
+    useCddThreadContext();
     dd_MatrixPtr mat = dd_CopyGenerators(polytope_);
     return ddfMatrix2EigenMatrix(mat, true);
 }
 
 std::pair<Eigen::MatrixXd, Eigen::VectorXd> Polyhedron::hrep() const
 {
-    std::unique_lock<std::mutex> lock(mtx);
+    useCddThreadContext();
     dd_MatrixPtr mat = dd_CopyInequalities(polytope_);
     return ddfMatrix2EigenMatrix(mat, false);
 }
 
 void Polyhedron::printVrep() const
 {
-    std::unique_lock<std::mutex> lock(mtx);
+    useCddThreadContext();
     dd_MatrixPtr mat = dd_CopyGenerators(polytope_);
     dd_WriteMatrix(stdout, mat);
 }
 
 void Polyhedron::printHrep() const
 {
-    std::unique_lock<std::mutex> lock(mtx);
+    useCddThreadContext();
     dd_MatrixPtr mat = dd_CopyInequalities(polytope_);
     dd_WriteMatrix(stdout, mat);
 }
@@ -0,0 +1,120 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "my_geometry/Polytope/HalfSpaceSet.h"
+
+// halfspace_bench [-n points] [-r repeats] [-s seed]
+// queries the margins of points uniform in [-1.5, 1.5]^dim against random
+// half-spaces with the origin inside, in 2D with 4 (a support polygon),
+// 3D with 20 and 6D with 64, and prints the points per second of a
+// per-point Eigen loop and of the scalar and AVX2 kernels of HalfSpaceSet
+// (the AVX2 one only if the cpu has it). Exits with 1 if a margin of the
+// kernels differs from the dense reference, (b - A x).minCoeff() on the
+// normalized rows, by more than 1e-12.
+static const double tol = 1e-12;
+
+static double elapsedS(const std::chrono::steady_clock::time_point& t_start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t_start).count();
+}
+
+static double maxDiff(const Eigen::VectorXd& a, const Eigen::VectorXd& b)
+{
+    return (a - b).cwiseAbs().maxCoeff();
+}
+
+// Mpts/s of the rows of X, the margins of the last repeat in margin
+static double rate(const HalfSpaceSet& hs, const Eigen::MatrixXd& X, int repeats,
+    Eigen::VectorXd& margin)
+{
+    auto t_start = std::chrono::steady_clock::now();
+    for (int r(0); r < repeats; ++r)
+        hs.margins(X, margin);
+    return 1e-6 * X.rows() * repeats / elapsedS(t_start);
+}
+
+int main(int argc, char** argv)
+{
+    int num = 100000;
+    int repeats = 20;
+    unsigned seed = 1;
+    for (int i(1); i < argc; ++i) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            num = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            repeats = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            seed = (unsigned)atoi(argv[++i]);
+        } else {
+            printf("usage: halfspace_bench [-n points] [-r repeats] [-s seed]\n");
+            return 1;
+        }
+    }
+
+    const int dims[3] = { 2, 3, 6 };
+    const int num_rows[3] = { 4, 20, 64 };
+    std::mt19937 gen(seed);
+    std::normal_distribution<double> normal(0., 1.);
+    std::uniform_real_distribution<double> uniform(-1.5, 1.5);
+    bool b_ok = true;
+    double sum = 0.;
+
+    printf("%d points, %d repeats, avx2 %s, [Mpts/s]\n", num, repeats,
+        HalfSpaceSet::hasAvx2() ? "yes" : "no");
+    printf("%4s %4s %16s %9s %9s %12s\n", "dim", "m", "per-point Eigen", "scalar", "avx2", "max error");
+    for (int c(0); c < 3; ++c) {
+        int dim = dims[c], m = num_rows[c];
+        Eigen::MatrixXd A(m, dim);
+        Eigen::VectorXd b(m);
+        for (int i(0); i < m; ++i) {
+            for (int j(0); j < dim; ++j)
+                A(i, j) = normal(gen);
+            b(i) = 0.5 + std::fabs(normal(gen));
+        }
+        Eigen::MatrixXd X(num, dim);
+        for (int k(0); k < num; ++k) {
+            for (int j(0); j < dim; ++j)
+                X(k, j) = uniform(gen);
+        }
+        HalfSpaceSet hs;
+        hs.setHrep(A, b);
+
+        // dense reference on the normalized rows, one point at a time
+        Eigen::VectorXd norms = A.rowwise().norm();
+        Eigen::MatrixXd An = norms.cwiseInverse().asDiagonal() * A;
+        Eigen::VectorXd bn = b.cwiseQuotient(norms);
+        Eigen::VectorXd ref(num);
+        Eigen::VectorXd x(dim);
+        auto t_start = std::chrono::steady_clock::now();
+        for (int r(0); r < repeats; ++r) {
+            for (int k(0); k < num; ++k) {
+                x = X.row(k).transpose();
+                ref(k) = (bn - An * x).minCoeff();
+            }
+        }
+        double rate_eigen = 1e-6 * num * repeats / elapsedS(t_start);
+
+        Eigen::VectorXd margin_scalar, margin_avx2;
+        hs.setUseSimd(false);
+        double rate_scalar = rate(hs, X, repeats, margin_scalar);
+        double err = maxDiff(margin_scalar, ref);
+        sum += margin_scalar.sum();
+        if (HalfSpaceSet::hasAvx2()) {
+            hs.setUseSimd(true);
+            double rate_avx2 = rate(hs, X, repeats, margin_avx2);
+            err = std::max(err, maxDiff(margin_avx2, ref));
+            printf("%4d %4d %16.1f %9.1f %9.1f %12.1e\n", dim, m, rate_eigen, rate_scalar, rate_avx2, err);
+        } else {
+            printf("%4d %4d %16.1f %9.1f %9s %12.1e\n", dim, m, rate_eigen, rate_scalar, "-", err);
+        }
+        b_ok = b_ok && err <= tol;
+    }
+    printf("%s (%.0f)\n", b_ok ? "OK" : "FAILED", sum);
+    return b_ok ? 0 : 1;
+}
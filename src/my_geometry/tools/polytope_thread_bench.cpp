@@ -0,0 +1,110 @@
+#include <malloc.h>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "my_geometry/Polytope/Polytope.h"
+
+// polytope_thread_bench [-t max_threads] [-n round_trips] [-s short_threads]
+// runs setVertices / hrep / setHrep / vrep round trips of a 16 vertex
+// polytope in 1 to max_threads threads at once and prints the conversions
+// per second, each result checked against the same round trip run alone.
+// Then short_threads threads are created one after the other, each doing
+// one round trip, and the heap still in use after them is printed, which
+// the per-thread cdd state must not grow. Exits with 1 if a result differs
+// or the heap grows by more than 256 bytes per thread.
+
+// number of vertices back from the h-representation, -1 on failure
+static int roundTrip(Polyhedron& poly, int t, int k)
+{
+    Eigen::MatrixXd V(16, 3);
+    for (int i(0); i < 16; ++i) {
+        double a = 0.39 * i + t + 1e-3 * k;
+        V.row(i) << std::cos(a), std::sin(a), (i % 2) * 1. + 0.1 * t;
+    }
+    if (!poly.setVertices(V))
+        return -1;
+    HrepXd h = poly.hrep();
+    Polyhedron back;
+    if (!back.setHrep(h.first, h.second))
+        return -1;
+    return (int)back.vrep().first.rows();
+}
+
+static size_t heapInUse()
+{
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+}
+
+int main(int argc, char** argv)
+{
+    int max_threads = 4;
+    int num = 400;
+    int num_short = 200;
+    for (int i(1); i < argc; ++i) {
+        if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            max_threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            num = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            num_short = atoi(argv[++i]);
+        } else {
+            printf("usage: polytope_thread_bench [-t max_threads] "
+                   "[-n round_trips] [-s short_threads]\n");
+            return 1;
+        }
+    }
+
+    std::vector<std::vector<int>> expected(max_threads, std::vector<int>(num));
+    {
+        Polyhedron poly;
+        for (int t(0); t < max_threads; ++t) {
+            for (int k(0); k < num; ++k)
+                expected[t][k] = roundTrip(poly, t, k);
+        }
+    }
+
+    bool b_ok = true;
+    for (int num_threads(1); num_threads <= max_threads; num_threads *= 2) {
+        std::vector<std::thread> threads;
+        std::vector<int> num_ok(num_threads, 0);
+        auto t_start = std::chrono::steady_clock::now();
+        for (int t(0); t < num_threads; ++t) {
+            threads.push_back(std::thread([&, t]() {
+                Polyhedron poly;
+                for (int k(0); k < num; ++k)
+                    num_ok[t] += roundTrip(poly, t, k) == expected[t][k];
+            }));
+        }
+        for (auto& thread : threads)
+            thread.join();
+        double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - t_start).count();
+        int total = 0;
+        for (int n : num_ok)
+            total += n;
+        printf("%d threads : %d/%d round trips, %.0f conversions/s\n", num_threads, total,
+            num_threads * num, 2. * num_threads * num / t);
+        b_ok = b_ok && total == num_threads * num;
+    }
+
+    // the first short thread sets up what stays for the process
+    std::thread([]() { Polyhedron poly; roundTrip(poly, 0, 0); }).join();
+    size_t heap_start = heapInUse();
+    for (int k(0); k < num_short; ++k) {
+        std::thread([&, k]() {
+            Polyhedron poly;
+            b_ok = roundTrip(poly, 0, k % num) == expected[0][k % num] && b_ok;
+        }).join();
+    }
+    double growth = ((double)heapInUse() - (double)heap_start) / num_short;
+    printf("%d short threads : heap growth %.0f bytes per thread\n", num_short, growth);
+    b_ok = b_ok && growth < 256.;
+
+    printf("%s\n", b_ok ? "OK" : "FAILED");
+    return b_ok ? 0 : 1;
+}
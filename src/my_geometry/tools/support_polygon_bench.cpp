@@ -0,0 +1,197 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "my_geometry/Polygon/SupportPolygon.h"
+#include "my_geometry/Polytope/Polytope.h"
+
+// support_polygon_bench [-n random_ops] [-t ticks] [-s seed]
+// applies random_ops random inserts and removes of 8 points, on a grid
+// half of the time to get collinear and repeated points, and checks the
+// hull of SupportPolygon after each against a monotone chain hull of the
+// inserted points : same area, every point inside the half-planes, and the
+// stability margin of random queries. Then times a 4 foot swing cycle, a
+// foot removed and put back every 20 ticks with the margin of the CoM every
+// tick, against Polyhedron setVertices / hrep on the stance feet.
+// Exits with 1 on a mismatch.
+static const int num_points = 8;
+static const double tol = 1e-9;
+
+static double cross(const Eigen::Vector2d& a, const Eigen::Vector2d& b, const Eigen::Vector2d& p)
+{
+    return (b - a).x() * (p - a).y() - (b - a).y() * (p - a).x();
+}
+
+// counterclockwise, empty with less than 3 vertices
+static std::vector<Eigen::Vector2d> monotoneChain(std::vector<Eigen::Vector2d> p)
+{
+    std::sort(p.begin(), p.end(), [](const Eigen::Vector2d& a, const Eigen::Vector2d& b) {
+        return a.x() < b.x() || (a.x() == b.x() && a.y() < b.y());
+    });
+    std::vector<Eigen::Vector2d> h;
+    int n = (int)p.size();
+    for (int i(0); i < n; ++i) {
+        while (h.size() >= 2 && cross(h[h.size() - 2], h.back(), p[i]) <= 1e-12)
+            h.pop_back();
+        h.push_back(p[i]);
+    }
+    size_t lower = h.size() + 1;
+    for (int i(n - 2); i >= 0; --i) {
+        while (h.size() >= lower && cross(h[h.size() - 2], h.back(), p[i]) <= 1e-12)
+            h.pop_back();
+        h.push_back(p[i]);
+    }
+    if (!h.empty())
+        h.pop_back();
+    if (h.size() < 3)
+        h.clear();
+    return h;
+}
+
+static double area(const std::vector<Eigen::Vector2d>& h)
+{
+    double a = 0.;
+    for (size_t i(0); i < h.size(); ++i)
+        a += cross(Eigen::Vector2d::Zero(), h[i], h[(i + 1) % h.size()]);
+    return 0.5 * a;
+}
+
+static double margin(const std::vector<Eigen::Vector2d>& h, const Eigen::Vector2d& x)
+{
+    bool b_inside = true;
+    double dist_edge = 1e9, dist_hull = 1e9;
+    for (size_t i(0); i < h.size(); ++i) {
+        Eigen::Vector2d a = h[i], d = h[(i + 1) % h.size()] - a;
+        double c = cross(a, a + d, x) / d.norm();
+        b_inside = b_inside && c >= 0.;
+        dist_edge = std::min(dist_edge, c);
+        double s = std::min(1., std::max(0., d.dot(x - a) / d.squaredNorm()));
+        dist_hull = std::min(dist_hull, (a + s * d - x).norm());
+    }
+    return b_inside ? dist_edge : -dist_hull;
+}
+
+static int checkRandom(int num, unsigned seed)
+{
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> uniform(-1., 1.);
+    SupportPolygon polygon(num_points);
+    std::vector<Eigen::Vector2d> pos(num_points);
+    std::vector<bool> active(num_points, false);
+    int num_bad = 0;
+    for (int k(0); k < num; ++k) {
+        int id = gen() % num_points;
+        if (gen() % 2) {
+            if (gen() % 2)
+                pos[id] << std::round(2. * uniform(gen)) / 2., std::round(2. * uniform(gen)) / 2.;
+            else
+                pos[id] << uniform(gen), uniform(gen);
+            polygon.insert(id, pos[id]);
+            active[id] = true;
+        } else {
+            polygon.remove(id);
+            active[id] = false;
+        }
+
+        std::vector<Eigen::Vector2d> points;
+        for (int i(0); i < num_points; ++i) {
+            if (active[i])
+                points.push_back(pos[i]);
+        }
+        std::vector<Eigen::Vector2d> ref = monotoneChain(points);
+        std::vector<Eigen::Vector2d> hull;
+        for (int i(0); i < polygon.getNumVertices(); ++i)
+            hull.push_back(polygon.getVertex(i));
+        if (hull.size() < 3)
+            hull.clear();
+
+        bool b_ok = hull.size() == ref.size() && std::fabs(area(hull) - area(ref)) < tol;
+        for (int i(0); i < polygon.getNumHalfPlanes(); ++i) {
+            for (const Eigen::Vector2d& p : points)
+                b_ok = b_ok && polygon.getNormal(i).dot(p) - polygon.getOffset(i) < tol;
+        }
+        if (!ref.empty()) {
+            for (int q(0); q < 5; ++q) {
+                Eigen::Vector2d x(1.5 * uniform(gen), 1.5 * uniform(gen));
+                b_ok = b_ok && std::fabs(polygon.stabilityMargin(x) - margin(ref, x)) < tol;
+            }
+        }
+        if (!b_ok) {
+            if (num_bad < 3) {
+                printf("mismatch at op %d : %d hull vertices, %d expected\n", k, (int)hull.size(),
+                    (int)ref.size());
+            }
+            ++num_bad;
+        }
+    }
+    return num_bad;
+}
+
+int main(int argc, char** argv)
+{
+    int num = 200000;
+    int num_ticks = 200000;
+    unsigned seed = 1;
+    for (int i(1); i < argc; ++i) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            num = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            num_ticks = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            seed = (unsigned)atoi(argv[++i]);
+        } else {
+            printf("usage: support_polygon_bench [-n random_ops] [-t ticks] [-s seed]\n");
+            return 1;
+        }
+    }
+
+    int num_bad = checkRandom(num, seed);
+    printf("%d random operations on %d points : %d mismatches\n", num, num_points, num_bad);
+
+    Eigen::Vector2d feet[4] = { { 0.35, 0.2 }, { -0.35, 0.2 }, { -0.35, -0.2 }, { 0.35, -0.2 } };
+    double sum = 0.;
+    SupportPolygon polygon(4);
+    for (int i(0); i < 4; ++i)
+        polygon.insert(i, feet[i]);
+    auto t_start = std::chrono::steady_clock::now();
+    for (int k(0); k < num_ticks; ++k) {
+        int swing = (k / 20) % 4;
+        if (k % 20 == 0)
+            polygon.remove(swing);
+        if (k % 20 == 10) {
+            feet[swing].x() += (k / 40) % 2 ? -1e-3 : 1e-3;
+            polygon.insert(swing, feet[swing]);
+        }
+        sum += polygon.stabilityMargin(Eigen::Vector2d(0.01 * (k % 7), 0.));
+    }
+    double t_polygon = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t_start).count();
+
+    Polyhedron poly;
+    int num_poly = std::max(1, num_ticks / 100);
+    Eigen::MatrixXd V(3, 2);
+    Eigen::Vector2d x;
+    t_start = std::chrono::steady_clock::now();
+    for (int k(0); k < num_poly; ++k) {
+        int swing = k % 4;
+        for (int i(0), r(0); i < 4; ++i) {
+            if (i != swing)
+                V.row(r++) = feet[i].transpose();
+        }
+        if (!poly.setVertices(V))
+            ++num_bad;
+        HrepXd h = poly.hrep();
+        x << 0.01 * (k % 7), 0.;
+        sum += (h.second - h.first * x).minCoeff();
+    }
+    double t_poly = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t_start).count();
+
+    printf("[us] per tick, SupportPolygon %.3f, Polyhedron %.3f (%.0f)\n", t_polygon / num_ticks,
+        t_poly / num_poly, sum);
+    printf("%s\n", num_bad == 0 ? "OK" : "FAILED");
+    return num_bad == 0 ? 0 : 1;
+}
@@ -28,6 +28,9 @@ class ANYmalMpcControlArchitecture : public ControlArchitecture {
 
   void saveData();
   void getIVDCommand(void* _command);
+  void updateCentroidalMPC();
+  void requestCoMReplan(double passed_time);
+  void applyCoMReplan();
   
   StateSequence<MotionCommand>* states_sequence_;
   MotionCommand user_cmd_;
@@ -37,6 +40,7 @@ class ANYmalMpcControlArchitecture : public ControlArchitecture {
   void _InitializeParameters();
   bool b_state_first_visit_;
   bool b_env_param_updated_;
+  int state_count_; // number of state transitions
 
  protected:
   ANYmalStateProvider* sp_;   
@@ -54,6 +58,13 @@ class ANYmalMpcControlArchitecture : public ControlArchitecture {
   SlipObserver* slip_ob_;
   SlipObserverData* slip_ob_data_;
 
+  // CoM replanning off the control thread
+  ANYmalCoMPlannerService* com_planner_service_;
+
+  // Receding horizon centroidal planner
+  ANYmalCentroidalMPC* centroidal_mpc_;
+  CentroidalMPCInput mpc_input_;
+
   private:
     Eigen::VectorXd tau_min_;
     Eigen::VectorXd tau_max_;
@@ -0,0 +1,237 @@
+#pragma once
+
+#include <array>
+#include <Eigen/Dense>
+
+#include <my_filter/Kalman/ExtendedKalmanFilter.hpp>
+
+// Contact aided floating base estimator, the state is
+//   x = [ base position(3), base velocity(3), foot positions(3 x NumFeet) ]
+// in the world frame. The imu acceleration (rotated to the world frame by
+// the imu attitude) drives the prediction, and the foot positions relative
+// to the base given by the leg kinematics are the measurements. A foot in
+// contact is assumed to stay in place, the noises of a swing foot are
+// inflated so that it does not affect the base.
+// Everything is fixed size, nothing is allocated after the construction.
+
+template <int StateDim>
+class FloatingBaseState : public Kalman::Vector<double, StateDim> {
+    public:
+    KALMAN_VECTOR(FloatingBaseState, double, StateDim)
+
+    static_assert(StateDim >= 6 && (StateDim - 6) % 3 == 0,
+                  "state : base position, velocity and 3d foot positions");
+    static constexpr int NumFeet = (StateDim - 6) / 3;
+    typedef Eigen::Matrix<double, StateDim, 1> Storage;
+
+    Eigen::VectorBlock<Storage, 3> pos() { return this->template segment<3>(0); }
+    Eigen::VectorBlock<Storage, 3> vel() { return this->template segment<3>(3); }
+    Eigen::VectorBlock<Storage, 3> foot(int i) {
+        return this->template segment<3>(6 + 3*i); }
+    Eigen::VectorBlock<const Storage, 3> pos() const {
+        return this->template segment<3>(0); }
+    Eigen::VectorBlock<const Storage, 3> vel() const {
+        return this->template segment<3>(3); }
+    Eigen::VectorBlock<const Storage, 3> foot(int i) const {
+        return this->template segment<3>(6 + 3*i); }
+};
+
+// world frame acceleration of the base
+class BaseAcceleration : public Kalman::Vector<double, 3> {
+    public:
+    KALMAN_VECTOR(BaseAcceleration, double, 3)
+};
+
+// foot positions relative to the base in the world frame
+template <int NumFeet>
+class FootPositionMeasurement : public Kalman::Vector<double, 3*NumFeet> {
+    public:
+    KALMAN_VECTOR(FootPositionMeasurement, double, 3*NumFeet)
+};
+
+template <int StateDim>
+class FloatingBaseSystemModel
+    : public Kalman::LinearizedSystemModel<FloatingBaseState<StateDim>,
+                                           BaseAcceleration> {
+    public:
+    typedef FloatingBaseState<StateDim> State;
+    typedef BaseAcceleration Control;
+    static constexpr int NumFeet = State::NumFeet;
+
+    FloatingBaseSystemModel()
+        : acc_noise_(0.1), foot_noise_(0.001), foot_swing_noise_(1.0) {
+        b_contact_.fill(true);
+        setTimeStep(0.001);
+    }
+
+    void setTimeStep(double dt) {
+        dt_ = dt;
+        this->F.setIdentity();
+        this->F.template block<3, 3>(0, 3).diagonal().setConstant(dt_);
+        _updateCovariance();
+    }
+    // acc_noise [m/s^2], foot_noise [m/sqrt(s)] in stance and in swing
+    void setNoise(double acc_noise, double foot_noise,
+                  double foot_swing_noise) {
+        acc_noise_ = acc_noise;
+        foot_noise_ = foot_noise;
+        foot_swing_noise_ = foot_swing_noise;
+        _updateCovariance();
+    }
+    void setContact(const std::array<bool, NumFeet>& b_contact) {
+        if(b_contact == b_contact_) return;
+        b_contact_ = b_contact;
+        _updateCovariance();
+    }
+
+    State f(const State& x, const Control& u) const override {
+        State xn = x;
+        xn.pos() += dt_*x.vel() + 0.5*dt_*dt_*u;
+        xn.vel() += dt_*u;
+        return xn;
+    }
+
+    protected:
+    // discretized white noise acceleration on the base,
+    // random walk on the feet
+    void _updateCovariance() {
+        Kalman::Covariance<State> Q = Kalman::Covariance<State>::Zero();
+        double qa = acc_noise_*acc_noise_;
+        for(int k(0); k<3; ++k) {
+            Q(k, k) = 0.25*dt_*dt_*dt_*dt_*qa;
+            Q(k, 3+k) = Q(3+k, k) = 0.5*dt_*dt_*dt_*qa;
+            Q(3+k, 3+k) = dt_*dt_*qa;
+        }
+        for(int i(0); i<NumFeet; ++i) {
+            double qf = b_contact_[i] ? foot_noise_ : foot_swing_noise_;
+            Q.template block<3, 3>(6 + 3*i, 6 + 3*i).diagonal()
+                .setConstant(dt_*qf*qf);
+        }
+        this->setCovariance(Q);
+    }
+
+    double dt_;
+    double acc_noise_;
+    double foot_noise_;
+    double foot_swing_noise_;
+    std::array<bool, NumFeet> b_contact_;
+};
+
+template <int StateDim>
+class FootPositionMeasurementModel
+    : public Kalman::LinearizedMeasurementModel<
+                FloatingBaseState<StateDim>,
+                FootPositionMeasurement<FloatingBaseState<StateDim>::NumFeet>> {
+    public:
+    typedef FloatingBaseState<StateDim> State;
+    static constexpr int NumFeet = State::NumFeet;
+    typedef FootPositionMeasurement<NumFeet> Measurement;
+
+    FootPositionMeasurementModel() {
+        // z_i = foot_i - pos
+        this->H.setZero();
+        for(int i(0); i<NumFeet; ++i) {
+            this->H.template block<3, 3>(3*i, 0).diagonal().setConstant(-1.);
+            this->H.template block<3, 3>(3*i, 6 + 3*i).diagonal().setConstant(1.);
+        }
+        b_contact_.fill(true);
+        setNoise(0.005, 100.);
+    }
+
+    // kin_noise [m] in stance and in swing
+    void setNoise(double kin_noise, double kin_swing_noise) {
+        kin_noise_ = kin_noise;
+        kin_swing_noise_ = kin_swing_noise;
+        _updateCovariance();
+    }
+    void setContact(const std::array<bool, NumFeet>& b_contact) {
+        if(b_contact == b_contact_) return;
+        b_contact_ = b_contact;
+        _updateCovariance();
+    }
+
+    Measurement h(const State& x) const override {
+        Measurement z;
+        for(int i(0); i<NumFeet; ++i)
+            z.template segment<3>(3*i) = x.foot(i) - x.pos();
+        return z;
+    }
+
+    protected:
+    void _updateCovariance() {
+        Kalman::Covariance<Measurement> R = Kalman::Covariance<Measurement>::Zero();
+        for(int i(0); i<NumFeet; ++i) {
+            double r = b_contact_[i] ? kin_noise_ : kin_swing_noise_;
+            R.template block<3, 3>(3*i, 3*i).diagonal().setConstant(r*r);
+        }
+        this->setCovariance(R);
+    }
+
+    double kin_noise_;
+    double kin_swing_noise_;
+    std::array<bool, NumFeet> b_contact_;
+};
+
+template <int StateDim>
+class FloatingBaseEKF {
+    public:
+    typedef FloatingBaseState<StateDim> State;
+    typedef FloatingBaseSystemModel<StateDim> SystemModel;
+    typedef FootPositionMeasurementModel<StateDim> MeasurementModel;
+    typedef typename MeasurementModel::Measurement Measurement;
+    static constexpr int NumFeet = State::NumFeet;
+
+    FloatingBaseEKF() {}
+    ~FloatingBaseEKF() {}
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    SystemModel& getSystemModel() { return sys_; }
+    MeasurementModel& getMeasurementModel() { return meas_; }
+
+    // foot_rel : foot positions relative to the base in the world frame
+    void initialize(const Eigen::Vector3d& pos, const Eigen::Vector3d& vel,
+                    const std::array<Eigen::Vector3d, NumFeet>& foot_rel,
+                    double pos_std, double vel_std) {
+        State x;
+        x.pos() = pos;
+        x.vel() = vel;
+        for(int i(0); i<NumFeet; ++i)
+            x.foot(i) = pos + foot_rel[i];
+        ekf_.init(x);
+
+        Kalman::Covariance<State> P = Kalman::Covariance<State>::Zero();
+        P.diagonal().setConstant(pos_std*pos_std);
+        P.template block<3, 3>(3, 3).diagonal().setConstant(vel_std*vel_std);
+        ekf_.setCovariance(P);
+    }
+
+    void predict(const Eigen::Vector3d& acc,
+                const std::array<bool, NumFeet>& b_contact) {
+        sys_.setContact(b_contact);
+        meas_.setContact(b_contact);
+        u_ = acc;
+        ekf_.predict(sys_, u_);
+    }
+
+    void update(const std::array<Eigen::Vector3d, NumFeet>& foot_rel) {
+        for(int i(0); i<NumFeet; ++i)
+            z_.template segment<3>(3*i) = foot_rel[i];
+        ekf_.update(meas_, z_);
+        // keep the covariance symmetric
+        P_ = ekf_.getCovariance();
+        P_ = 0.5*(P_ + P_.transpose()).eval();
+        ekf_.setCovariance(P_);
+    }
+
+    const State& getState() const { return ekf_.getState(); }
+    const Kalman::Covariance<State>& getCovariance() const {
+        return ekf_.getCovariance(); }
+
+    protected:
+    Kalman::ExtendedKalmanFilter<State> ekf_;
+    SystemModel sys_;
+    MeasurementModel meas_;
+    BaseAcceleration u_;
+    Measurement z_;
+    Kalman::Covariance<State> P_;
+};
@@ -1,10 +1,15 @@
 #pragma once
 
+#include <array>
+#include <string>
+#include <Eigen/Dense>
+
 #include <my_robot_core/anymal_core/anymal_state_provider.hpp>
 #include <my_robot_core/state_estimator.hpp>
 #include <my_utils/Math/low_pass_filter.h>
-#include <my_utils/Math/simple_kalman_filter.h>
-#include <deque>
+#include <my_utils/Math/batched_kalman_filter.h>
+#include <my_utils/Math/recursive_least_squares.h>
+#include <my_utils/IO/LogChannel.hpp>
 
 class ANYmalWbcSpecContainer;
 class ANYmalReferenceGeneratorContainer;
@@ -18,7 +23,23 @@ class SlipObserverData {
 
 };
 
+// Per foot state in arrays indexed by the foot, the contact kinematics
+// are shared with ANYmalWBC through the spec container.
+// Nothing is allocated after the construction unless save_data is set.
 class SlipObserver : public StateEstimator {
+  public:
+    static constexpr int dim_grf = 3; // point contact
+    static constexpr int max_grf = ANYmal::n_leg*dim_grf;
+    // foot velocity filter channels, every axis of every foot
+    static constexpr int n_vel_channel = ANYmal::n_leg*dim_grf;
+
+    typedef Eigen::Matrix<double, Eigen::Dynamic, ANYmal::n_dof,
+                        Eigen::ColMajor, max_grf, ANYmal::n_dof> StackedJacobian;
+    typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic,
+                        Eigen::ColMajor, max_grf, max_grf> StackedMatrix;
+    typedef Eigen::Matrix<double, Eigen::Dynamic, 1,
+                        Eigen::ColMajor, max_grf, 1> StackedVector;
+
   public:
     SlipObserver( ANYmalWbcSpecContainer* ws_container,
                 RobotSystem* _robot);
@@ -26,24 +47,35 @@ class SlipObserver : public StateEstimator {
     void evaluate();
     void initialization(const YAML::Node& node);
 
-    void checkVelocity();   
+    void checkVelocity();
     void checkVelocityFoot(int foot_idx);
     bool estimateParameters();
-     
+
     void checkForce();
-    Eigen::VectorXd computeGRFDesired(const Eigen::VectorXd& tau);
+    // grf of the feet in contact explaining the torque command tau
+    void computeGRFDesired(const Eigen::VectorXd& tau);
 
     void weightShaping();
 
     void initContact();
     void initParams();
     void updateContact();
-  
+
+    const Eigen::Vector3d& getFootVelocity(int foot_idx) {
+        return foot_vel_[foot_idx]; } // filtered
+    const Eigen::Vector3d& getGRFDesired(int foot_idx) {
+        return grf_des_[foot_idx]; }
+    double getFrictionEstimate(int foot_idx) {
+        return mu_rls_[foot_idx].getParameter(0); }
+    double getStiffnessEstimate(int foot_idx) {
+        return stiffness_rls_[foot_idx].getParameter(0)/sinkage_scale; }
+
   public:
     int weight_shaping_activated_;
     int online_param_estimation_activated_;
+    int velocity_kalman_filter_; // 0: lpf2_, 1: vel_kf_
     double lin_vel_thres_;
-    
+    bool b_save_data_;
 
   protected:
     ANYmalStateProvider* sp_;
@@ -52,36 +84,64 @@ class SlipObserver : public StateEstimator {
     double t_updated_;
     bool b_swing_phase_;
     int swing_foot_idx_;
-    
-    std::map<int, bool> b_foot_contact_map_;
-    std::map<int, int> dim_grf_map_;
-    std::map<int, Eigen::VectorXd> foot_vel_map_;
-    std::map<int, Eigen::VectorXd> foot_acc_map_;
-
-    std::map<int, Eigen::VectorXd> grf_act_map_;
-    std::map<int, Eigen::VectorXd> grf_des_map_;
-    std::map<int, Eigen::VectorXd> grf_des_map2_;
 
-    Eigen::MatrixXd Sa_;
-
-    Eigen::MatrixXd M_;
-    Eigen::MatrixXd Minv_;
-    Eigen::MatrixXd grav_;
-    Eigen::MatrixXd coriolis_;
-
-    Eigen::VectorXd q_;
-    Eigen::VectorXd qdot_;
-    Eigen::VectorXd qddot_;  
-
-    std::array<LowPassFilter2*, ANYmal::n_leg> lpf2_container_;    
+    std::array<bool, ANYmal::n_leg> b_foot_contact_;
+    std::array<Eigen::Vector3d, ANYmal::n_leg> foot_vel_;
+    std::array<Eigen::Vector3d, ANYmal::n_leg> foot_acc_;
+
+    std::array<Eigen::Vector3d, ANYmal::n_leg> grf_act_; // sensed
+    std::array<Eigen::Vector3d, ANYmal::n_leg> grf_des_; // from tau
+    std::array<Eigen::Vector3d, ANYmal::n_leg> grf_des_wbc_;
+
+    // workspace
+    Eigen::MatrixXd Jc_i_;
+    Eigen::VectorXd JcDotQdot_i_;
+    Eigen::Vector3d xcdot_;
+    Eigen::Matrix<double, 2*dim_grf, 1> grf_act_des_;
+    StackedJacobian Jc_;
+    StackedJacobian JcMinv_;
+    StackedMatrix A_;
+    StackedMatrix Ainv_;
+    StackedVector grf_stacked_;
+    Eigen::VectorXd tau_cg_;
+    Eigen::JacobiSVD<StackedMatrix> svd_;
+
+    std::array<LowPassFilter2Fixed<dim_grf>, ANYmal::n_leg> lpf2_;
     double lpf_vel_cutoff_;
 
-    // parameter estimation
-    int time_sampling_period_;
-    std::array<std::deque<Eigen::VectorXd>, ANYmal::n_leg> stacked_grf_map_;
-    std::array<SimpleKalmanFilter*, ANYmal::n_leg> kf_container_;
-    SimpleSystemParam* kf_sys_;
-
-
-    
-};
\ No newline at end of file
+    // [velocity, acceleration] of every foot axis, one update per tick
+    BatchedKalmanFilter<n_vel_channel, 2> vel_kf_;
+    BatchedKalmanFilter<n_vel_channel, 2>::ChannelArray vel_meas_;
+    double vel_kf_acc_noise_;
+    double vel_kf_meas_noise_;
+    void _initVelocityFilter();
+
+    // parameter estimation, one update per tick and foot
+    //   friction : |f_t| = mu*f_z while the foot slides
+    //   stiffness : f_z = k*d + f_0, d the foot sinkage since the touchdown,
+    //     regressed on d/sinkage_scale so that both parameters are in [N],
+    //     and only while |d| > stiffness_min_sinkage, k is not observable
+    //     from the kinematics noise around the touchdown
+    static constexpr double sinkage_scale = 1e-3; // [m]
+    std::array<RecursiveLeastSquares<1>, ANYmal::n_leg> mu_rls_;
+    std::array<RecursiveLeastSquares<2>, ANYmal::n_leg> stiffness_rls_;
+    std::array<bool, ANYmal::n_leg> b_stance_;
+    std::array<double, ANYmal::n_leg> foot_z_touchdown_;
+    double rls_forgetting_factor_;
+    double rls_min_normal_force_;
+    double stiffness_min_sinkage_;
+    double slip_normal_vel_thres_;
+    int mu_min_samples_;
+    double mu_min_;
+    double mu_max_;
+    double mu_update_tol_;
+    double mu_replan_tol_;
+    Eigen::Vector3d grf_world_;
+    Eigen::Matrix<double, 1+ANYmal::n_leg*2, 1> param_est_;
+    void _initParameterEstimation();
+
+    // data saving
+    std::array<my_utils::LogChannel, ANYmal::n_leg> log_vel_;
+    std::array<my_utils::LogChannel, ANYmal::n_leg> log_grf_;
+    my_utils::LogChannel log_param_est_;
+};
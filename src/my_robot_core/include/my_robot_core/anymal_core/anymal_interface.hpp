@@ -8,6 +8,7 @@
 
 class ANYmalStateProvider;
 class ANYmalStateEstimator;
+namespace my_utils { class TelemetryPublisher; }
 
 namespace RUN_MODE {
 constexpr int BALANCE = 0;
@@ -27,8 +28,13 @@ class ANYmalSensorData {
                         Eigen::VectorXd::Zero(6),Eigen::VectorXd::Zero(6)};
         b_foot_contact = {false,false,false,false};
         tau_cmd_prev = Eigen::VectorXd::Zero(ANYmal::n_adof);
+
+        imu_quat = Eigen::Quaterniond::Identity();
+        imu_ang_vel = Eigen::Vector3d::Zero();
+        imu_acc = Eigen::Vector3d::Zero();
     }
     virtual ~ANYmalSensorData() {}
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
 
     Eigen::VectorXd q;
     Eigen::VectorXd qdot;
@@ -39,6 +45,12 @@ class ANYmalSensorData {
     std::array<bool, ANYmal::n_leg> b_foot_contact;
 
     Eigen::VectorXd tau_cmd_prev;
+
+    // imu on the base : attitude w.r.t. the world,
+    // angular velocity and specific force in the base frame
+    Eigen::Quaterniond imu_quat;
+    Eigen::Vector3d imu_ang_vel;
+    Eigen::Vector3d imu_acc;
 };
 
 class ANYmalCommand {
@@ -61,7 +73,9 @@ class ANYmalInterface : public EnvInterface {
     bool _CheckCommand(ANYmalCommand* cmd);
     void _SetStopCommand(ANYmalSensorData*, ANYmalCommand* cmd);
     void _SaveDataCmd(ANYmalSensorData*, ANYmalCommand* cmd);
+    void _PublishTelemetry(ANYmalSensorData*, ANYmalCommand* cmd);
     void _ParameterSetting(const YAML::Node& cfg);
+    void _TelemetrySetting(const YAML::Node& cfg);
 
     std::string test_name_;
 
@@ -75,6 +89,12 @@ class ANYmalInterface : public EnvInterface {
     Eigen::VectorXd cmd_jvel_;
     Eigen::VectorXd cmd_jtrq_;
 
+    // NULL if telemetry is disabled
+    my_utils::TelemetryPublisher* telemetry_;
+    int telemetry_state_;
+    int telemetry_contact_;
+    int telemetry_command_;
+
     int check_com_planner_updated;
     int check_foot_planner_updated;
 
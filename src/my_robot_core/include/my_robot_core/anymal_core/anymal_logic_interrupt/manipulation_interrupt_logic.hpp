@@ -1,5 +1,6 @@
 #pragma once
 
+#include <deque>
 #include <my_robot_core/interrupt_logic.hpp>
 #include <my_robot_core/control_architecture.hpp>
 
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <Eigen/Dense>
+
+#include <my_utils/IO/IOUtilities.hpp>
+#include <my_utils/General/Clock.hpp>
+#include <my_robot_core/anymal_core/anymal_definition.hpp>
+
+class QuadProgSolver;
+
+// Centroidal state and contact schedule, filled by the control thread
+class CentroidalMPCInput {
+    public:
+    CentroidalMPCInput();
+
+    double time;
+    double mass;
+    Eigen::Vector3d com_pos;
+    Eigen::Vector3d com_vel;
+    Eigen::Vector3d ang_mom;
+
+    // foot i is in contact if b_contact[i] != (t >= switch_time[i]),
+    // at foot_pos_next[i] after the switch
+    std::array<bool, ANYmal::n_leg> b_contact;
+    std::array<double, ANYmal::n_leg> switch_time;
+    std::array<Eigen::Vector3d, ANYmal::n_leg> foot_pos;
+    std::array<Eigen::Vector3d, ANYmal::n_leg> foot_pos_next;
+    std::array<double, ANYmal::n_leg> foot_mu;
+    std::array<double, ANYmal::n_leg> max_fz;
+
+    // com reference at the end of each step, k = 1, ..., N
+    std::vector<Eigen::Vector3d> com_pos_ref;
+    std::vector<Eigen::Vector3d> com_vel_ref;
+};
+
+// Predicted centroidal trajectory, forces are held over each step
+class CentroidalMPCOutput {
+    public:
+    CentroidalMPCOutput();
+
+    double time; // time of the initial state
+    double dt;
+    int n_step;
+    double mass;
+    std::vector<Eigen::Vector3d> com_pos; // N+1
+    std::vector<Eigen::Vector3d> com_vel; // N+1
+    std::vector<std::array<Eigen::Vector3d, ANYmal::n_leg>> foot_force; // N
+};
+
+// Receding horizon centroidal MPC.
+//      x = [p; v; L],  u = [f_1; ...; f_4]
+//      p+ = p + dt*v + 0.5*dt^2*(sum f/m + g)
+//      v+ = v + dt*(sum f/m + g)
+//      L+ = L + dt*sum skew(r_i - p_ref)*f_i
+// The states are condensed out, so the QP is over the forces only with
+// the friction pyramid of every foot at every step. The row layout is
+// fixed (a foot out of contact gets mu = fz_max = 0), so the active set
+// of the previous solve can warm start the next one (warm_start, off: it
+// is slower than the cold Goldfarb-Idnani solve on this QP).
+class ANYmalCentroidalMPC {
+    public:
+    static constexpr int dim_x = 9;
+    static constexpr int dim_u = 3*ANYmal::n_leg;
+    static constexpr int dim_cone = 6; // friction pyramid with max fz
+
+    public:
+    ANYmalCentroidalMPC();
+    ~ANYmalCentroidalMPC();
+
+    void initialization(const YAML::Node& node);
+
+    // solver thread at the given rate
+    void start();
+    void stop();
+
+    // the solver thread asks for a new input at every tick
+    // and waits for it up to half of the period
+    bool isInputRequested() { return b_input_requested_.load(); }
+    // do not block the control thread, false if the buffer is busy
+    bool setInput(const CentroidalMPCInput& input);
+    // interpolate the latest solution at time,
+    // false if there is none or it is older than the horizon
+    bool getReference(double time,
+                    Eigen::Vector3d& com_pos,
+                    Eigen::Vector3d& com_vel,
+                    Eigen::Vector3d& com_acc,
+                    std::array<Eigen::Vector3d, ANYmal::n_leg>& foot_force);
+
+    // synchronous solve, used by the solver thread
+    bool solve(const CentroidalMPCInput& input, CentroidalMPCOutput& output);
+
+    bool isEnabled() { return b_enabled_; }
+    bool useCoMReference() { return b_use_com_ref_; }
+    bool useForceReference() { return b_use_force_ref_; }
+    int getNumSteps() { return n_step_; }
+    double getStepTime() { return dt_; }
+
+    // statistics
+    int getNumSolve() { return num_solve_.load(); }
+    int getNumFailed() { return num_failed_.load(); }
+    int getNumDeadlineMiss() { return num_deadline_miss_.load(); }
+    int getNumWarmSolve() { return num_warm_solve_.load(); }
+    double getLastSolveTime() { return last_solve_time_.load(); } // [ms]
+    double getMaxSolveTime() { return max_solve_time_.load(); } // [ms]
+    double getMeanSolveTime();
+
+    private:
+    void _run();
+    void _buildDynamics(const CentroidalMPCInput& input);
+    void _buildCost(const CentroidalMPCInput& input);
+    void _buildConstraints(const CentroidalMPCInput& input);
+    bool _isContact(const CentroidalMPCInput& input, int foot_idx,
+                    double t, Eigen::Vector3d& foot_pos);
+
+    private:
+    // parameters
+    bool b_enabled_;
+    bool b_use_com_ref_;
+    bool b_use_force_ref_;
+    bool b_warm_start_;
+    double rate_;
+    int n_step_;
+    double dt_;
+    Eigen::VectorXd Q_; // dim_x
+    double w_force_;
+    Eigen::Vector3d grav_;
+
+    // condensed problem,  X = Sx*x0 + Su*U + Sd
+    Eigen::Matrix<double, dim_x, dim_x> A_;
+    std::vector<Eigen::Matrix<double, dim_x, dim_u>> B_;
+    Eigen::Matrix<double, dim_x, 1> d_;
+    std::vector<std::array<bool, ANYmal::n_leg>> contact_;
+    Eigen::MatrixXd Su_;
+    Eigen::VectorXd X0_; // Sx*x0 + Sd
+    Eigen::VectorXd Xref_;
+    Eigen::MatrixXd QSu_;
+    Eigen::MatrixXd H_;
+    Eigen::VectorXd f_;
+    Eigen::MatrixXd Aieq_;
+    Eigen::VectorXd bieq_;
+    Eigen::VectorXd U_;
+
+    QuadProgSolver* qp_solver_;
+    Clock clock_;
+
+    // solver thread
+    std::thread thread_;
+    std::atomic<bool> b_running_;
+    std::atomic<bool> b_input_requested_;
+
+    std::mutex input_mtx_;
+    std::condition_variable input_cv_;
+    bool b_new_input_;
+    CentroidalMPCInput input_; // written by setInput
+    CentroidalMPCInput input_solve_;
+
+    std::mutex output_mtx_;
+    bool b_new_output_;
+    bool b_output_valid_;
+    CentroidalMPCOutput output_; // written by the solver thread
+    CentroidalMPCOutput output_solve_;
+    CentroidalMPCOutput output_ctrl_; // copy on the control thread
+
+    std::atomic<int> num_solve_;
+    std::atomic<int> num_failed_;
+    std::atomic<int> num_deadline_miss_;
+    std::atomic<int> num_warm_solve_;
+    std::atomic<double> last_solve_time_;
+    std::atomic<double> max_solve_time_;
+    std::atomic<double> sum_solve_time_;
+};
@@ -2,8 +2,12 @@
 
 #include <Eigen/Dense>
 
+#include <my_utils/General/Clock.hpp>
+#include <my_geometry/Polygon/SupportPolygon.h>
 #include <my_robot_core/anymal_core/anymal_definition.hpp>
 #include <my_robot_core/anymal_core/anymal_command_api.hpp>
+#include <my_robot_core/anymal_core/anymal_planner/anymal_com_planner_builder.hpp>
+#include <my_robot_core/anymal_core/anymal_planner/anymal_com_sampler.hpp>
 
 
 class RobotSystem;
@@ -11,11 +15,31 @@ class ContactSpec;
 class ANYmalStateProvider;
 class QuadProgSolver;
 
+// plan of ANYmalCoMPlanner, copied between the control thread and
+// ANYmalCoMPlannerService
+class ANYmalCoMPlanData {
+    public:
+    ANYmalCoMPlanData();
+
+    Eigen::Vector3d p_init;
+    Eigen::Vector3d p_goal;
+    double Tf, Tt1, Ts, Tt2;
+    double T1, T2, T3;
+    int swing_foot_link_idx;
+    Eigen::Vector3d swing_foot_dpos;
+
+    Eigen::Vector3d dir_com_swing;
+    double alpha;
+    double beta;
+    Eigen::Vector3d acc_swing;
+    Eigen::Vector3d p_swing_init;
+    Eigen::Vector3d v_swing_init;
+};
 
 class ANYmalCoMPlanner{
     public:
     ANYmalCoMPlanner(RobotSystem* robot);
-    ~ANYmalCoMPlanner() {};
+    ~ANYmalCoMPlanner();
 
     void planCentroidalMotion(const Eigen::Vector3d& pcom_goal,
                         MotionCommand &_motion_command,
@@ -34,37 +58,67 @@ class ANYmalCoMPlanner{
                         const std::array<ContactSpec*, ANYmal::n_leg>& f_contacts,
                         double passed_time);
 
+    // replanning on the contact configuration given by 
+    // setContactConfiguration, without access to the robot
+    void replanCentroidalMotionPreSwing();
+    void replanCentroidalMotionSwing(double passed_time);
+
     ComMotionCommand getFullSupportCoMCmdReplaned(double passed_time);  
     ComMotionCommand getSwingCoMCmdReplaned(double passed_time);  
 
+    // sample the support region for a com goal with a larger margin,
+    // return true if the com goal is changed
+    void samplerInitialization(const YAML::Node& node);
+    bool searchCoMGoal(const std::array<ContactSpec*, ANYmal::n_leg>& f_contacts);
+    bool searchCoMGoal();
+    ANYmalCoMSampler* getCoMSampler() { return com_sampler_; }
+
+    // static stability margin of com_pos on the stance feet of the plan,
+    // the swing foot is out of the polygon
+    double getSupportMargin(const Eigen::Vector3d& com_pos) {
+        return support_polygon_->stabilityMargin(com_pos.head(2)); }
+    SupportPolygon* getSupportPolygon() { return support_polygon_; }
+
+    // replan latency [ms]
+    double getLastSolveTime() { return solve_time_last_; }
+    double getMaxSolveTime() { return solve_time_max_; }
+    double getMeanSolveTime() { 
+        return num_solve_ > 0 ? solve_time_sum_/num_solve_ : 0.; }
+    int getNumSolve() { return num_solve_; }
+    // cold / warm started solve in the incremental mode
+    double getMeanColdSolveTime() { 
+        return num_cold_ > 0 ? solve_time_cold_sum_/num_cold_ : 0.; }
+    double getMeanWarmSolveTime() { 
+        return num_warm_ > 0 ? solve_time_warm_sum_/num_warm_ : 0.; }
+    int getNumWarmSolve() { return num_warm_; }
+
+    void paramInitialization(const YAML::Node& node);
+
+    // snapshot of the plan / contact configuration
+    void getPlanData(ANYmalCoMPlanData& data);
+    void setPlanData(const ANYmalCoMPlanData& data);
+    void readContactConfiguration(
+                const std::array<ContactSpec*, ANYmal::n_leg>& f_contacts,
+                std::array<Eigen::Vector3d, ANYmal::n_leg>& foot_pos,
+                std::array<Eigen::Matrix3d, ANYmal::n_leg>& foot_rot,
+                std::array<double, ANYmal::n_leg>& foot_mu);
+    void setContactConfiguration(
+                const std::array<Eigen::Vector3d, ANYmal::n_leg>& foot_pos,
+                const std::array<Eigen::Matrix3d, ANYmal::n_leg>& foot_rot,
+                const std::array<double, ANYmal::n_leg>& foot_mu);
+
     private:
         void _setConfigurations(const Eigen::Vector3d& pcom_goal,
                                 MotionCommand &_motion_command);
         void _setPeriods(const Eigen::VectorXd& periods);
-        void _buildCentroidalSystemMatrices();
-        void _buildPfRf();        
-        void _buildFrictionCone(const std::array<ContactSpec*, 
+        void _buildProblem(const std::array<ContactSpec*, 
                                 ANYmal::n_leg>& f_contacts_);
-        void _buildWeightMatrices(const std::array<ContactSpec*, 
-                                ANYmal::n_leg>& f_contacts_);
-
-        void _getEndTransitionCondition(Eigen::MatrixXd& DD,
-                                        Eigen::VectorXd& dd);
-        void _getSwingConditionGivenRatio(double ratio,
-                                        Eigen::MatrixXd& DD,
-                                        Eigen::VectorXd& dd);       
-                                    
-        Eigen::MatrixXd _computeSwingDDa(double t,
-                                        const Eigen::MatrixXd& invA1,
-                                        const Eigen::MatrixXd& invA2);
-        Eigen::MatrixXd _computeSwingDDb(double t,
-                                        const Eigen::MatrixXd& invA1);
+        void _buildProblem();
         void _solveQuadProg();
 
         // replanning
-        void _getSwingConditionReplan(Eigen::MatrixXd& DD,
-                                      Eigen::VectorXd& dd);
         void _solveQuadProgReplan();
+        void _updateSolveTime(double time_ms, bool b_warm);
 
     private:
         Eigen::Vector3d p_init_;
@@ -83,28 +137,23 @@ class ANYmalCoMPlanner{
         Eigen::Vector3d grav_;        
 
         int swing_foot_link_idx_;
-        Eigen::VectorXd swing_foot_dpos_;
-
-        // system matrices
-        Eigen::MatrixXd Af_;
-        Eigen::MatrixXd Ac_;
-        Eigen::VectorXd Cf_;
-        Eigen::VectorXd Cc_;
-
-        // contact configuration matrices 
-        Eigen::MatrixXd Pf_; // stack full
-        Eigen::MatrixXd Rf_; // stack full
-        Eigen::MatrixXd Pc_; // stack only contact
-        Eigen::MatrixXd Rc_; // stack only contact
-
-        // Friction cone : Df*Fc >= df
-        Eigen::MatrixXd Df_;
-        Eigen::MatrixXd Dc_;
-        Eigen::VectorXd df_;
-        Eigen::VectorXd dc_;
-        // weight matrices
-        Eigen::MatrixXd invWf_;
-        Eigen::MatrixXd invWc_;
+        int swing_foot_idx_;
+        Eigen::Vector3d swing_foot_dpos_;
+
+        // contact configuration
+        std::array<Eigen::Vector3d, ANYmal::n_leg> foot_pos_;
+        std::array<Eigen::Matrix3d, ANYmal::n_leg> foot_rot_;
+        std::array<double, ANYmal::n_leg> foot_mu_;
+
+        // alpha/beta QP, allocated once for all the feet in contact
+        ANYmalCoMPlannerBuilder* builder_;
+        Eigen::Matrix3d H_;
+        Eigen::Vector3d f_;
+        Eigen::VectorXd x_;
+
+        // feasible com goal search
+        ANYmalCoMSampler* com_sampler_;
+        SupportPolygon* support_polygon_;
         
         double T1_;
         double T2_;
@@ -119,9 +168,31 @@ class ANYmalCoMPlanner{
         Eigen::Vector3d p_swing_init_;
         Eigen::Vector3d v_swing_init_;
 
+        // timing
+        Clock clock_;
+        double solve_time_last_;
+        double solve_time_max_;
+        double solve_time_sum_;
+        int num_solve_;
+        double solve_time_cold_sum_;
+        double solve_time_warm_sum_;
+        int num_cold_;
+        int num_warm_;
+
+        // incremental replanning
+        bool b_incremental_;
+        double update_tol_;
+        bool b_save_solve_time_;
+        bool b_cache_;
+        double cache_max_kb_;
+        double cache_pos_res_;
+        double cache_rot_res_;
+        double cache_mu_res_;
+
         bool initialized;
         RobotSystem* robot_;
         ANYmalStateProvider* sp_;
         QuadProgSolver* qp_solver_;
+        QuadProgSolver* qp_solver_swing_; // swing replan keeps its own active set
 };
 
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <array>
+#include <Eigen/Dense>
+
+#include <my_robot_core/anymal_core/anymal_definition.hpp>
+#include <my_robot_core/anymal_core/anymal_planner/contact_set_cache.hpp>
+
+// Builds the alpha/beta QP constraints of ANYmalCoMPlanner.
+// Every block is sized once for ANYmal::n_leg contacts, so an update
+// writes the friction cones and the centroidal equality in place.
+//
+// With the weighted inverse of the centroidal dynamics,
+//      Fc = invA*(m*[skew(g)*delP; delPddot] + C),
+// the friction cone D*Fc >= d of each contact set reduces to
+//      (0.5*m*t^2*G1 + m*G2)*x >= dd,
+// where G1 = D*invA1*skew(g), G2 = D*invA2, dd = -D*invA*C + d.
+// With the cache enabled, the contact sets of a stance seen before
+// (same contact mask and quantized foot geometry) are reused.
+class ANYmalCoMPlannerBuilder {
+    public:
+    static constexpr int dim_rf = 3; // point contact
+    static constexpr int dim_cone = 5; // friction pyramid without max fz
+    static constexpr int max_rf = ANYmal::n_leg*dim_rf;
+    static constexpr int max_cone = ANYmal::n_leg*dim_cone;
+    // end transition (2 samples) + swing given ratio (3 samples)
+    static constexpr int max_ieq = 2*max_cone + 3*max_cone;
+
+    typedef Eigen::Matrix<double, Eigen::Dynamic, 3,
+                        Eigen::ColMajor, max_cone, 3> ConeMatrix;
+    typedef Eigen::Matrix<double, Eigen::Dynamic, 1,
+                        Eigen::ColMajor, max_cone, 1> ConeVector;
+    typedef Eigen::Matrix<double, Eigen::Dynamic, 3,
+                        Eigen::ColMajor, max_ieq, 3> IeqMatrix;
+    typedef Eigen::Matrix<double, Eigen::Dynamic, 1,
+                        Eigen::ColMajor, max_ieq, 1> IeqVector;
+
+    // friction cone constraint projected on the com motion
+    struct ContactSet {
+        int n_contact;
+        ConeMatrix G1;
+        ConeMatrix G2;
+        ConeVector dd;
+    };
+
+    public:
+    ANYmalCoMPlannerBuilder();
+    ~ANYmalCoMPlannerBuilder();
+
+    // alpha = ratio*beta minimizing the maximum distance from the com goal
+    static double getSwingRatio(double T2, double T3);
+
+    void setMass(double mass) { mass_ = mass; _invalidate(); }
+    void setAngularMomentumRate(const Eigen::Vector3d& Ldot) { 
+        Ldot_ = Ldot; _invalidate(); }
+    // feet that moved no more than the tolerance keep their blocks,
+    // 0 keeps the unchanged feet only (exact), a positive tolerance keeps
+    // stale blocks and changes the plan, < 0 rebuilds every foot
+    void setUpdateTolerance(double tol) { update_tol_ = tol; }
+    // contact set cache of max_kb, foot positions (relative to the com
+    // goal), rotations and friction quantized by the given resolutions
+    void setCache(bool b_enable, double max_kb,
+                double pos_res, double rot_res, double mu_res);
+    // nullptr if disabled
+    ContactSetCache<ContactSet>* getCache() { return cache_; }
+
+    // swing_foot_idx < 0 : all feet in contact
+    void update(const std::array<Eigen::Vector3d, ANYmal::n_leg>& foot_pos,
+                const std::array<Eigen::Matrix3d, ANYmal::n_leg>& foot_rot,
+                const std::array<double, ANYmal::n_leg>& foot_mu,
+                int swing_foot_idx,
+                const Eigen::Vector3d& swing_foot_dpos,
+                const Eigen::Vector3d& p_goal);
+
+    // stack constraints as Aieq*x <= bieq (QuadProgSolver form)
+    void clearConstraints() { n_ieq_ = 0; }
+    void addEndTransitionCondition(double T3);
+    void addSwingConditionGivenRatio(double ratio, double T2, double T3);
+    void addSwingConditionReplan(double T2);
+
+    int getNumConstraints() const { return n_ieq_; }
+    Eigen::Block<const IeqMatrix, Eigen::Dynamic, 3> getIeqMtx() const {
+        return Aieq_.topRows(n_ieq_); }
+    Eigen::VectorBlock<const IeqVector> getIeqVec() const {
+        return bieq_.head(n_ieq_); }
+
+    const ContactSet& getFullSet() const { return full_; }
+    const ContactSet& getContactSet() const { return contact_; }
+    // number of the foot blocks rebuilt by the last update
+    int getNumUpdatedFeet() const { return n_updated_feet_; }
+
+    private:
+    void _buildFootBlocks(int foot_idx,
+                        const Eigen::Vector3d& pi,
+                        const Eigen::Matrix3d& Ri,
+                        double mu,
+                        const Eigen::Vector3d& p_goal);
+    bool _isFootChanged(int foot_idx,
+                        const Eigen::Vector3d& pi,
+                        const Eigen::Matrix3d& Ri,
+                        double mu,
+                        const Eigen::Vector3d& p_goal);
+    void _buildContactSet(bool b_exclude_swing, ContactSet& cs);
+    void _invalidate();
+    void _appendRows(const ContactSet& cs, double a, double b, double c);
+    static void _pseudoInverse6(const Eigen::Matrix<double, 6, 6>& AWA,
+                                double sigmaThreshold,
+                                Eigen::Matrix<double, 6, 6>& AWAinv);
+
+    private:
+    double mass_;
+    Eigen::Vector3d grav_;
+    Eigen::Vector3d Ldot_;
+    Eigen::Matrix3d skew_grav_;
+    Eigen::Matrix<double, 6, 1> C_;
+
+    int swing_foot_idx_;
+
+    // inputs of the last foot blocks
+    double update_tol_;
+    bool b_force_update_;
+    int n_updated_feet_;
+    std::array<Eigen::Vector3d, ANYmal::n_leg> pi_prev_;
+    std::array<Eigen::Matrix3d, ANYmal::n_leg> Ri_prev_;
+    std::array<double, ANYmal::n_leg> mu_prev_;
+    Eigen::Vector3d p_goal_prev_;
+
+    // per foot blocks
+    std::array<Eigen::Matrix<double, 6, 3>, ANYmal::n_leg> A_;
+    std::array<Eigen::Vector3d, ANYmal::n_leg> invW_;
+    std::array<Eigen::Matrix<double, dim_cone, 3>, ANYmal::n_leg> D_;
+    std::array<Eigen::Matrix<double, dim_cone, 1>, ANYmal::n_leg> d_;
+
+    // workspace
+    Eigen::Matrix<double, 6, 6> AWA_;
+    Eigen::Matrix<double, 6, 6> AWAinv_;
+    Eigen::Matrix<double, 3, 6> invA_i_;
+    Eigen::Matrix<double, dim_cone, 6> DinvA_i_;
+
+    ContactSet full_; // all feet, swing foot at its next position
+    ContactSet contact_; // feet in contact during swing
+
+    ContactSetCache<ContactSet>* cache_;
+    ContactSetKey cache_key_;
+
+    int n_ieq_;
+    IeqMatrix Aieq_;
+    IeqVector bieq_;
+};
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <Eigen/Dense>
+
+#include <my_utils/General/Mailbox.hpp>
+#include <my_robot_core/anymal_core/anymal_definition.hpp>
+#include <my_robot_core/anymal_core/anymal_planner/anymal_com_planner.hpp>
+
+class RobotSystem;
+class ContactSpec;
+
+// replan request, a snapshot of the control thread
+class ANYmalCoMPlanRequest {
+    public:
+    enum Type { PRE_SWING, SWING };
+
+    ANYmalCoMPlanRequest();
+
+    int type;
+    int state_count; // state machine instance the request belongs to
+    double passed_time;
+    unsigned int id;
+    std::chrono::steady_clock::time_point request_time;
+
+    ANYmalCoMPlanData plan;
+    std::array<Eigen::Vector3d, ANYmal::n_leg> foot_pos;
+    std::array<Eigen::Matrix3d, ANYmal::n_leg> foot_rot;
+    std::array<double, ANYmal::n_leg> foot_mu;
+};
+
+class ANYmalCoMPlanResult {
+    public:
+    ANYmalCoMPlanResult();
+
+    int type;
+    int state_count;
+    unsigned int id;
+    std::chrono::steady_clock::time_point request_time;
+    std::chrono::steady_clock::time_point done_time;
+
+    ANYmalCoMPlanData plan;
+    bool b_com_goal_updated;
+    bool b_sampled;
+    // evaluated com candidates, for the plot
+    std::vector<std::pair<double, Eigen::Vector3d>> feasible_com_list;
+};
+
+// Runs the com replanning of ANYmalCoMPlanner off the control thread.
+// Requests go through a lock-free single slot mailbox (a newer request
+// replaces a pending one), results are written to the back buffer of a
+// double buffer and the control thread swaps it in at a safe point.
+// The service owns its planner, the control planner is only touched by
+// the control thread.
+class ANYmalCoMPlannerService {
+    public:
+    ANYmalCoMPlannerService(RobotSystem* robot);
+    ~ANYmalCoMPlannerService();
+
+    void initialization(const YAML::Node& node);
+    // planner / sampler parameters of the service planner
+    void plannerInitialization(const YAML::Node& planner_node,
+                            const YAML::Node& sampler_node);
+
+    void start();
+    void stop();
+    bool isEnabled() { return b_enabled_; }
+
+    // control thread, never blocks
+    void requestPreSwingReplan(ANYmalCoMPlanner* planner,
+            const std::array<ContactSpec*, ANYmal::n_leg>& f_contacts,
+            int state_count);
+    void requestSwingReplan(ANYmalCoMPlanner* planner,
+            const std::array<ContactSpec*, ANYmal::n_leg>& f_contacts,
+            int state_count, double passed_time);
+    // at the safe point, true if a new result is swapped in
+    bool swapResult();
+    const ANYmalCoMPlanResult& getResult() { return results_[front_]; }
+    // the swapped result is applied or discarded
+    void markApplied();
+    void markStale();
+    // a control tick runs while a request is in flight
+    bool isPending() { return id_requested_ != id_consumed_; }
+    void countTick();
+
+    // statistics
+    int getNumRequest() { return num_request_; }
+    int getNumReplaced() { return num_replaced_; }
+    int getNumApplied() { return num_applied_; }
+    int getNumStale() { return num_stale_; }
+    int getNumStaleTicks() { return num_stale_ticks_; }
+    // request to availability, request to application [ms]
+    double getLastLatency() { return latency_last_; }
+    double getMaxLatency() { return latency_max_; }
+    double getMeanLatency() {
+        return num_result_ > 0 ? latency_sum_/num_result_ : 0.; }
+    double getLastApplyLatency() { return apply_latency_last_; }
+
+    private:
+    void _fillRequest(ANYmalCoMPlanRequest& req, ANYmalCoMPlanner* planner,
+            const std::array<ContactSpec*, ANYmal::n_leg>& f_contacts,
+            int state_count);
+    void _postRequest();
+    void _run();
+    void _solve(const ANYmalCoMPlanRequest& req, ANYmalCoMPlanResult& res);
+
+    private:
+    bool b_enabled_;
+    double wait_period_; // [ms], max wait for a request
+
+    ANYmalCoMPlanner* planner_; // service thread only
+    Mailbox<ANYmalCoMPlanRequest> requests_;
+
+    // double buffer, the control thread reads results_[front_]
+    std::array<ANYmalCoMPlanResult, 2> results_;
+    int front_;
+    std::atomic<bool> b_result_ready_;
+
+    std::thread thread_;
+    std::atomic<bool> b_running_;
+    std::mutex mtx_;
+    std::condition_variable cv_;
+
+    // control thread only
+    unsigned int id_requested_;
+    unsigned int id_consumed_;
+    int num_request_;
+    int num_replaced_;
+    int num_applied_;
+    int num_stale_;
+    int num_stale_ticks_;
+    int num_result_;
+    double latency_last_;
+    double latency_max_;
+    double latency_sum_;
+    double apply_latency_last_;
+};
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <Eigen/Dense>
+
+#include <my_utils/IO/IOUtilities.hpp>
+#include <my_utils/General/Clock.hpp>
+#include <my_geometry/Polytope/HalfSpaceSet.h>
+#include <my_geometry/Polygon/SupportPolygon.h>
+#include <my_robot_core/anymal_core/anymal_definition.hpp>
+#include <my_robot_core/anymal_core/anymal_planner/anymal_com_planner_builder.hpp>
+
+class QuadProgSolver;
+
+// Samples com goal candidates over the support polygon and checks each
+// against the friction cone / transition constraints of ANYmalCoMPlanner.
+// margin = alpha_max - alpha, where alpha is the swing acceleration
+// the planner needs for the candidate (-inf if the QP is infeasible).
+// At most max_samples candidates are evaluated, the closest to the
+// reference first, and the evaluation stops once time_budget [ms] is
+// spent, so a sample called on the control thread stays bounded.
+class ANYmalCoMSampler {
+    public:
+    ANYmalCoMSampler();
+    ~ANYmalCoMSampler();
+
+    void initialization(const YAML::Node& node);
+
+    void setProblem(double mass,
+                    const Eigen::Vector3d& Ldot,
+                    const std::array<Eigen::Vector3d, ANYmal::n_leg>& foot_pos,
+                    const std::array<Eigen::Matrix3d, ANYmal::n_leg>& foot_rot,
+                    const std::array<double, ANYmal::n_leg>& foot_mu,
+                    int swing_foot_idx,
+                    const Eigen::Vector3d& swing_foot_dpos,
+                    double T2, double T3);
+
+    // p_ref is always evaluated first, candidates are sorted by
+    // the distance from p_ref on the plane z = p_ref(2)
+    // return true if any feasible candidate is found
+    bool sample(const Eigen::Vector3d& p_ref);
+
+    bool isEnabled() { return b_enabled_; }
+    int getNumThreads() { return num_threads_; }
+    double getMarginThreshold() { return margin_threshold_; }
+
+    double getRefMargin() { return ref_margin_; }
+    double getBestMargin() { return best_margin_; }
+    Eigen::Vector3d getBestCoM() { return best_com_; }
+    // evaluated candidates, (margin, com)
+    void getCandidateList(
+            std::vector<std::pair<double, Eigen::Vector3d>>& com_list);
+
+    int getNumEvaluated() { return num_evaluated_; }
+    // the last sample stopped on the time budget
+    bool isTimedOut() { return b_timed_out_; }
+    double getSampleTime() { return sample_time_; } // [ms]
+    double getCandidatesPerSec();
+
+    private:
+    struct Workspace {
+        Workspace();
+        ~Workspace();
+        ANYmalCoMPlannerBuilder* builder;
+        QuadProgSolver* qp_solver;
+        Eigen::Matrix3d H;
+        Eigen::Vector3d f;
+        Eigen::VectorXd x;
+    };
+
+    void _startWorkers();
+    void _stopWorkers();
+    void _workerLoop(int tid, unsigned int batch_id);
+    void _evaluateCandidates(Workspace* ws);
+    double _evaluate(const Eigen::Vector3d& p_goal, Workspace* ws);
+    void _generateCandidates(const Eigen::Vector3d& p_ref);
+
+    private:
+    // parameters
+    bool b_enabled_;
+    int num_threads_;
+    int max_samples_;
+    double resolution_;
+    double alpha_max_;
+    double margin_threshold_;
+    double time_budget_; // [ms], 0 : none
+
+    // problem
+    double mass_;
+    Eigen::Vector3d Ldot_;
+    std::array<Eigen::Vector3d, ANYmal::n_leg> foot_pos_;
+    std::array<Eigen::Matrix3d, ANYmal::n_leg> foot_rot_;
+    std::array<double, ANYmal::n_leg> foot_mu_;
+    int swing_foot_idx_;
+    Eigen::Vector3d swing_foot_dpos_;
+    double T2_;
+    double T3_;
+    double ratio_;
+
+    // support polygon of the stance feet
+    SupportPolygon* support_polygon_;
+    Eigen::MatrixXd support_A_;
+    Eigen::VectorXd support_b_;
+    // its edges, the grid is screened in one batch
+    HalfSpaceSet support_edges_;
+    // grid buffers sized once, a polygon too large for grid_capacity_
+    // points at resolution_ is sampled coarser
+    int grid_capacity_;
+    int grid_size_;
+    Eigen::MatrixXd grid_; // (x, y) stacked in the first grid_size_ rows
+    Eigen::VectorXd grid_margin_;
+    std::vector<char> grid_inside_;
+    std::vector<int> grid_order_; // inside grid points by distance
+
+    // candidates
+    std::vector<Eigen::Vector3d> candidates_;
+    std::vector<double> margins_;
+    std::vector<char> evaluated_;
+    int num_candidates_;
+
+    // results
+    double ref_margin_;
+    double best_margin_;
+    Eigen::Vector3d best_com_;
+    int num_evaluated_;
+    double sample_time_;
+    bool b_timed_out_;
+    Clock clock_;
+
+    // thread pool, the caller thread uses workspaces_[0]
+    std::vector<Workspace*> workspaces_;
+    std::vector<std::thread> workers_;
+    std::mutex mtx_;
+    std::condition_variable cv_start_;
+    std::condition_variable cv_done_;
+    unsigned int batch_id_;
+    int num_busy_;
+    bool b_terminate_;
+    std::atomic<int> next_idx_;
+    std::atomic<bool> b_early_exit_;
+    std::atomic<bool> b_time_over_;
+    std::chrono::steady_clock::time_point deadline_;
+};
@@ -1 +1,3 @@
 #include <my_robot_core/anymal_core/anymal_planner/anymal_com_planner.hpp>
+#include <my_robot_core/anymal_core/anymal_planner/anymal_com_planner_service.hpp>
+#include <my_robot_core/anymal_core/anymal_planner/anymal_centroidal_mpc.hpp>
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <Eigen/Dense>
+
+#include <my_robot_core/anymal_core/anymal_definition.hpp>
+
+// Quantized contact geometry of a stance: the contact bitmask, and for
+// every foot in contact its position relative to a reference point
+// (the com goal), its orientation and its friction coefficient.
+class ContactSetKey {
+    public:
+    static constexpr int dim_foot = 3 + 9 + 1;
+    static constexpr int dim_key = ANYmal::n_leg*dim_foot;
+
+    ContactSetKey() : mask(0), hash(0) { q.fill(0); }
+
+    bool operator==(const ContactSetKey& other) const {
+        return hash == other.hash && mask == other.mask && q == other.q; }
+
+    unsigned int mask;
+    std::array<long, dim_key> q;
+    uint64_t hash;
+};
+
+// LRU cache of the geometry computed for a contact set, e.g. the friction
+// cones and the wrench maps of a stance, so that a repeated gait phase
+// reuses the work of an earlier one.
+// The entries live in a pool sized by the memory cap, the lookup is a
+// linear scan of the hashes (tens of entries) and nothing is allocated
+// after setMemoryCap.
+template <typename Value>
+class ContactSetCache {
+    public:
+    ContactSetCache() {
+        pos_res_ = 1e-3;
+        rot_res_ = 1e-3;
+        mu_res_ = 1e-3;
+        head_ = -1;
+        tail_ = -1;
+        n_entries_ = 0;
+        resetStatistics();
+    }
+    ~ContactSetCache() {}
+
+    void setResolution(double pos_res, double rot_res, double mu_res) {
+        pos_res_ = pos_res;
+        rot_res_ = rot_res;
+        mu_res_ = mu_res;
+        clear();
+    }
+    // keep as many entries as fit in max_kb, at least one
+    void setMemoryCap(double max_kb) {
+        int capacity = (int)(max_kb*1024./sizeof(Entry));
+        pool_.resize(capacity > 0 ? capacity : 1);
+        clear();
+    }
+    // the values depend on something out of the key
+    void clear() {
+        head_ = -1;
+        tail_ = -1;
+        n_entries_ = 0;
+    }
+    void resetStatistics() {
+        num_hit_ = 0;
+        num_miss_ = 0;
+        num_evict_ = 0;
+    }
+
+    void makeKey(unsigned int mask,
+                const std::array<Eigen::Vector3d, ANYmal::n_leg>& foot_pos,
+                const std::array<Eigen::Matrix3d, ANYmal::n_leg>& foot_rot,
+                const std::array<double, ANYmal::n_leg>& foot_mu,
+                const Eigen::Vector3d& p_ref,
+                ContactSetKey& key) const {
+        key.mask = mask;
+        key.q.fill(0);
+        int k(0);
+        for(int i(0); i<ANYmal::n_leg; ++i) {
+            if(!(mask & (1u << i))) { k += ContactSetKey::dim_foot; continue; }
+            for(int j(0); j<3; ++j)
+                key.q[k++] = std::lround((foot_pos[i](j) - p_ref(j))/pos_res_);
+            for(int j(0); j<9; ++j)
+                key.q[k++] = std::lround(foot_rot[i](j)/rot_res_);
+            key.q[k++] = std::lround(foot_mu[i]/mu_res_);
+        }
+        // FNV-1a
+        uint64_t h = 14695981039346656037ull;
+        h = (h ^ key.mask) * 1099511628211ull;
+        for(int j(0); j<ContactSetKey::dim_key; ++j)
+            h = (h ^ (uint64_t)key.q[j]) * 1099511628211ull;
+        key.hash = h;
+    }
+
+    // copy the cached value, false on a miss
+    bool find(const ContactSetKey& key, Value& value) {
+        for(int idx = head_; idx >= 0; idx = pool_[idx].next) {
+            if(pool_[idx].key == key) {
+                value = pool_[idx].value;
+                _moveToFront(idx);
+                ++num_hit_;
+                return true;
+            }
+        }
+        ++num_miss_;
+        return false;
+    }
+
+    // the least recently used entry is replaced when the pool is full
+    void insert(const ContactSetKey& key, const Value& value) {
+        if(pool_.empty()) setMemoryCap(0.);
+        int idx;
+        if(n_entries_ < (int)pool_.size()) {
+            idx = n_entries_++;
+            _linkFront(idx);
+        } else {
+            idx = tail_;
+            ++num_evict_;
+            _moveToFront(idx);
+        }
+        pool_[idx].key = key;
+        pool_[idx].value = value;
+    }
+
+    // statistics
+    int getCapacity() { return (int)pool_.size(); }
+    int getNumEntries() { return n_entries_; }
+    int getNumHit() { return num_hit_; }
+    int getNumMiss() { return num_miss_; }
+    int getNumEvict() { return num_evict_; }
+    double getHitRate() {
+        int n = num_hit_ + num_miss_;
+        return n > 0 ? (double)num_hit_/n : 0.; }
+    double getMemoryKb() { return pool_.size()*sizeof(Entry)/1024.; }
+
+    private:
+    struct Entry {
+        ContactSetKey key;
+        Value value;
+        int prev;
+        int next;
+    };
+
+    void _unlink(int idx) {
+        Entry& e = pool_[idx];
+        if(e.prev >= 0) pool_[e.prev].next = e.next; else head_ = e.next;
+        if(e.next >= 0) pool_[e.next].prev = e.prev; else tail_ = e.prev;
+    }
+    void _linkFront(int idx) {
+        pool_[idx].prev = -1;
+        pool_[idx].next = head_;
+        if(head_ >= 0) pool_[head_].prev = idx; else tail_ = idx;
+        head_ = idx;
+    }
+    void _moveToFront(int idx) {
+        if(idx == head_) return;
+        _unlink(idx);
+        _linkFront(idx);
+    }
+
+    private:
+    double pos_res_;
+    double rot_res_;
+    double mu_res_;
+
+    std::vector<Entry> pool_;
+    int head_; // most recently used
+    int tail_; // least recently used
+    int n_entries_;
+
+    int num_hit_;
+    int num_miss_;
+    int num_evict_;
+};
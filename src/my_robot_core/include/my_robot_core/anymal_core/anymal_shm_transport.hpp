@@ -0,0 +1,107 @@
+#pragma once
+
+#include <stdint.h>
+#include <my_robot_core/anymal_core/anymal_definition.hpp>
+#include <my_utils/IO/ShmSeqlock.hpp>
+
+class ANYmalInterface;
+class ANYmalSensorData;
+class ANYmalCommand;
+
+// Controller in its own process, exchanging the sensor data and the
+// command with the simulator or the hardware driver through the shared
+// memory : each side publishes its data in a seqlock segment, and the
+// command of a tick carries the tick of the sensor data it answers.
+
+// fixed layout mirrors of ANYmalSensorData, ANYmalCommand
+struct ANYmalSensorDataPod {
+    uint64_t tick;
+    uint64_t round_trip_ns; // of the previous tick, 0 : none
+    double q[ANYmal::n_adof];
+    double qdot[ANYmal::n_adof];
+    double virtual_q[ANYmal::n_vdof];
+    double virtual_qdot[ANYmal::n_vdof];
+    double foot_wrench[ANYmal::n_leg][6];
+    double tau_cmd_prev[ANYmal::n_adof];
+    double imu_quat[4]; // w, x, y, z
+    double imu_ang_vel[3];
+    double imu_acc[3];
+    uint8_t b_foot_contact[ANYmal::n_leg];
+    uint16_t button; // key pressed since the previous tick, 0 : none
+};
+
+struct ANYmalCommandPod {
+    uint64_t tick; // of the sensor data
+    uint64_t compute_ns; // in the controller
+    double q[ANYmal::n_adof];
+    double qdot[ANYmal::n_adof];
+    double jtrq[ANYmal::n_adof];
+};
+
+namespace ANYmalShm {
+constexpr const char* sensor_data_name = "/anymal_sensor_data";
+constexpr const char* command_name = "/anymal_command";
+
+void toPod(const ANYmalSensorData* data, ANYmalSensorDataPod& pod);
+void fromPod(const ANYmalSensorDataPod& pod, ANYmalSensorData* data);
+void toPod(const ANYmalCommand* command, ANYmalCommandPod& pod);
+void fromPod(const ANYmalCommandPod& pod, ANYmalCommand* command);
+}  // namespace ANYmalShm
+
+// simulator / driver side
+class ANYmalShmClient {
+   public:
+    ANYmalShmClient(my_utils::ShmWakeup wakeup, double timeout);
+    ~ANYmalShmClient();
+
+    // blocks until the controller process is up
+    void connect();
+    // sends the sensor data and waits for its command, false if it does
+    // not come within the timeout, command is then left as it was. A
+    // restarted controller is waited for.
+    bool exchange(const ANYmalSensorData* data, ANYmalCommand* command);
+    // sent with the next sensor data
+    void setButton(uint16_t key) { button_ = key; }
+
+   private:
+    void openCommand_();
+
+    my_utils::ShmSeqlock sensor_pub_;
+    my_utils::ShmSeqlock command_sub_;
+    ANYmalSensorDataPod sensor_pod_;
+    ANYmalCommandPod command_pod_;
+
+    double timeout_;
+    uint64_t tick_;
+    uint32_t command_seq_;
+    uint64_t round_trip_ns_;
+    uint16_t button_;
+};
+
+// controller side, runs the interface on the sensor data of the client
+class ANYmalShmServer {
+   public:
+    ANYmalShmServer(my_utils::ShmWakeup wakeup);
+    ~ANYmalShmServer();
+
+    // blocks until the client process is up
+    void connect();
+    // computes the command of the next sensor data, false if none comes
+    // within the timeout [s]. A restarted client is waited for.
+    bool spinOnce(double timeout);
+
+   private:
+    void openSensorData_();
+
+    ANYmalInterface* interface_;
+    ANYmalSensorData* sensor_data_;
+    ANYmalCommand* command_;
+
+    my_utils::ShmSeqlock command_pub_;
+    my_utils::ShmSeqlock sensor_sub_;
+    ANYmalSensorDataPod sensor_pod_;
+    ANYmalCommandPod command_pod_;
+
+    uint32_t sensor_seq_;
+    uint64_t last_compute_ns_;
+};
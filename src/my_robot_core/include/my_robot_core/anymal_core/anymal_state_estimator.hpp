@@ -1,17 +1,26 @@
 #pragma once
 
+#include <array>
 #include <../my_utils/Configuration.h>
 #include <Eigen/Dense>
 
+#include <my_robot_core/anymal_core/anymal_definition.hpp>
+#include <my_utils/IO/IOUtilities.hpp>
+
 class ANYmalStateProvider;
 class RobotSystem;
 class ANYmalSensorData;
+template <int StateDim> class FloatingBaseEKF;
 
 class ANYmalStateEstimator {
    public:
+    // base position, velocity and foot positions
+    typedef FloatingBaseEKF<6 + 3*ANYmal::n_leg> BaseEKF;
+
     ANYmalStateEstimator(RobotSystem* robot);
     ~ANYmalStateEstimator();
 
+    void setParameters(const YAML::Node& node);
     void Initialization(ANYmalSensorData*);
     void Update(ANYmalSensorData*);
 
@@ -23,7 +32,20 @@ class ANYmalStateEstimator {
     Eigen::VectorXd curr_qdot_;
     Eigen::VectorXd prev_tau_cmd_;
 
+    // contact aided base estimation,
+    // otherwise the base state of the sensor data is used
+    bool b_base_estimation_;
+    bool b_save_data_;
+    BaseEKF* base_ekf_;
+    double init_pos_std_;
+    double init_vel_std_;
+    double prev_yaw_;
+    Eigen::Vector3d gravity_;
+    std::array<Eigen::Vector3d, ANYmal::n_leg> foot_rel_;
+
     void _JointUpdate(ANYmalSensorData* data);
     void _ConfigurationAndModelUpdate();
     void _FootContactUpdate(ANYmalSensorData* data);
+    void _BaseStateInitialization(ANYmalSensorData* data);
+    void _BaseStateUpdate(ANYmalSensorData* data);
 };
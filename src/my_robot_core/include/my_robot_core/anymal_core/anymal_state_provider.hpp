@@ -74,6 +74,9 @@ class ANYmalStateProvider {
     Eigen::Vector3d com_vel_des;
     Eigen::VectorXd mom_des;
 
+    // com projection to the support polygon edges, < 0 if outside
+    double support_margin;
+
     Eigen::Quaternion<double> base_ori;
     Eigen::VectorXd base_ang_vel;
 
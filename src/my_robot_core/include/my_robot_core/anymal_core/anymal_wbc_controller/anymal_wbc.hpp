@@ -19,6 +19,16 @@ class ANYmalWBC {
   virtual void getCommand(void* _cmd);
   virtual void ctrlInitialization(const YAML::Node& node);
 
+  // centroidal reference from the mpc, overrides the com task and
+  // regularizes the reaction forces to foot_force until cleared
+  void setCentroidalReference(const Eigen::Vector3d& com_pos,
+                              const Eigen::Vector3d& com_vel,
+                              const Eigen::Vector3d& com_acc,
+                              bool b_com_ref);
+  void setCentroidalReference(
+          const std::array<Eigen::Vector3d, ANYmal::n_leg>& foot_force);
+  void clearCentroidalReference();
+
  protected:
   //  Processing Step for first visit
   virtual void firstVisit();  
@@ -27,6 +37,7 @@ class ANYmalWBC {
   virtual void _PreProcessing_Command();
 
   void set_grf_des();
+  void _SetCentroidalReference();
 
  protected:
   RobotSystem* robot_;
@@ -74,6 +85,14 @@ class ANYmalWBC {
   Eigen::VectorXd tau_min_;
   Eigen::VectorXd tau_max_;
 
+  // centroidal reference
+  bool b_com_ref_;
+  bool b_force_ref_;
+  Eigen::VectorXd com_pos_ref_;
+  Eigen::VectorXd com_vel_ref_;
+  Eigen::VectorXd com_acc_ref_;
+  std::array<Eigen::Vector3d, ANYmal::n_leg> foot_force_ref_;
+
  private:
   // Controller Objects
   WBLC* wbc_;
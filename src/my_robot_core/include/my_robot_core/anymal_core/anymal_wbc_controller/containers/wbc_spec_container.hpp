@@ -10,6 +10,7 @@
 #include <my_wbc/Contact/BasicContactSpec.hpp>
 #include <my_wbc/Contact/GroundFrameContactSpec.hpp>
 #include <my_wbc/Task/Task.hpp>
+#include <my_geometry/Polygon/SupportPolygon.h>
 #include <my_robot_core/anymal_core/anymal_specs/ContactWeight.hpp>
 
 #include <my_robot_core/anymal_core/anymal_definition.hpp>
@@ -60,6 +61,11 @@ class ANYmalWbcSpecContainer {
   std::array<bool, ANYmal::n_leg> b_feet_contact_list_;
   std::array<ContactSpec*, ANYmal::n_leg> feet_contacts_;
   int full_contact_dim_;
+  // robot update of the feet contact kinematics
+  std::array<long, ANYmal::n_leg> feet_contacts_update_;
+
+  // support polygon of the feet in contact_list, foot idx as point id
+  SupportPolygon* support_polygon_;
 
   Eigen::VectorXd friction_coeff_;
 
@@ -104,8 +110,13 @@ class ANYmalWbcSpecContainer {
 
   // contact
   void set_contact_list(int moving_cop);
+  // signed distance of the com projection to the support polygon edges
+  double get_support_margin(const Eigen::Vector3d& com_pos);
   // contact spec
   void set_contact_maxfz(int moving_cop=-1);
+  // Jc, JcDotQdot once per robot update, shared by the wbc and the observers
+  void update_foot_contact_kinematics(int foot_idx);
+  void update_feet_contact_kinematics();
 
   void set_contact_weight_param(int trans_cop=-1);
   void reshape_weight_param(double alpha,
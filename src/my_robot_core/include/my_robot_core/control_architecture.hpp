@@ -20,6 +20,7 @@ class ControlArchitecture {
 
   virtual void ControlArchitectureInitialization() = 0;
   virtual void getCommand(void* _command) = 0;  
+  // from any thread, the command is copied
   virtual void addState(StateIdentifier _state_id, void* _user_state_command) = 0;
   
   int getState() { return state_; }
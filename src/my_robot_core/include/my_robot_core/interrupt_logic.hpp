@@ -1,20 +1,32 @@
 #pragma once
 
+#include <my_utils/General/MpscQueue.hpp>
 #include <my_utils/IO/IOUtilities.hpp>
 
 class InterruptLogic {
  public:
-  InterruptLogic() { resetFlags(); }
+  static constexpr int max_buttons = 16; // pressed between two ticks
+
+  InterruptLogic() : button_queue_(max_buttons) { resetFlags(); }
   virtual ~InterruptLogic() {}
-  virtual void processInterrupts() { resetFlags(); }
+  virtual void processInterrupts() { while(nextFlags()) {} resetFlags(); }
   virtual void resetFlags() {    
     // b_interrupt_button_p = false;
     b_button_pressed = false;   
   }
   virtual void setInterruptRoutine(const YAML::Node& motion_cfg) {};
-  virtual void setFlags(uint16_t key) {b_button_pressed = true; pressed_button = key;};
+  // from any thread, e.g. the key handler of the simulator, false if
+  // max_buttons are already waiting
+  virtual bool setFlags(uint16_t key) { return button_queue_.push(key); };
 // bool b_interrupt_button_p;
  protected:
+  // control thread, next button pressed in pressed_button, false if none
+  bool nextFlags() {
+    b_button_pressed = button_queue_.pop(pressed_button);
+    return b_button_pressed;
+  }
+
   bool b_button_pressed;
   uint16_t pressed_button;  
+  MpscQueue<uint16_t> button_queue_;
 };
@@ -37,6 +37,11 @@ class CoMTrajectoryManager : public TrajectoryManagerBase {
   // Computes the swing com trajectory
   void updateCoMTrajectory(double current_time);
 
+  // Evaluates the com trajectory without updating the task
+  void getCoMReference(double time, 
+                      Eigen::Vector3d& com_pos, 
+                      Eigen::Vector3d& com_vel);
+
   double getTrajEndTime() {  return traj_end_time_; };
   double getTrajDuration() {  return traj_duration_; };
 
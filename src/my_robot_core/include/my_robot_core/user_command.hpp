@@ -1,6 +1,7 @@
 #pragma once
 
-#include <deque>
+#include <utility>
+#include <my_utils/General/MpscQueue.hpp>
 
 
 // default component
@@ -10,26 +11,29 @@ class UserCommand {
     virtual ~UserCommand() {}; 
 };
 
-// container
+// container, states added from any thread (interrupt logic, UI, network,
+// script) and taken by the control thread without lock or allocation
 template<class T>
 class StateSequence{
   protected:
-    std::deque<std::pair<int,T>> state_sequence_;
+    MpscQueue<std::pair<int,T>> state_sequence_;
 
   public:
-    StateSequence() { state_sequence_.clear(); }
-    void addState(int state_id, const T& state_cmd){
-      state_sequence_.push_back( std::make_pair(state_id, state_cmd) );
+    static constexpr int max_states = 64;
+
+    StateSequence() : state_sequence_(max_states) {}
+    // false if the sequence is full
+    bool addState(int state_id, const T& state_cmd){
+      return state_sequence_.push( std::make_pair(state_id, state_cmd) );
     }
+    // control thread
     bool getNextState(int& state_id, T& state_cmd){
-      if(state_sequence_.empty()) return false;
-      auto pair = state_sequence_.front();
-      state_id = pair.first;
-      state_cmd = pair.second;
-      state_sequence_.pop_front();
-      return true;
+      return state_sequence_.consume([&](std::pair<int,T>& state) {
+        state_id = state.first;
+        state_cmd = state.second;
+      }, 1) > 0;
     }
     int getNumStates(){
       return state_sequence_.size();
     }
-};
\ No newline at end of file
+};
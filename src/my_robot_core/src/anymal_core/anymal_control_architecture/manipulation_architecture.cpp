@@ -1,7 +1,15 @@
 
 #include <my_robot_core/anymal_core/anymal_control_architecture/anymal_control_architecture_set.hpp>
 #include <my_robot_core/anymal_core/anymal_state_provider.hpp>
+#include <my_utils/IO/Trace.hpp>
+#include <my_utils/IO/LogChannel.hpp>
+#include <my_utils/IO/StageTiming.hpp>
 
+MY_LOG_CHANNEL(log_fsm_state, "fsm_state", 1, 1, true);
+static const std::array<my_utils::LogChannel, ANYmal::n_leg> log_wrf =
+    my_utils::makeLogChannels(ANYmalFoot::Names, "_Wrf", 3);
+MY_TIMING_STAGE(timing_state_machine, "state_machine", 0.);
+MY_TIMING_STAGE(timing_wbc, "wbc", 0.);
 
 ANYmalManipulationControlArchitecture::ANYmalManipulationControlArchitecture(RobotSystem* _robot)
     : ControlArchitecture(_robot) {
@@ -64,12 +72,16 @@ void ANYmalManipulationControlArchitecture::getCommand(void* _command) {
     b_state_first_visit_ = false;
   }
 
-  state_machines_[state_]->oneStep();
+  {
+    MY_TIMING_PROBE(timing_state_machine);
+    state_machines_[state_]->oneStep();
+  }
   
   // Get Wholebody control commands
   if (state_ == ANYMAL_STATES::INITIALIZE) {
     getIVDCommand(_command);
   } else {
+    MY_TIMING_PROBE(timing_wbc);
     wbc_controller->getCommand(_command);
   }
 
@@ -109,8 +121,9 @@ void ANYmalManipulationControlArchitecture::getCommand(void* _command) {
 
 void ANYmalManipulationControlArchitecture::addState(
   StateIdentifier _state_id, void* _user_state_command) {
-  states_sequence_->addState( 
-    _state_id, *((ManipulationCommand*)_user_state_command) );
+  if(!states_sequence_->addState( 
+    _state_id, *((ManipulationCommand*)_user_state_command) ))
+    MY_TRACE_WARN("state sequence full, state {} dropped", _state_id);
 }
 
 ///////////////////////////////////////////////////////////////////////
@@ -174,18 +187,12 @@ void ANYmalManipulationControlArchitecture::saveData() {
   // 
   //  fsm state
   double state_val = (double) state_;
-  my_utils::saveValue( state_val, "fsm_state" );
+  MY_LOG(log_fsm_state, state_val);
 
 
   // weights
-  std::string filename;
-  Eigen::VectorXd W_tmp;
-  for(int i(0); i<ANYmal::n_leg; ++i) {
-    filename = ANYmalFoot::Names[i] + "_Wrf";    
-    W_tmp = ws_container_->feet_weights_[i]->getWrf();
-    my_utils::saveVector(W_tmp, filename);
-
-  }
+  for(int i(0); i<ANYmal::n_leg; ++i)
+    MY_LOG(log_wrf[i], ws_container_->feet_weights_[i]->getWrf());
 
 
 }
@@ -1,7 +1,20 @@
 
 #include <my_robot_core/anymal_core/anymal_control_architecture/anymal_control_architecture_set.hpp>
 #include <my_robot_core/anymal_core/anymal_state_provider.hpp>
-
+#include <my_utils/IO/LogChannel.hpp>
+#include <my_utils/IO/StageTiming.hpp>
+#include <my_utils/IO/Trace.hpp>
+
+MY_LOG_CHANNEL(log_fsm_state, "fsm_state", 1, 1, true);
+MY_LOG_CHANNEL(log_support_margin, "support_margin", 1, 1, true);
+MY_LOG_CHANNEL(log_mpc_stat, "centroidal_mpc_stat", 5, 1, true);
+MY_LOG_CHANNEL(log_service_stat, "com_planner_service_stat", 6, 1, true);
+static const std::array<my_utils::LogChannel, ANYmal::n_leg> log_wrf =
+    my_utils::makeLogChannels(ANYmalFoot::Names, "_Wrf", 3);
+MY_TIMING_STAGE(timing_slip_observer, "slip_observer", 0.);
+MY_TIMING_STAGE(timing_state_machine, "state_machine", 0.);
+MY_TIMING_STAGE(timing_mpc_update, "centroidal_mpc_update", 0.);
+MY_TIMING_STAGE(timing_wbc, "wbc", 0.);
 
 ANYmalMpcControlArchitecture::ANYmalMpcControlArchitecture(RobotSystem* _robot)
     : ControlArchitecture(_robot) {
@@ -22,6 +35,9 @@ ANYmalMpcControlArchitecture::ANYmalMpcControlArchitecture(RobotSystem* _robot)
   slip_ob_ = new SlipObserver(ws_container_, robot_);
   slip_ob_data_ = new SlipObserverData();
 
+  com_planner_service_ = new ANYmalCoMPlannerService(robot_);
+  centroidal_mpc_ = new ANYmalCentroidalMPC();
+
   states_sequence_ = new StateSequence<MotionCommand>();
   user_cmd_ = MotionCommand();
 
@@ -40,6 +56,7 @@ ANYmalMpcControlArchitecture::ANYmalMpcControlArchitecture(RobotSystem* _robot)
   prev_state_ = ANYMAL_STATES::INITIALIZE;
   b_state_first_visit_ = true;
   b_env_param_updated_ = false;
+  state_count_ = 0;
   sp_->curr_state = state_;
   
   _InitializeParameters();
@@ -53,6 +70,10 @@ ANYmalMpcControlArchitecture::~ANYmalMpcControlArchitecture() {
   delete slip_ob_;
   delete slip_ob_data_;
 
+  // stop the solver threads first
+  delete com_planner_service_;
+  delete centroidal_mpc_;
+
   // Delete the state machines
   // delete state_machines_[ANYMAL_STATES::INITIALIZE];
   // delete state_machines_[ANYMAL_STATES::STAND];
@@ -69,14 +90,20 @@ void ANYmalMpcControlArchitecture::getCommand(void* _command) {
 
   // --------------------------------------------------
   // State Estimator / Observer
-  std::cout<<"slip observer"<<std::endl;
-  slip_ob_->checkVelocity();    
-  slip_ob_->checkForce();
+  MY_TRACE_DEBUG("slip observer");
+  {
+    MY_TIMING_PROBE(timing_slip_observer);
+    slip_ob_->checkVelocity();    
+    slip_ob_->checkForce();
+  }
 
   // --------------------------------------------------
 
+  // swap in the replan result at the start of the tick
+  if(com_planner_service_->isEnabled()) applyCoMReplan();
+
   // Initialize State
-  std::cout<<"first visit"<<std::endl;
+  MY_TRACE_DEBUG("first visit");
   if (b_state_first_visit_) {
     state_machines_[state_]->firstVisit();
     b_state_first_visit_ = false;
@@ -89,10 +116,15 @@ void ANYmalMpcControlArchitecture::getCommand(void* _command) {
       ComMotionCommand mc_com;
       double passed_time = sp_->curr_time-state_machines_[state_]->getStateMachineStartTime() ;
       double ctrl_start_time = sp_->curr_time;
-      if( mc_curr.foot_motion_given ) {  
+      if( mc_curr.foot_motion_given && com_planner_service_->isEnabled() ) {
+        requestCoMReplan(passed_time);
+      } else if( mc_curr.foot_motion_given ) {  
         switch(state_){
           case ANYMAL_STATES::BALANCE:
-          std::cout<<"fullsupport replan / passed_time= "<<passed_time<<std::endl;
+          MY_TRACE_INFO("fullsupport replan / passed_time= {}", passed_time);
+          // move the com goal if the estimated friction makes it infeasible
+          rg_container_->com_sequence_planner_->searchCoMGoal(
+                                          ws_container_->feet_contacts_);
           rg_container_->com_sequence_planner_->replanCentroidalMotionPreSwing(
                                           ws_container_->feet_contacts_);
           
@@ -102,10 +134,10 @@ void ANYmalMpcControlArchitecture::getCommand(void* _command) {
                        ->setCoMTrajectory(ctrl_start_time, mc_com);
           break;
           case ANYMAL_STATES::SWING_START_TRANS:
-          std::cout<<"swing start replan / ";
+          MY_TRACE_INFO("swing start replan");
           passed_time = 0.;
           case ANYMAL_STATES::SWING:
-          std::cout<<"swing replan / passed_time= "<<passed_time<<std::endl;
+          MY_TRACE_INFO("swing replan / passed_time= {}", passed_time);
           rg_container_->com_sequence_planner_->replanCentroidalMotionSwing(
                                           ws_container_->feet_contacts_,
                                           passed_time);
@@ -120,23 +152,31 @@ void ANYmalMpcControlArchitecture::getCommand(void* _command) {
     }
   }
 
-  std::cout<<"one step"<<std::endl;
-  state_machines_[state_]->oneStep();
+  MY_TRACE_DEBUG("one step");
+  {
+    MY_TIMING_PROBE(timing_state_machine);
+    state_machines_[state_]->oneStep();
+  }
 
   // Update State Machine
   if(prev_state_ != ANYMAL_STATES::INITIALIZE){  
     slip_ob_->weightShaping();
   }
   
-  std::cout<<"wbc get command"<<std::endl;
+  MY_TRACE_DEBUG("wbc get command");
   // Get Wholebody control commands
   if (state_ == ANYMAL_STATES::INITIALIZE) {
     getIVDCommand(_command);
   } else {
+    {
+      MY_TIMING_PROBE(timing_mpc_update);
+      updateCentroidalMPC();
+    }
+    MY_TIMING_PROBE(timing_wbc);
     wbc_controller->getCommand(_command);
   }
 
-  std::cout<<"end state"<<std::endl;
+  MY_TRACE_DEBUG("end state");
   // Save Data
   saveData();
 
@@ -149,6 +189,7 @@ void ANYmalMpcControlArchitecture::getCommand(void* _command) {
     sp_->curr_state = state_;
     sp_->curr_motion_command = (MotionCommand)user_cmd_;
     b_state_first_visit_ = true;
+    ++state_count_;
 
     // if(states_sequence_->getNumStates()==0)
     //   exit(0);
@@ -158,13 +199,138 @@ void ANYmalMpcControlArchitecture::getCommand(void* _command) {
 
 void ANYmalMpcControlArchitecture::addState(StateIdentifier _state_id, 
                                             void* _user_state_command) {
-  states_sequence_->addState( _state_id, 
-                            *((MotionCommand*)_user_state_command) );
+  if(!states_sequence_->addState( _state_id, 
+                            *((MotionCommand*)_user_state_command) ))
+    MY_TRACE_WARN("state sequence full, state {} dropped", _state_id);
 }
 
 
 ///////////////////////////////////////////////////////////////////////
 
+void ANYmalMpcControlArchitecture::requestCoMReplan(double passed_time) {
+  ANYmalCoMPlanner* planner = rg_container_->com_sequence_planner_;
+  switch(state_){
+    case ANYMAL_STATES::BALANCE:
+    com_planner_service_->requestPreSwingReplan(planner,
+                              ws_container_->feet_contacts_, state_count_);
+    break;
+    case ANYMAL_STATES::SWING_START_TRANS:
+    passed_time = 0.;
+    case ANYMAL_STATES::SWING:
+    com_planner_service_->requestSwingReplan(planner,
+                              ws_container_->feet_contacts_, state_count_,
+                              passed_time);
+    break;
+  }
+}
+
+void ANYmalMpcControlArchitecture::applyCoMReplan() {
+  com_planner_service_->countTick();
+  if(!com_planner_service_->swapResult()) return;
+
+  const ANYmalCoMPlanResult& res = com_planner_service_->getResult();
+  ANYmalCoMPlanner* planner = rg_container_->com_sequence_planner_;
+  bool b_applied = true;
+  if(!b_state_first_visit_ && res.state_count == state_count_) {
+    // same state, restart the com trajectory from the current desired
+    planner->setPlanData(res.plan);
+    double passed_time = 
+      sp_->curr_time - state_machines_[state_]->getStateMachineStartTime();
+    ComMotionCommand mc_com;
+    if(res.type == ANYmalCoMPlanRequest::PRE_SWING) {
+      mc_com = planner->getFullSupportCoMCmdReplaned(passed_time);
+    } else {
+      if(state_ == ANYMAL_STATES::SWING_START_TRANS) passed_time = 0.;
+      mc_com = planner->getSwingCoMCmdReplaned(passed_time);
+    }
+    rg_container_->com_trajectory_manager_
+                 ->setCoMTrajectory(sp_->curr_time, mc_com);
+  } else if(b_state_first_visit_ && res.state_count == state_count_-1) {
+    // finished at the transition, the new state starts from it
+    planner->setPlanData(res.plan);
+  } else {
+    b_applied = false;
+  }
+
+  if(b_applied) {
+    if(res.b_sampled) {
+      sp_->feasible_com_list = res.feasible_com_list;
+      sp_->com_pos_target = res.plan.p_goal;
+      sp_->check_com_planner_updated++;
+    }
+    com_planner_service_->markApplied();
+  } else {
+    com_planner_service_->markStale();
+  }
+
+  // [request to available(ms), request to swap(ms), applied, 
+  //  stale ticks, stale results, replaced requests]
+  Eigen::Matrix<double, 6, 1> service_stat;
+  service_stat << com_planner_service_->getLastLatency(),
+                  com_planner_service_->getLastApplyLatency(),
+                  (double)b_applied,
+                  (double)com_planner_service_->getNumStaleTicks(),
+                  (double)com_planner_service_->getNumStale(),
+                  (double)com_planner_service_->getNumReplaced();
+  MY_LOG(log_service_stat, service_stat);
+}
+
+void ANYmalMpcControlArchitecture::updateCentroidalMPC() {
+  if(!centroidal_mpc_->isEnabled()) return;
+
+  // new state and contact schedule when the solver thread asks for it
+  if(centroidal_mpc_->isInputRequested()) {
+    mpc_input_.time = sp_->curr_time;
+    mpc_input_.mass = robot_->getRobotMass();
+    mpc_input_.com_pos = sp_->com_pos;
+    mpc_input_.com_vel = sp_->com_vel;
+    mpc_input_.ang_mom = sp_->mom.head(3);
+
+    // the swing foot lands at the end of the foot trajectory, 
+    // the other feet are assumed to stay over the horizon
+    for(int i(0); i<ANYmal::n_leg; ++i) {
+      mpc_input_.b_contact[i] = ws_container_->b_feet_contact_list_[i];
+      mpc_input_.foot_pos[i] = sp_->foot_pos[i].head(3);
+      mpc_input_.foot_mu[i] = ws_container_->feet_contacts_[i]->getFrictionCoeff();
+      mpc_input_.max_fz[i] = ws_container_->feet_contacts_[i]->getMaxFz();
+      if(mpc_input_.b_contact[i]) {
+        mpc_input_.switch_time[i] = std::numeric_limits<double>::infinity();
+        mpc_input_.foot_pos_next[i] = mpc_input_.foot_pos[i];
+      } else {
+        mpc_input_.switch_time[i] = 
+            rg_container_->foot_trajectory_manager_->getTrajEndTime();
+        mpc_input_.foot_pos_next[i] = sp_->foot_pos_target.head(3);
+        mpc_input_.max_fz[i] = ws_container_->max_rf_z_contact_;
+      }
+    }
+
+    int n_step = centroidal_mpc_->getNumSteps();
+    double dt = centroidal_mpc_->getStepTime();
+    mpc_input_.com_pos_ref.resize(n_step);
+    mpc_input_.com_vel_ref.resize(n_step);
+    for(int k(0); k<n_step; ++k) {
+      rg_container_->com_trajectory_manager_->getCoMReference(
+                                      sp_->curr_time + (k+1)*dt,
+                                      mpc_input_.com_pos_ref[k],
+                                      mpc_input_.com_vel_ref[k]);
+    }
+    centroidal_mpc_->setInput(mpc_input_);
+  }
+
+  // latest solution interpolated at the current time
+  Eigen::Vector3d com_pos, com_vel, com_acc;
+  std::array<Eigen::Vector3d, ANYmal::n_leg> foot_force;
+  if(centroidal_mpc_->getReference(sp_->curr_time, 
+                                  com_pos, com_vel, com_acc, foot_force)) {
+    wbc_controller->setCentroidalReference(com_pos, com_vel, com_acc,
+                                  centroidal_mpc_->useCoMReference());
+    if(centroidal_mpc_->useForceReference())
+      wbc_controller->setCentroidalReference(foot_force);
+  } else {
+    wbc_controller->clearCentroidalReference();
+  }
+}
+
 void ANYmalMpcControlArchitecture::getIVDCommand(void* _cmd) {
   Eigen::VectorXd tau_cmd = Eigen::VectorXd::Zero(ANYmal::n_adof);
   Eigen::VectorXd des_jpos = Eigen::VectorXd::Zero(ANYmal::n_adof);
@@ -224,23 +390,46 @@ void ANYmalMpcControlArchitecture::_InitializeParameters() {
                   ->initialization(cfg_["transition_params"]);
 
   slip_ob_->initialization(cfg_["slip_observer_params"]);
+
+  // Planner initialization
+  rg_container_->com_sequence_planner_
+                ->paramInitialization(cfg_["com_planner_params"]);
+  com_planner_service_->initialization(cfg_["com_planner_service_params"]);
+  if(com_planner_service_->isEnabled()) {
+    // the sampler runs on the service planner only
+    com_planner_service_->plannerInitialization(cfg_["com_planner_params"],
+                                                cfg_["com_sampler_params"]);
+    com_planner_service_->start();
+  } else {
+    rg_container_->com_sequence_planner_
+                  ->samplerInitialization(cfg_["com_sampler_params"]);
+  }
+
+  centroidal_mpc_->initialization(cfg_["centroidal_mpc_params"]);
+  centroidal_mpc_->start();
 }
 
 void ANYmalMpcControlArchitecture::saveData() {
   // 
   //  fsm state
   double state_val = (double) state_;
-  my_utils::saveValue( state_val, "fsm_state" );
+  MY_LOG(log_fsm_state, state_val);
+  MY_LOG(log_support_margin, sp_->support_margin);
 
 
   // weights
-  std::string filename;
-  Eigen::VectorXd W_tmp;
-  for(int i(0); i<ANYmal::n_leg; ++i) {
-    filename = ANYmalFoot::Names[i] + "_Wrf";    
-    W_tmp = ws_container_->feet_weights_[i]->getWrf();
-    my_utils::saveVector(W_tmp, filename);
-
+  for(int i(0); i<ANYmal::n_leg; ++i)
+    MY_LOG(log_wrf[i], ws_container_->feet_weights_[i]->getWrf());
+
+  // centroidal mpc timing
+  if(centroidal_mpc_->isEnabled()) {
+    Eigen::Matrix<double, 5, 1> mpc_stat;
+    mpc_stat << centroidal_mpc_->getLastSolveTime(), 
+                centroidal_mpc_->getMaxSolveTime(),
+                (double)centroidal_mpc_->getNumSolve(),
+                (double)centroidal_mpc_->getNumDeadlineMiss(),
+                (double)centroidal_mpc_->getNumWarmSolve();
+    MY_LOG(log_mpc_stat, mpc_stat);
   }
 
 
@@ -1,5 +1,6 @@
 #include <my_robot_core/anymal_core/anymal_control_architecture/anymal_control_architecture_set.hpp>
 #include <my_robot_core/anymal_core/anymal_state_provider.hpp>
+#include <my_utils/IO/Trace.hpp>
 
 ANYmalWblcControlArchitecture::ANYmalWblcControlArchitecture(RobotSystem* _robot)
     : ControlArchitecture(_robot) {
@@ -96,8 +97,9 @@ void ANYmalWblcControlArchitecture::getCommand(void* _command) {
 
 void ANYmalWblcControlArchitecture::addState(StateIdentifier _state_id, 
                                             void* _user_state_command) {
-  states_sequence_->addState( _state_id, 
-                            *((MotionCommand*)_user_state_command) );
+  if(!states_sequence_->addState( _state_id, 
+                            *((MotionCommand*)_user_state_command) ))
+    MY_TRACE_WARN("state sequence full, state {} dropped", _state_id);
 }
 
 ///////////////////////////////////////////////////////////////////////
@@ -1,10 +1,10 @@
 #include <my_robot_core/anymal_core/anymal_wbc_controller/containers/wbc_spec_container.hpp>
 #include <my_robot_core/anymal_core/anymal_estimator/slip_observer.hpp>
 #include <my_robot_core/anymal_core/anymal_control_architecture/anymal_control_architecture_set.hpp>
-#include <my_utils/Math/pseudo_inverse.hpp>
 
 SlipObserver::SlipObserver( ANYmalWbcSpecContainer* ws_container,
-              RobotSystem* _robot) : StateEstimator(_robot) {
+              RobotSystem* _robot) : StateEstimator(_robot),
+              svd_(max_grf, max_grf, Eigen::ComputeThinU | Eigen::ComputeThinV) {
   my_utils::pretty_constructor(2, "StateEstimator: SlipObserver");
 
   // Set Pointer to wbc spec / reference generator container
@@ -13,107 +13,153 @@ SlipObserver::SlipObserver( ANYmalWbcSpecContainer* ws_container,
   // Get State Provider
   sp_ = ANYmalStateProvider::getStateProvider(robot_);
 
-  // lpf2_container_, kalman filter
-  for(int i(0); i<ANYmal::n_leg; ++i){
-    lpf2_container_[i] = new LowPassFilter2();   
-    kf_container_[i] = new SimpleKalmanFilter(); 
-  }
-
-  // kalman filter setting
-  time_sampling_period_ = 10;
-  kf_sys_ = new SimpleSystemParam();  
-  kf_sys_->F = Eigen::MatrixXd::Identity(2,2);
-  kf_sys_->Q = Eigen::MatrixXd::Zero(2,2);
-  kf_sys_->Q << 0.000004, 0. , 0., 0.01;
-  kf_sys_->H = Eigen::MatrixXd::Identity(time_sampling_period_, 2);
-  kf_sys_->R = 0.1*Eigen::MatrixXd::Identity(time_sampling_period_,time_sampling_period_);
-
-  // set parameters  
+  // workspace, sized once
+  Jc_i_ = Eigen::MatrixXd::Zero(dim_grf, ANYmal::n_dof);
+  vel_meas_.setZero();
+  JcDotQdot_i_ = Eigen::VectorXd::Zero(dim_grf);
+  tau_cg_ = Eigen::VectorXd::Zero(ANYmal::n_dof);
+  log_vel_ = my_utils::makeLogChannels(ANYmalFoot::Names, "_vel_filtered", dim_grf);
+  log_grf_ = my_utils::makeLogChannels(ANYmalFoot::Names, "_grf_act_des", 2*dim_grf);
+  log_param_est_ = my_utils::LogChannel("feet_param_est", 1+ANYmal::n_leg*2);
+
+  // set parameters
   initParams();
   initContact();
+  _initVelocityFilter();
+  _initParameterEstimation();
 
   t_updated_ = sp_->curr_time;
   b_swing_phase_ = false;
+  swing_foot_idx_ = -1;
 }
 
-SlipObserver::~SlipObserver() { 
-    for( auto &lpf2 : lpf2_container_)
-        delete lpf2;
-}
+SlipObserver::~SlipObserver() {}
 
 void SlipObserver::initialization(const YAML::Node& node) {
-    try { 
-        my_utils::readParameter(node,"slip_velocity_threshold", lin_vel_thres_);  
-        my_utils::readParameter(node,"weight_shaping", weight_shaping_activated_); 
-        my_utils::readParameter(node,"online_param_estimation", online_param_estimation_activated_); 
+    try {
+        my_utils::readParameter(node,"slip_velocity_threshold", lin_vel_thres_);
+        my_utils::readParameter(node,"weight_shaping", weight_shaping_activated_);
+        my_utils::readParameter(node,"online_param_estimation", online_param_estimation_activated_);
         my_utils::readParameter(node,"lpf_vel_cutoff", lpf_vel_cutoff_);
+        my_utils::readParameter(node,"velocity_kalman_filter", velocity_kalman_filter_);
+        my_utils::readParameter(node,"vel_kf_acc_noise", vel_kf_acc_noise_);
+        my_utils::readParameter(node,"vel_kf_meas_noise", vel_kf_meas_noise_);
+        my_utils::readParameter(node,"rls_forgetting_factor", rls_forgetting_factor_);
+        my_utils::readParameter(node,"rls_min_normal_force", rls_min_normal_force_);
+        my_utils::readParameter(node,"stiffness_min_sinkage", stiffness_min_sinkage_);
+        my_utils::readParameter(node,"slip_normal_velocity_threshold", slip_normal_vel_thres_);
+        my_utils::readParameter(node,"mu_min_samples", mu_min_samples_);
+        my_utils::readParameter(node,"mu_min", mu_min_);
+        my_utils::readParameter(node,"mu_max", mu_max_);
+        my_utils::readParameter(node,"mu_update_tolerance", mu_update_tol_);
+        my_utils::readParameter(node,"mu_replan_tolerance", mu_replan_tol_);
+        my_utils::readParameter(node,"save_data", b_save_data_);
     } catch (std::runtime_error& e) {
         std::cout << "Error reading parameter [" << e.what() << "] at file: ["
                 << __FILE__ << "]" << std::endl
                 << std::endl;
         exit(0);
-    }  
+    }
+
+    for( auto &lpf2 : lpf2_)
+        lpf2.initialize(lpf_vel_cutoff_);
+    _initVelocityFilter();
+    _initParameterEstimation();
+}
+
+void SlipObserver::_initVelocityFilter() {
+    // constant acceleration between the ticks,
+    // white noise jerk of vel_kf_acc_noise_ [m/s^3/sqrt(Hz)]
+    double dt = ANYmalAux::servo_rate;
+    double qa = vel_kf_acc_noise_*vel_kf_acc_noise_;
+    Eigen::Matrix2d F, Q, P0;
+    F << 1., dt,
+         0., 1.;
+    Q << qa*dt*dt*dt/3., qa*dt*dt/2.,
+         qa*dt*dt/2., qa*dt;
+    vel_kf_.setSystem(F, Q);
+    vel_kf_.setMeasurement(Eigen::Vector2d(1., 0.));
+    vel_kf_.setMeasurementNoise(vel_kf_meas_noise_*vel_kf_meas_noise_);
+    P0 << vel_kf_meas_noise_*vel_kf_meas_noise_, 0.,
+          0., qa*dt;
+    vel_kf_.initialize(Eigen::Vector2d::Zero(), P0);
+}
 
-    for(int i(0); i<ANYmal::n_leg; ++i){
-        lpf2_container_[i]->initialize(
-            ws_container_->feet_contacts_[i]->getDim(), lpf_vel_cutoff_); 
+void SlipObserver::_initParameterEstimation() {
+    // mu starts from the value of the contact spec
+    Eigen::Matrix<double, 1, 1> mu0, P0_mu;
+    Eigen::Vector2d k0;
+    Eigen::Matrix2d P0_k;
+    P0_mu << 1.;
+    k0 << 0., 0.;
+    // k*sinkage_scale and f_0 within about 100 N
+    P0_k << 1e4, 0.,
+            0., 1e4;
+    for(int foot_idx(0); foot_idx<ANYmal::n_leg; ++foot_idx) {
+        mu0 << ws_container_->feet_contacts_[foot_idx]->getFrictionCoeff();
+        mu_rls_[foot_idx].setForgettingFactor(rls_forgetting_factor_);
+        mu_rls_[foot_idx].setMaxCovarianceTrace(P0_mu.trace());
+        mu_rls_[foot_idx].initialize(mu0, P0_mu);
+        stiffness_rls_[foot_idx].setForgettingFactor(rls_forgetting_factor_);
+        stiffness_rls_[foot_idx].setMaxCovarianceTrace(P0_k.trace());
+        stiffness_rls_[foot_idx].initialize(k0, P0_k);
+        b_stance_[foot_idx] = false;
+        foot_z_touchdown_[foot_idx] = 0.;
     }
+    param_est_.setZero();
 }
 
 void SlipObserver::initParams(){
-    Sa_ = Eigen::MatrixXd::Zero(ANYmal::n_adof, ANYmal::n_dof);
-    for(int i=0; i< ANYmal::n_adof; ++i){ Sa_(i, ANYmal::idx_adof[i]) = 1.; }
     weight_shaping_activated_=0;
     online_param_estimation_activated_=0;
     lin_vel_thres_=0.02;
+    b_save_data_=false;
+    velocity_kalman_filter_=0;
+    vel_kf_acc_noise_=10.;
+    vel_kf_meas_noise_=0.005;
+    rls_forgetting_factor_=0.99;
+    rls_min_normal_force_=10.;
+    stiffness_min_sinkage_=2e-4;
+    slip_normal_vel_thres_=0.001;
+    mu_min_samples_=10;
+    mu_min_=0.1;
+    mu_max_=0.7;
+    mu_update_tol_=0.01;
+    mu_replan_tol_=0.1;
 }
 
 void SlipObserver::initContact(){
-    int dim_grf;
     for( int foot_idx(0); foot_idx<ANYmal::n_leg; foot_idx++ )
     {
-        b_foot_contact_map_[foot_idx] =  true;
-        dim_grf = ws_container_->feet_contacts_[foot_idx]->getDim();
-
-        dim_grf_map_[foot_idx] = dim_grf;
-        foot_vel_map_[foot_idx] = Eigen::VectorXd::Zero(dim_grf); 
-        foot_acc_map_[foot_idx] = Eigen::VectorXd::Zero(dim_grf);         
-        grf_des_map_[foot_idx] = Eigen::VectorXd::Zero(dim_grf);
-    }   
+        b_foot_contact_[foot_idx] = true;
+        foot_vel_[foot_idx].setZero();
+        foot_acc_[foot_idx].setZero();
+        grf_act_[foot_idx].setZero();
+        grf_des_[foot_idx].setZero();
+        grf_des_wbc_[foot_idx].setZero();
+    }
 }
 
 void SlipObserver::updateContact(){
+    // computed once per robot update, ANYmalWBC reuses them
+    ws_container_->update_feet_contact_kinematics();
+
     // one time update
     if( t_updated_ < sp_->curr_time ) {
         t_updated_ = sp_->curr_time;
         b_swing_phase_ = (sp_->curr_state == ANYMAL_STATES::SWING);
 
-        // update kinematics
-        q_ = robot_->getQ();
-        qdot_ = robot_->getQdot();
-        qddot_ = robot_->getQddot();  
-
-        // update dynamics
-        Minv_ = robot_->getInvMassMatrix();
-        grav_ = robot_->getGravity();
-        coriolis_ = robot_->getCoriolis();       
-
         // update contact
-        initContact();
-        swing_foot_idx_ = sp_->curr_motion_command.get_moving_foot();        
-        for( int foot_idx(0); foot_idx<ANYmal::n_leg; foot_idx++ ){
-            ws_container_->feet_contacts_[foot_idx]->updateContactSpec();
-            if( b_swing_phase_ && swing_foot_idx_ == foot_idx ) {
-                    b_foot_contact_map_[foot_idx] = false; }            
-        }
+        swing_foot_idx_ = sp_->curr_motion_command.get_moving_foot();
+        for( int foot_idx(0); foot_idx<ANYmal::n_leg; foot_idx++ )
+            b_foot_contact_[foot_idx] =
+                    !( b_swing_phase_ && swing_foot_idx_ == foot_idx );
 
-        // update sensed GRF value
+        // update sensed GRF value, force part of the wrench
         for(int i(0); i<ANYmal::n_leg; ++i){
-            grf_act_map_[i] = sp_->foot_rf[i];
-            grf_des_map2_[i] = sp_->foot_rf_des[i];
+            grf_act_[i] = sp_->foot_rf[i].tail<dim_grf>();
+            grf_des_wbc_[i] = sp_->foot_rf_des[i].tail<dim_grf>();
         }
-        
-
     }
 }
 
@@ -123,6 +169,19 @@ void SlipObserver::checkVelocity(){
     checkVelocityFoot(ANYmalFoot::RF);
     checkVelocityFoot(ANYmalFoot::LH);
     checkVelocityFoot(ANYmalFoot::RH);
+    if(velocity_kalman_filter_==0) return;
+
+    // all the feet at once
+    vel_kf_.predict();
+    vel_kf_.update(vel_meas_);
+    for(int foot_idx(0); foot_idx<ANYmal::n_leg; ++foot_idx) {
+        foot_vel_[foot_idx] = vel_kf_.getState().col(0)
+                        .segment<dim_grf>(foot_idx*dim_grf).matrix();
+        foot_acc_[foot_idx] = vel_kf_.getState().col(1)
+                        .segment<dim_grf>(foot_idx*dim_grf).matrix();
+        if(b_save_data_)
+            MY_LOG(log_vel_[foot_idx], foot_vel_[foot_idx]);
+    }
 }
 
 void SlipObserver::checkVelocityFoot(int foot_idx) {
@@ -131,233 +190,185 @@ void SlipObserver::checkVelocityFoot(int foot_idx) {
     updateContact();
 
     auto contact = ws_container_->feet_contacts_[foot_idx];
-    
-    Eigen::MatrixXd Jc;
-    Eigen::VectorXd JcDotQdot;
-
-    contact->getContactJacobian(Jc);
-    contact->getJcDotQdot(JcDotQdot);
-
-    Eigen::VectorXd xcdot = Jc*qdot_;
-    Eigen::VectorXd xcddot = Jc*qddot_ + JcDotQdot;
-
-    Eigen::VectorXd xcdot_filtered = lpf2_container_[foot_idx]->update(xcdot);
-    
-    foot_vel_map_[foot_idx] = xcdot_filtered; // xcdot;
-    foot_acc_map_[foot_idx] = xcddot;
+    contact->getContactJacobian(Jc_i_);
+    contact->getJcDotQdot(JcDotQdot_i_);
+
+    // the accelerations of the robot model are not set, qddot = 0
+    xcdot_.noalias() = Jc_i_*sp_->qdot;
+    if(velocity_kalman_filter_) {
+        // filtered in checkVelocity
+        vel_meas_.segment<dim_grf>(foot_idx*dim_grf) = xcdot_.array();
+        return;
+    }
+    foot_acc_[foot_idx] = JcDotQdot_i_;
+    foot_vel_[foot_idx] = lpf2_[foot_idx].update(xcdot_);
 
     // data saving
-    std::string foot_vel_name = ANYmalFoot::Names[foot_idx] + "_vel";
-    // my_utils::saveVector(xcdot, foot_vel_name);    
-
-    foot_vel_name = ANYmalFoot::Names[foot_idx] + "_vel_filtered";
-    my_utils::saveVector(xcdot_filtered, foot_vel_name);    
+    if(b_save_data_)
+        MY_LOG(log_vel_[foot_idx], foot_vel_[foot_idx]);
 }
 
 void SlipObserver::checkForce() {
-    // std::cout<<" checkForce " << std::endl;
-    // update grf_act_map_
-    updateContact();    
+    // update grf_act_
+    updateContact();
     // compute desired value
-    Eigen::VectorXd tau = sp_->tau_cmd_prev;
-    Eigen::VectorXd grf_des_stacked = computeGRFDesired(tau);    
-    int dim_grf_stacked = 0;
-    int dim_grf=0;
-    for ( auto &[foot_idx, b_contact] : b_foot_contact_map_) {
-        // desired force (estimated from observation)
-        if(b_contact){
-            dim_grf = dim_grf_map_[foot_idx];
-            grf_des_map_[foot_idx] = grf_des_stacked.segment(dim_grf_stacked, dim_grf);
-            dim_grf_stacked += dim_grf;         
-        } else{
-            grf_des_map_[foot_idx] = Eigen::VectorXd::Zero(6);
-        }    
-    }
+    computeGRFDesired(sp_->tau_cmd_prev);
+
     // DATA SAVING
-    std::string filename;
-    Eigen::VectorXd grf_act_des;
-    for( auto &[foot_idx, b_contact] : b_foot_contact_map_ ) {
-        filename = ANYmalFoot::Names[foot_idx] + "_grf_act_des";
-        dim_grf = dim_grf_map_[foot_idx];
-        grf_act_des = Eigen::VectorXd::Zero(2*dim_grf);
-        grf_act_des.head(dim_grf) = grf_act_map_[foot_idx];
-        // grf_act_des.tail(dim_grf) = grf_des_map_[foot_idx];
-        grf_act_des.tail(dim_grf) = grf_des_map2_[foot_idx];       
-        // my_utils::pretty_print(grf_act_des, std::cout, "grf_act_des"); 
-        my_utils::saveVector(grf_act_des, filename);
+    if(!b_save_data_) return;
+    for(int foot_idx(0); foot_idx<ANYmal::n_leg; ++foot_idx) {
+        grf_act_des_.head<dim_grf>() = grf_act_[foot_idx];
+        // grf_act_des_.tail<dim_grf>() = grf_des_[foot_idx];
+        grf_act_des_.tail<dim_grf>() = grf_des_wbc_[foot_idx];
+        MY_LOG(log_grf_[foot_idx], grf_act_des_);
     }
 }
 
 bool SlipObserver::estimateParameters(){
+    // O(1) per foot and tick, the estimated mu replaces the one of the
+    // friction cone of the contact spec, returns true if it changed
+    // enough to replan the com motion
+    if(online_param_estimation_activated_==0) return false;
+    updateContact();
+
+    Eigen::Matrix<double, 1, 1> phi_mu;
+    Eigen::Vector2d phi_k;
+    bool b_updated = false;
+    for( int foot_idx(0); foot_idx<ANYmal::n_leg; ++foot_idx) {
+        const Eigen::Isometry3d& T_wf =
+            robot_->getBodyNodeIsometry(ANYmalFoot::LinkIdx[foot_idx]);
+        // grf_act_ is in the foot frame, foot_vel_ in the ground frame
+        grf_world_.noalias() = T_wf.linear()*grf_act_[foot_idx];
+        double fz = grf_world_[2];
+        if( !b_foot_contact_[foot_idx] || fz < rls_min_normal_force_ ) {
+            b_stance_[foot_idx] = false;
+            continue;
+        }
+
+        // contact stiffness
+        double z = T_wf.translation()[2];
+        if( !b_stance_[foot_idx] ) {
+            foot_z_touchdown_[foot_idx] = z;
+            b_stance_[foot_idx] = true;
+        }
+        double d = foot_z_touchdown_[foot_idx] - z;
+        if( fabs(d) > stiffness_min_sinkage_ ) {
+            phi_k << d/sinkage_scale, 1.;
+            stiffness_rls_[foot_idx].update(phi_k, fz);
+        }
 
-    // if(online_param_estimation_activated_==0) return false;
-
-    // double mu;
-    // Eigen::VectorXd x0 = Eigen::VectorXd::Zero(2); // mu, mu*fm
-    // Eigen::VectorXd t_x0 = Eigen::VectorXd::Zero(3); 
-
-    // bool b_updated = false;
-    // // check if slip occurs
-    // for( auto& [foot_idx, xcdot] : foot_vel_map_) {
-    //     if( foot_idx!=swing_foot_idx_ ) {
-    //         // detect slip
-    //         if( fabs(xcdot[5]) < 0.001 && xcdot.segment(3,2).norm() > lin_vel_thres_ ) {
-    //             // std::cout<< " slip detected at foot[" << foot_idx << "], under swing foot[";
-    //             // std::cout<<swing_foot_idx_<<"], phase="<<sp_->curr_state<<", fz=" <<grf_act_map_[foot_idx][5]<<std::endl;
-    //             // std::cout<< " slip detected, vel=" << xcdot.segment(3,3).transpose() << std::endl;
-    //             stacked_grf_map_[foot_idx].push_back( grf_act_map_[foot_idx] );
-
-    //             // kalman filter
-    //             if( stacked_grf_map_[foot_idx].size() == time_sampling_period_){      
-    //                 // controller value              
-    //                 mu = ws_container_->feet_contacts_[foot_idx]->getFrictionCoeff();
-
-    //                 // check initialize
-    //                 if(!kf_container_[foot_idx]->b_initialize) {       
-    //                     x0 << mu;
-    //                     kf_container_[foot_idx]->initialize(x0, kf_sys_->Q);
-    //                     // std::cout<< foot_idx << "th kf initialized with " <<x0.transpose()<< std::endl;
-    //                 }
-
-    //                 Eigen::VectorXd ftemp;
-    //                 Eigen::VectorXd ft = Eigen::VectorXd::Zero(time_sampling_period_);
-    //                 Eigen::VectorXd fz = Eigen::VectorXd::Zero(time_sampling_period_);
-    //                 for(int tt(0); tt<time_sampling_period_; ++tt){
-    //                     ftemp = stacked_grf_map_[foot_idx][tt];
-    //                     if(ftemp.size() == 6){
-    //                         ft(tt)= std::sqrt(ftemp(3)*ftemp(3) + ftemp(4)*ftemp(4));
-    //                         fz(tt) = ftemp(5);
-    //                     }else{ // ==3
-    //                         ft(tt)= std::sqrt(ftemp(0)*ftemp(0) + ftemp(1)*ftemp(1));
-    //                         fz(tt) = ftemp(2);
-    //                     }                        
-    //                 }
-    //                 stacked_grf_map_[foot_idx].pop_front();
-
-    //                 // kalman filter
-    //                 kf_sys_->H = Eigen::MatrixXd::Constant(time_sampling_period_, 2 ,1.);
-    //                 kf_sys_->H.col(0)=fz;
-    //                 kf_container_[foot_idx]->propagate(ft, x0, kf_sys_);                    
-
-    //                 // update new parameter
-    //                 double errchange = kf_container_[foot_idx]->getErrorChange();
-
-    //                 std::string foot_param_name = ANYmalFoot::Names[foot_idx] + "_param";
-    //                 t_x0 << sp_->curr_time, x0(0), x0(1);
-    //                 my_utils::saveVector(t_x0, foot_param_name);
-
-    //                 if(errchange < 0.01){
-    //                     // data saving
-    //                     foot_param_name += "_consistent";
-    //                     my_utils::saveVector(t_x0, foot_param_name); 
-
-    //                     // check safe region
-    //                     if(x0(0) > 0.1 && x0(0) < 0.7){               
-                       
-    //                         if( fabs(mu-x0(0)) < 0.01 ) continue; // no need to update
-
-    //                         if( fabs(mu-x0(0)) > 0.1 ) b_updated = true; // replanning
-                            
-    //                         mu = x0(0);
-
-    //                         foot_param_name += "_safe";
-    //                         my_utils::saveVector(t_x0, foot_param_name);                         
-
-    //                         std::cout<< foot_idx << "th param update : mu= "<<mu ", errchange="<<errchange<<std::endl;
-
-    //                         ws_container_->feet_contacts_[foot_idx]->setFrictionCoeff(mu);                            
-    //                     }
-    //                     // else{
-    //                     //     kf_container_[foot_idx]->b_initialize = false;
-    //                     // }
-    //                 }
-                    
-    //             }
-
-    //         } else{
-    //             stacked_grf_map_[foot_idx].clear();
-    //             kf_container_[foot_idx]->b_initialize = false;
-    //         }
-    //     }
-    // }
-    // return b_updated;
-    return false;
+        // friction, observable only while the foot slides on the ground
+        const Eigen::Vector3d& xcdot = foot_vel_[foot_idx];
+        if( fabs(xcdot[2]) > slip_normal_vel_thres_ ||
+            xcdot.head<2>().norm() < lin_vel_thres_ ) continue;
+        // std::cout<< " slip detected at foot[" << foot_idx << "], under swing foot[";
+        // std::cout<<swing_foot_idx_<<"], phase="<<sp_->curr_state<<", fz=" <<fz<<std::endl;
+        phi_mu << fz;
+        mu_rls_[foot_idx].update(phi_mu, grf_world_.head<2>().norm());
+        if( mu_rls_[foot_idx].getNumUpdate() < mu_min_samples_ ) continue;
+
+        // check safe region
+        double mu_est = mu_rls_[foot_idx].getParameter(0);
+        mu_est = std::max(mu_min_, std::min(mu_max_, mu_est));
+        double mu = ws_container_->feet_contacts_[foot_idx]->getFrictionCoeff();
+        if( fabs(mu - mu_est) < mu_update_tol_ ) continue; // no need to update
+        if( fabs(mu - mu_est) > mu_replan_tol_ ) b_updated = true; // replanning
+
+        // std::cout<< foot_idx << "th param update : mu= "<<mu_est<<std::endl;
+        // the cone is rebuilt by the next updateContactConstraint
+        ws_container_->setContactFriction(foot_idx, mu_est);
+    }
+
+    // data saving : time, (mu, k) of every foot
+    if(b_save_data_) {
+        param_est_[0] = sp_->curr_time;
+        for( int foot_idx(0); foot_idx<ANYmal::n_leg; ++foot_idx) {
+            param_est_[1+2*foot_idx] = getFrictionEstimate(foot_idx);
+            param_est_[2+2*foot_idx] = getStiffnessEstimate(foot_idx);
+        }
+        MY_LOG(log_param_est_, param_est_);
+    }
+    return b_updated;
 }
 
 void SlipObserver::weightShaping() {
     // reshape the weight w.r.t grf ("ws_container_->W_rf_")
     // climbing_param.yaml
     // w_rf = 1.0, w_rf_z = 0.001 / w_rf_z_nocontact = 0.05
-    // 
-    // if there exists a foot in slippery, we would want to 
+    //
+    // if there exists a foot in slippery, we would want to
     // increase the normal force & decrease the tangential force
     // should decrease w_rf_z, increase w_rf
-    
+
     if(weight_shaping_activated_==0) return;
 
-    double slip_level = 1.0;    
-    for( auto& [foot_idx, xcdot] : foot_vel_map_) {
-        if( foot_idx!=swing_foot_idx_ ) { //!b_swing_phase_ && 
+    double slip_level = 1.0;
+    int moving_cop = swing_foot_idx_ < 0 ? -1 : ANYmalFoot::LinkIdx[swing_foot_idx_];
+    for( int foot_idx(0); foot_idx<ANYmal::n_leg; ++foot_idx) {
+        if( foot_idx!=swing_foot_idx_ ) { //!b_swing_phase_ &&
             // detect slip
-            slip_level = xcdot.tail(3).norm() / lin_vel_thres_;
+            slip_level = foot_vel_[foot_idx].norm() / lin_vel_thres_;
             if( slip_level > 1.0 ) {
                 // std::cout<< " slip detected at foot[" << foot_idx << "], under swing foot[";
                 // std::cout<<swing_foot_idx_<<"], phase="<<sp_->curr_state<<std::endl;
-                
-                ws_container_->reshape_weight_param( slip_level,  
-                                ANYmalFoot::LinkIdx[foot_idx], 
-                                ANYmalFoot::LinkIdx[swing_foot_idx_] );
-            }            
+
+                ws_container_->reshape_weight_param( slip_level,
+                                ANYmalFoot::LinkIdx[foot_idx],
+                                moving_cop );
+            }
         }
     }
 }
 
 
-Eigen::VectorXd SlipObserver::computeGRFDesired(const Eigen::VectorXd& tau) {    
-    
-    Eigen::MatrixXd Jc_i, Jc, Js;
-    Eigen::VectorXd JcDotQdot_i, JcDotQdot;
-    Eigen::VectorXd fa = Eigen::VectorXd::Zero(6); // swing foot adhesive force
-
-    int dim_grf= 0;
-    for( int foot_idx(0); foot_idx<ANYmal::n_leg; foot_idx++ ) {       
-        // foot in contact
-        if( b_foot_contact_map_[foot_idx] ) {
-            ws_container_->feet_contacts_[foot_idx]->getContactJacobian(Jc_i);
-            ws_container_->feet_contacts_[foot_idx]->getJcDotQdot(JcDotQdot_i);
-
-            // stack Matrices & Vectors
-            if(dim_grf==0){
-                Jc = Jc_i;
-                JcDotQdot = JcDotQdot_i;                
-            }else{
-                Jc.conservativeResize(dim_grf + Jc_i.rows(), ANYmal::n_dof);
-                Jc.block(dim_grf, 0, Jc_i.rows(), ANYmal::n_dof) = Jc_i;            
-                JcDotQdot.conservativeResize(dim_grf + Jc_i.rows());
-                JcDotQdot.tail(Jc_i.rows()) = JcDotQdot_i;                
-            }
-            dim_grf += Jc_i.rows();            
-        } // swing foot
-        else {
-            ws_container_->feet_contacts_[foot_idx]->getContactJacobian(Js);
-            int fz_idx = ws_container_->feet_contacts_[foot_idx]->getFzIndex();    
+void SlipObserver::computeGRFDesired(const Eigen::VectorXd& tau) {
+    // stack the jacobians of the feet in contact
+    int dim_grf_stacked = 0;
+    for( int foot_idx(0); foot_idx<ANYmal::n_leg; foot_idx++ )
+        if( b_foot_contact_[foot_idx] ) dim_grf_stacked += dim_grf;
+    Jc_.resize(dim_grf_stacked, ANYmal::n_dof);
+    dim_grf_stacked = 0;
+    for( int foot_idx(0); foot_idx<ANYmal::n_leg; foot_idx++ ) {
+        if( !b_foot_contact_[foot_idx] ) continue;
+        ws_container_->feet_contacts_[foot_idx]->getContactJacobian(Jc_i_);
+        Jc_.middleRows<dim_grf>(dim_grf_stacked) = Jc_i_;
+        dim_grf_stacked += dim_grf;
+    }
+
+    // f_c = inv(Jc *Minv_ * JcT) * ( Jc Minv_ (tau - c - g) - Jc ddq ),
+    // tau is the full torque (zero on the virtual joints), ddq = 0
+    // and the swing foot adhesive force is zero
+    if(dim_grf_stacked > 0) {
+        const Eigen::MatrixXd& Minv = robot_->getInvMassMatrix();
+        JcMinv_.noalias() = Jc_*Minv;
+        A_.noalias() = JcMinv_*Jc_.transpose();
+
+        // my_utils::pseudoInverse(A_, 0.0001, Ainv_)
+        const double sigma_threshold = 0.0001;
+        svd_.compute(A_, Eigen::ComputeThinU | Eigen::ComputeThinV);
+        grf_stacked_ = svd_.singularValues();
+        for(int ii(0); ii < grf_stacked_.size(); ++ii) {
+            double sigma = grf_stacked_(ii);
+            grf_stacked_(ii) = sigma > sigma_threshold ? 1.0/sigma
+                            : sigma/sigma_threshold/sigma_threshold;
         }
+        Ainv_.noalias() = svd_.matrixV()*grf_stacked_.asDiagonal()
+                            *svd_.matrixU().transpose();
+
+        tau_cg_ = tau - robot_->getCoriolis() - robot_->getGravity();
+        grf_stacked_.noalias() = JcMinv_*tau_cg_;
+        grf_stacked_ = Ainv_*grf_stacked_;
     }
 
-    Eigen::MatrixXd Ainv;
-    Eigen::MatrixXd A = Jc*Minv_*Jc.transpose();
-    my_utils::pseudoInverse(A, 0.0001, Ainv);
-    
-    Eigen::VectorXd grf_des = Eigen::VectorXd::Zero(dim_grf);
-    // f_c = inv(Jc *Minv_ * JcT) * ( S'tau + Jc Minv_ JsT fa - Jc ddq - Jc Minv_ (c+g) )
-    if(b_swing_phase_) {
-        grf_des = Ainv * ( Jc*Minv_*( Sa_.transpose()*tau  + Js.transpose()*fa )
-                        - Jc*qddot_ - Jc*Minv_*(coriolis_ + grav_) );
-    }else {
-        grf_des = Ainv * ( Jc*Minv_*Sa_.transpose()*tau
-                        - Jc*qddot_ - Jc*Minv_*(coriolis_ + grav_) );    }
-
-    return grf_des;
+    dim_grf_stacked = 0;
+    for( int foot_idx(0); foot_idx<ANYmal::n_leg; foot_idx++ ) {
+        if( b_foot_contact_[foot_idx] ) {
+            grf_des_[foot_idx] = grf_stacked_.segment<dim_grf>(dim_grf_stacked);
+            dim_grf_stacked += dim_grf;
+        } else {
+            grf_des_[foot_idx].setZero();
+        }
+    }
 }
 
 // void SlipObserver::checkJointConfiguration(int foot_idx) {
@@ -367,4 +378,3 @@ Eigen::VectorXd SlipObserver::computeGRFDesired(const Eigen::VectorXd& tau) {
 void SlipObserver::evaluate() {
 
 }
-
@@ -10,9 +10,18 @@
 #include <my_robot_core/anymal_core/anymal_logic_interrupt/anymal_interrupt_logic_set.hpp>
 
 #include <my_utils/IO/IOUtilities.hpp>
+#include <my_utils/IO/LogChannel.hpp>
+#include <my_utils/IO/StageTiming.hpp>
+#include <my_utils/IO/TelemetryPublisher.hpp>
+#include <my_utils/IO/Trace.hpp>
 #include <my_utils/Math/MathUtilities.hpp>
 #include <string>
 
+MY_TIMING_STAGE(timing_tick, "control_tick", 1e3*ANYmalAux::servo_rate);
+MY_TIMING_STAGE(timing_estimator, "state_estimator", 0.);
+MY_TIMING_STAGE(timing_interrupt, "interrupt", 0.);
+MY_TIMING_STAGE(timing_architecture, "control_architecture", 0.);
+
 ANYmalInterface::ANYmalInterface() : EnvInterface() {
     // ANYmalInterface 
     std::string border = "=";
@@ -40,6 +49,8 @@ ANYmalInterface::ANYmalInterface() : EnvInterface() {
     // interrupt_ = new WalkingInterruptLogic(control_architecture_);  
     interrupt_ = new ManipulationInterruptLogic(control_architecture_);   
 
+    telemetry_ = NULL;
+
     // read from INTERFACE.yaml
     _ParameterSetting(cfg);
 
@@ -60,6 +71,7 @@ ANYmalInterface::~ANYmalInterface() {
     delete state_estimator_;
     delete control_architecture_;
     delete interrupt_;
+    delete telemetry_;
 }
 
 void ANYmalInterface::_ParameterSetting(const YAML::Node& cfg) {      
@@ -78,6 +90,35 @@ void ANYmalInterface::_ParameterSetting(const YAML::Node& cfg) {
             std::string conf = stringStream.str();
             interrupt_->setInterruptRoutine(motion_cfg[conf]);           
         }
+
+        state_estimator_->setParameters(cfg["state_estimator"]);
+
+        // experiment_data/<name>.txt or columnar <name>.bin
+        std::string log_format;
+        my_utils::readParameter(cfg, "log_format", log_format);
+        my_utils::AsyncLogger* logger = my_utils::AsyncLogger::getLogger();
+        if(log_format == "float64")
+            logger->setFileFormat(my_utils::LogFormat::Float64);
+        else if(log_format == "float32")
+            logger->setFileFormat(my_utils::LogFormat::Float32);
+        else
+            logger->setFileFormat(my_utils::LogFormat::Text);
+        logger->setRate(1./ANYmalAux::servo_rate);
+        my_utils::LogChannelRegistry::getRegistry()
+                            ->configure(cfg["log_channels"]);
+
+        // console traces of the control loop
+        std::string trace_level;
+        int trace_rate_limit;
+        my_utils::readParameter(cfg, "trace_level", trace_level);
+        my_utils::readParameter(cfg, "trace_rate_limit", trace_rate_limit);
+        my_utils::TraceLevel level;
+        if(!my_utils::parseTraceLevel(trace_level, level))
+            throw std::runtime_error("trace_level");
+        my_utils::Tracer::getTracer()->setLevel(level);
+        my_utils::Tracer::getTracer()->setRateLimit(trace_rate_limit);
+
+        _TelemetrySetting(cfg["telemetry"]);
         
     } catch (std::runtime_error& e) {
         std::cout << "Error reading parameter [" << e.what() << "] at file: ["
@@ -88,16 +129,53 @@ void ANYmalInterface::_ParameterSetting(const YAML::Node& cfg) {
 }
 
 
+void ANYmalInterface::_TelemetrySetting(const YAML::Node& cfg) {
+    bool b_enabled;
+    my_utils::readParameter(cfg, "enabled", b_enabled);
+    if(!b_enabled) return;
+
+    std::string endpoint;
+    int state_decimation, contact_decimation, command_decimation;
+    my_utils::readParameter(cfg, "endpoint", endpoint);
+    my_utils::readParameter(cfg["decimation"], "robot_state", state_decimation);
+    my_utils::readParameter(cfg["decimation"], "contact_forces", contact_decimation);
+    my_utils::readParameter(cfg["decimation"], "wbc_command", command_decimation);
+
+    telemetry_ = new my_utils::TelemetryPublisher();
+    telemetry_state_ = telemetry_->addTopic("robot_state",
+        {{"virtual_q", ANYmal::n_vdof}, {"q", ANYmal::n_adof},
+         {"virtual_qdot", ANYmal::n_vdof}, {"qdot", ANYmal::n_adof}},
+        state_decimation);
+    telemetry_contact_ = telemetry_->addTopic("contact_forces",
+        {{"foot_wrench", 6*ANYmal::n_leg}, {"b_foot_contact", ANYmal::n_leg}},
+        contact_decimation);
+    telemetry_command_ = telemetry_->addTopic("wbc_command",
+        {{"jpos", ANYmal::n_adof}, {"jvel", ANYmal::n_adof},
+         {"jtrq", ANYmal::n_adof}}, command_decimation);
+    if(!telemetry_->start(endpoint)) {
+        delete telemetry_;
+        telemetry_ = NULL;
+    }
+}
+
 void ANYmalInterface::getCommand(void* _data, void* _command) {
     ANYmalCommand* cmd = ((ANYmalCommand*)_command);
     ANYmalSensorData* data = ((ANYmalSensorData*)_data);
-    
+    MY_TIMING_PROBE(timing_tick);
 
     if(!_Initialization(data, cmd)) {
-        state_estimator_->Update(data); // robot skelPtr in robotSystem updated 
-        interrupt_->processInterrupts();
-        control_architecture_->getCommand(cmd);
-        
+        {
+            MY_TIMING_PROBE(timing_estimator);
+            state_estimator_->Update(data); // robot skelPtr in robotSystem updated 
+        }
+        {
+            MY_TIMING_PROBE(timing_interrupt);
+            interrupt_->processInterrupts();
+        }
+        {
+            MY_TIMING_PROBE(timing_architecture);
+            control_architecture_->getCommand(cmd);
+        }
         
         if(!_CheckCommand(cmd)) { _SetStopCommand(data,cmd); }    
     }   
@@ -107,6 +185,8 @@ void ANYmalInterface::getCommand(void* _data, void* _command) {
 
     running_time_ = ((double)count_)*ANYmalAux::servo_rate;
     sp_->curr_time = running_time_;
+    my_utils::AsyncLogger::getLogger()->setTime(running_time_);
+    if(telemetry_) _PublishTelemetry(data, cmd);
     ++count_;
 }
 
@@ -147,6 +227,24 @@ void ANYmalInterface::_SaveDataCmd(ANYmalSensorData* data, ANYmalCommand* cmd)
     cmd_jpos_ = cmd->q;
 }
 
+void ANYmalInterface::_PublishTelemetry(ANYmalSensorData* data, ANYmalCommand* cmd) {
+    // copied into the ring of the publisher, sent by its thread
+    double values[my_utils::TelemetryPublisher::max_values];
+    Eigen::Map<Eigen::VectorXd> state(values, 2*ANYmal::n_dof);
+    state << data->virtual_q, data->q, data->virtual_qdot, data->qdot;
+    telemetry_->publish(telemetry_state_, values, 2*ANYmal::n_dof, running_time_);
+
+    for(int leg(0); leg<ANYmal::n_leg; ++leg) {
+        Eigen::Map<Eigen::VectorXd>(values + 6*leg, 6) = data->foot_wrench[leg];
+        values[6*ANYmal::n_leg + leg] = data->b_foot_contact[leg] ? 1. : 0.;
+    }
+    telemetry_->publish(telemetry_contact_, values, 7*ANYmal::n_leg, running_time_);
+
+    Eigen::Map<Eigen::VectorXd> command(values, 3*ANYmal::n_adof);
+    command << cmd->q, cmd->qdot, cmd->jtrq;
+    telemetry_->publish(telemetry_command_, values, 3*ANYmal::n_adof, running_time_);
+}
+
 bool ANYmalInterface::IsPlannerUpdated() {
     if (check_com_planner_updated == sp_->check_com_planner_updated) {
         return false;
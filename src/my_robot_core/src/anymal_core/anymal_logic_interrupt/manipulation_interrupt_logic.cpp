@@ -1,5 +1,6 @@
 #include <my_robot_core/anymal_core/anymal_logic_interrupt/manipulation_interrupt_logic.hpp>
 #include <my_robot_core/anymal_core/anymal_control_architecture/anymal_control_architecture_set.hpp>
+#include <my_utils/IO/Trace.hpp>
 
 ManipulationInterruptLogic::ManipulationInterruptLogic(
         ControlArchitecture* _ctrl_arch)
@@ -16,13 +17,14 @@ ManipulationInterruptLogic::~ManipulationInterruptLogic() {}
 
 // Process Interrupts here
 void ManipulationInterruptLogic::processInterrupts() {   
-  if(b_button_pressed) {
+  // the buttons pressed since the previous tick, in order
+  while(nextFlags()) {
     // std::cout << "[Walking Interrupt Logic] button pressed : " << pressed_button << std::endl;
     switch(pressed_button){
       case 's':
-        std::cout << "[Manipulation Interrupt Logic] button S pressed" << std::endl;
-        std::cout << "---------                        ---------" << std::endl;
-        std::cout << "---------     SCRIPT MOTION      ---------" << std::endl;
+        MY_TRACE_INFO("[Manipulation Interrupt Logic] button S pressed\n"
+                      "---------                        ---------\n"
+                      "---------     SCRIPT MOTION      ---------");
         if (ctrl_arch_->getState() == ANYMAL_STATES::BALANCE) {
           // set stateMachine sequences
           for(auto &it : script_user_cmd_deque_) {
@@ -35,9 +37,9 @@ void ManipulationInterruptLogic::processInterrupts() {
         }
       break;
       case 'w':
-        std::cout << "[Manipulation Interrupt Logic] button w pressed" << std::endl;
-        std::cout << "---------                        ---------" << std::endl;
-        std::cout << "---------          EE up         ---------" << std::endl;
+        MY_TRACE_INFO("[Manipulation Interrupt Logic] button w pressed\n"
+                      "---------                        ---------\n"
+                      "---------          EE up         ---------");
         if (ctrl_arch_->getState() == ANYMAL_STATES::BALANCE) {
           POSE_DATA pose_up(0,0,0.01, 1,0,0,0);
           addStateCommand(ANYMAL_STATES::MANIPULATION, 
@@ -46,9 +48,9 @@ void ManipulationInterruptLogic::processInterrupts() {
         }
       break;
       case 'x':
-        std::cout << "[Manipulation Interrupt Logic] button x pressed" << std::endl;
-        std::cout << "---------                        ---------" << std::endl;
-        std::cout << "---------         EE down        ---------" << std::endl;
+        MY_TRACE_INFO("[Manipulation Interrupt Logic] button x pressed\n"
+                      "---------                        ---------\n"
+                      "---------         EE down        ---------");
         if (ctrl_arch_->getState() == ANYMAL_STATES::BALANCE) {
           POSE_DATA pose_dn(0,0,-0.01, 1,0,0,0);
           addStateCommand(ANYMAL_STATES::MANIPULATION, 
@@ -64,8 +66,8 @@ void ManipulationInterruptLogic::processInterrupts() {
 }
 
 void ManipulationInterruptLogic::addStateCommand(int _state_id, const ManipulationCommand& _mc){
-  ManipulationCommand* user_state_cmd = new ManipulationCommand(_mc);
-  ctrl_arch_->addState(_state_id, user_state_cmd);
+  // copied into the state sequence
+  ctrl_arch_->addState(_state_id, const_cast<ManipulationCommand*>(&_mc));
 }
 
 void ManipulationInterruptLogic::setInterruptRoutine(const YAML::Node& motion_cfg){
@@ -1,5 +1,6 @@
 #include <my_robot_core/anymal_core/anymal_logic_interrupt/walking_interrupt_logic.hpp>
 #include <my_robot_core/anymal_core/anymal_control_architecture/anymal_control_architecture_set.hpp>
+#include <my_utils/IO/Trace.hpp>
 
 WalkingInterruptLogic::WalkingInterruptLogic(
         ControlArchitecture* _ctrl_arch)
@@ -16,13 +17,14 @@ WalkingInterruptLogic::~WalkingInterruptLogic() {}
 
 // Process Interrupts here
 void WalkingInterruptLogic::processInterrupts() {   
-  if(b_button_pressed) {
+  // the buttons pressed since the previous tick, in order
+  while(nextFlags()) {
     // std::cout << "[Walking Interrupt Logic] button pressed : " << pressed_button << std::endl;
     switch(pressed_button){
       case 's':
-        std::cout << "[Walking Interrupt Logic] button S pressed" << std::endl;
-        std::cout << "---------                        ---------" << std::endl;
-        std::cout << "---------     SCRIPT MOTION      ---------" << std::endl;
+        MY_TRACE_INFO("[Walking Interrupt Logic] button S pressed\n"
+                      "---------                        ---------\n"
+                      "---------     SCRIPT MOTION      ---------");
         if (ctrl_arch_->getState() == ANYMAL_STATES::BALANCE) {
           // set stateMachine sequences
           for(auto &it : script_user_cmd_deque_) {
@@ -37,9 +39,9 @@ void WalkingInterruptLogic::processInterrupts() {
         }
       break;
       case 'w':
-        std::cout << "[Walking Interrupt Logic] button w pressed" << std::endl;
-        std::cout << "---------                        ---------" << std::endl;
-        std::cout << "---------     com up      ---------" << std::endl;
+        MY_TRACE_INFO("[Walking Interrupt Logic] button w pressed\n"
+                      "---------                        ---------\n"
+                      "---------     com up      ---------");
         if (ctrl_arch_->getState() == ANYMAL_STATES::BALANCE) {
           POSE_DATA pose_up(0,0,0.01, 1,0,0,0);
           addStateCommand(ANYMAL_STATES::BALANCE, 
@@ -47,9 +49,9 @@ void WalkingInterruptLogic::processInterrupts() {
         }
       break;
       case 'x':
-        std::cout << "[Walking Interrupt Logic] button x pressed" << std::endl;
-        std::cout << "---------                        ---------" << std::endl;
-        std::cout << "---------     com down      ---------" << std::endl;
+        MY_TRACE_INFO("[Walking Interrupt Logic] button x pressed\n"
+                      "---------                        ---------\n"
+                      "---------     com down      ---------");
         if (ctrl_arch_->getState() == ANYMAL_STATES::BALANCE) {
           POSE_DATA pose_dn(0,0,-0.01, 1,0,0,0);
           addStateCommand(ANYMAL_STATES::BALANCE, 
@@ -64,8 +66,8 @@ void WalkingInterruptLogic::processInterrupts() {
 }
 
 void WalkingInterruptLogic::addStateCommand(int _state_id, const MotionCommand& _mc){
-  MotionCommand* user_state_cmd = new MotionCommand(_mc);
-  ctrl_arch_->addState(_state_id, user_state_cmd);
+  // copied into the state sequence
+  ctrl_arch_->addState(_state_id, const_cast<MotionCommand*>(&_mc));
 }
 
 void WalkingInterruptLogic::setInterruptRoutine(const YAML::Node& motion_cfg){
@@ -0,0 +1,376 @@
+#include <my_robot_core/anymal_core/anymal_planner/anymal_centroidal_mpc.hpp>
+#include <my_wbc/QuadProgSolver.hpp>
+#include <my_utils/IO/StageTiming.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <cmath>
+
+MY_TIMING_STAGE(timing_centroidal_mpc, "centroidal_mpc_solve", 0.);
+
+namespace {
+inline void skewInPlace(const Eigen::Vector3d& w, Eigen::Matrix3d& Wx) {
+    Wx <<   0.0,   -w(2),  w(1),
+           w(2),     0.0, -w(0),
+          -w(1),    w(0),  0.0;
+}
+}
+
+CentroidalMPCInput::CentroidalMPCInput() {
+    time = 0.;
+    mass = 0.;
+    com_pos.setZero();
+    com_vel.setZero();
+    ang_mom.setZero();
+    for(int i(0); i<ANYmal::n_leg; ++i) {
+        b_contact[i] = true;
+        switch_time[i] = std::numeric_limits<double>::infinity();
+        foot_pos[i].setZero();
+        foot_pos_next[i].setZero();
+        foot_mu[i] = 0.;
+        max_fz[i] = 0.;
+    }
+}
+
+CentroidalMPCOutput::CentroidalMPCOutput() {
+    time = 0.;
+    dt = 0.;
+    n_step = 0;
+    mass = 0.;
+}
+
+ANYmalCentroidalMPC::ANYmalCentroidalMPC() {
+    my_utils::pretty_constructor(3, "ANYmal Centroidal MPC");
+
+    b_enabled_ = false;
+    b_use_com_ref_ = true;
+    b_use_force_ref_ = true;
+    b_warm_start_ = false;
+    rate_ = 50.;
+    n_step_ = 10;
+    dt_ = 0.05;
+    Q_ = Eigen::VectorXd::Ones(dim_x);
+    w_force_ = 1e-5;
+    grav_ << 0., 0., -9.81;
+
+    qp_solver_ = new QuadProgSolver();
+    qp_solver_->setVerbose(false);
+    qp_solver_->setWarmStart(b_warm_start_);
+
+    b_running_ = false;
+    b_input_requested_ = false;
+    b_new_input_ = false;
+    b_new_output_ = false;
+    b_output_valid_ = false;
+
+    num_solve_ = 0;
+    num_failed_ = 0;
+    num_deadline_miss_ = 0;
+    num_warm_solve_ = 0;
+    last_solve_time_ = 0.;
+    max_solve_time_ = 0.;
+    sum_solve_time_ = 0.;
+}
+
+ANYmalCentroidalMPC::~ANYmalCentroidalMPC() {
+    stop();
+    delete qp_solver_;
+}
+
+void ANYmalCentroidalMPC::initialization(const YAML::Node& node) {
+    Eigen::VectorXd w_pos, w_vel, w_ang_mom;
+    try {
+        my_utils::readParameter(node,"enable", b_enabled_);
+        my_utils::readParameter(node,"use_com_reference", b_use_com_ref_);
+        my_utils::readParameter(node,"use_force_reference", b_use_force_ref_);
+        my_utils::readParameter(node,"warm_start", b_warm_start_);
+        my_utils::readParameter(node,"rate", rate_);
+        my_utils::readParameter(node,"horizon", n_step_);
+        my_utils::readParameter(node,"dt", dt_);
+        my_utils::readParameter(node,"weight_pos", w_pos);
+        my_utils::readParameter(node,"weight_vel", w_vel);
+        my_utils::readParameter(node,"weight_ang_mom", w_ang_mom);
+        my_utils::readParameter(node,"weight_force", w_force_);
+    } catch (std::runtime_error& e) {
+        std::cout << "Error reading parameter [" << e.what() << "] at file: ["
+                << __FILE__ << "]" << std::endl
+                << std::endl;
+        exit(0);
+    }
+    Q_ << w_pos, w_vel, w_ang_mom;
+    qp_solver_->setWarmStart(b_warm_start_);
+
+    // x+ = A*x + B_k*u_k + d
+    A_.setIdentity();
+    A_.block<3,3>(0,3) = dt_*Eigen::Matrix3d::Identity();
+    d_.setZero();
+    d_.segment<3>(0) = 0.5*dt_*dt_*grav_;
+    d_.segment<3>(3) = dt_*grav_;
+
+    // every buffer is sized once for the horizon
+    int n_opt = dim_u*n_step_;
+    int n_ieq = dim_cone*ANYmal::n_leg*n_step_;
+    B_.assign(n_step_, Eigen::Matrix<double, dim_x, dim_u>::Zero());
+    contact_.resize(n_step_);
+    Su_.setZero(dim_x*n_step_, n_opt);
+    X0_.setZero(dim_x*n_step_);
+    Xref_.setZero(dim_x*n_step_);
+    QSu_.setZero(dim_x*n_step_, n_opt);
+    H_.setZero(n_opt, n_opt);
+    f_.setZero(n_opt);
+    Aieq_.setZero(n_ieq, n_opt);
+    bieq_.setZero(n_ieq);
+    U_.setZero(n_opt);
+
+    output_solve_.com_pos.resize(n_step_+1);
+    output_solve_.com_vel.resize(n_step_+1);
+    output_solve_.foot_force.resize(n_step_);
+    output_ = output_solve_;
+    output_ctrl_ = output_solve_;
+    input_.com_pos_ref.resize(n_step_);
+    input_.com_vel_ref.resize(n_step_);
+    input_solve_ = input_;
+}
+
+void ANYmalCentroidalMPC::start() {
+    if(!b_enabled_ || b_running_) return;
+    b_running_ = true;
+    thread_ = std::thread(&ANYmalCentroidalMPC::_run, this);
+}
+
+void ANYmalCentroidalMPC::stop() {
+    if(!b_running_) return;
+    b_running_ = false;
+    input_cv_.notify_all();
+    thread_.join();
+}
+
+bool ANYmalCentroidalMPC::setInput(const CentroidalMPCInput& input) {
+    {
+        std::unique_lock<std::mutex> lock(input_mtx_, std::try_to_lock);
+        if(!lock.owns_lock()) return false;
+        input_ = input;
+        b_new_input_ = true;
+        b_input_requested_ = false;
+    }
+    input_cv_.notify_one();
+    return true;
+}
+
+bool ANYmalCentroidalMPC::getReference(double time,
+                    Eigen::Vector3d& com_pos,
+                    Eigen::Vector3d& com_vel,
+                    Eigen::Vector3d& com_acc,
+                    std::array<Eigen::Vector3d, ANYmal::n_leg>& foot_force) {
+    {
+        // keep the last copy if the solver thread is publishing
+        std::unique_lock<std::mutex> lock(output_mtx_, std::try_to_lock);
+        if(lock.owns_lock() && b_new_output_) {
+            output_ctrl_ = output_;
+            b_new_output_ = false;
+            b_output_valid_ = true;
+        }
+    }
+    if(!b_output_valid_) return false;
+
+    double s = time - output_ctrl_.time;
+    if(s < 0. || s > output_ctrl_.n_step*output_ctrl_.dt) return false;
+
+    // forces are held over the step
+    int k = std::min((int)(s/output_ctrl_.dt), output_ctrl_.n_step-1);
+    double tau = s - k*output_ctrl_.dt;
+    foot_force = output_ctrl_.foot_force[k];
+    com_acc = grav_;
+    for(int i(0); i<ANYmal::n_leg; ++i)
+        com_acc += foot_force[i]/output_ctrl_.mass;
+    com_pos = output_ctrl_.com_pos[k] + tau*output_ctrl_.com_vel[k]
+                + 0.5*tau*tau*com_acc;
+    com_vel = output_ctrl_.com_vel[k] + tau*com_acc;
+    return true;
+}
+
+double ANYmalCentroidalMPC::getMeanSolveTime() {
+    int n = num_solve_.load();
+    if(n > 0) return sum_solve_time_.load() / (double)n;
+    return 0.;
+}
+
+bool ANYmalCentroidalMPC::solve(const CentroidalMPCInput& input,
+                                CentroidalMPCOutput& output) {
+    clock_.start();
+
+    _buildDynamics(input);
+    _buildCost(input);
+    _buildConstraints(input);
+
+    qp_solver_->setProblem(H_, f_, Aieq_, bieq_);
+    double cost = qp_solver_->solveProblem(U_);
+    bool b_solved = (cost != std::numeric_limits<double>::infinity());
+
+    if(b_solved) {
+        output.time = input.time;
+        output.dt = dt_;
+        output.n_step = n_step_;
+        output.mass = input.mass;
+        output.com_pos.resize(n_step_+1);
+        output.com_vel.resize(n_step_+1);
+        output.foot_force.resize(n_step_);
+        output.com_pos[0] = input.com_pos;
+        output.com_vel[0] = input.com_vel;
+        X0_.noalias() += Su_*U_;
+        for(int k(0); k<n_step_; ++k) {
+            output.com_pos[k+1] = X0_.segment<3>(dim_x*k);
+            output.com_vel[k+1] = X0_.segment<3>(dim_x*k+3);
+            for(int i(0); i<ANYmal::n_leg; ++i)
+                output.foot_force[k][i] = U_.segment<3>(dim_u*k + 3*i);
+        }
+    }
+
+    // statistics
+    double solve_time = clock_.stop();
+    my_utils::StageTiming::getStageTiming()->record(timing_centroidal_mpc,
+                                                    (uint64_t)(solve_time*1e6));
+    last_solve_time_ = solve_time;
+    if(solve_time > max_solve_time_.load()) max_solve_time_ = solve_time;
+    sum_solve_time_ = sum_solve_time_.load() + solve_time;
+    ++num_solve_;
+    if(!b_solved) ++num_failed_;
+    if(qp_solver_->isWarmStarted()) ++num_warm_solve_;
+    return b_solved;
+}
+
+void ANYmalCentroidalMPC::_run() {
+    typedef std::chrono::steady_clock steady_clock;
+    steady_clock::duration period =
+        std::chrono::duration_cast<steady_clock::duration>(
+            std::chrono::duration<double>(1./rate_));
+    steady_clock::time_point next_time = steady_clock::now();
+    bool b_input;
+
+    while(b_running_) {
+        next_time += period;
+
+        // ask the control thread for the current state
+        b_input_requested_ = true;
+        {
+            std::unique_lock<std::mutex> lock(input_mtx_);
+            input_cv_.wait_until(lock, next_time - period/2, [this]{
+                return b_new_input_ || !b_running_; });
+            b_input = b_new_input_;
+            if(b_input) input_solve_ = input_;
+            b_new_input_ = false;
+        }
+        if(!b_running_) break;
+
+        if(b_input && solve(input_solve_, output_solve_)) {
+            std::lock_guard<std::mutex> lock(output_mtx_);
+            output_ = output_solve_;
+            b_new_output_ = true;
+        }
+
+        // the solve ran over the period, restart from now
+        steady_clock::time_point now = steady_clock::now();
+        if(now > next_time) {
+            ++num_deadline_miss_;
+            next_time = now;
+        } else {
+            std::this_thread::sleep_until(next_time);
+        }
+    }
+    b_input_requested_ = false;
+}
+
+bool ANYmalCentroidalMPC::_isContact(const CentroidalMPCInput& input,
+                                    int i, double t,
+                                    Eigen::Vector3d& foot_pos) {
+    bool b_switched = (t >= input.switch_time[i]);
+    foot_pos = b_switched ? input.foot_pos_next[i] : input.foot_pos[i];
+    return input.b_contact[i] != b_switched;
+}
+
+void ANYmalCentroidalMPC::_buildDynamics(const CentroidalMPCInput& input) {
+    Eigen::Vector3d ri, p_lin;
+    Eigen::Matrix3d Sx;
+    double t;
+    for(int k(0); k<n_step_; ++k) {
+        // the forces act over [t_k, t_k+1), linearized at the reference
+        t = input.time + k*dt_;
+        p_lin = (k == 0) ? input.com_pos : input.com_pos_ref[k-1];
+        B_[k].setZero();
+        for(int i(0); i<ANYmal::n_leg; ++i) {
+            contact_[k][i] = _isContact(input, i, t + 0.5*dt_, ri);
+            B_[k].block<3,3>(0,3*i).diagonal().setConstant(
+                                            0.5*dt_*dt_/input.mass);
+            B_[k].block<3,3>(3,3*i).diagonal().setConstant(dt_/input.mass);
+            skewInPlace(ri - p_lin, Sx);
+            B_[k].block<3,3>(6,3*i) = dt_*Sx;
+        }
+    }
+
+    // Su(k,j) = A^(k-j)*B_j
+    Eigen::Matrix<double, dim_x, dim_u> M;
+    for(int j(0); j<n_step_; ++j) {
+        M = B_[j];
+        for(int k(j); k<n_step_; ++k) {
+            Su_.block<dim_x, dim_u>(dim_x*k, dim_u*j) = M;
+            M = A_*M;
+        }
+    }
+
+    // free response, Sx*x0 + Sd
+    Eigen::Matrix<double, dim_x, 1> x;
+    x << input.com_pos, input.com_vel, input.ang_mom;
+    for(int k(0); k<n_step_; ++k) {
+        x = A_*x + d_;
+        X0_.segment<dim_x>(dim_x*k) = x;
+    }
+}
+
+void ANYmalCentroidalMPC::_buildCost(const CentroidalMPCInput& input) {
+    // sum_k (x_k - xref_k)'*Q*(x_k - xref_k) + w_force*u_k'*u_k
+    for(int k(0); k<n_step_; ++k) {
+        Xref_.segment<3>(dim_x*k) = input.com_pos_ref[k];
+        Xref_.segment<3>(dim_x*k+3) = input.com_vel_ref[k];
+        Xref_.segment<3>(dim_x*k+6).setZero();
+    }
+    for(int k(0); k<n_step_; ++k)
+        QSu_.middleRows<dim_x>(dim_x*k).noalias() =
+                        Q_.asDiagonal()*Su_.middleRows<dim_x>(dim_x*k);
+    H_.noalias() = Su_.transpose()*QSu_;
+    H_.diagonal().array() += w_force_;
+    f_.noalias() = QSu_.transpose()*(X0_ - Xref_);
+}
+
+void ANYmalCentroidalMPC::_buildConstraints(const CentroidalMPCInput& input) {
+    // per foot, Aieq*f <= bieq
+    //  -fz <= 0, fz <= max_fz, +-fx - mu*fz <= 0, +-fy - mu*fz <= 0
+    // a foot out of contact gets mu = max_fz = 0, i.e. f = 0
+    double mu, max_fz;
+    int row, col;
+    for(int k(0); k<n_step_; ++k) {
+        for(int i(0); i<ANYmal::n_leg; ++i) {
+            row = dim_cone*(ANYmal::n_leg*k + i);
+            col = dim_u*k + 3*i;
+            if(contact_[k][i]) {
+                mu = input.foot_mu[i]/std::sqrt(2.0);
+                max_fz = input.max_fz[i];
+            } else {
+                mu = 0.;
+                max_fz = 0.;
+            }
+            Aieq_(row, col+2) = -1.;
+            Aieq_(row+1, col+2) = 1.;
+            Aieq_(row+2, col) = 1.;
+            Aieq_(row+2, col+2) = -mu;
+            Aieq_(row+3, col) = -1.;
+            Aieq_(row+3, col+2) = -mu;
+            Aieq_(row+4, col+1) = 1.;
+            Aieq_(row+4, col+2) = -mu;
+            Aieq_(row+5, col+1) = -1.;
+            Aieq_(row+5, col+2) = -mu;
+            bieq_.segment<dim_cone>(row).setZero();
+            bieq_(row+1) = max_fz;
+        }
+    }
+}
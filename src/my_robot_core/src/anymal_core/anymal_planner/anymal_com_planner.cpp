@@ -9,9 +9,28 @@
 #include <my_wbc/Contact/GroundFrameContactSpec.hpp>
 
 #include <my_utils/IO/IOUtilities.hpp>
+#include <my_utils/IO/LogChannel.hpp>
+#include <my_utils/IO/StageTiming.hpp>
 #include <my_utils/Math/MathUtilities.hpp>
-#include "my_utils/Math/pseudo_inverse.hpp"
-#include <time.h>
+
+MY_LOG_CHANNEL(log_solve_time, "com_planner_solve_time", 4, 1, true);
+MY_LOG_CHANNEL(log_cache_stat, "com_planner_cache_stat", 5, 1, true);
+MY_TIMING_STAGE(timing_com_planner, "com_planner", 0.);
+
+ANYmalCoMPlanData::ANYmalCoMPlanData() {
+    p_init.setZero();
+    p_goal.setZero();
+    Tf = 0.; Tt1 = 0.; Ts = 0.; Tt2 = 0.;
+    T1 = 0.; T2 = 0.; T3 = 0.;
+    swing_foot_link_idx = -1;
+    swing_foot_dpos.setZero();
+    dir_com_swing.setZero();
+    alpha = 0.;
+    beta = 0.;
+    acc_swing.setZero();
+    p_swing_init.setZero();
+    v_swing_init.setZero();
+}
 
 ANYmalCoMPlanner::ANYmalCoMPlanner(RobotSystem* robot) {
     my_utils::pretty_constructor(3, "ANYmal CoM Hermite Spline Parameter Planner");
@@ -20,6 +39,7 @@ ANYmalCoMPlanner::ANYmalCoMPlanner(RobotSystem* robot) {
     robot_ = robot;
     sp_ = ANYmalStateProvider::getStateProvider(robot_);
     qp_solver_= new QuadProgSolver();
+    qp_solver_swing_ = new QuadProgSolver();
 
     mass_ = robot_->getRobotMass();
     grav_.setZero();
@@ -27,28 +47,134 @@ ANYmalCoMPlanner::ANYmalCoMPlanner(RobotSystem* robot) {
     zero_vel_.setZero();
     Ldot_ = zero_vel_;
 
+    // problem blocks for the maximum number of contacts
+    builder_ = new ANYmalCoMPlannerBuilder();
+    builder_->setMass(mass_);
+    builder_->setAngularMomentumRate(Ldot_);
+    H_.setIdentity();
+    f_.setZero();
+    x_ = Eigen::VectorXd::Zero(3);
+    com_sampler_ = new ANYmalCoMSampler();
+    support_polygon_ = new SupportPolygon(ANYmal::n_leg);
+
+    swing_foot_link_idx_ = -1;
+    swing_foot_idx_ = -1;
+    swing_foot_dpos_.setZero();
+    for(int i(0); i<ANYmal::n_leg; ++i) {
+        foot_pos_[i].setZero();
+        foot_rot_[i].setIdentity();
+        foot_mu_[i] = 0.;
+    }
+
+    solve_time_last_ = 0.;
+    solve_time_max_ = 0.;
+    solve_time_sum_ = 0.;
+    num_solve_ = 0;
+    solve_time_cold_sum_ = 0.;
+    solve_time_warm_sum_ = 0.;
+    num_cold_ = 0;
+    num_warm_ = 0;
+
+    b_incremental_ = false;
+    update_tol_ = 0.;
+    b_save_solve_time_ = false;
+    b_cache_ = false;
+    cache_max_kb_ = 0.;
+    cache_pos_res_ = 1e-3;
+    cache_rot_res_ = 1e-3;
+    cache_mu_res_ = 1e-3;
 
     initialized = false;
     Tt_given_ = 0.0;
 }
 
+ANYmalCoMPlanner::~ANYmalCoMPlanner() {
+    delete qp_solver_;
+    delete qp_solver_swing_;
+    delete builder_;
+    delete com_sampler_;
+    delete support_polygon_;
+}
+
+void ANYmalCoMPlanner::paramInitialization(const YAML::Node& node) {
+    try {
+        my_utils::readParameter(node,"incremental_replan", b_incremental_);
+        my_utils::readParameter(node,"update_tolerance", update_tol_);
+        my_utils::readParameter(node,"save_solve_time", b_save_solve_time_);
+        my_utils::readParameter(node,"contact_set_cache", b_cache_);
+        my_utils::readParameter(node,"cache_max_kb", cache_max_kb_);
+        my_utils::readParameter(node,"cache_pos_resolution", cache_pos_res_);
+        my_utils::readParameter(node,"cache_rot_resolution", cache_rot_res_);
+        my_utils::readParameter(node,"cache_mu_resolution", cache_mu_res_);
+    } catch (std::runtime_error& e) {
+        std::cout << "Error reading parameter [" << e.what() << "] at file: ["
+                << __FILE__ << "]" << std::endl
+                << std::endl;
+        exit(0);
+    }
+
+    // keep unchanged contact blocks and the previous active set
+    if(b_incremental_) builder_->setUpdateTolerance(update_tol_);
+    else builder_->setUpdateTolerance(-1.);
+    qp_solver_->setWarmStart(b_incremental_);
+    qp_solver_swing_->setWarmStart(b_incremental_);
+    // reuse the contact sets of the stances seen before
+    builder_->setCache(b_cache_, cache_max_kb_,
+                cache_pos_res_, cache_rot_res_, cache_mu_res_);
+}
+
+void ANYmalCoMPlanner::samplerInitialization(const YAML::Node& node) {
+    com_sampler_->initialization(node);
+}
+
+bool ANYmalCoMPlanner::searchCoMGoal(
+                const std::array<ContactSpec*, ANYmal::n_leg>& f_contacts) {
+    if(!com_sampler_->isEnabled()) return false;
+
+    readContactConfiguration(f_contacts, foot_pos_, foot_rot_, foot_mu_);
+    bool b_updated = searchCoMGoal();
+
+    // for the plot
+    com_sampler_->getCandidateList(sp_->feasible_com_list);
+    sp_->com_pos_target = p_goal_;
+    sp_->check_com_planner_updated++;
+    return b_updated;
+}
+
+bool ANYmalCoMPlanner::searchCoMGoal() {
+    if(!com_sampler_->isEnabled()) return false;
+
+    _buildProblem();
+    com_sampler_->setProblem(mass_, Ldot_, foot_pos_, foot_rot_, foot_mu_,
+                            swing_foot_idx_, swing_foot_dpos_, T2_, T3_);
+    com_sampler_->sample(p_goal_);
+
+    bool b_updated = false;
+    if( com_sampler_->getRefMargin() < com_sampler_->getMarginThreshold()
+        && com_sampler_->getBestMargin() > com_sampler_->getRefMargin() ) {
+        p_goal_ = com_sampler_->getBestCoM();
+        b_updated = true;
+    }
+    return b_updated;
+}
+
 void ANYmalCoMPlanner::replanCentroidalMotionPreSwing(
                                         const std::array<ContactSpec*, ANYmal::n_leg>& f_contacts){
+    readContactConfiguration(f_contacts, foot_pos_, foot_rot_, foot_mu_);
+    replanCentroidalMotionPreSwing();
+}
 
+void ANYmalCoMPlanner::replanCentroidalMotionPreSwing(){
+    clock_.start();
     // all the process almost same except these happen during the 
 
     // set p_init_, p_goal_, swing_foot_dpos_
     // _setConfigurations(pcom_goal,_motion_command);
     // set matrices
-    _buildFrictionCone(f_contacts);
-    _buildWeightMatrices(f_contacts);
-    _buildPfRf();
-    _buildCentroidalSystemMatrices();
+    _buildProblem();
 
     // 
     // _setPeriods( _motion_command.get_motion_periods() );
-    std::cout<<"Tf_="<<Tf_<<", Tt1_="<<Tt1_<<", Ts_="<<Ts_<<", Tt2="<<Tt2_<<std::endl;
-    std::cout<<"T1_="<<T1_<<", T2_="<<T2_<<", T3_="<<T3_<<std::endl;
 
     // solve problem
     _solveQuadProg(); // get dir_com_swing_, alpha, beta
@@ -57,55 +183,53 @@ void ANYmalCoMPlanner::replanCentroidalMotionPreSwing(
                                 + 0.5*alpha_*T2_*T2_ )*dir_com_swing_;
     v_swing_init_ = (-beta_*T3_ -alpha_*T2_)*dir_com_swing_;
     acc_swing_ = alpha_*dir_com_swing_;
-    
+    _updateSolveTime(clock_.stop(), qp_solver_->isWarmStarted());
 }
 
 void ANYmalCoMPlanner::replanCentroidalMotionSwing(
                                         const std::array<ContactSpec*, ANYmal::n_leg>& f_contacts,
                                         double passed_time){
     if(acc_swing_.norm() > 1e-5){
-        std::cout<<"acc_swing_ ="  <<acc_swing_.transpose() <<std::endl;
         return;
     }
+    readContactConfiguration(f_contacts, foot_pos_, foot_rot_, foot_mu_);
+    replanCentroidalMotionSwing(passed_time);
+}
+
+void ANYmalCoMPlanner::replanCentroidalMotionSwing(double passed_time){
+    if(acc_swing_.norm() > 1e-5){
+        return;
+    }
+    clock_.start();
 
     // set p_init_, p_goal_, swing_foot_dpos_
     // _setConfigurations(pcom_goal,_motion_command);
     // set matrices
-    _buildFrictionCone(f_contacts);
-    _buildWeightMatrices(f_contacts);
-    _buildPfRf();
-    _buildCentroidalSystemMatrices();
+    _buildProblem();
 
     // motion period 
     // _setPeriods( _motion_command.get_motion_periods() );
     T2_ = Ts_ - passed_time;
-    std::cout<<"Tf_="<<Tf_<<", Tt1_="<<Tt1_<<", Ts_="<<Ts_<<", Tt2="<<Tt2_<<std::endl;
-    std::cout<<"T1_="<<T1_<<", T2_="<<T2_<<", T3_="<<T3_<<std::endl;
 
     _solveQuadProgReplan();
 
     acc_swing_ = alpha_*dir_com_swing_;
-
+    _updateSolveTime(clock_.stop(), qp_solver_swing_->isWarmStarted());
 }
 
 void ANYmalCoMPlanner::planCentroidalMotion(const Eigen::Vector3d& pcom_goal,
                                         MotionCommand &_motion_command,
                                         const std::array<ContactSpec*, ANYmal::n_leg>& f_contacts){
-    clock_t start = clock();
+    clock_.start();
     
     // set p_com init & goal, p_swing init & goal
     _setConfigurations(pcom_goal,_motion_command);
 
     // set matrices
-    _buildFrictionCone(f_contacts);
-    _buildWeightMatrices(f_contacts);
-    _buildPfRf();
-    _buildCentroidalSystemMatrices();
+    _buildProblem(f_contacts);
 
     // motion period 
     _setPeriods( _motion_command.get_motion_periods() );
-    std::cout<<"Tf_="<<Tf_<<", Tt1_="<<Tt1_<<", Ts_="<<Ts_<<", Tt2="<<Tt2_<<std::endl;
-    std::cout<<"T1_="<<T1_<<", T2_="<<T2_<<", T3_="<<T3_<<std::endl;
 
     // solve problem
     _solveQuadProg(); // get dir_com_swing_, alpha, beta
@@ -115,11 +239,41 @@ void ANYmalCoMPlanner::planCentroidalMotion(const Eigen::Vector3d& pcom_goal,
     v_swing_init_ = (-beta_*T3_ -alpha_*T2_)*dir_com_swing_;
     acc_swing_ = alpha_*dir_com_swing_;
     
-    clock_t end = clock();
-    double cpu_time_used = ((double) (end - start)) / CLOCKS_PER_SEC;    
-    // std::cout<<" computation time =  "<< cpu_time_used<<std::endl;
-    // my_utils::saveValue(cpu_time_used, "cpu_time_used" );
-    // std::cout<<"########################################################"<<std::endl;
+    _updateSolveTime(clock_.stop(), qp_solver_->isWarmStarted());
+}
+
+void ANYmalCoMPlanner::_updateSolveTime(double time_ms, bool b_warm) {
+    my_utils::StageTiming::getStageTiming()->record(timing_com_planner,
+                                                    (uint64_t)(time_ms*1e6));
+    solve_time_last_ = time_ms;
+    solve_time_max_ = std::max(solve_time_max_, time_ms);
+    solve_time_sum_ += time_ms;
+    ++num_solve_;
+    if(b_warm) {
+        solve_time_warm_sum_ += time_ms;
+        ++num_warm_;
+    } else {
+        solve_time_cold_sum_ += time_ms;
+        ++num_cold_;
+    }
+
+    if(b_save_solve_time_) {
+        // [time(ms), warm started, mean cold, mean warm]
+        Eigen::Vector4d solve_time_info(time_ms, (double)b_warm,
+                        getMeanColdSolveTime(), getMeanWarmSolveTime());
+        MY_LOG(log_solve_time, solve_time_info);
+
+        ContactSetCache<ANYmalCoMPlannerBuilder::ContactSet>* cache 
+                                                    = builder_->getCache();
+        if(cache) {
+            // [hit rate, hits, misses, evictions, entries]
+            Eigen::Matrix<double, 5, 1> cache_info;
+            cache_info << cache->getHitRate(), cache->getNumHit(), 
+                cache->getNumMiss(), cache->getNumEvict(), 
+                cache->getNumEntries();
+            MY_LOG(log_cache_stat, cache_info);
+        }
+    }
 }
 
 ComMotionCommand ANYmalCoMPlanner::getFullSupportCoMCmdReplaned(double passed_time) {
@@ -185,11 +339,11 @@ void ANYmalCoMPlanner::_setConfigurations(const Eigen::Vector3d& pcom_goal,
         swing_foot_link_idx_ = ANYmalFoot::LinkIdx[md.foot_idx];     
         swing_foot_dpos_ = md.dpose.pos;        
         if(md.dpose.is_baseframe){
-            Eigen::MatrixXd Rwb = robot_->getBodyNodeIsometry(ANYmalBodyNode::base).linear();
+            Eigen::Matrix3d Rwb = robot_->getBodyNodeIsometry(ANYmalBodyNode::base).linear();
             swing_foot_dpos_ = Rwb*swing_foot_dpos_;
         }
     }
-    else swing_foot_dpos_ = Eigen::VectorXd::Zero(3);
+    else swing_foot_dpos_.setZero();
 }
 
 void ANYmalCoMPlanner::_setPeriods(const Eigen::VectorXd& periods){
@@ -214,241 +368,99 @@ void ANYmalCoMPlanner::_setPeriods(const Eigen::VectorXd& periods){
     T3_ = Tt2_;
 }
 
-void ANYmalCoMPlanner::_buildCentroidalSystemMatrices(){
-    int dim_f = Rc_.cols();
-    Ac_ = Eigen::MatrixXd::Zero(6, dim_f);
-    Ac_.topRows(3) = Pc_-my_utils::skew(p_goal_)*Rc_;
-    Ac_.bottomRows(3) = Rc_;
-
-    Cc_ = Eigen::VectorXd::Zero(6);
-    Cc_.head(3) = Ldot_;
-    Cc_.tail(3) = -mass_*grav_;
-
-    dim_f = Rf_.cols();
-    Af_ = Eigen::MatrixXd::Zero(6, dim_f);
-    Af_.topRows(3) = Pf_-my_utils::skew(p_goal_)*Rf_;
-    Af_.bottomRows(3) = Rf_;
-
-    Cf_ = Eigen::VectorXd::Zero(6);
-    Cf_.head(3) = Ldot_;
-    Cf_.tail(3) = -mass_*grav_ ;    
-}
-
-void ANYmalCoMPlanner::_buildFrictionCone(
+void ANYmalCoMPlanner::_buildProblem(
     const std::array<ContactSpec*, ANYmal::n_leg>& f_contacts){
-    Df_ = Eigen::MatrixXd::Zero(0,0);
-    Dc_ = Eigen::MatrixXd::Zero(0,0);
-    df_ = Eigen::VectorXd::Zero(0);
-    dc_ = Eigen::VectorXd::Zero(0);
-
-    Eigen::MatrixXd Di;
-    Eigen::VectorXd di;
-    // Di*Fc >= di
-    for(auto &contact : f_contacts) {
-        ((GroundFramePointContactSpec*)contact)->getRFConstraintMtx(Di);
-        ((GroundFramePointContactSpec*)contact)->getRFConstraintVec(di);
-        // exclude maximum fz
-        Di = Di.topRows(5);
-        di = di.head(5);
-        Di(1, 0) = 1.;
-        Df_ = my_utils::dStack(Df_, Di);
-        df_ = my_utils::vStack(df_, di);
-        if(contact->getLinkIdx() != swing_foot_link_idx_){
-            Dc_ = my_utils::dStack(Dc_, Di);
-            dc_ = my_utils::vStack(dc_, di);
-        }
-    }
+    readContactConfiguration(f_contacts, foot_pos_, foot_rot_, foot_mu_);
+    _buildProblem();
 }
 
-void ANYmalCoMPlanner::_buildWeightMatrices(
-    const std::array<ContactSpec*, ANYmal::n_leg>& f_contacts){
-    invWf_ = Eigen::MatrixXd::Zero(0,0);
-    invWc_ = Eigen::MatrixXd::Zero(0,0);
-
-    double mu;
-    Eigen::VectorXd invwi;
-    // Di*Fc >= di
-    for(auto &contact : f_contacts) {
-        mu = contact->getFrictionCoeff();
-        // wi << 1., 1., mu^2;
-        invwi = Eigen::VectorXd::Zero(3);
-        // invwi << 1., 1., 1./mu/mu;
-        // invwi << mu*mu, mu*mu, 1.;
-        invwi << mu*mu, mu*mu, 1.;
-        invWf_ = my_utils::dStack(invWf_, invwi.asDiagonal());
-        if(contact->getLinkIdx() != swing_foot_link_idx_){
-            invWc_ = my_utils::dStack(invWc_, invwi.asDiagonal());
-        }
+void ANYmalCoMPlanner::_buildProblem(){
+    // swing foot at its next desired position
+    swing_foot_idx_ = -1;
+    for(int i(0); i<ANYmal::n_leg; ++i) {
+        if(ANYmalFoot::LinkIdx[i] == swing_foot_link_idx_) 
+            swing_foot_idx_ = i;
+    }
+    for(int i(0); i<ANYmal::n_leg; ++i) {
+        if(i == swing_foot_idx_) support_polygon_->remove(i);
+        else support_polygon_->insert(i, foot_pos_[i].head(2));
     }
+    // friction cones, weights and centroidal dynamics written in place
+    builder_->update(foot_pos_, foot_rot_, foot_mu_,
+                    swing_foot_idx_, swing_foot_dpos_, p_goal_);
 }
 
-void ANYmalCoMPlanner::_buildPfRf() {
-    Pf_ = Eigen::MatrixXd::Zero(0,0);
-    Rf_ = Eigen::MatrixXd::Zero(0,0);
-    Pc_ = Eigen::MatrixXd::Zero(0,0);
-    Rc_ = Eigen::MatrixXd::Zero(0,0);
-
-    Eigen::MatrixXd PRi, Ri;
-    Eigen::VectorXd pi;
-    for(int i(0); i<ANYmal::n_leg; ++i) {        
-        pi = robot_->getBodyNodeIsometry(
+void ANYmalCoMPlanner::readContactConfiguration(
+                const std::array<ContactSpec*, ANYmal::n_leg>& f_contacts,
+                std::array<Eigen::Vector3d, ANYmal::n_leg>& foot_pos,
+                std::array<Eigen::Matrix3d, ANYmal::n_leg>& foot_rot,
+                std::array<double, ANYmal::n_leg>& foot_mu) {
+    for(int i(0); i<ANYmal::n_leg; ++i) {
+        foot_pos[i] = robot_->getBodyNodeIsometry(
             ANYmalFoot::LinkIdx[i]).translation();
-        Ri = robot_->getBodyNodeIsometry(
-            ANYmalFoot::LinkIdx[i]).linear();            
-        PRi = my_utils::skew(pi)*Ri;
-        
-        if(ANYmalFoot::LinkIdx[i] != swing_foot_link_idx_){
-            Pf_ = my_utils::hStack(Pf_, PRi);
-            Rf_ = my_utils::hStack(Rf_, Ri);
-            Pc_ = my_utils::hStack(Pc_, PRi);
-            Rc_ = my_utils::hStack(Rc_, Ri);
-        }
-        else{
-            // next desired foot position
-            pi += swing_foot_dpos_;
-            PRi = my_utils::skew(pi)*Ri;
-            Pf_ = my_utils::hStack(Pf_, PRi);
-            Rf_ = my_utils::hStack(Rf_, Ri);
-        }
+        foot_rot[i] = robot_->getBodyNodeIsometry(
+            ANYmalFoot::LinkIdx[i]).linear();
+        foot_mu[i] = f_contacts[i]->getFrictionCoeff();
     }
 }
 
-void ANYmalCoMPlanner::_getSwingConditionReplan(Eigen::MatrixXd& DD,
-                                                Eigen::VectorXd& dd) {
-    // Centroidal Dynamics
-    // A*Fc = B*alpha*dir + C
-    // solve Fc with weighted inverse matirx
-    // Fc = invA*(B*delP + C)
-
-    Eigen::MatrixXd AWA = Af_*invWf_*Af_.transpose();
-    Eigen::MatrixXd AWAinv;
-    my_utils::pseudoInverse(AWA, 0.0001, AWAinv);
-
-    Eigen::MatrixXd invA = invWf_*Af_.transpose()*AWAinv;
-    Eigen::VectorXd ddf = - Df_*invA*Cf_ + df_;
-
-    Eigen::MatrixXd invA1 = invA.leftCols<3>();
-    Eigen::MatrixXd invA2 = invA.rightCols<3>();
-    
-    Eigen::MatrixXd DD1, DD2;
-    // centroidal dynamics soln applied friction cone
-    // D( 0.5*m*(t)^2*invA1*skew(g) + m*invA2)*alpha*pdir >= - D*invA*C + d    
-    // when t=0
-    // DD1*alpha*dir >= ddf
-    DD1 = Df_* mass_*invA2;
-    // when t=Ts
-    // DD2*alpha*dir >= ddf
-    DD2 = Df_*(0.5*mass_*(T2_*T2_)*invA1*my_utils::skew(grav_) + mass_*invA2);
-
-    DD = my_utils::vStack(DD1,DD2);
-    dd = my_utils::vStack(ddf,ddf);    
-}
-
-
-void ANYmalCoMPlanner::_getEndTransitionCondition(Eigen::MatrixXd& DD,
-                                                   Eigen::VectorXd& dd) {
-    // Centroidal Dynamics
-    // A*Fc = B*beta*dir + C
-    // solve Fc with weighted inverse matirx
-    // Fc = invA*(S(s,sddot)*delP + C)
-
-    Eigen::MatrixXd AWA = Af_*invWf_*Af_.transpose();
-    Eigen::MatrixXd AWAinv;
-    my_utils::pseudoInverse(AWA, 0.0001, AWAinv);
-
-    Eigen::MatrixXd invA = invWf_*Af_.transpose()*AWAinv;
-    Eigen::VectorXd ddf = - Df_*invA*Cf_ + df_;
-
-    Eigen::MatrixXd invA1 = invA.leftCols<3>();
-    Eigen::MatrixXd invA2 = invA.rightCols<3>();
-    
-    Eigen::MatrixXd DD1, DD2;
-    // centroidal dynamics soln applied friction cone
-    // D( 0.5*m*(Tt-t)^2*invA1*skew(g) + m*invA2)*beta*pdir + D*invA*C - d >=0    
-    // when t=0
-    // DD1*beta*dir - ddf >=0
-    DD1 = Df_*( 0.5*mass_*(T3_*T3_)*invA1*my_utils::skew(grav_) + mass_*invA2);
-    // when t=Tt
-    // DD2*beta*dir - ddf >=0
-    DD2 = Df_*mass_*invA2;
-
-    DD = my_utils::vStack(DD1,DD2);
-    dd = my_utils::vStack(ddf,ddf);
-}
-
-
-void ANYmalCoMPlanner::_getSwingConditionGivenRatio(double ratio,
-                                                    Eigen::MatrixXd& DD,
-                                                    Eigen::VectorXd& dd){
-    // alpha = ratio*beta
-
-    Eigen::MatrixXd AWA = Ac_*invWc_*Ac_.transpose();
-    Eigen::MatrixXd AWAinv;
-    my_utils::pseudoInverse(AWA, 0.0001, AWAinv);
-
-    Eigen::MatrixXd invA = invWc_*Ac_.transpose()*AWAinv;
-    Eigen::VectorXd ddc = - Dc_*invA*Cc_ + dc_;
-
-    Eigen::MatrixXd invA1 = invA.leftCols<3>();
-    Eigen::MatrixXd invA2 = invA.rightCols<3>();
-
-    Eigen::MatrixXd DDa, DDb;
-    // @ t=0    
-    DDa = _computeSwingDDa(0., invA1, invA2);
-    DDb = _computeSwingDDb(0., invA1);
-    // @ t=T2
-    DDa = my_utils::vStack(DDa, _computeSwingDDa(T2_, invA1, invA2));
-    DDb = my_utils::vStack(DDb, _computeSwingDDb(T2_, invA1));
-    dd = my_utils::vStack(ddc, ddc);
-
-    // @ t=tstar (local maxima)
-    double t_star = T2_ + T3_/2./ratio;
-    if(t_star > 0. && t_star < T2_){
-        DDa = my_utils::vStack(DDa, _computeSwingDDa(t_star, invA1, invA2));
-        DDb = my_utils::vStack(DDb, _computeSwingDDb(t_star, invA1));
-        dd = my_utils::vStack(dd, ddc);
-    }
-    
-    DD = DDa*ratio+DDb;
+void ANYmalCoMPlanner::setContactConfiguration(
+                const std::array<Eigen::Vector3d, ANYmal::n_leg>& foot_pos,
+                const std::array<Eigen::Matrix3d, ANYmal::n_leg>& foot_rot,
+                const std::array<double, ANYmal::n_leg>& foot_mu) {
+    foot_pos_ = foot_pos;
+    foot_rot_ = foot_rot;
+    foot_mu_ = foot_mu;
 }
 
-Eigen::MatrixXd ANYmalCoMPlanner::_computeSwingDDa(double t,
-                                            const Eigen::MatrixXd& invA1,
-                                            const Eigen::MatrixXd& invA2){
-    // Da =  D*( 0.5*m*(T2-t)^2*invA1*skew(g) + m*invA2 );
-    return Dc_*( 0.5*mass_*(T2_-t)*(T2_-t)*invA1*my_utils::skew(grav_) + mass_*invA2);
+void ANYmalCoMPlanner::getPlanData(ANYmalCoMPlanData& data) {
+    data.p_init = p_init_;
+    data.p_goal = p_goal_;
+    data.Tf = Tf_; data.Tt1 = Tt1_; data.Ts = Ts_; data.Tt2 = Tt2_;
+    data.T1 = T1_; data.T2 = T2_; data.T3 = T3_;
+    data.swing_foot_link_idx = swing_foot_link_idx_;
+    data.swing_foot_dpos = swing_foot_dpos_;
+    data.dir_com_swing = dir_com_swing_;
+    data.alpha = alpha_;
+    data.beta = beta_;
+    data.acc_swing = acc_swing_;
+    data.p_swing_init = p_swing_init_;
+    data.v_swing_init = v_swing_init_;
 }
 
-Eigen::MatrixXd ANYmalCoMPlanner::_computeSwingDDb(double t,
-                                            const Eigen::MatrixXd& invA1){
-    // Db = D*( 0.5*m*T3*(T3+2*T2-t)*invA1*skew(g) );
-    return Dc_*( 0.5*mass_*T3_*(T3_+2*T2_-t)*invA1*my_utils::skew(grav_) );
+void ANYmalCoMPlanner::setPlanData(const ANYmalCoMPlanData& data) {
+    p_init_ = data.p_init;
+    p_goal_ = data.p_goal;
+    Tf_ = data.Tf; Tt1_ = data.Tt1; Ts_ = data.Ts; Tt2_ = data.Tt2;
+    T1_ = data.T1; T2_ = data.T2; T3_ = data.T3;
+    swing_foot_link_idx_ = data.swing_foot_link_idx;
+    swing_foot_dpos_ = data.swing_foot_dpos;
+    dir_com_swing_ = data.dir_com_swing;
+    alpha_ = data.alpha;
+    beta_ = data.beta;
+    acc_swing_ = data.acc_swing;
+    p_swing_init_ = data.p_swing_init;
+    v_swing_init_ = data.v_swing_init;
 }
 
 void ANYmalCoMPlanner::_solveQuadProgReplan(){
     /* -- 1. solve alpha for swing phase --*/
-    Eigen::MatrixXd DDs;
-    Eigen::VectorXd dds;
+    builder_->clearConstraints();
+    builder_->addSwingConditionReplan(T2_);
 
-    _getSwingConditionReplan(DDs, dds);
     // solve quad prob for x = alpha*dir
     // min 0.5*x'*x
     // s.t. -DDs*x <= -dds
-    std::cout<<"########################################################"<<std::endl;
-    Eigen::VectorXd x;
-    qp_solver_->setProblem(Eigen::MatrixXd::Identity(3,3),
-                        Eigen::VectorXd::Zero(3),-DDs,-dds);
-    qp_solver_->solveProblem(x);
+    qp_solver_swing_->setProblem(H_, f_, 
+                builder_->getIeqMtx(), builder_->getIeqVec());
+    qp_solver_swing_->solveProblem(x_);
 
-    alpha_ = x.norm();
+    alpha_ = x_.norm();
 
-    if(std::fabs(alpha_) > 1e-5) dir_com_swing_ = x/alpha_;
-    else dir_com_swing_ = Eigen::VectorXd::Zero(3);
+    if(std::fabs(alpha_) > 1e-5) dir_com_swing_ = x_/alpha_;
+    else dir_com_swing_.setZero();
    
-    std::cout<<" dir_com_swing= " << dir_com_swing_.transpose() << std::endl;
-    std::cout<<" alpha= " <<alpha_ << std::endl;
     if(alpha_>0.5) alpha_ = 0.5; 
-    std::cout<<"########################################################"<<std::endl;
 
     /* --  2. get Tt2 --*/
 
@@ -457,49 +469,33 @@ void ANYmalCoMPlanner::_solveQuadProgReplan(){
 
 
 void ANYmalCoMPlanner::_solveQuadProg(){
-    Eigen::MatrixXd DDf, DDs, DD;
-    Eigen::VectorXd ddf, dds, dd;
+    builder_->clearConstraints();
 
     // Phase 3
-    _getEndTransitionCondition(DDf, ddf);
+    builder_->addEndTransitionCondition(T3_);
 
     // Phase 2
     // find ratio minimizing the maximum distance from com goal along the spline
     // alpha=ratio*beta
-    double a = 0.5*T2_*T2_;
-    double c = -0.5*T3_*T3_;
-    double b = T3_*(T2_+T3_);
-    double ratio = (-b - std::sqrt(b*b-4*a*c)) / 2/a;
-    // std::cout<<"ratio = " <<ratio<<std::endl;
-    _getSwingConditionGivenRatio(ratio, DDs, dds);
-
-    // Phase 2 & 3
-    DD = my_utils::vStack(DDf, DDs);
-    dd = my_utils::vStack(ddf, dds);
-    // my_utils::pretty_print(DDs,std::cout,"DD");
-    // my_utils::pretty_print(dds,std::cout,"dd");
-
-    std::cout<<"########################################################"<<std::endl;
+    double ratio = ANYmalCoMPlannerBuilder::getSwingRatio(T2_, T3_);
+    builder_->addSwingConditionGivenRatio(ratio, T2_, T3_);
+
     // solve quad prob for x = beta*dir
     // min 0.5*x'*x
     // s.t. -DD*x <= -dd
-    Eigen::VectorXd x;
-    qp_solver_->setProblem(Eigen::MatrixXd::Identity(3,3),
-                        Eigen::VectorXd::Zero(3),-DD,-dd);
-    qp_solver_->solveProblem(x);
+    qp_solver_->setProblem(H_, f_, 
+                builder_->getIeqMtx(), builder_->getIeqVec());
+    qp_solver_->solveProblem(x_);
 
     // set result
-    if(ratio < 0) beta_ = - x.norm();
-    else beta_ = x.norm();
+    if(ratio < 0) beta_ = - x_.norm();
+    else beta_ = x_.norm();
 
-    if(std::fabs(beta_) > 1e-5) dir_com_swing_ = x/beta_;
-    else dir_com_swing_ = Eigen::VectorXd::Zero(3);
+    if(std::fabs(beta_) > 1e-5) dir_com_swing_ = x_/beta_;
+    else dir_com_swing_.setZero();
 
     alpha_ = beta_*ratio;
     
-    std::cout<<" dir_com_swing= " << dir_com_swing_.transpose() << std::endl;
-    std::cout<<" alpha= " <<alpha_ << ", beta= " <<beta_ << std::endl;
     if(alpha_>1.2) alpha_ = 1.2; 
     beta_ = alpha_/ratio;
-    std::cout<<"########################################################"<<std::endl;
 }
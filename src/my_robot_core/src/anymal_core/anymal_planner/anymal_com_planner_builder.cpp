@@ -0,0 +1,276 @@
+#include <my_robot_core/anymal_core/anymal_planner/anymal_com_planner_builder.hpp>
+#include <Eigen/SVD>
+#include <cmath>
+
+namespace {
+inline void skewInPlace(const Eigen::Vector3d& w, Eigen::Matrix3d& Wx) {
+    Wx <<   0.0,   -w(2),  w(1),
+           w(2),     0.0, -w(0),
+          -w(1),    w(0),  0.0;
+}
+}
+
+ANYmalCoMPlannerBuilder::ANYmalCoMPlannerBuilder() {
+    mass_ = 0.;
+    grav_ << 0., 0., -9.81;
+    Ldot_.setZero();
+    skewInPlace(grav_, skew_grav_);
+    swing_foot_idx_ = -1;
+
+    update_tol_ = -1.;
+    b_force_update_ = true;
+    n_updated_feet_ = 0;
+    p_goal_prev_.setZero();
+
+    for(int i(0); i<ANYmal::n_leg; ++i) {
+        pi_prev_[i].setZero();
+        Ri_prev_[i].setIdentity();
+        mu_prev_[i] = 0.;
+        A_[i].setZero();
+        invW_[i].setOnes();
+        D_[i].setZero();
+        d_[i].setZero();
+    }
+    AWA_.setZero();
+    AWAinv_.setZero();
+
+    full_.n_contact = 0;
+    full_.G1.setZero(max_cone, 3);
+    full_.G2.setZero(max_cone, 3);
+    full_.dd.setZero(max_cone);
+    contact_ = full_;
+    cache_ = nullptr;
+
+    n_ieq_ = 0;
+    Aieq_.setZero(max_ieq, 3);
+    bieq_.setZero(max_ieq);
+}
+
+ANYmalCoMPlannerBuilder::~ANYmalCoMPlannerBuilder() {
+    delete cache_;
+}
+
+void ANYmalCoMPlannerBuilder::setCache(bool b_enable, double max_kb,
+                                double pos_res, double rot_res, double mu_res) {
+    delete cache_;
+    cache_ = nullptr;
+    if(!b_enable) return;
+    cache_ = new ContactSetCache<ContactSet>();
+    cache_->setResolution(pos_res, rot_res, mu_res);
+    cache_->setMemoryCap(max_kb);
+}
+
+void ANYmalCoMPlannerBuilder::_invalidate() {
+    b_force_update_ = true;
+    // the cached sets depend on the mass and Ldot through C
+    if(cache_) cache_->clear();
+}
+
+double ANYmalCoMPlannerBuilder::getSwingRatio(double T2, double T3) {
+    double a = 0.5*T2*T2;
+    double c = -0.5*T3*T3;
+    double b = T3*(T2+T3);
+    return (-b - std::sqrt(b*b-4*a*c)) / 2/a;
+}
+
+void ANYmalCoMPlannerBuilder::update(
+                const std::array<Eigen::Vector3d, ANYmal::n_leg>& foot_pos,
+                const std::array<Eigen::Matrix3d, ANYmal::n_leg>& foot_rot,
+                const std::array<double, ANYmal::n_leg>& foot_mu,
+                int swing_foot_idx,
+                const Eigen::Vector3d& swing_foot_dpos,
+                const Eigen::Vector3d& p_goal) {
+    bool b_swing_changed = (swing_foot_idx_ != swing_foot_idx);
+    swing_foot_idx_ = swing_foot_idx;
+
+    C_.head<3>() = Ldot_;
+    C_.tail<3>() = -mass_*grav_;
+
+    // rebuild the blocks of the feet that changed only
+    std::array<Eigen::Vector3d, ANYmal::n_leg> pi;
+    std::array<bool, ANYmal::n_leg> b_changed;
+    bool b_any_changed = false;
+    for(int i(0); i<ANYmal::n_leg; ++i) {
+        pi[i] = foot_pos[i];
+        // next desired foot position
+        if(i == swing_foot_idx_) pi[i] += swing_foot_dpos;
+        b_changed[i] = b_force_update_ 
+            || _isFootChanged(i, pi[i], foot_rot[i], foot_mu[i], p_goal);
+        b_any_changed = b_any_changed || b_changed[i];
+    }
+    // all the blocks share the com goal
+    if(b_any_changed && p_goal != p_goal_prev_) b_changed.fill(true);
+
+    n_updated_feet_ = 0;
+    for(int i(0); i<ANYmal::n_leg; ++i) {
+        if(!b_changed[i]) continue;
+        _buildFootBlocks(i, pi[i], foot_rot[i], foot_mu[i], p_goal);
+        pi_prev_[i] = pi[i];
+        Ri_prev_[i] = foot_rot[i];
+        mu_prev_[i] = foot_mu[i];
+        ++n_updated_feet_;
+    }
+    if(n_updated_feet_ > 0) p_goal_prev_ = p_goal;
+
+    // every foot is coupled through inv(AWA) 
+    if(b_force_update_ || b_swing_changed || n_updated_feet_ > 0) {
+        _buildContactSet(false, full_);
+        _buildContactSet(true, contact_);
+    }
+    b_force_update_ = false;
+}
+
+bool ANYmalCoMPlannerBuilder::_isFootChanged(int i,
+                                            const Eigen::Vector3d& pi,
+                                            const Eigen::Matrix3d& Ri,
+                                            double mu,
+                                            const Eigen::Vector3d& p_goal) {
+    if(update_tol_ < 0.) return true;
+    return (pi - pi_prev_[i]).cwiseAbs().maxCoeff() > update_tol_
+        || (Ri - Ri_prev_[i]).cwiseAbs().maxCoeff() > update_tol_
+        || std::fabs(mu - mu_prev_[i]) > update_tol_
+        || (p_goal - p_goal_prev_).cwiseAbs().maxCoeff() > update_tol_;
+}
+
+void ANYmalCoMPlannerBuilder::_buildFootBlocks(int i,
+                                            const Eigen::Vector3d& pi,
+                                            const Eigen::Matrix3d& Ri,
+                                            double mu,
+                                            const Eigen::Vector3d& p_goal) {
+    // A_i = [ (skew(pi) - skew(p_goal))*Ri ; Ri ]
+    Eigen::Matrix3d Sx;
+    skewInPlace(pi - p_goal, Sx);
+    A_[i].topRows<3>().noalias() = Sx*Ri;
+    A_[i].bottomRows<3>() = Ri;
+
+    // wi << 1., 1., mu^2
+    invW_[i] << mu*mu, mu*mu, 1.;
+
+    // GroundFramePointContactSpec::_setU without the max fz row
+    double mu_cone = mu/std::sqrt(2.0);
+    D_[i].setZero();
+    D_[i](0, 2) = 1.;
+    D_[i](1, 0) = 1.;
+    D_[i](1, 2) = mu_cone;
+    D_[i](2, 0) = -1.;
+    D_[i](2, 2) = mu_cone;
+    D_[i](3, 1) = 1.;
+    D_[i](3, 2) = mu_cone;
+    D_[i](4, 1) = -1.;
+    D_[i](4, 2) = mu_cone;
+    d_[i].setZero();
+}
+
+void ANYmalCoMPlannerBuilder::_buildContactSet(bool b_exclude_swing,
+                                                ContactSet& cs) {
+    // the blocks were built from pi_prev_, Ri_prev_, mu_prev_, p_goal_prev_
+    if(cache_) {
+        unsigned int mask = 0;
+        for(int i(0); i<ANYmal::n_leg; ++i)
+            if(!(b_exclude_swing && i == swing_foot_idx_)) mask |= (1u << i);
+        cache_->makeKey(mask, pi_prev_, Ri_prev_, mu_prev_, p_goal_prev_,
+                        cache_key_);
+        if(cache_->find(cache_key_, cs)) return;
+    }
+
+    // AWA = sum_i A_i*W_i*A_i'
+    AWA_.setZero();
+    int n_contact = 0;
+    for(int i(0); i<ANYmal::n_leg; ++i) {
+        if(b_exclude_swing && i == swing_foot_idx_) continue;
+        AWA_.noalias() += A_[i]*invW_[i].asDiagonal()*A_[i].transpose();
+        ++n_contact;
+    }
+    _pseudoInverse6(AWA_, 0.0001, AWAinv_);
+
+    cs.n_contact = n_contact;
+    cs.G1.resize(n_contact*dim_cone, 3);
+    cs.G2.resize(n_contact*dim_cone, 3);
+    cs.dd.resize(n_contact*dim_cone);
+
+    int row = 0;
+    for(int i(0); i<ANYmal::n_leg; ++i) {
+        if(b_exclude_swing && i == swing_foot_idx_) continue;
+        // invA_i = W_i*A_i'*inv(AWA)
+        invA_i_.noalias() = invW_[i].asDiagonal()*A_[i].transpose()*AWAinv_;
+        DinvA_i_.noalias() = D_[i]*invA_i_;
+
+        cs.G1.middleRows<dim_cone>(row).noalias() =
+                            DinvA_i_.leftCols<3>()*skew_grav_;
+        cs.G2.middleRows<dim_cone>(row) = DinvA_i_.rightCols<3>();
+        cs.dd.segment<dim_cone>(row).noalias() = - DinvA_i_*C_;
+        cs.dd.segment<dim_cone>(row) += d_[i];
+        row += dim_cone;
+    }
+    if(cache_) cache_->insert(cache_key_, cs);
+}
+
+void ANYmalCoMPlannerBuilder::_appendRows(const ContactSet& cs,
+                                        double a, double b, double c) {
+    // a*G1*x + b*G2*x >= c*dd  <=>  -(a*G1 + b*G2)*x <= -c*dd
+    int n_rows = cs.G1.rows();
+    if(n_ieq_ + n_rows > max_ieq) return;
+    Aieq_.middleRows(n_ieq_, n_rows) = -a*cs.G1 - b*cs.G2;
+    bieq_.segment(n_ieq_, n_rows) = -c*cs.dd;
+    n_ieq_ += n_rows;
+}
+
+void ANYmalCoMPlannerBuilder::addEndTransitionCondition(double T3) {
+    // D( 0.5*m*(Tt-t)^2*invA1*skew(g) + m*invA2)*beta*pdir + D*invA*C - d >=0
+    // when t=0
+    _appendRows(full_, 0.5*mass_*T3*T3, mass_, 1.);
+    // when t=Tt
+    _appendRows(full_, 0., mass_, 1.);
+}
+
+void ANYmalCoMPlannerBuilder::addSwingConditionReplan(double T2) {
+    // D( 0.5*m*(t)^2*invA1*skew(g) + m*invA2)*alpha*pdir >= - D*invA*C + d
+    // when t=0
+    _appendRows(full_, 0., mass_, 1.);
+    // when t=Ts
+    _appendRows(full_, 0.5*mass_*T2*T2, mass_, 1.);
+}
+
+void ANYmalCoMPlannerBuilder::addSwingConditionGivenRatio(double ratio,
+                                                        double T2,
+                                                        double T3) {
+    // alpha = ratio*beta, DD = ratio*Da + Db
+    // Da =  D*( 0.5*m*(T2-t)^2*invA1*skew(g) + m*invA2 );
+    // Db = D*( 0.5*m*T3*(T3+2*T2-t)*invA1*skew(g) );
+    double t;
+    // @ t=0
+    t = 0.;
+    _appendRows(contact_,
+        ratio*0.5*mass_*(T2-t)*(T2-t) + 0.5*mass_*T3*(T3+2*T2-t),
+        ratio*mass_, 1.);
+    // @ t=T2
+    t = T2;
+    _appendRows(contact_,
+        ratio*0.5*mass_*(T2-t)*(T2-t) + 0.5*mass_*T3*(T3+2*T2-t),
+        ratio*mass_, 1.);
+    // @ t=tstar (local maxima)
+    t = T2 + T3/2./ratio;
+    if(t > 0. && t < T2){
+        _appendRows(contact_,
+            ratio*0.5*mass_*(T2-t)*(T2-t) + 0.5*mass_*T3*(T3+2*T2-t),
+            ratio*mass_, 1.);
+    }
+}
+
+void ANYmalCoMPlannerBuilder::_pseudoInverse6(
+                                    const Eigen::Matrix<double, 6, 6>& AWA,
+                                    double sigmaThreshold,
+                                    Eigen::Matrix<double, 6, 6>& AWAinv) {
+    // same regularization as my_utils::pseudoInverse, on fixed size storage
+    Eigen::JacobiSVD<Eigen::Matrix<double, 6, 6>> svd(AWA,
+                                    Eigen::ComputeFullU | Eigen::ComputeFullV);
+    Eigen::Matrix<double, 6, 1> invS;
+    double sv;
+    for (int ii(0); ii < 6; ++ii) {
+        sv = svd.singularValues()(ii);
+        if (sv > sigmaThreshold) invS(ii) = 1.0 / sv;
+        else invS(ii) = sv / sigmaThreshold / sigmaThreshold;
+    }
+    AWAinv.noalias() = svd.matrixV() * invS.asDiagonal()
+                        * svd.matrixU().transpose();
+}
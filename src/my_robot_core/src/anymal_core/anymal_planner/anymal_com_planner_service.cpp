@@ -0,0 +1,212 @@
+#include <my_robot_core/anymal_core/anymal_planner/anymal_com_planner_service.hpp>
+#include <my_wbc/Contact/ContactSpec.hpp>
+
+#include <algorithm>
+
+namespace {
+inline double elapsedMs(const std::chrono::steady_clock::time_point& from,
+                        const std::chrono::steady_clock::time_point& to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+}
+
+ANYmalCoMPlanRequest::ANYmalCoMPlanRequest() {
+    type = PRE_SWING;
+    state_count = -1;
+    passed_time = 0.;
+    id = 0;
+    for(int i(0); i<ANYmal::n_leg; ++i) {
+        foot_pos[i].setZero();
+        foot_rot[i].setIdentity();
+        foot_mu[i] = 0.;
+    }
+}
+
+ANYmalCoMPlanResult::ANYmalCoMPlanResult() {
+    type = ANYmalCoMPlanRequest::PRE_SWING;
+    state_count = -1;
+    id = 0;
+    b_com_goal_updated = false;
+    b_sampled = false;
+}
+
+ANYmalCoMPlannerService::ANYmalCoMPlannerService(RobotSystem* robot) {
+    my_utils::pretty_constructor(3, "ANYmal CoM Planner Service");
+
+    b_enabled_ = false;
+    wait_period_ = 1.;
+
+    planner_ = new ANYmalCoMPlanner(robot);
+
+    front_ = 0;
+    b_result_ready_ = false;
+    b_running_ = false;
+
+    id_requested_ = 0;
+    id_consumed_ = 0;
+    num_request_ = 0;
+    num_replaced_ = 0;
+    num_applied_ = 0;
+    num_stale_ = 0;
+    num_stale_ticks_ = 0;
+    num_result_ = 0;
+    latency_last_ = 0.;
+    latency_max_ = 0.;
+    latency_sum_ = 0.;
+    apply_latency_last_ = 0.;
+}
+
+ANYmalCoMPlannerService::~ANYmalCoMPlannerService() {
+    stop();
+    delete planner_;
+}
+
+void ANYmalCoMPlannerService::initialization(const YAML::Node& node) {
+    try {
+        my_utils::readParameter(node,"enable", b_enabled_);
+        my_utils::readParameter(node,"wait_period", wait_period_);
+    } catch (std::runtime_error& e) {
+        std::cout << "Error reading parameter [" << e.what() << "] at file: ["
+                << __FILE__ << "]" << std::endl
+                << std::endl;
+        exit(0);
+    }
+}
+
+void ANYmalCoMPlannerService::plannerInitialization(
+                                        const YAML::Node& planner_node,
+                                        const YAML::Node& sampler_node) {
+    planner_->paramInitialization(planner_node);
+    planner_->samplerInitialization(sampler_node);
+}
+
+void ANYmalCoMPlannerService::start() {
+    if(!b_enabled_ || b_running_) return;
+    b_running_ = true;
+    thread_ = std::thread(&ANYmalCoMPlannerService::_run, this);
+}
+
+void ANYmalCoMPlannerService::stop() {
+    if(!b_running_) return;
+    b_running_ = false;
+    cv_.notify_all();
+    thread_.join();
+}
+
+void ANYmalCoMPlannerService::requestPreSwingReplan(ANYmalCoMPlanner* planner,
+            const std::array<ContactSpec*, ANYmal::n_leg>& f_contacts,
+            int state_count) {
+    ANYmalCoMPlanRequest& req = requests_.getWriteBuffer();
+    _fillRequest(req, planner, f_contacts, state_count);
+    req.type = ANYmalCoMPlanRequest::PRE_SWING;
+    req.passed_time = 0.;
+    _postRequest();
+}
+
+void ANYmalCoMPlannerService::requestSwingReplan(ANYmalCoMPlanner* planner,
+            const std::array<ContactSpec*, ANYmal::n_leg>& f_contacts,
+            int state_count, double passed_time) {
+    ANYmalCoMPlanRequest& req = requests_.getWriteBuffer();
+    _fillRequest(req, planner, f_contacts, state_count);
+    req.type = ANYmalCoMPlanRequest::SWING;
+    req.passed_time = passed_time;
+    _postRequest();
+}
+
+void ANYmalCoMPlannerService::_fillRequest(ANYmalCoMPlanRequest& req,
+            ANYmalCoMPlanner* planner,
+            const std::array<ContactSpec*, ANYmal::n_leg>& f_contacts,
+            int state_count) {
+    req.id = ++id_requested_;
+    req.state_count = state_count;
+    req.request_time = std::chrono::steady_clock::now();
+    planner->getPlanData(req.plan);
+    planner->readContactConfiguration(f_contacts,
+                            req.foot_pos, req.foot_rot, req.foot_mu);
+}
+
+void ANYmalCoMPlannerService::_postRequest() {
+    ++num_request_;
+    if(!requests_.post()) ++num_replaced_;
+    cv_.notify_one();
+}
+
+bool ANYmalCoMPlannerService::swapResult() {
+    if(!b_result_ready_.load(std::memory_order_acquire)) return false;
+    front_ = 1 - front_;
+    // the service thread may write the other buffer from now on
+    b_result_ready_.store(false, std::memory_order_release);
+
+    const ANYmalCoMPlanResult& res = results_[front_];
+    latency_last_ = elapsedMs(res.request_time, res.done_time);
+    latency_max_ = std::max(latency_max_, latency_last_);
+    latency_sum_ += latency_last_;
+    ++num_result_;
+    apply_latency_last_ = elapsedMs(res.request_time,
+                                    std::chrono::steady_clock::now());
+    return true;
+}
+
+void ANYmalCoMPlannerService::markApplied() {
+    ++num_applied_;
+    id_consumed_ = std::max(id_consumed_, results_[front_].id);
+}
+
+void ANYmalCoMPlannerService::markStale() {
+    ++num_stale_;
+    id_consumed_ = std::max(id_consumed_, results_[front_].id);
+}
+
+void ANYmalCoMPlannerService::countTick() {
+    if(isPending()) ++num_stale_ticks_;
+}
+
+void ANYmalCoMPlannerService::_run() {
+    while(b_running_) {
+        // keep the request until the last result is swapped in
+        if(!b_result_ready_.load(std::memory_order_acquire)
+            && requests_.fetch()) {
+            _solve(requests_.getReadBuffer(), results_[1 - front_]);
+            b_result_ready_.store(true, std::memory_order_release);
+            continue;
+        }
+        // the control thread does not lock, a missed notify costs
+        // wait_period at most
+        std::unique_lock<std::mutex> lock(mtx_);
+        cv_.wait_for(lock, std::chrono::duration<double, std::milli>(
+                                                            wait_period_),
+            [this]{ return !b_running_ || (requests_.hasMessage()
+                            && !b_result_ready_.load()); });
+    }
+}
+
+void ANYmalCoMPlannerService::_solve(const ANYmalCoMPlanRequest& req,
+                                    ANYmalCoMPlanResult& res) {
+    planner_->setPlanData(req.plan);
+    planner_->setContactConfiguration(req.foot_pos, req.foot_rot,
+                                    req.foot_mu);
+
+    res.b_com_goal_updated = false;
+    res.b_sampled = false;
+    switch(req.type) {
+        case ANYmalCoMPlanRequest::PRE_SWING:
+        // move the com goal if the estimated friction makes it infeasible
+        if(planner_->getCoMSampler()->isEnabled()) {
+            res.b_com_goal_updated = planner_->searchCoMGoal();
+            planner_->getCoMSampler()->getCandidateList(res.feasible_com_list);
+            res.b_sampled = true;
+        }
+        planner_->replanCentroidalMotionPreSwing();
+        break;
+        case ANYmalCoMPlanRequest::SWING:
+        planner_->replanCentroidalMotionSwing(req.passed_time);
+        break;
+    }
+
+    res.type = req.type;
+    res.state_count = req.state_count;
+    res.id = req.id;
+    res.request_time = req.request_time;
+    planner_->getPlanData(res.plan);
+    res.done_time = std::chrono::steady_clock::now();
+}
@@ -0,0 +1,331 @@
+#include <my_robot_core/anymal_core/anymal_planner/anymal_com_sampler.hpp>
+#include <my_wbc/QuadProgSolver.hpp>
+#include <my_utils/IO/LogChannel.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+MY_LOG_CHANNEL(log_sampler_stat, "com_sampler_stat", 4, 1, true);
+
+ANYmalCoMSampler::Workspace::Workspace() {
+    builder = new ANYmalCoMPlannerBuilder();
+    qp_solver = new QuadProgSolver();
+    // infeasible candidates are expected
+    qp_solver->setVerbose(false);
+    H.setIdentity();
+    f.setZero();
+    x = Eigen::VectorXd::Zero(3);
+}
+
+ANYmalCoMSampler::Workspace::~Workspace() {
+    delete builder;
+    delete qp_solver;
+}
+
+ANYmalCoMSampler::ANYmalCoMSampler() {
+    my_utils::pretty_constructor(3, "ANYmal CoM Sampler");
+
+    b_enabled_ = false;
+    num_threads_ = 0;
+    max_samples_ = 400;
+    resolution_ = 0.01;
+    alpha_max_ = 1.2;
+    margin_threshold_ = 0.5;
+    time_budget_ = 0.;
+
+    mass_ = 0.;
+    Ldot_.setZero();
+    for(int i(0); i<ANYmal::n_leg; ++i) {
+        foot_pos_[i].setZero();
+        foot_rot_[i].setIdentity();
+        foot_mu_[i] = 0.;
+    }
+    swing_foot_idx_ = -1;
+    swing_foot_dpos_.setZero();
+    T2_ = 0.;
+    T3_ = 0.;
+    ratio_ = 0.;
+    support_polygon_ = new SupportPolygon(ANYmal::n_leg);
+    grid_capacity_ = 4096;
+    grid_size_ = 0;
+    grid_.resize(grid_capacity_, 2);
+    grid_margin_.resize(grid_capacity_);
+    grid_inside_.resize(grid_capacity_);
+    grid_order_.reserve(grid_capacity_);
+
+    num_candidates_ = 0;
+    ref_margin_ = -std::numeric_limits<double>::infinity();
+    best_margin_ = -std::numeric_limits<double>::infinity();
+    best_com_.setZero();
+    num_evaluated_ = 0;
+    sample_time_ = 0.;
+    b_timed_out_ = false;
+
+    batch_id_ = 0;
+    num_busy_ = 0;
+    b_terminate_ = false;
+    next_idx_ = 0;
+    b_early_exit_ = false;
+    b_time_over_ = false;
+
+    workspaces_.push_back(new Workspace());
+}
+
+ANYmalCoMSampler::~ANYmalCoMSampler() {
+    _stopWorkers();
+    for(auto &ws : workspaces_) delete ws;
+    delete support_polygon_;
+}
+
+void ANYmalCoMSampler::initialization(const YAML::Node& node) {
+    try {
+        my_utils::readParameter(node,"enable", b_enabled_);
+        my_utils::readParameter(node,"num_threads", num_threads_);
+        my_utils::readParameter(node,"max_samples", max_samples_);
+        my_utils::readParameter(node,"resolution", resolution_);
+        my_utils::readParameter(node,"alpha_max", alpha_max_);
+        my_utils::readParameter(node,"margin_threshold", margin_threshold_);
+        my_utils::readParameter(node,"time_budget", time_budget_);
+    } catch (std::runtime_error& e) {
+        std::cout << "Error reading parameter [" << e.what() << "] at file: ["
+                << __FILE__ << "]" << std::endl
+                << std::endl;
+        exit(0);
+    }
+
+    // reserve the sample buffers once
+    candidates_.reserve(max_samples_);
+    margins_.reserve(max_samples_);
+    evaluated_.reserve(max_samples_);
+
+    _stopWorkers();
+    if(b_enabled_) _startWorkers();
+}
+
+void ANYmalCoMSampler::setProblem(double mass,
+                    const Eigen::Vector3d& Ldot,
+                    const std::array<Eigen::Vector3d, ANYmal::n_leg>& foot_pos,
+                    const std::array<Eigen::Matrix3d, ANYmal::n_leg>& foot_rot,
+                    const std::array<double, ANYmal::n_leg>& foot_mu,
+                    int swing_foot_idx,
+                    const Eigen::Vector3d& swing_foot_dpos,
+                    double T2, double T3) {
+    mass_ = mass;
+    Ldot_ = Ldot;
+    foot_pos_ = foot_pos;
+    foot_rot_ = foot_rot;
+    foot_mu_ = foot_mu;
+    swing_foot_idx_ = swing_foot_idx;
+    swing_foot_dpos_ = swing_foot_dpos;
+    T2_ = T2;
+    T3_ = T3;
+    ratio_ = ANYmalCoMPlannerBuilder::getSwingRatio(T2_, T3_);
+
+    for(auto &ws : workspaces_) {
+        ws->builder->setMass(mass_);
+        ws->builder->setAngularMomentumRate(Ldot_);
+    }
+
+    // support polygon of the stance feet
+    for(int i(0); i<ANYmal::n_leg; ++i) {
+        if(i == swing_foot_idx_) support_polygon_->remove(i);
+        else support_polygon_->insert(i, foot_pos_[i].head<2>());
+    }
+    if(support_polygon_->getNumHalfPlanes() > 0) {
+        support_polygon_->getHalfPlanes(support_A_, support_b_);
+        support_edges_.setHrep(support_A_, support_b_);
+    }
+}
+
+bool ANYmalCoMSampler::sample(const Eigen::Vector3d& p_ref) {
+    clock_.start();
+    deadline_ = std::chrono::steady_clock::now()
+        + std::chrono::microseconds((long)(1e3*time_budget_));
+
+    _generateCandidates(p_ref);
+
+    next_idx_ = 0;
+    b_early_exit_ = false;
+    b_time_over_ = false;
+    if(!workers_.empty()) {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            num_busy_ = (int)workers_.size();
+            ++batch_id_;
+        }
+        cv_start_.notify_all();
+    }
+    _evaluateCandidates(workspaces_[0]);
+    if(!workers_.empty()) {
+        std::unique_lock<std::mutex> lock(mtx_);
+        cv_done_.wait(lock, [this]{ return num_busy_ == 0; });
+    }
+
+    // best candidate by margin
+    ref_margin_ = margins_[0];
+    best_margin_ = -std::numeric_limits<double>::infinity();
+    best_com_ = p_ref;
+    num_evaluated_ = 0;
+    for(int k(0); k<num_candidates_; ++k) {
+        if(!evaluated_[k]) continue;
+        ++num_evaluated_;
+        if(margins_[k] > best_margin_) {
+            best_margin_ = margins_[k];
+            best_com_ = candidates_[k];
+        }
+    }
+
+    b_timed_out_ = b_time_over_.load();
+    sample_time_ = clock_.stop();
+
+    // [sample time(ms), evaluated, candidates per sec, timed out]
+    Eigen::Vector4d sampler_stat;
+    sampler_stat << sample_time_, (double)num_evaluated_,
+                    getCandidatesPerSec(), (double)b_timed_out_;
+    MY_LOG(log_sampler_stat, sampler_stat);
+    return best_margin_ > 0.;
+}
+
+void ANYmalCoMSampler::getCandidateList(
+            std::vector<std::pair<double, Eigen::Vector3d>>& com_list) {
+    com_list.clear();
+    for(int k(0); k<num_candidates_; ++k) {
+        if(evaluated_[k])
+            com_list.push_back(std::make_pair(margins_[k], candidates_[k]));
+    }
+}
+
+double ANYmalCoMSampler::getCandidatesPerSec() {
+    if(sample_time_ > 0.) return 1000.*(double)num_evaluated_ / sample_time_;
+    return 0.;
+}
+
+void ANYmalCoMSampler::_startWorkers() {
+    b_terminate_ = false;
+    // the caller thread works as well
+    for(int tid(1); tid<num_threads_; ++tid) {
+        if((int)workspaces_.size() <= tid)
+            workspaces_.push_back(new Workspace());
+        workers_.push_back(std::thread(&ANYmalCoMSampler::_workerLoop,
+                                        this, tid, batch_id_));
+    }
+}
+
+void ANYmalCoMSampler::_stopWorkers() {
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        b_terminate_ = true;
+    }
+    cv_start_.notify_all();
+    for(auto &worker : workers_) worker.join();
+    workers_.clear();
+}
+
+void ANYmalCoMSampler::_workerLoop(int tid, unsigned int batch_id) {
+    Workspace* ws = workspaces_[tid];
+    while(true) {
+        {
+            std::unique_lock<std::mutex> lock(mtx_);
+            cv_start_.wait(lock, [this, &batch_id]{
+                return b_terminate_ || batch_id != batch_id_; });
+            if(b_terminate_) return;
+            batch_id = batch_id_;
+        }
+
+        _evaluateCandidates(ws);
+
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            --num_busy_;
+        }
+        cv_done_.notify_one();
+    }
+}
+
+void ANYmalCoMSampler::_evaluateCandidates(Workspace* ws) {
+    int k;
+    while(!b_early_exit_.load()) {
+        k = next_idx_.fetch_add(1);
+        if(k >= num_candidates_) break;
+        margins_[k] = _evaluate(candidates_[k], ws);
+        evaluated_[k] = 1;
+        if(margins_[k] >= margin_threshold_) b_early_exit_ = true;
+        // the reference is evaluated before the budget is checked
+        if(time_budget_ > 0.
+            && std::chrono::steady_clock::now() > deadline_) {
+            b_time_over_ = true;
+            b_early_exit_ = true;
+        }
+    }
+}
+
+double ANYmalCoMSampler::_evaluate(const Eigen::Vector3d& p_goal,
+                                    Workspace* ws) {
+    // same problem with ANYmalCoMPlanner::_solveQuadProg
+    ws->builder->update(foot_pos_, foot_rot_, foot_mu_,
+                    swing_foot_idx_, swing_foot_dpos_, p_goal);
+    ws->builder->clearConstraints();
+    ws->builder->addEndTransitionCondition(T3_);
+    ws->builder->addSwingConditionGivenRatio(ratio_, T2_, T3_);
+
+    ws->qp_solver->setProblem(ws->H, ws->f,
+                ws->builder->getIeqMtx(), ws->builder->getIeqVec());
+    double cost = ws->qp_solver->solveProblem(ws->x);
+    if(cost == std::numeric_limits<double>::infinity())
+        return -std::numeric_limits<double>::infinity();
+
+    double alpha = std::fabs(ratio_)*ws->x.norm();
+    return alpha_max_ - alpha;
+}
+
+void ANYmalCoMSampler::_generateCandidates(const Eigen::Vector3d& p_ref) {
+    candidates_.clear();
+    candidates_.push_back(p_ref);
+
+    if(support_polygon_->getNumHalfPlanes() > 0) {
+        Eigen::Vector2d pmin = support_polygon_->getVertex(0);
+        Eigen::Vector2d pmax = pmin;
+        for(int i(1); i<support_polygon_->getNumVertices(); ++i) {
+            pmin = pmin.cwiseMin(support_polygon_->getVertex(i));
+            pmax = pmax.cwiseMax(support_polygon_->getVertex(i));
+        }
+        Eigen::Vector2d size = pmax - pmin;
+        double step = resolution_;
+        while(((int)(size(0)/step) + 1)*((int)(size(1)/step) + 1) > grid_capacity_)
+            step *= 1.25;
+        int nx = (int)(size(0)/step) + 1;
+        int ny = (int)(size(1)/step) + 1;
+        grid_size_ = nx*ny;
+        int k(0);
+        for(int i(0); i<nx; ++i) {
+            for(int j(0); j<ny; ++j) {
+                grid_(k, 0) = pmin(0) + i*step;
+                grid_(k, 1) = pmin(1) + j*step;
+                ++k;
+            }
+        }
+        // points on an edge are inside up to the rounding of the margin
+        support_edges_.contains(grid_, grid_size_, grid_inside_, grid_margin_, 1e-12);
+        grid_order_.clear();
+        for(k = 0; k < grid_size_; ++k) {
+            if(grid_inside_[k]) grid_order_.push_back(k);
+        }
+        // only the closest to the reference are taken, up to max_samples
+        int n_take = std::min((int)grid_order_.size(), max_samples_ - 1);
+        Eigen::Vector2d p_ref_2d = p_ref.head<2>();
+        const Eigen::MatrixXd& grid = grid_;
+        std::partial_sort(grid_order_.begin(), grid_order_.begin() + n_take,
+            grid_order_.end(), [&grid, &p_ref_2d](int a, int b) {
+                return (grid.row(a).transpose() - p_ref_2d).squaredNorm()
+                        < (grid.row(b).transpose() - p_ref_2d).squaredNorm(); });
+        for(k = 0; k < n_take; ++k) {
+            candidates_.push_back(Eigen::Vector3d(grid_(grid_order_[k], 0),
+                                    grid_(grid_order_[k], 1), p_ref(2)));
+        }
+    }
+
+    num_candidates_ = candidates_.size();
+    margins_.assign(num_candidates_, -std::numeric_limits<double>::infinity());
+    evaluated_.assign(num_candidates_, 0);
+}
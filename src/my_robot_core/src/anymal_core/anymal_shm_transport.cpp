@@ -0,0 +1,225 @@
+#include <unistd.h>
+#include <chrono>
+#include <cstring>
+#include <type_traits>
+#include <my_robot_core/anymal_core/anymal_interface.hpp>
+#include <my_robot_core/anymal_core/anymal_shm_transport.hpp>
+
+#include <my_utils/IO/IOUtilities.hpp>
+#include <my_utils/IO/StageTiming.hpp>
+#include <my_utils/IO/Trace.hpp>
+
+static_assert(std::is_trivially_copyable<ANYmalSensorDataPod>::value,
+              "ANYmalSensorDataPod is copied through the shared memory");
+static_assert(std::is_trivially_copyable<ANYmalCommandPod>::value,
+              "ANYmalCommandPod is copied through the shared memory");
+
+// recorded by the controller, the client sends its round trips back
+MY_TIMING_STAGE(timing_round_trip, "shm_round_trip", 1e3*ANYmalAux::servo_rate);
+MY_TIMING_STAGE(timing_transport, "shm_transport", 0.);
+
+static uint64_t elapsedNs(const std::chrono::steady_clock::time_point& t_start) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - t_start).count();
+}
+
+// =============================================================================
+// POD conversions
+// =============================================================================
+void ANYmalShm::toPod(const ANYmalSensorData* data, ANYmalSensorDataPod& pod) {
+    for(int i(0); i<ANYmal::n_adof; ++i) {
+        pod.q[i] = data->q[i];
+        pod.qdot[i] = data->qdot[i];
+        pod.tau_cmd_prev[i] = data->tau_cmd_prev[i];
+    }
+    for(int i(0); i<ANYmal::n_vdof; ++i) {
+        pod.virtual_q[i] = data->virtual_q[i];
+        pod.virtual_qdot[i] = data->virtual_qdot[i];
+    }
+    for(int leg(0); leg<ANYmal::n_leg; ++leg) {
+        for(int i(0); i<6; ++i)
+            pod.foot_wrench[leg][i] = data->foot_wrench[leg][i];
+        pod.b_foot_contact[leg] = data->b_foot_contact[leg];
+    }
+    pod.imu_quat[0] = data->imu_quat.w();
+    pod.imu_quat[1] = data->imu_quat.x();
+    pod.imu_quat[2] = data->imu_quat.y();
+    pod.imu_quat[3] = data->imu_quat.z();
+    for(int i(0); i<3; ++i) {
+        pod.imu_ang_vel[i] = data->imu_ang_vel[i];
+        pod.imu_acc[i] = data->imu_acc[i];
+    }
+}
+
+void ANYmalShm::fromPod(const ANYmalSensorDataPod& pod, ANYmalSensorData* data) {
+    for(int i(0); i<ANYmal::n_adof; ++i) {
+        data->q[i] = pod.q[i];
+        data->qdot[i] = pod.qdot[i];
+        data->tau_cmd_prev[i] = pod.tau_cmd_prev[i];
+    }
+    for(int i(0); i<ANYmal::n_vdof; ++i) {
+        data->virtual_q[i] = pod.virtual_q[i];
+        data->virtual_qdot[i] = pod.virtual_qdot[i];
+    }
+    for(int leg(0); leg<ANYmal::n_leg; ++leg) {
+        for(int i(0); i<6; ++i)
+            data->foot_wrench[leg][i] = pod.foot_wrench[leg][i];
+        data->b_foot_contact[leg] = pod.b_foot_contact[leg] != 0;
+    }
+    data->imu_quat = Eigen::Quaterniond(pod.imu_quat[0], pod.imu_quat[1],
+                                        pod.imu_quat[2], pod.imu_quat[3]);
+    for(int i(0); i<3; ++i) {
+        data->imu_ang_vel[i] = pod.imu_ang_vel[i];
+        data->imu_acc[i] = pod.imu_acc[i];
+    }
+}
+
+void ANYmalShm::toPod(const ANYmalCommand* command, ANYmalCommandPod& pod) {
+    for(int i(0); i<ANYmal::n_adof; ++i) {
+        pod.q[i] = command->q[i];
+        pod.qdot[i] = command->qdot[i];
+        pod.jtrq[i] = command->jtrq[i];
+    }
+}
+
+void ANYmalShm::fromPod(const ANYmalCommandPod& pod, ANYmalCommand* command) {
+    for(int i(0); i<ANYmal::n_adof; ++i) {
+        command->q[i] = pod.q[i];
+        command->qdot[i] = pod.qdot[i];
+        command->jtrq[i] = pod.jtrq[i];
+    }
+}
+
+// =============================================================================
+// ANYmalShmClient
+// =============================================================================
+ANYmalShmClient::ANYmalShmClient(my_utils::ShmWakeup wakeup, double timeout)
+    : timeout_(timeout), tick_(0), command_seq_(0), round_trip_ns_(0),
+      button_(0) {
+    my_utils::pretty_constructor(1, "ANYmal Shm Client");
+    memset(&sensor_pod_, 0, sizeof(sensor_pod_));
+    memset(&command_pod_, 0, sizeof(command_pod_));
+    command_sub_.setWakeup(wakeup);
+}
+
+ANYmalShmClient::~ANYmalShmClient() {}
+
+void ANYmalShmClient::connect() {
+    if(!sensor_pub_.open(ANYmalShm::sensor_data_name,
+                         sizeof(ANYmalSensorDataPod), true)) {
+        std::cout << "Error creating the shared memory ["
+                  << ANYmalShm::sensor_data_name << "]" << std::endl;
+        exit(0);
+    }
+    openCommand_();
+}
+
+void ANYmalShmClient::openCommand_() {
+    for(int i(0); !command_sub_.open(ANYmalShm::command_name,
+                                     sizeof(ANYmalCommandPod), false); ++i) {
+        if(i % 1000 == 0)
+            std::cout << "waiting for the controller process ["
+                      << ANYmalShm::command_name << "]" << std::endl;
+        usleep(1000);
+    }
+    // the command of a previous client is not an answer
+    command_seq_ = command_sub_.getSequence();
+}
+
+bool ANYmalShmClient::exchange(const ANYmalSensorData* data,
+                               ANYmalCommand* command) {
+    auto t_start = std::chrono::steady_clock::now();
+    ANYmalShm::toPod(data, sensor_pod_);
+    sensor_pod_.tick = ++tick_;
+    sensor_pod_.round_trip_ns = round_trip_ns_;
+    sensor_pod_.button = button_;
+    button_ = 0;
+    sensor_pub_.write(&sensor_pod_);
+
+    // a late command of a previous tick is skipped
+    do {
+        double timeout = timeout_ - 1e-9 * elapsedNs(t_start);
+        if(timeout <= 0. ||
+           !command_sub_.waitRead(&command_pod_, command_seq_, timeout)) {
+            MY_TRACE_WARN("no command from the controller for tick {}", tick_);
+            round_trip_ns_ = 0;
+            if(!command_sub_.isWriterAlive()) openCommand_();
+            return false;
+        }
+    } while(command_pod_.tick != tick_);
+
+    ANYmalShm::fromPod(command_pod_, command);
+    round_trip_ns_ = elapsedNs(t_start);
+    return true;
+}
+
+// =============================================================================
+// ANYmalShmServer
+// =============================================================================
+ANYmalShmServer::ANYmalShmServer(my_utils::ShmWakeup wakeup)
+    : sensor_seq_(0), last_compute_ns_(0) {
+    my_utils::pretty_constructor(1, "ANYmal Shm Server");
+    interface_ = new ANYmalInterface();
+    sensor_data_ = new ANYmalSensorData();
+    command_ = new ANYmalCommand();
+    memset(&sensor_pod_, 0, sizeof(sensor_pod_));
+    memset(&command_pod_, 0, sizeof(command_pod_));
+    sensor_sub_.setWakeup(wakeup);
+}
+
+ANYmalShmServer::~ANYmalShmServer() {
+    delete interface_;
+    delete sensor_data_;
+    delete command_;
+}
+
+void ANYmalShmServer::connect() {
+    if(!command_pub_.open(ANYmalShm::command_name,
+                          sizeof(ANYmalCommandPod), true)) {
+        std::cout << "Error creating the shared memory ["
+                  << ANYmalShm::command_name << "]" << std::endl;
+        exit(0);
+    }
+    openSensorData_();
+}
+
+void ANYmalShmServer::openSensorData_() {
+    for(int i(0); !sensor_sub_.open(ANYmalShm::sensor_data_name,
+                                    sizeof(ANYmalSensorDataPod), false); ++i) {
+        if(i % 1000 == 0)
+            std::cout << "waiting for the simulator process ["
+                      << ANYmalShm::sensor_data_name << "]" << std::endl;
+        usleep(1000);
+    }
+    // the segment is new with the client, its first sensor data included
+    sensor_seq_ = 0;
+}
+
+bool ANYmalShmServer::spinOnce(double timeout) {
+    if(!sensor_sub_.waitRead(&sensor_pod_, sensor_seq_, timeout)) {
+        if(!sensor_sub_.isWriterAlive()) openSensorData_();
+        return false;
+    }
+
+    auto t_start = std::chrono::steady_clock::now();
+    // the round trip of the previous tick includes its computation
+    if(sensor_pod_.round_trip_ns > 0) {
+        my_utils::StageTiming* timing = my_utils::StageTiming::getStageTiming();
+        timing->record(timing_round_trip, sensor_pod_.round_trip_ns);
+        if(sensor_pod_.round_trip_ns > last_compute_ns_)
+            timing->record(timing_transport,
+                           sensor_pod_.round_trip_ns - last_compute_ns_);
+    }
+    if(sensor_pod_.button != 0)
+        interface_->interrupt_->setFlags(sensor_pod_.button);
+
+    ANYmalShm::fromPod(sensor_pod_, sensor_data_);
+    interface_->getCommand(sensor_data_, command_);
+
+    ANYmalShm::toPod(command_, command_pod_);
+    command_pod_.tick = sensor_pod_.tick;
+    last_compute_ns_ = elapsedNs(t_start);
+    command_pod_.compute_ns = last_compute_ns_;
+    command_pub_.write(&command_pod_);
+    return true;
+}
@@ -1,9 +1,17 @@
+#include <cmath>
 #include <my_robot_system/RobotSystem.hpp>
 #include <my_robot_core/anymal_core/anymal_definition.hpp>
 #include <my_robot_core/anymal_core/anymal_interface.hpp>
 #include <my_robot_core/anymal_core/anymal_state_estimator.hpp>
 #include <my_robot_core/anymal_core/anymal_state_provider.hpp>
+#include <my_robot_core/anymal_core/anymal_estimator/floating_base_ekf.hpp>
 #include <my_utils/IO/IOUtilities.hpp>
+#include <my_utils/IO/LogChannel.hpp>
+
+MY_LOG_CHANNEL(log_base_q_est, "base_q_est", ANYmal::n_vdof, 1, true);
+MY_LOG_CHANNEL(log_base_qdot_est, "base_qdot_est", ANYmal::n_vdof, 1, true);
+MY_LOG_CHANNEL(log_base_q_true, "base_q_true", ANYmal::n_vdof, 1, true);
+MY_LOG_CHANNEL(log_base_qdot_true, "base_qdot_true", ANYmal::n_vdof, 1, true);
 
 ANYmalStateEstimator::ANYmalStateEstimator(RobotSystem* robot) {
     my_utils::pretty_constructor(1, "ANYmal State Estimator");
@@ -13,20 +21,58 @@ ANYmalStateEstimator::ANYmalStateEstimator(RobotSystem* robot) {
     curr_config_ = Eigen::VectorXd::Zero(ANYmal::n_dof);
     curr_qdot_ = Eigen::VectorXd::Zero(ANYmal::n_dof);
     prev_tau_cmd_ = Eigen::VectorXd::Zero(ANYmal::n_dof);
+
+    b_base_estimation_ = false;
+    b_save_data_ = false;
+    base_ekf_ = new BaseEKF();
+    base_ekf_->getSystemModel().setTimeStep(ANYmalAux::servo_rate);
+    init_pos_std_ = 0.001;
+    init_vel_std_ = 0.01;
+    prev_yaw_ = 0.;
+    gravity_ = robot_->getSkeleton()->getGravity();
+    for(int ii(0); ii<ANYmal::n_leg; ++ii)
+        foot_rel_[ii].setZero();
 }
 
-ANYmalStateEstimator::~ANYmalStateEstimator() {}
+ANYmalStateEstimator::~ANYmalStateEstimator() {
+    delete base_ekf_;
+}
+
+void ANYmalStateEstimator::setParameters(const YAML::Node& node) {
+    double acc_noise, foot_noise, foot_swing_noise;
+    double kin_noise, kin_swing_noise;
+    try {
+        my_utils::readParameter(node, "base_estimation", b_base_estimation_);
+        my_utils::readParameter(node, "save_data", b_save_data_);
+        my_utils::readParameter(node, "acc_noise", acc_noise);
+        my_utils::readParameter(node, "foot_noise", foot_noise);
+        my_utils::readParameter(node, "foot_swing_noise", foot_swing_noise);
+        my_utils::readParameter(node, "kin_noise", kin_noise);
+        my_utils::readParameter(node, "kin_swing_noise", kin_swing_noise);
+        my_utils::readParameter(node, "init_pos_std", init_pos_std_);
+        my_utils::readParameter(node, "init_vel_std", init_vel_std_);
+    } catch (std::runtime_error& e) {
+        std::cout << "Error reading parameter [" << e.what() << "] at file: ["
+                  << __FILE__ << "]" << std::endl
+                  << std::endl;
+        exit(0);
+    }
+    base_ekf_->getSystemModel().setNoise(acc_noise, foot_noise, foot_swing_noise);
+    base_ekf_->getMeasurementModel().setNoise(kin_noise, kin_swing_noise);
+}
 
 void ANYmalStateEstimator::Initialization(ANYmalSensorData* data) {
     sp_->jpos_ini = data->q; //sp_->getActiveJointValue(curr_config_);
     _JointUpdate(data);
     _ConfigurationAndModelUpdate();    
     _FootContactUpdate(data);
+    if(b_base_estimation_) _BaseStateInitialization(data);
     sp_->saveCurrentData();
 }
 
 void ANYmalStateEstimator::Update(ANYmalSensorData* data) {
     _JointUpdate(data);
+    if(b_base_estimation_) _BaseStateUpdate(data);
     _ConfigurationAndModelUpdate();
     _FootContactUpdate(data);
     sp_->saveCurrentData();
@@ -61,3 +107,64 @@ void ANYmalStateEstimator::_FootContactUpdate(ANYmalSensorData* data) {
         sp_->foot_rf[ii] = data->foot_wrench[ii];
     }
 }
+
+void ANYmalStateEstimator::_BaseStateInitialization(ANYmalSensorData* data) {
+    // start from the initial base state, the robot is updated with it
+    Eigen::Vector3d pos = curr_config_.head(3);
+    Eigen::Vector3d vel = curr_qdot_.head(3);
+    for(int ii(0); ii<ANYmal::n_leg; ++ii)
+        foot_rel_[ii] = robot_->getBodyNodeIsometry(
+            ANYmalFoot::LinkIdx[ii]).translation() - pos;
+    base_ekf_->initialize(pos, vel, foot_rel_, init_pos_std_, init_vel_std_);
+    prev_yaw_ = curr_config_[ANYmalDoF::baseRotZ];
+}
+
+void ANYmalStateEstimator::_BaseStateUpdate(ANYmalSensorData* data) {
+    // orientation from the imu attitude as zyx euler angles
+    // of the virtual joints, the yaw is kept continuous
+    Eigen::Matrix3d R_wb = data->imu_quat.toRotationMatrix();
+    double yaw = std::atan2(R_wb(1,0), R_wb(0,0));
+    yaw += 2.*M_PI*std::round((prev_yaw_ - yaw)/(2.*M_PI));
+    double pitch = std::asin(-std::min(1., std::max(-1., R_wb(2,0))));
+    double roll = std::atan2(R_wb(2,1), R_wb(2,2));
+    prev_yaw_ = yaw;
+
+    // euler rates from the gyro, w_world = E * d/dt[yaw, pitch, roll]
+    Eigen::Matrix3d E;
+    E.col(0) << 0., 0., 1.;
+    E.col(1) << -std::sin(yaw), std::cos(yaw), 0.;
+    E.col(2) << std::cos(yaw)*std::cos(pitch), std::sin(yaw)*std::cos(pitch),
+                -std::sin(pitch);
+    Eigen::Vector3d euler_dot = E.inverse() * (R_wb * data->imu_ang_vel);
+
+    base_ekf_->predict(R_wb * data->imu_acc + gravity_, data->b_foot_contact);
+
+    const BaseEKF::State& x = base_ekf_->getState();
+    curr_config_.head(3) = x.pos();
+    curr_config_[ANYmalDoF::baseRotZ] = yaw;
+    curr_config_[ANYmalDoF::baseRotY] = pitch;
+    curr_config_[ANYmalDoF::baseRotX] = roll;
+    curr_qdot_.head(3) = x.vel();
+    curr_qdot_[ANYmalDoF::baseRotZ] = euler_dot[0];
+    curr_qdot_[ANYmalDoF::baseRotY] = euler_dot[1];
+    curr_qdot_[ANYmalDoF::baseRotX] = euler_dot[2];
+
+    // leg kinematics with the predicted base, the feet relative to the base
+    // do not depend on the base position. Only the forward kinematics is
+    // computed here, the model is updated again with the corrected base
+    robot_->updateSystem(curr_config_, curr_qdot_, false);
+    for(int ii(0); ii<ANYmal::n_leg; ++ii)
+        foot_rel_[ii] = robot_->getBodyNodeIsometry(
+            ANYmalFoot::LinkIdx[ii]).translation() - curr_config_.head(3);
+
+    base_ekf_->update(foot_rel_);
+    curr_config_.head(3) = x.pos();
+    curr_qdot_.head(3) = x.vel();
+
+    if(b_save_data_) {
+        MY_LOG(log_base_q_est, curr_config_.head(ANYmal::n_vdof));
+        MY_LOG(log_base_qdot_est, curr_qdot_.head(ANYmal::n_vdof));
+        MY_LOG(log_base_q_true, data->virtual_q);
+        MY_LOG(log_base_qdot_true, data->virtual_qdot);
+    }
+}
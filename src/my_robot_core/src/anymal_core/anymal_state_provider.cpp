@@ -51,6 +51,7 @@ ANYmalStateProvider::ANYmalStateProvider(RobotSystem* _robot) {
     com_pos_des.setZero();
     com_vel_des.setZero();
     mom_des = Eigen::VectorXd::Zero(6);
+    support_margin = 0.;
 
     for(int i=0;i<ANYmal::n_leg;++i){
         foot_pos[i] = Eigen::VectorXd::Zero(3);
@@ -1,4 +1,10 @@
 #include <my_robot_core/anymal_core/anymal_wbc_controller/anymal_wbc.hpp>
+#include <my_utils/IO/StageTiming.hpp>
+#include <my_utils/IO/Trace.hpp>
+
+MY_TIMING_STAGE(timing_wbc_tasks, "wbc_tasks", 0.);
+MY_TIMING_STAGE(timing_kin_wbc, "kin_wbc", 0.);
+MY_TIMING_STAGE(timing_wblc, "wblc", 0.);
 
 ANYmalWBC::ANYmalWBC( ANYmalWbcSpecContainer* _ws_container, 
                             RobotSystem* _robot){
@@ -30,6 +36,15 @@ ANYmalWBC::ANYmalWBC( ANYmalWbcSpecContainer* _ws_container,
   jpos_des_ = Eigen::VectorXd::Zero(ANYmal::n_dof);
   jvel_des_ = Eigen::VectorXd::Zero(ANYmal::n_dof);
   jacc_des_ = Eigen::VectorXd::Zero(ANYmal::n_dof);
+
+  // Initialize centroidal reference
+  b_com_ref_ = false;
+  b_force_ref_ = false;
+  com_pos_ref_ = Eigen::VectorXd::Zero(3);
+  com_vel_ref_ = Eigen::VectorXd::Zero(3);
+  com_acc_ref_ = Eigen::VectorXd::Zero(3);
+  for(int foot_idx(0); foot_idx<ANYmal::n_leg; ++foot_idx)
+    foot_force_ref_[foot_idx].setZero();
 }
 
 ANYmalWBC::~ANYmalWBC() {
@@ -61,22 +76,86 @@ void ANYmalWBC::_PreProcessing_Command() {
     contact_list_.push_back(ws_container_->contact_list_[i]);
   }
 
-  // Update Contact Spec
+  // Update Contact Spec, the feet kinematics may be updated already
+  // in this tick by the observers
+  int foot_idx;
   for (int i = 0; i < contact_list_.size(); i++) {
-    contact_list_[i]->updateContactSpec();
+    foot_idx = ws_container_->footLink2FootIdx(contact_list_[i]->getLinkIdx());
+    if(foot_idx > -1) {
+      ws_container_->update_foot_contact_kinematics(foot_idx);
+      contact_list_[i]->updateContactConstraint();
+    } else {
+      contact_list_[i]->updateContactSpec();
+    }
+  }
+
+  _SetCentroidalReference();
+}
+
+void ANYmalWBC::setCentroidalReference(const Eigen::Vector3d& com_pos,
+                                      const Eigen::Vector3d& com_vel,
+                                      const Eigen::Vector3d& com_acc,
+                                      bool b_com_ref) {
+  b_com_ref_ = b_com_ref;
+  com_pos_ref_ = com_pos;
+  com_vel_ref_ = com_vel;
+  com_acc_ref_ = com_acc;
+}
+
+void ANYmalWBC::setCentroidalReference(
+          const std::array<Eigen::Vector3d, ANYmal::n_leg>& foot_force) {
+  b_force_ref_ = true;
+  foot_force_ref_ = foot_force;
+}
+
+void ANYmalWBC::clearCentroidalReference() {
+  b_com_ref_ = false;
+  b_force_ref_ = false;
+}
+
+void ANYmalWBC::_SetCentroidalReference() {
+  // com task given by the state machine otherwise
+  if(b_com_ref_) {
+    ws_container_->com_task_->updateTask(com_pos_ref_, 
+                                        com_vel_ref_, 
+                                        com_acc_ref_);
+  }
+
+  // stack the desired forces in the order of contact_list_
+  if(!b_force_ref_) {
+    wbc_param_->F_des_.resize(0);
+    return;
+  }
+  int dim_grf_stacked(0), foot_idx;
+  for ( auto &contact : contact_list_) dim_grf_stacked += contact->getDim();
+  wbc_param_->F_des_ = Eigen::VectorXd::Zero(dim_grf_stacked);
+
+  dim_grf_stacked = 0;
+  for ( auto &contact : contact_list_) {
+    foot_idx = ws_container_->footLink2FootIdx(contact->getLinkIdx());
+    // point contact, force in the ground frame
+    if(foot_idx>-1 && foot_idx< ANYmal::n_leg && contact->getDim() == 3)
+      wbc_param_->F_des_.segment(dim_grf_stacked, 3) = foot_force_ref_[foot_idx];
+    dim_grf_stacked += contact->getDim();
   }
 }
 
 void ANYmalWBC::getCommand(void* _cmd) {
 
   // grab & update task_list and contact_list & QP weights
-  _PreProcessing_Command();
+  {
+    MY_TIMING_PROBE(timing_wbc_tasks);
+    _PreProcessing_Command();
+  }
 
   // ---- Solve Inv Kinematics
   // kin_wbc_->FindConfiguration(sp_->q, task_list_, contact_list_, 
   //                               jpos_des_, jvel_des_, jacc_des_); 
-  kin_wbc_->FindFullConfiguration(sp_->q, task_list_, contact_list_, 
-                                    jpos_des_, jvel_des_, jacc_des_); 
+  {
+    MY_TIMING_PROBE(timing_kin_wbc);
+    kin_wbc_->FindFullConfiguration(sp_->q, task_list_, contact_list_, 
+                                      jpos_des_, jvel_des_, jacc_des_); 
+  }
 
   Eigen::VectorXd jacc_des_cmd = jacc_des_;
   for(int i(0); i<ANYmal::n_adof; ++i) {
@@ -86,8 +165,11 @@ void ANYmalWBC::getCommand(void* _cmd) {
   }
                                
   // wbmc
-  wbc_->updateSetting(A_, Ainv_, coriolis_, grav_);
-  wbc_->makeTorqueGivenRef(jacc_des_cmd, contact_list_, jtrq_des_, wbc_param_);
+  {
+    MY_TIMING_PROBE(timing_wblc);
+    wbc_->updateSetting(A_, Ainv_, coriolis_, grav_);
+    wbc_->makeTorqueGivenRef(jacc_des_cmd, contact_list_, jtrq_des_, wbc_param_);
+  }
 
   set_grf_des();
   
@@ -127,8 +209,8 @@ void ANYmalWBC::set_grf_des(){
       grf_des_list[foot_idx]  = wbc_param_->Fr_.segment(dim_grf_stacked, dim_grf);
       dim_grf_stacked += dim_grf;    
     }else{
-      std::cout<<"set_grf_des??? foot_idx = "<< foot_idx << std::endl;
-      std::cout<<"set_grf_des???? link idx = "<< contact->getLinkIdx() << std::endl;
+      MY_TRACE_WARN("set_grf_des??? foot_idx = {}, link idx = {}",
+                    foot_idx, contact->getLinkIdx());
     }    
   }
 
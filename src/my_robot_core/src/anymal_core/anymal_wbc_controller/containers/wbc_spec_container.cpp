@@ -54,7 +54,9 @@ void ANYmalWbcSpecContainer::_InitializeContacts() {
 
     full_contact_dim_ += feet_contacts_[i]->getDim();
     b_feet_contact_list_[i] = true;
+    feet_contacts_update_[i] = -1;
   }
+  support_polygon_ = new SupportPolygon(ANYmal::n_leg);
 
   // Add all contacts initially. Remove later as needed.
   contact_list_.clear();
@@ -88,6 +90,7 @@ void ANYmalWbcSpecContainer::_DeleteContacts() {
 
   for( auto &contact : feet_contacts_)
     delete contact;
+  delete support_polygon_;
 }
 
 void ANYmalWbcSpecContainer::_DeleteOthers() {
@@ -176,12 +179,23 @@ void ANYmalWbcSpecContainer::set_contact_list(int moving_cop) {
     if( ANYmalFoot::LinkIdx[i] != moving_cop ) {
       contact_list_.push_back(feet_contacts_[i]);
       b_feet_contact_list_[i] = true;
+      // only the foot entering contact changes the polygon
+      if(!support_polygon_->hasPoint(i))
+        support_polygon_->insert(i, robot_->getBodyNodeIsometry(
+                        ANYmalFoot::LinkIdx[i]).translation().head(2));
     }
-    else
+    else {
       b_feet_contact_list_[i] = false;
+      support_polygon_->remove(i);
+    }
   }
 }
 
+double ANYmalWbcSpecContainer::get_support_margin(
+                                  const Eigen::Vector3d& com_pos) {
+  return support_polygon_->stabilityMargin(com_pos.head(2));
+}
+
 void ANYmalWbcSpecContainer::set_contact_maxfz(int moving_cop) {
   for(auto &contact : contact_list_) {
     if( contact->getLinkIdx() == moving_cop) {
@@ -266,6 +280,18 @@ Task* ANYmalWbcSpecContainer::get_foot_ori_task(int moving_cop) {
   else return feet_ori_tasks_[foot_idx]; 
 }
 
+void ANYmalWbcSpecContainer::update_foot_contact_kinematics(int foot_idx) {
+  long num_update = robot_->getNumUpdate();
+  if(feet_contacts_update_[foot_idx] == num_update) return;
+  feet_contacts_[foot_idx]->updateContactKinematics();
+  feet_contacts_update_[foot_idx] = num_update;
+}
+
+void ANYmalWbcSpecContainer::update_feet_contact_kinematics() {
+  for(int i(0); i<ANYmal::n_leg; ++i)
+    update_foot_contact_kinematics(i);
+}
+
 int ANYmalWbcSpecContainer::footLink2FootIdx(int moving_cop) {
   for( int foot_idx(0); foot_idx<ANYmal::n_leg; ++foot_idx) {
     if(ANYmalFoot::LinkIdx[foot_idx] == moving_cop)
@@ -1,6 +1,7 @@
 #include <my_robot_core/anymal_core/anymal_wbc_controller/containers/reference_generator_container.hpp>
 #include <my_robot_core/anymal_core/anymal_wbc_controller/containers/wbc_spec_container.hpp>
 #include <my_robot_core/anymal_core/anymal_wbc_controller/state_machines/full_support.hpp>
+#include <my_utils/IO/Trace.hpp>
 
 FullSupport::FullSupport(const StateIdentifier state_identifier_in,
     ANYmalReferenceGeneratorContainer* rg_container) 
@@ -18,8 +19,8 @@ FullSupport::FullSupport(const StateIdentifier state_identifier_in,
 FullSupport::~FullSupport() {}
 
 void FullSupport::firstVisit() {
-  std::cout<<"-------------------------------" <<std::endl;
-  std::cout << "[Full Support Balance] Start" << std::endl;
+  MY_TRACE_INFO("-------------------------------\n"
+                "[Full Support Balance] Start");
 
   ctrl_start_time_ = sp_->curr_time;
   // -- set current motion param
@@ -73,10 +74,10 @@ void FullSupport::firstVisit() {
 
   sp_->com_pos_init = pcom;
   sp_->com_pos_target = pc_goal;
-  my_utils::pretty_print(pcom, std::cout, "pc_init");
-  my_utils::pretty_print(pc_goal, std::cout, "pc_goal");
-  my_utils::pretty_print(q_init, std::cout, "q_init");
-  my_utils::pretty_print(q_goal, std::cout, "q_goal");
+  MY_TRACE_DEBUG("pc_init {}", pcom);
+  MY_TRACE_DEBUG("pc_goal {}", pc_goal);
+  MY_TRACE_DEBUG("q_init {}", q_init);
+  MY_TRACE_DEBUG("q_goal {}", q_goal);
   
   // ---------------------------------------
   //      CONTACT LIST
@@ -149,6 +150,7 @@ void FullSupport::_weightUpdate() {
 
 void FullSupport::oneStep() {
   state_machine_time_ = sp_->curr_time - ctrl_start_time_;
+  sp_->support_margin = ws_container_->get_support_margin(sp_->com_pos);
   _taskUpdate();
   _weightUpdate();
 }
@@ -160,7 +162,7 @@ bool FullSupport::endOfState() {
   // std::cout<<"state_machine_time_ = "<<state_machine_time_<<", ctrl_duration_ = " << ctrl_duration_;
   // std::cout<<", sp_->num_state = "<< sp_->num_state<< std::endl;
   if ( state_machine_time_ > ctrl_duration_ && sp_->num_state > 0) {
-    std::cout << "[Full Support Balance] End" << std:: endl;
+    MY_TRACE_INFO("[Full Support Balance] End");
     return true;
   }
   return false;
@@ -1,6 +1,7 @@
 #include <my_robot_core/anymal_core/anymal_wbc_controller/containers/reference_generator_container.hpp>
 #include <my_robot_core/anymal_core/anymal_wbc_controller/containers/wbc_spec_container.hpp>
 #include <my_robot_core/anymal_core/anymal_wbc_controller/state_machines/manipulation.hpp>
+#include <my_utils/IO/Trace.hpp>
 
 Manipulation::Manipulation(const StateIdentifier state_identifier_in,
     ANYmalReferenceGeneratorContainer* rg_container) 
@@ -18,8 +19,8 @@ Manipulation::Manipulation(const StateIdentifier state_identifier_in,
 Manipulation::~Manipulation() {}
 
 void Manipulation::firstVisit() {
-  std::cout<<"-------------------------------" <<std::endl;
-  std::cout << "[Full Support Balance] Start" << std::endl;
+  MY_TRACE_INFO("-------------------------------\n"
+                "[Full Support Balance] Start");
 
   ctrl_start_time_ = sp_->curr_time;
   // -- set current motion param
@@ -124,7 +125,7 @@ bool Manipulation::endOfState() {
   // std::cout<<"state_machine_time_ = "<<state_machine_time_<<", ctrl_duration_ = " << ctrl_duration_;
   // std::cout<<", sp_->num_state = "<< sp_->num_state<< std::endl;
   if ( state_machine_time_ > ctrl_duration_ && sp_->num_state > 0) {
-    std::cout << "[Full Support Balance] End" << std:: endl;
+    MY_TRACE_INFO("[Full Support Balance] End");
     return true;
   }
   return false;
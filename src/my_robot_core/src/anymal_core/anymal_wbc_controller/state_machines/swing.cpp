@@ -1,6 +1,7 @@
 #include <my_robot_core/anymal_core/anymal_wbc_controller/containers/reference_generator_container.hpp>
 #include <my_robot_core/anymal_core/anymal_wbc_controller/containers/wbc_spec_container.hpp>
 #include <my_robot_core/anymal_core/anymal_wbc_controller/state_machines/swing.hpp>
+#include <my_utils/IO/Trace.hpp>
 
 Swing::Swing(const StateIdentifier state_identifier_in,
     ANYmalReferenceGeneratorContainer* rg_container)
@@ -18,8 +19,8 @@ Swing::Swing(const StateIdentifier state_identifier_in,
 Swing::~Swing() {}
 
 void Swing::firstVisit() {
-  std::cout<<"-------------------------------" <<std::endl;
-  std::cout << "[SWING] Start" << std::endl;
+  MY_TRACE_INFO("-------------------------------\n"
+                "[SWING] Start");
 
   ctrl_start_time_ = sp_->curr_time;
 
@@ -40,8 +41,8 @@ void Swing::firstVisit() {
   moving_foot_idx_ = rg_container_->foot_trajectory_manager_->getMovingFootIdx();
 
   moving_foot_link_idx_ = ANYmalFoot::LinkIdx[moving_foot_idx_];
-  std::cout << " swing !! - moving_foot_link_idx_=" << moving_foot_link_idx_
-            << ", moving_foot_idx_=" << moving_foot_idx_ << std::endl;
+  MY_TRACE_DEBUG(" swing !! - moving_foot_link_idx_={}, moving_foot_idx_={}",
+                 moving_foot_link_idx_, moving_foot_idx_);
 
 
   // --set com traj
@@ -113,6 +114,7 @@ void Swing::_weightUpdate() {
 
 void Swing::oneStep() {
   state_machine_time_ = sp_->curr_time - ctrl_start_time_;
+  sp_->support_margin = ws_container_->get_support_margin(sp_->com_pos);
   _taskUpdate();
   _weightUpdate();
 }
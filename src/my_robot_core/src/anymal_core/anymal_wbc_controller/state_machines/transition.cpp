@@ -1,6 +1,7 @@
 #include <my_robot_core/anymal_core/anymal_wbc_controller/containers/reference_generator_container.hpp>
 #include <my_robot_core/anymal_core/anymal_wbc_controller/containers/wbc_spec_container.hpp>
 #include <my_robot_core/anymal_core/anymal_wbc_controller/state_machines/transition.hpp>
+#include <my_utils/IO/Trace.hpp>
 
 Transition::Transition(const StateIdentifier state_identifier_in, 
     ANYmalReferenceGeneratorContainer* rg_container,
@@ -19,8 +20,8 @@ Transition::Transition(const StateIdentifier state_identifier_in,
 Transition::~Transition() {}
 
 void Transition::firstVisit() {
-  std::cout<<"-------------------------------" <<std::endl;
-  std::cout << "[contact transition] Start : " << b_contact_start_ << std::endl;
+  MY_TRACE_INFO("-------------------------------\n"
+                "[contact transition] Start : {}", b_contact_start_);
 
   ctrl_start_time_ = sp_->curr_time;
  
@@ -36,8 +37,8 @@ void Transition::firstVisit() {
   MotionCommand mc_curr_ = sp_->curr_motion_command;
   moving_foot_idx_ = mc_curr_.get_moving_foot();
   moving_foot_link_idx_ = ANYmalFoot::LinkIdx[moving_foot_idx_];
-  std::cout << " transition !! - moving_foot_link_idx_=" << moving_foot_link_idx_
-            << ", moving_foot_idx_" << moving_foot_idx_ << std::endl;
+  MY_TRACE_DEBUG(" transition !! - moving_foot_link_idx_={}, moving_foot_idx_={}",
+                 moving_foot_link_idx_, moving_foot_idx_);
 
   
 
@@ -134,6 +135,7 @@ void Transition::_weightUpdate() {
 
 void Transition::oneStep() {
   state_machine_time_ = sp_->curr_time - ctrl_start_time_;
+  sp_->support_margin = ws_container_->get_support_margin(sp_->com_pos);
   _taskUpdate();
   _weightUpdate();
 }
@@ -143,7 +145,7 @@ void Transition::lastVisit() {}
 bool Transition::endOfState() {
   // Also check if footstep list is non-zero
   if ( state_machine_time_ > ctrl_duration_) {
-    std::cout << "[contact transition] End : " << b_contact_start_ << std::endl;
+    MY_TRACE_INFO("[contact transition] End : {}", b_contact_start_);
     return true;
   }
   return false;
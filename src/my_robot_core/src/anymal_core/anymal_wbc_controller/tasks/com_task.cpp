@@ -2,6 +2,9 @@
 #include <my_robot_core/anymal_core/anymal_definition.hpp>
 #include <../my_utils/Configuration.h>
 #include <my_utils/IO/IOUtilities.hpp>
+#include <my_utils/IO/LogChannel.hpp>
+
+MY_LOG_CHANNEL(log_com_pos_err, "com_pos_err", 3, 1, false);
 
 CoMTask::CoMTask(RobotSystem* robot):Task(robot, 3)
 {
@@ -28,7 +31,7 @@ bool CoMTask::_UpdateCommand(const Eigen::VectorXd & _pos_des,
     vel_des = _vel_des;
     acc_des = _acc_des;
 
-    //0112 my_utils::saveVector(pos_err, "com_pos_err");
+    MY_LOG(log_com_pos_err, pos_err);
     // my_utils::pretty_print(_pos_des, std::cout, "_pos_des  @  _UpdateCommand");
     // my_utils::pretty_print(_vel_des, std::cout, "_vel_des  @  _UpdateCommand");
     // my_utils::pretty_print(_acc_des, std::cout, "_acc_des  @  _UpdateCommand");
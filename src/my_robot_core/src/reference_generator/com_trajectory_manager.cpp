@@ -1,5 +1,10 @@
 #include <my_robot_core/reference_generator/com_trajectory_manager.hpp>
 #include <my_robot_core/anymal_core/anymal_state_provider.hpp>
+#include <my_utils/IO/LogChannel.hpp>
+
+MY_LOG_CHANNEL(log_com_pos_des, "com_pos_des_", 3, 1, true);
+MY_LOG_CHANNEL(log_com_vel_des, "com_vel_des_", 3, 1, true);
+MY_LOG_CHANNEL(log_com_acc_des, "com_acc_des_", 3, 1, true);
 
 CoMTrajectoryManager::CoMTrajectoryManager(RobotSystem* _robot)
                         : TrajectoryManagerBase(_robot) {
@@ -81,10 +86,16 @@ void CoMTrajectoryManager::updateCoMTrajectory(double current_time) {
   com_vel_des_ = pos_traj.evaluateFirstDerivative(t);
   com_acc_des_ = pos_traj.evaluateSecondDerivative(t);
 
-  my_utils::saveVector(com_pos_des_, "com_pos_des_");
-  my_utils::saveVector(com_vel_des_, "com_vel_des_");
-  my_utils::saveVector(com_acc_des_, "com_acc_des_");
+  MY_LOG(log_com_pos_des, com_pos_des_);
+  MY_LOG(log_com_vel_des, com_vel_des_);
+  MY_LOG(log_com_acc_des, com_acc_des_);
 
 }
 
-
+void CoMTrajectoryManager::getCoMReference(double time,
+                                          Eigen::Vector3d& com_pos,
+                                          Eigen::Vector3d& com_vel) {
+  double t = time - traj_start_time_;
+  com_pos = pos_traj.evaluate(t);
+  com_vel = pos_traj.evaluateFirstDerivative(t);
+}
@@ -1,6 +1,15 @@
 #include <my_robot_core/anymal_core/anymal_definition.hpp>
 #include <my_robot_core/reference_generator/ee_trajectory_manager.hpp>
 #include <my_robot_core/anymal_core/anymal_state_provider.hpp>
+#include <my_utils/IO/LogChannel.hpp>
+#include <my_utils/IO/Trace.hpp>
+
+MY_LOG_CHANNEL(log_ee_pos_des, "ee_pos_des_", 3, 1, false);
+MY_LOG_CHANNEL(log_ee_vel_des, "ee_vel_des_", 3, 1, false);
+MY_LOG_CHANNEL(log_ee_acc_des, "ee_acc_des_", 3, 1, false);
+MY_LOG_CHANNEL(log_ee_quat_des, "ee_quat_des_", 4, 1, false); // x, y, z, w
+MY_LOG_CHANNEL(log_ee_ori_vel_des, "ee_ori_vel_des_", 3, 1, false);
+MY_LOG_CHANNEL(log_ee_ori_acc_des, "ee_ori_acc_des_", 3, 1, false);
 
 EETrajectoryManager::EETrajectoryManager(RobotSystem* _robot)
                         : TrajectoryManagerBase(_robot) {
@@ -91,7 +100,7 @@ void EETrajectoryManager::setEETrajectory(const double& _start_time,
   pos_hermite_curve_.initialize(ee_pos_ini_, zero_vel_, 
                   ee_pos_des_, zero_vel_, traj_duration_);
 
-  my_utils::pretty_print(pos_dev_b,std::cout,"pos_dev_b_ee");
+  MY_TRACE_DEBUG("pos_dev_b_ee {}", pos_dev_b);
   // my_utils::pretty_print(ee_pos_ini_,std::cout,"ee_pos_ini_");
   // my_utils::pretty_print(ee_pos_des_,std::cout,"ee_pos_des_"); 
 
@@ -124,11 +133,11 @@ void EETrajectoryManager::updateEETrajectory(const double& current_time) {
   quat_hermite_curve_.getAngularAcceleration(t, ee_ori_acc_des_);
   my_utils::convertQuatDesToOriDes(ee_quat_des_, ee_ori_pos_des_);
 
-  // my_utils::saveVector(ee_pos_des_, "ee_pos_des_");
-  // my_utils::saveVector(ee_vel_des_, "ee_vel_des_");
-  // my_utils::saveVector(ee_acc_des_, "ee_acc_des_");
-  // my_utils::saveVector(ee_quat_des_, "ee_quat_des_");
-  // my_utils::saveVector(ee_ori_vel_des_, "ee_ori_vel_des_");
-  // my_utils::saveVector(ee_ori_acc_des_, "ee_ori_acc_des_");
+  MY_LOG(log_ee_pos_des, ee_pos_des_);
+  MY_LOG(log_ee_vel_des, ee_vel_des_);
+  MY_LOG(log_ee_acc_des, ee_acc_des_);
+  MY_LOG(log_ee_quat_des, ee_quat_des_.coeffs());
+  MY_LOG(log_ee_ori_vel_des, ee_ori_vel_des_);
+  MY_LOG(log_ee_ori_acc_des, ee_ori_acc_des_);
 }
 
@@ -1,6 +1,15 @@
 #include <my_robot_core/anymal_core/anymal_definition.hpp>
 #include <my_robot_core/reference_generator/foot_trajectory_manager.hpp>
 #include <my_robot_core/anymal_core/anymal_state_provider.hpp>
+#include <my_utils/IO/LogChannel.hpp>
+#include <my_utils/IO/Trace.hpp>
+
+MY_LOG_CHANNEL(log_foot_pos_des, "foot_pos_des_", 3, 1, false);
+MY_LOG_CHANNEL(log_foot_vel_des, "foot_vel_des_", 3, 1, false);
+MY_LOG_CHANNEL(log_foot_acc_des, "foot_acc_des_", 3, 1, false);
+MY_LOG_CHANNEL(log_foot_quat_des, "foot_quat_des_", 4, 1, false); // x, y, z, w
+MY_LOG_CHANNEL(log_foot_ori_vel_des, "foot_ori_vel_des_", 3, 1, false);
+MY_LOG_CHANNEL(log_foot_ori_acc_des, "foot_ori_acc_des_", 3, 1, false);
 
 FootPosTrajectoryManager::FootPosTrajectoryManager(RobotSystem* _robot)
                         : TrajectoryManagerBase(_robot) {
@@ -60,10 +69,10 @@ void FootPosTrajectoryManager::setFootPosTrajectory(const double& _start_time,
       pos_dev_b = motion_cmd_data.dpose.pos;
       swing_height_ = motion_cmd_data.swing_height;
       is_base_frame_ = motion_cmd_data.dpose.is_baseframe;
-      std::cout<<" setFootPosTrajectory " << foot_idx_<< ", " << link_idx_<< std::endl;
+      MY_TRACE_DEBUG(" setFootPosTrajectory {}, {}", foot_idx_, link_idx_);
   } else {
     // heuristic computation
-    std::cout<< "NOOOOO!! no foot motion cmd?" << std::endl;
+    MY_TRACE_WARN("NOOOOO!! no foot motion cmd?");
     traj_duration_ = 1.0;
     pos_dev_b = Eigen::VectorXd::Zero(3);
     swing_height_ = 0.5;
@@ -89,7 +98,7 @@ void FootPosTrajectoryManager::setFootPosTrajectory(const double& _start_time,
   else // absolute coordinate
     foot_pos_des_ = foot_pos_ini_ + pos_dev_b;
 
-  my_utils::pretty_print(pos_dev_b,std::cout,"pos_dev_b");
+  MY_TRACE_DEBUG("pos_dev_b {}", pos_dev_b);
   // my_utils::pretty_print(foot_pos_ini_,std::cout,"foot_pos_ini_");
   // my_utils::pretty_print(foot_pos_des_,std::cout,"foot_pos_des_");
   
@@ -135,16 +144,13 @@ void FootPosTrajectoryManager::updateFootPosTrajectory(const double& current_tim
     foot_vel_des_ = pos_traj_mid_to_end_.evaluateFirstDerivative(t);
     foot_acc_des_ = pos_traj_mid_to_end_.evaluateSecondDerivative(t);
   }
-  //0112 my_utils::saveVector(foot_pos_des_, "foot_pos_des_");
-  // //0112 my_utils::saveVector(foot_quat_des_, "foot_quat_des_");
-
-  // my_utils::saveVector(foot_pos_des_, "foot_pos_des_");
-  // my_utils::saveVector(foot_vel_des_, "foot_vel_des_");
-  // my_utils::saveVector(foot_acc_des_, "foot_acc_des_");
+  MY_LOG(log_foot_pos_des, foot_pos_des_);
+  MY_LOG(log_foot_vel_des, foot_vel_des_);
+  MY_LOG(log_foot_acc_des, foot_acc_des_);
 
-  // my_utils::saveVector(foot_quat_des_, "foot_quat_des_");
-  // my_utils::saveVector(foot_ori_vel_des_, "foot_ori_vel_des_");
-  // my_utils::saveVector(foot_ori_acc_des_, "foot_ori_acc_des_");
+  MY_LOG(log_foot_quat_des, foot_quat_des_.coeffs());
+  MY_LOG(log_foot_ori_vel_des, foot_ori_vel_des_);
+  MY_LOG(log_foot_ori_acc_des, foot_ori_acc_des_);
 
 }
 
@@ -164,10 +170,10 @@ void FootPosTrajectoryManager::setSwingPosCurve(const Eigen::VectorXd& foot_pos_
   pos_traj_mid_to_end_.initialize(foot_pos_mid, foot_vel_mid,
                                   foot_pos_des, zero_vel_, 0.5*traj_duration_);
 
-  my_utils::pretty_print(foot_pos_ini_, std::cout, "foot_pos_ini_");
-  my_utils::pretty_print(foot_pos_mid, std::cout, "foot_pos_mid");
-  my_utils::pretty_print(foot_pos_des_, std::cout, "foot_pos_des_");
-  std::cout<<"swing_height_ = "<< swing_height_ << std::endl;
+  MY_TRACE_DEBUG("foot_pos_ini_ {}", foot_pos_ini_);
+  MY_TRACE_DEBUG("foot_pos_mid {}", foot_pos_mid);
+  MY_TRACE_DEBUG("foot_pos_des_ {}", foot_pos_des_);
+  MY_TRACE_DEBUG("swing_height_ = {}", swing_height_);
 }
 
 
@@ -0,0 +1,210 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <../my_utils/Configuration.h>
+#include <my_robot_core/anymal_core/anymal_estimator/floating_base_ekf.hpp>
+#include <my_utils/IO/IOUtilities.hpp>
+#include <my_utils/IO/StageTiming.hpp>
+
+using my_utils::LatencyHistogram;
+
+// base_ekf_consistency [-r runs] [-t seconds] [-a acc_noise] [-k kin_noise]
+//                       [-f foot_drift]
+// runs the base EKF of ANYmalStateEstimator, with the noises of
+// INTERFACE.yaml state_estimator, on a synthetic trot at 1 kHz : the base
+// bobs and sways while the diagonal pairs of feet swing in turn and the
+// stance feet drift as a random walk of foot_drift [m/sqrt(s)], the
+// foot_noise of the filter by default. The accelerometer and the leg
+// kinematics are measured with white noises of acc_noise [m/s^2] and
+// kin_noise [m]. Prints the latency of predict and update, the heap
+// allocations in them, and the normalized estimation error squared of the
+// base position and velocity averaged over the runs and the ticks after
+// the first second. A consistent filter has a mean
+// NEES of 6 and 5% of its ticks above the 95% bound of chi2(6).
+// Exits with 1 if the mean NEES is off by more than 0.75 or the filter
+// allocates.
+typedef FloatingBaseEKF<18> BaseEKF;
+static const double dt = 0.001;
+static const double chi2_6_95 = 12.59;
+
+static bool b_count_alloc = false;
+static uint64_t num_alloc = 0;
+
+// malloc of glibc counted, operator new and the Eigen storage go through it
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* malloc(size_t size) {
+    if (b_count_alloc) ++num_alloc;
+    return __libc_malloc(size);
+}
+
+struct Latency {
+    Latency() : buckets(LatencyHistogram::num_buckets, 0), count(0), sum_ns(0) {}
+    void add(uint64_t ns) {
+        ++buckets[LatencyHistogram::bucketIndex(ns)];
+        ++count;
+        sum_ns += ns;
+    }
+    void print(const char* name) const {
+        printf("%-22s %9llu %9.3f %9.3f %9.3f %9.3f\n", name,
+               (unsigned long long)count, count ? 1e-3 * sum_ns / count : 0.,
+               1e-3 * LatencyHistogram::quantile(buckets.data(), count, 0.5),
+               1e-3 * LatencyHistogram::quantile(buckets.data(), count, 0.99),
+               1e-3 * LatencyHistogram::quantile(buckets.data(), count, 0.999));
+    }
+    std::vector<uint64_t> buckets;
+    uint64_t count, sum_ns;
+};
+
+static uint64_t elapsedNs(const std::chrono::steady_clock::time_point& t_start) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - t_start).count();
+}
+
+int main(int argc, char** argv) {
+    int num_runs = 20;
+    double duration = 20.;
+    double acc_noise = 0.2;
+    double kin_noise = 0.005;
+    double foot_drift = -1.;
+    for (int i(1); i < argc; ++i) {
+        if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            num_runs = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            duration = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-a") == 0 && i + 1 < argc) {
+            acc_noise = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-k") == 0 && i + 1 < argc) {
+            kin_noise = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            foot_drift = atof(argv[++i]);
+        } else {
+            printf("usage: base_ekf_consistency [-r runs] [-t seconds] "
+                   "[-a acc_noise] [-k kin_noise] [-f foot_drift]\n");
+            return 1;
+        }
+    }
+
+    double ekf_acc_noise, foot_noise, foot_swing_noise;
+    double ekf_kin_noise, kin_swing_noise, init_pos_std, init_vel_std;
+    try {
+        YAML::Node cfg = YAML::LoadFile(THIS_COM "config/ANYmal/INTERFACE.yaml");
+        YAML::Node node = cfg["state_estimator"];
+        my_utils::readParameter(node, "acc_noise", ekf_acc_noise);
+        my_utils::readParameter(node, "foot_noise", foot_noise);
+        my_utils::readParameter(node, "foot_swing_noise", foot_swing_noise);
+        my_utils::readParameter(node, "kin_noise", ekf_kin_noise);
+        my_utils::readParameter(node, "kin_swing_noise", kin_swing_noise);
+        my_utils::readParameter(node, "init_pos_std", init_pos_std);
+        my_utils::readParameter(node, "init_vel_std", init_vel_std);
+    } catch (std::runtime_error& e) {
+        std::cout << "Error reading parameter [" << e.what() << "] at file: ["
+                  << __FILE__ << "]" << std::endl
+                  << std::endl;
+        return 1;
+    }
+    if (foot_drift < 0.) foot_drift = foot_noise;
+
+    BaseEKF* ekf = new BaseEKF();
+    ekf->getSystemModel().setTimeStep(dt);
+    ekf->getSystemModel().setNoise(ekf_acc_noise, foot_noise, foot_swing_noise);
+    ekf->getMeasurementModel().setNoise(ekf_kin_noise, kin_swing_noise);
+
+    Latency latency;
+    uint64_t num_ekf_alloc = 0;
+    double sum_nees = 0.;
+    double sum_pos_err2 = 0., sum_vel_err2 = 0.;
+    uint64_t num_nees = 0, num_above = 0;
+    int num_ticks = (int)(duration / dt);
+    std::normal_distribution<double> normal(0., 1.);
+    for (int r(0); r < num_runs; ++r) {
+        std::mt19937 gen(r + 1);
+        auto noise = [&](double sigma) {
+            return Eigen::Vector3d(sigma * normal(gen), sigma * normal(gen), sigma * normal(gen));
+        };
+
+        Eigen::Vector3d pos(0., 0., 0.5), vel(0.3, 0., 0.);
+        std::array<Eigen::Vector3d, 4> feet = {
+            Eigen::Vector3d(0.3, 0.2, 0.), Eigen::Vector3d(0.3, -0.2, 0.),
+            Eigen::Vector3d(-0.3, 0.2, 0.), Eigen::Vector3d(-0.3, -0.2, 0.)};
+        std::array<Eigen::Vector3d, 4> foot_rel;
+        for (int i(0); i < 4; ++i) foot_rel[i] = feet[i] - pos;
+        // the initial error drawn from the initial covariance
+        ekf->initialize(pos + noise(init_pos_std), vel + noise(init_vel_std), foot_rel,
+                        init_pos_std, init_vel_std);
+
+        std::array<bool, 4> b_contact, b_contact_prev;
+        b_contact_prev.fill(true);
+        for (int k(0); k < num_ticks; ++k) {
+            // trot : LF-RH then RF-LH swing for 0.25 s after 0.1 s of full support
+            double t = k * dt;
+            double t_phase = std::fmod(t, 0.35);
+            int pair = (int)(t / 0.35) % 2;
+            for (int i(0); i < 4; ++i) {
+                bool b_pair = (i == 0 || i == 3) == (pair == 0);
+                b_contact[i] = t_phase < 0.1 || !b_pair;
+            }
+
+            Eigen::Vector3d acc(0.5 * std::sin(M_PI * t), 0.3 * std::cos(1.4 * M_PI * t),
+                                0.8 * std::sin(2. * M_PI * t / 0.35));
+            pos += dt * vel + 0.5 * dt * dt * acc;
+            vel += dt * acc;
+            for (int i(0); i < 4; ++i) {
+                if (b_contact[i]) continue;
+                double s = (t_phase - 0.1) / 0.25;
+                feet[i] += dt * Eigen::Vector3d(0.7, 0., 0.4 * M_PI * std::cos(M_PI * s));
+            }
+            for (int i(0); i < 4; ++i) {
+                // touchdown on the ground, then the stance foot drifts
+                if (b_contact[i] && !b_contact_prev[i]) feet[i].z() = 0.;
+                if (b_contact[i]) feet[i] += noise(foot_drift * std::sqrt(dt));
+                foot_rel[i] = feet[i] - pos + noise(kin_noise);
+            }
+            b_contact_prev = b_contact;
+            Eigen::Vector3d acc_meas = acc + noise(acc_noise);
+
+            num_alloc = 0;
+            b_count_alloc = true;
+            auto t_start = std::chrono::steady_clock::now();
+            ekf->predict(acc_meas, b_contact);
+            ekf->update(foot_rel);
+            latency.add(elapsedNs(t_start));
+            b_count_alloc = false;
+            num_ekf_alloc += num_alloc;
+
+            if (t < 1.) continue;
+            const BaseEKF::State& x = ekf->getState();
+            Eigen::Matrix<double, 6, 1> err;
+            err.head<3>() = x.pos() - pos;
+            err.tail<3>() = x.vel() - vel;
+            Eigen::Matrix<double, 6, 6> P = ekf->getCovariance().topLeftCorner<6, 6>();
+            double nees = err.dot(P.ldlt().solve(err));
+            sum_nees += nees;
+            num_above += nees > chi2_6_95;
+            sum_pos_err2 += err.head<3>().squaredNorm();
+            sum_vel_err2 += err.tail<3>().squaredNorm();
+            ++num_nees;
+        }
+    }
+    delete ekf;
+
+    double mean_nees = sum_nees / num_nees;
+    printf("%d runs of %.0f s, sensor noise acc %.3f m/s^2 kin %.4f m foot %.4f m/sqrt(s), "
+           "ekf acc %.3f kin %.4f foot %.4f\n", num_runs, duration, acc_noise, kin_noise,
+           foot_drift, ekf_acc_noise, ekf_kin_noise, foot_noise);
+    printf("%-22s %9s %9s %9s %9s %9s\n", "[us]", "count", "mean", "p50", "p99",
+           "p99.9");
+    latency.print("predict + update");
+    printf("allocations %llu\n", (unsigned long long)num_ekf_alloc);
+    printf("rms error pos %.4f m vel %.4f m/s\n", std::sqrt(sum_pos_err2 / num_nees),
+           std::sqrt(sum_vel_err2 / num_nees));
+    printf("mean NEES %.2f (6 dof), above the 95%% bound %.1f%%\n", mean_nees,
+           100. * num_above / num_nees);
+    bool b_ok = num_ekf_alloc == 0 && std::fabs(mean_nees - 6.) < 0.75;
+    printf("%s\n", b_ok ? "OK" : "FAILED");
+    return b_ok ? 0 : 1;
+}
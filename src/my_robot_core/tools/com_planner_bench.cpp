@@ -0,0 +1,201 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <../my_utils/Configuration.h>
+#include <my_robot_core/anymal_core/anymal_planner/anymal_com_planner_builder.hpp>
+#include <my_utils/IO/IOUtilities.hpp>
+#include <my_utils/IO/StageTiming.hpp>
+#include <my_wbc/QuadProgSolver.hpp>
+
+using my_utils::LatencyHistogram;
+
+// com_planner_bench [-n replans] [-w] [-m motion_script]
+// replans the alpha/beta QP of ANYmalCoMPlanner on a trot-like sequence
+// of stances, the feet and friction moving a little every replan, and
+// prints the latency of the problem build and of the solve with the heap
+// allocations of the build, which should be none. -w warm starts the
+// solver and keeps the unchanged foot blocks as incremental_replan with
+// update_tolerance 0. -m steps through the motions of a script under
+// config/ANYmal/MOTIONS instead, e.g. walkset.yaml, each step planned once
+// and replanned 9 times as the friction estimate of one stance foot moves.
+// Exits with 1 if the build allocates.
+static bool b_count_alloc = false;
+static uint64_t num_alloc = 0;
+
+// malloc of glibc counted, operator new and the Eigen storage go through it
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* malloc(size_t size) {
+    if (b_count_alloc) ++num_alloc;
+    return __libc_malloc(size);
+}
+
+struct Latency {
+    Latency() : buckets(LatencyHistogram::num_buckets, 0), count(0), sum_ns(0) {}
+    void add(uint64_t ns) {
+        ++buckets[LatencyHistogram::bucketIndex(ns)];
+        ++count;
+        sum_ns += ns;
+    }
+    void print(const char* name) const {
+        printf("%-22s %9llu %9.3f %9.3f %9.3f %9.3f\n", name,
+               (unsigned long long)count, count ? 1e-3 * sum_ns / count : 0.,
+               1e-3 * LatencyHistogram::quantile(buckets.data(), count, 0.5),
+               1e-3 * LatencyHistogram::quantile(buckets.data(), count, 0.99),
+               1e-3 * LatencyHistogram::quantile(buckets.data(), count, 0.999));
+    }
+    std::vector<uint64_t> buckets;
+    uint64_t count, sum_ns;
+};
+
+struct Step {
+    int foot;
+    Eigen::Vector3d dpos;
+    double T2, T3;
+};
+static const int replans_per_step = 10;
+
+static bool readScript(const std::string& file_name, std::vector<Step>& steps) {
+    try {
+        YAML::Node motion_cfg = YAML::LoadFile(THIS_COM "config/ANYmal/MOTIONS/" + file_name);
+        int num_motion;
+        my_utils::readParameter(motion_cfg, "num_motion", num_motion);
+        for (int i(0); i < num_motion; ++i) {
+            YAML::Node node = motion_cfg["motion" + std::to_string(i)];
+            Eigen::VectorXd pos, durations;
+            Step step;
+            my_utils::readParameter(node, "foot", step.foot);
+            my_utils::readParameter(node, "pos", pos);
+            my_utils::readParameter(node, "durations", durations);
+            if (durations.size() != 4) return false;
+            // as ANYmalCoMPlanner::_setPeriods
+            step.dpos = pos.head<3>();
+            step.T2 = durations(1) + durations(2);
+            step.T3 = durations(3);
+            steps.push_back(step);
+        }
+    } catch (std::exception& e) {
+        printf("cannot read %s : %s\n", file_name.c_str(), e.what());
+        return false;
+    }
+    return !steps.empty();
+}
+
+static uint64_t elapsedNs(const std::chrono::steady_clock::time_point& t_start) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - t_start).count();
+}
+
+int main(int argc, char** argv) {
+    int num = 20000;
+    bool b_warm = false;
+    std::string script;
+    for (int i(1); i < argc; ++i) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            num = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-w") == 0) {
+            b_warm = true;
+        } else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc) {
+            script = argv[++i];
+        } else {
+            printf("usage: com_planner_bench [-n replans] [-w] [-m motion_script]\n");
+            return 1;
+        }
+    }
+    std::vector<Step> steps;
+    if (!script.empty() && !readScript(script, steps)) return 1;
+
+    ANYmalCoMPlannerBuilder builder;
+    builder.setMass(35.);
+    builder.setAngularMomentumRate(Eigen::Vector3d::Zero());
+    builder.setUpdateTolerance(b_warm ? 0. : -1.);
+    QuadProgSolver solver;
+    solver.setVerbose(false);
+    solver.setWarmStart(b_warm);
+
+    std::array<Eigen::Vector3d, ANYmal::n_leg> foot_pos;
+    std::array<Eigen::Matrix3d, ANYmal::n_leg> foot_rot;
+    std::array<double, ANYmal::n_leg> foot_mu;
+    const double stance[ANYmal::n_leg][2] = {
+        {0.35, -0.2}, {0.35, 0.2}, {-0.35, 0.2}, {-0.35, -0.2}};
+    Eigen::Vector3d swing_dpos(0.1, 0., 0.);
+    Eigen::Vector3d p_goal(0.02, 0., 0.45);
+    Eigen::Matrix3d H = Eigen::Matrix3d::Identity();
+    Eigen::Vector3d f = Eigen::Vector3d::Zero();
+    Eigen::VectorXd x(3);
+    double T2 = 0.5, T3 = 0.1;
+    double ratio = ANYmalCoMPlannerBuilder::getSwingRatio(T2, T3);
+
+    Latency build_latency, solve_latency;
+    uint64_t num_build_alloc = 0;
+    int num_infeasible = 0;
+    srand(0);
+    int swing_foot = 0;
+    for (int i(0); i < ANYmal::n_leg; ++i) {
+        foot_pos[i] << stance[i][0], stance[i][1], 0.;
+        foot_rot[i].setIdentity();
+    }
+    for (int k(0); k < num; ++k) {
+        if (steps.empty()) {
+            // a new swing foot every 50 replans, the stance drifting between
+            swing_foot = (k / 50) % ANYmal::n_leg;
+            for (int i(0); i < ANYmal::n_leg; ++i) {
+                double noise = 1e-3 * ((double)rand() / RAND_MAX - 0.5);
+                foot_pos[i] << stance[i][0] + 0.05 * (k / 200 % 3) + noise,
+                    stance[i][1] + noise, 0.;
+                foot_mu[i] = 0.6 + 0.1 * ((k / 100 + i) % 2);
+            }
+        } else {
+            // the swing foot lands at the end of the step, the goal over
+            // the next stance, one stance foot sliding in between
+            int r = k % replans_per_step;
+            const Step& step = steps[k / replans_per_step % steps.size()];
+            if (r == 0) {
+                if (k > 0) foot_pos[swing_foot] += swing_dpos;
+                swing_foot = step.foot;
+                swing_dpos = step.dpos;
+                T2 = step.T2;
+                T3 = step.T3;
+                ratio = ANYmalCoMPlannerBuilder::getSwingRatio(T2, T3);
+                p_goal = swing_dpos;
+                for (int i(0); i < ANYmal::n_leg; ++i) p_goal += foot_pos[i];
+                p_goal /= ANYmal::n_leg;
+                p_goal(2) = 0.45;
+                for (int i(0); i < ANYmal::n_leg; ++i) foot_mu[i] = 0.6;
+            } else {
+                foot_mu[(swing_foot + 1 + r % 3) % ANYmal::n_leg] -= 0.01;
+            }
+        }
+
+        auto t_build = std::chrono::steady_clock::now();
+        b_count_alloc = true;
+        builder.update(foot_pos, foot_rot, foot_mu, swing_foot, swing_dpos, p_goal);
+        builder.clearConstraints();
+        builder.addEndTransitionCondition(T3);
+        builder.addSwingConditionGivenRatio(ratio, T2, T3);
+        b_count_alloc = false;
+        build_latency.add(elapsedNs(t_build));
+        num_build_alloc += num_alloc;
+        num_alloc = 0;
+
+        auto t_solve = std::chrono::steady_clock::now();
+        solver.setProblem(H, f, builder.getIeqMtx(), builder.getIeqVec());
+        double cost = solver.solveProblem(x);
+        solve_latency.add(elapsedNs(t_solve));
+        if (cost == std::numeric_limits<double>::infinity()) ++num_infeasible;
+    }
+
+    printf("%d replans%s%s, %s, %d constraints\n", num, script.empty() ? "" : " of ",
+           script.c_str(), b_warm ? "warm started" : "cold", builder.getNumConstraints());
+    printf("%-22s %9s %9s %9s %9s %9s\n", "[us]", "count", "mean", "p50", "p99",
+           "p99.9");
+    build_latency.print("build");
+    solve_latency.print("solve");
+    printf("allocations in build %llu, infeasible %d\n",
+           (unsigned long long)num_build_alloc, num_infeasible);
+    return num_build_alloc == 0 ? 0 : 1;
+}
@@ -0,0 +1,181 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <../my_utils/Configuration.h>
+#include <my_utils/IO/IOUtilities.hpp>
+#include <my_utils/Math/recursive_least_squares.h>
+
+// friction_estimation_sim [-t seconds] [-f force_noise] [-z sinkage_noise]
+// runs the friction and contact stiffness estimation of SlipObserver, with
+// the slip_observer_params of WALKING_PARAMS.yaml, on one foot stepping at
+// 2 Hz, 0.3 s of stance and 0.2 s of swing, on a ground which changes : mu
+// from 0.6 to 0.3 at 3 s then up to 0.5 from 6 s to 7 s, the stiffness
+// from 5e4 to 2e4 N/m at 4.5 s. The normal force rises after the touchdown
+// and oscillates, the foot slides over the last 0.1 s of every stance,
+// the forces are measured with force_noise [N] and the sinkage with
+// sinkage_noise [m]. Prints the time the applied mu takes to come within
+// 0.02 of the ground after the drop, its largest error while sliding
+// after that until 6 s, and the relative error of the stiffness at the end
+// of the stances and the largest condition number of its covariance,
+// estimated as now and as before the sinkage scaling and gate (P0 1e12 on
+// d, updated from the touchdown). Exits with 1 if mu takes more than 1.5 s,
+// three slides, or the stiffness is off by more than 10%.
+static const double dt = 0.001;
+static const double t_step = 0.5;
+static const double t_stance = 0.3;
+static const double t_slide = 0.1;
+static const double sinkage_scale = 1e-3; // as SlipObserver
+
+static double groundFriction(double t) {
+    if (t < 3.) return 0.6;
+    if (t < 6.) return 0.3;
+    return 0.3 + 0.2 * std::min(1., t - 6.);
+}
+
+static double groundStiffness(double t) { return t < 4.5 ? 5e4 : 2e4; }
+
+static double conditionNumber(const Eigen::Matrix2d& P) {
+    double m = 0.5 * P.trace();
+    double r = std::sqrt(0.25 * (P(0, 0) - P(1, 1)) * (P(0, 0) - P(1, 1)) + P(0, 1) * P(1, 0));
+    return (m + r) / std::max(m - r, 1e-300);
+}
+
+int main(int argc, char** argv) {
+    double duration = 9.;
+    double force_noise = 2.;
+    double sinkage_noise = 5e-5;
+    for (int i(1); i < argc; ++i) {
+        if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            duration = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            force_noise = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-z") == 0 && i + 1 < argc) {
+            sinkage_noise = atof(argv[++i]);
+        } else {
+            printf("usage: friction_estimation_sim [-t seconds] [-f force_noise] "
+                   "[-z sinkage_noise]\n");
+            return 1;
+        }
+    }
+
+    double forgetting_factor, min_normal_force, min_sinkage, mu_min, mu_max;
+    int mu_min_samples;
+    try {
+        YAML::Node cfg =
+            YAML::LoadFile(THIS_COM "config/ANYmal/ARCHITECTURE/WALKING_PARAMS.yaml");
+        YAML::Node node = cfg["slip_observer_params"];
+        my_utils::readParameter(node, "rls_forgetting_factor", forgetting_factor);
+        my_utils::readParameter(node, "rls_min_normal_force", min_normal_force);
+        my_utils::readParameter(node, "stiffness_min_sinkage", min_sinkage);
+        my_utils::readParameter(node, "mu_min_samples", mu_min_samples);
+        my_utils::readParameter(node, "mu_min", mu_min);
+        my_utils::readParameter(node, "mu_max", mu_max);
+    } catch (std::runtime_error& e) {
+        std::cout << "Error reading parameter [" << e.what() << "] at file: ["
+                  << __FILE__ << "]" << std::endl
+                  << std::endl;
+        return 1;
+    }
+
+    RecursiveLeastSquares<1> mu_rls;
+    Eigen::Matrix<double, 1, 1> mu0, P0_mu, phi_mu;
+    mu0 << 0.6;
+    P0_mu << 1.;
+    mu_rls.setForgettingFactor(forgetting_factor);
+    mu_rls.setMaxCovarianceTrace(P0_mu.trace());
+    mu_rls.initialize(mu0, P0_mu);
+
+    RecursiveLeastSquares<2> k_rls, k_rls_before;
+    Eigen::Matrix2d P0_k;
+    Eigen::Vector2d phi_k;
+    P0_k << 1e4, 0., 0., 1e4;
+    k_rls.setForgettingFactor(forgetting_factor);
+    k_rls.setMaxCovarianceTrace(P0_k.trace());
+    k_rls.initialize(Eigen::Vector2d::Zero(), P0_k);
+    P0_k << 1e12, 0., 0., 1e4;
+    k_rls_before.setForgettingFactor(forgetting_factor);
+    k_rls_before.setMaxCovarianceTrace(P0_k.trace());
+    k_rls_before.initialize(Eigen::Vector2d::Zero(), P0_k);
+
+    std::mt19937 gen(1);
+    std::normal_distribution<double> normal(0., 1.);
+    double mu_applied = mu0[0];
+    double t_converged = -1., max_mu_err = 0.;
+    std::vector<double> k_err, k_err_before;
+    double max_cond = 0., max_cond_before = 0.;
+    uint64_t sum_ns = 0, num_update = 0;
+    int num_ticks = (int)(duration / dt);
+    for (int n(0); n < num_ticks; ++n) {
+        double t = n * dt;
+        double t_phase = std::fmod(t, t_step);
+        if (t_phase >= t_stance) continue;
+
+        // the normal force rises over 30 ms from the touchdown, f_0 the
+        // force at which the contact is detected
+        double f0 = min_normal_force;
+        double fz = f0 + (1. - std::exp(-t_phase / 0.03)) *
+                             (130. + 60. * std::sin(2. * M_PI * 1.3 * t));
+        double k = groundStiffness(t);
+        double d = (fz - f0) / k + sinkage_noise * normal(gen);
+        double fz_meas = fz + force_noise * normal(gen);
+        bool b_slide = t_phase > t_stance - t_slide;
+        double ft_meas = b_slide ? groundFriction(t) * fz + force_noise * normal(gen)
+                                 : 0.;
+
+        auto t_start = std::chrono::steady_clock::now();
+        if (std::fabs(d) > min_sinkage) {
+            phi_k << d / sinkage_scale, 1.;
+            k_rls.update(phi_k, fz_meas);
+        }
+        if (b_slide) {
+            phi_mu << fz_meas;
+            mu_rls.update(phi_mu, std::fabs(ft_meas));
+        }
+        sum_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::steady_clock::now() - t_start).count();
+        ++num_update;
+        if (b_slide && mu_rls.getNumUpdate() >= mu_min_samples)
+            mu_applied = std::max(mu_min, std::min(mu_max, mu_rls.getParameter(0)));
+
+        phi_k << d, 1.;
+        k_rls_before.update(phi_k, fz_meas);
+        max_cond = std::max(max_cond, conditionNumber(k_rls.getCovariance()));
+        max_cond_before =
+            std::max(max_cond_before, conditionNumber(k_rls_before.getCovariance()));
+
+        if (b_slide && t > 3.) {
+            double err = std::fabs(mu_applied - groundFriction(t));
+            if (t_converged < 0. && err < 0.02) t_converged = t - 3.;
+            if (t_converged >= 0. && t < 6.) max_mu_err = std::max(max_mu_err, err);
+        }
+        // end of the stance, after the first steps and the stiffness change
+        if (n % (int)(t_step / dt) == (int)(t_stance / dt) - 1 && t > 1. &&
+            (t < 4.5 || t > 5.5)) {
+            k_err.push_back(std::fabs(k_rls.getParameter(0) / sinkage_scale - k) / k);
+            k_err_before.push_back(std::fabs(k_rls_before.getParameter(0) - k) / k);
+        }
+    }
+
+    std::sort(k_err.begin(), k_err.end());
+    std::sort(k_err_before.begin(), k_err_before.end());
+    printf("%.0f s, force noise %.1f N, sinkage noise %.0e m, min sinkage %.0e m\n", duration,
+           force_noise, sinkage_noise, min_sinkage);
+    printf("mu 0.6 -> 0.3 : within 0.02 after %.3f s, largest error after %.4f\n",
+           t_converged, max_mu_err);
+    printf("%-22s %9s %9s %9s\n", "stiffness", "median", "max", "cond(P)");
+    printf("%-22s %9.4f %9.4f %9.1e\n", "gated", k_err[k_err.size() / 2], k_err.back(),
+           max_cond);
+    printf("%-22s %9.4f %9.4f %9.1e\n", "before", k_err_before[k_err_before.size() / 2],
+           k_err_before.back(), max_cond_before);
+    printf("%.1f ns per update\n", (double)sum_ns / num_update);
+    bool b_ok = t_converged >= 0. && t_converged < 1.5 && k_err.back() < 0.1;
+    printf("%s\n", b_ok ? "OK" : "FAILED");
+    return b_ok ? 0 : 1;
+}
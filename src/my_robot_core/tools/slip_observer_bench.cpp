@@ -0,0 +1,303 @@
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <vector>
+
+#include <my_robot_core/anymal_core/anymal_definition.hpp>
+#include <my_utils/IO/StageTiming.hpp>
+#include <my_utils/Math/low_pass_filter.h>
+#include <my_utils/Math/pseudo_inverse.hpp>
+
+using my_utils::LatencyHistogram;
+
+// slip_observer_bench [-n ticks]
+// replays the per-tick work of SlipObserver (checkVelocity and checkForce)
+// on the ANYmal sizes with random jacobians, mass matrix and torques, one
+// foot swinging every other phase of 100 ticks: once as before the fixed
+// array rewrite, VectorXd in std::map, conservativeResize stacking and
+// my_utils::pseudoInverse, and once as now. The robot model calls are left
+// out, the same in both. Prints the latency and the heap allocations per
+// tick of both, exits with 1 if the desired grf differ or the new tick
+// allocates.
+static const int dim_grf = 3;
+static const int max_grf = dim_grf*ANYmal::n_leg;
+
+static bool b_count_alloc = false;
+static uint64_t num_alloc = 0;
+
+// malloc of glibc counted, operator new and the Eigen storage go through it
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* malloc(size_t size) {
+    if (b_count_alloc) ++num_alloc;
+    return __libc_malloc(size);
+}
+
+struct Latency {
+    Latency() : buckets(LatencyHistogram::num_buckets, 0), count(0), sum_ns(0) {}
+    void add(uint64_t ns) {
+        ++buckets[LatencyHistogram::bucketIndex(ns)];
+        ++count;
+        sum_ns += ns;
+    }
+    void print(const char* name) const {
+        printf("%-22s %9llu %9.3f %9.3f %9.3f %9.3f\n", name,
+               (unsigned long long)count, count ? 1e-3 * sum_ns / count : 0.,
+               1e-3 * LatencyHistogram::quantile(buckets.data(), count, 0.5),
+               1e-3 * LatencyHistogram::quantile(buckets.data(), count, 0.99),
+               1e-3 * LatencyHistogram::quantile(buckets.data(), count, 0.999));
+    }
+    std::vector<uint64_t> buckets;
+    uint64_t count, sum_ns;
+};
+
+static uint64_t elapsedNs(const std::chrono::steady_clock::time_point& t_start) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - t_start).count();
+}
+
+// what the robot model and the state provider give every tick
+struct Inputs {
+    std::array<Eigen::MatrixXd, ANYmal::n_leg> Jc;
+    std::array<Eigen::VectorXd, ANYmal::n_leg> JcDotQdot;
+    Eigen::MatrixXd Minv;
+    Eigen::VectorXd coriolis, grav, qdot, qddot;
+    Eigen::VectorXd tau_a; // actuated joints
+    Eigen::MatrixXd Sa;
+    int swing_foot;
+};
+
+// SlipObserver before the rewrite
+class OldObserver {
+   public:
+    OldObserver() {
+        for (int i(0); i < ANYmal::n_leg; ++i) {
+            lpf_[i] = new LowPassFilter2();
+            lpf_[i]->initialize(dim_grf, 30.);
+            dim_grf_map_[i] = dim_grf;
+        }
+    }
+    ~OldObserver() {
+        for (int i(0); i < ANYmal::n_leg; ++i) delete lpf_[i];
+    }
+
+    void tick(const Inputs& in) {
+        // updateContact
+        qdot_ = in.qdot;
+        qddot_ = in.qddot;
+        Minv_ = in.Minv;
+        grav_ = in.grav;
+        coriolis_ = in.coriolis;
+        for (int i(0); i < ANYmal::n_leg; ++i) b_foot_contact_map_[i] = in.swing_foot != i;
+
+        // checkVelocityFoot
+        for (int i(0); i < ANYmal::n_leg; ++i) {
+            Eigen::MatrixXd Jc = in.Jc[i];
+            Eigen::VectorXd JcDotQdot = in.JcDotQdot[i];
+            Eigen::VectorXd xcdot = Jc * qdot_;
+            Eigen::VectorXd xcddot = Jc * qddot_ + JcDotQdot;
+            foot_vel_map_[i] = lpf_[i]->update(xcdot);
+            foot_acc_map_[i] = xcddot;
+        }
+
+        // checkForce
+        Eigen::MatrixXd Jc_i, Jc;
+        int dim = 0;
+        for (int i(0); i < ANYmal::n_leg; ++i) {
+            if (!b_foot_contact_map_[i]) continue;
+            Jc_i = in.Jc[i];
+            if (dim == 0) {
+                Jc = Jc_i;
+            } else {
+                Jc.conservativeResize(dim + Jc_i.rows(), ANYmal::n_dof);
+                Jc.block(dim, 0, Jc_i.rows(), ANYmal::n_dof) = Jc_i;
+            }
+            dim += Jc_i.rows();
+        }
+        Eigen::MatrixXd Ainv;
+        Eigen::MatrixXd A = Jc * Minv_ * Jc.transpose();
+        my_utils::pseudoInverse(A, 0.0001, Ainv);
+        Eigen::VectorXd grf = Ainv * (Jc * Minv_ * in.Sa.transpose() * in.tau_a -
+                                      Jc * qddot_ - Jc * Minv_ * (coriolis_ + grav_));
+        dim = 0;
+        for (auto& contact : b_foot_contact_map_) {
+            if (contact.second) {
+                grf_des_map_[contact.first] = grf.segment(dim, dim_grf_map_[contact.first]);
+                dim += dim_grf_map_[contact.first];
+            } else {
+                grf_des_map_[contact.first] = Eigen::VectorXd::Zero(dim_grf);
+            }
+        }
+    }
+    Eigen::Vector3d getGRFDesired(int i) { return grf_des_map_[i]; }
+
+   private:
+    std::array<LowPassFilter2*, ANYmal::n_leg> lpf_;
+    std::map<int, bool> b_foot_contact_map_;
+    std::map<int, int> dim_grf_map_;
+    std::map<int, Eigen::VectorXd> foot_vel_map_;
+    std::map<int, Eigen::VectorXd> foot_acc_map_;
+    std::map<int, Eigen::VectorXd> grf_des_map_;
+    Eigen::VectorXd qdot_, qddot_, grav_, coriolis_;
+    Eigen::MatrixXd Minv_;
+};
+
+// SlipObserver now
+class NewObserver {
+   public:
+    NewObserver() : svd_(max_grf, max_grf, Eigen::ComputeThinU | Eigen::ComputeThinV) {
+        for (int i(0); i < ANYmal::n_leg; ++i) lpf_[i].initialize(30.);
+        Jc_i_ = Eigen::MatrixXd::Zero(dim_grf, ANYmal::n_dof);
+        JcDotQdot_i_ = Eigen::VectorXd::Zero(dim_grf);
+        tau_cg_ = Eigen::VectorXd::Zero(ANYmal::n_dof);
+    }
+
+    void tick(const Inputs& in, const Eigen::VectorXd& tau) {
+        for (int i(0); i < ANYmal::n_leg; ++i) b_foot_contact_[i] = in.swing_foot != i;
+
+        // checkVelocityFoot
+        for (int i(0); i < ANYmal::n_leg; ++i) {
+            Jc_i_ = in.Jc[i];
+            JcDotQdot_i_ = in.JcDotQdot[i];
+            xcdot_.noalias() = Jc_i_ * in.qdot;
+            foot_acc_[i] = JcDotQdot_i_;
+            foot_vel_[i] = lpf_[i].update(xcdot_);
+        }
+
+        // computeGRFDesired
+        int dim = 0;
+        for (int i(0); i < ANYmal::n_leg; ++i)
+            if (b_foot_contact_[i]) dim += dim_grf;
+        Jc_.resize(dim, ANYmal::n_dof);
+        dim = 0;
+        for (int i(0); i < ANYmal::n_leg; ++i) {
+            if (!b_foot_contact_[i]) continue;
+            Jc_i_ = in.Jc[i];
+            Jc_.middleRows<dim_grf>(dim) = Jc_i_;
+            dim += dim_grf;
+        }
+        JcMinv_.noalias() = Jc_ * in.Minv;
+        A_.noalias() = JcMinv_ * Jc_.transpose();
+        const double sigma_threshold = 0.0001;
+        svd_.compute(A_, Eigen::ComputeThinU | Eigen::ComputeThinV);
+        grf_stacked_ = svd_.singularValues();
+        for (int k(0); k < grf_stacked_.size(); ++k) {
+            double sigma = grf_stacked_(k);
+            grf_stacked_(k) = sigma > sigma_threshold ? 1.0 / sigma
+                                                      : sigma / sigma_threshold / sigma_threshold;
+        }
+        Ainv_.noalias() = svd_.matrixV() * grf_stacked_.asDiagonal() * svd_.matrixU().transpose();
+        tau_cg_ = tau - in.coriolis - in.grav;
+        grf_stacked_.noalias() = JcMinv_ * tau_cg_;
+        grf_stacked_ = Ainv_ * grf_stacked_;
+        dim = 0;
+        for (int i(0); i < ANYmal::n_leg; ++i) {
+            if (b_foot_contact_[i]) {
+                grf_des_[i] = grf_stacked_.segment<dim_grf>(dim);
+                dim += dim_grf;
+            } else {
+                grf_des_[i].setZero();
+            }
+        }
+    }
+    const Eigen::Vector3d& getGRFDesired(int i) const { return grf_des_[i]; }
+
+   private:
+    // as SlipObserver, fixed capacity
+    typedef Eigen::Matrix<double, Eigen::Dynamic, ANYmal::n_dof, Eigen::ColMajor, max_grf,
+                          ANYmal::n_dof> StackedJacobian;
+    typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::ColMajor, max_grf,
+                          max_grf> StackedMatrix;
+    typedef Eigen::Matrix<double, Eigen::Dynamic, 1, Eigen::ColMajor, max_grf, 1> StackedVector;
+
+    std::array<LowPassFilter2Fixed<dim_grf>, ANYmal::n_leg> lpf_;
+    std::array<bool, ANYmal::n_leg> b_foot_contact_;
+    std::array<Eigen::Vector3d, ANYmal::n_leg> foot_vel_;
+    std::array<Eigen::Vector3d, ANYmal::n_leg> foot_acc_;
+    std::array<Eigen::Vector3d, ANYmal::n_leg> grf_des_;
+    Eigen::MatrixXd Jc_i_;
+    Eigen::VectorXd JcDotQdot_i_;
+    Eigen::Vector3d xcdot_;
+    Eigen::VectorXd tau_cg_;
+    StackedJacobian Jc_;
+    StackedJacobian JcMinv_;
+    StackedMatrix A_;
+    StackedMatrix Ainv_;
+    StackedVector grf_stacked_;
+    Eigen::JacobiSVD<StackedMatrix> svd_;
+};
+
+int main(int argc, char** argv) {
+    int num = 20000;
+    for (int i(1); i < argc; ++i) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            num = atoi(argv[++i]);
+        } else {
+            printf("usage: slip_observer_bench [-n ticks]\n");
+            return 1;
+        }
+    }
+
+    srand(0);
+    Inputs in;
+    Eigen::MatrixXd M = Eigen::MatrixXd::Random(ANYmal::n_dof, ANYmal::n_dof);
+    M = M * M.transpose() + ANYmal::n_dof * Eigen::MatrixXd::Identity(ANYmal::n_dof, ANYmal::n_dof);
+    in.Minv = M.inverse();
+    in.coriolis = Eigen::VectorXd::Random(ANYmal::n_dof);
+    in.grav = Eigen::VectorXd::Random(ANYmal::n_dof);
+    in.qddot = Eigen::VectorXd::Zero(ANYmal::n_dof);
+    in.Sa = Eigen::MatrixXd::Zero(ANYmal::n_adof, ANYmal::n_dof);
+    for (int i(0); i < ANYmal::n_adof; ++i) in.Sa(i, ANYmal::idx_adof[i]) = 1.;
+    for (int i(0); i < ANYmal::n_leg; ++i) in.JcDotQdot[i] = Eigen::VectorXd::Zero(dim_grf);
+    Eigen::VectorXd tau(ANYmal::n_dof);
+
+    OldObserver old_observer;
+    NewObserver new_observer;
+    Latency old_latency, new_latency;
+    uint64_t num_old_alloc = 0, num_new_alloc = 0;
+    double max_error = 0.;
+    for (int k(0); k < num; ++k) {
+        for (int i(0); i < ANYmal::n_leg; ++i)
+            in.Jc[i] = Eigen::MatrixXd::Random(dim_grf, ANYmal::n_dof);
+        in.qdot = Eigen::VectorXd::Random(ANYmal::n_dof);
+        in.tau_a = Eigen::VectorXd::Random(ANYmal::n_adof);
+        in.swing_foot = (k / 100) % 2 ? (k / 200) % ANYmal::n_leg : -1;
+        tau = in.Sa.transpose() * in.tau_a;
+
+        num_alloc = 0;
+        b_count_alloc = true;
+        auto t_start = std::chrono::steady_clock::now();
+        old_observer.tick(in);
+        old_latency.add(elapsedNs(t_start));
+        b_count_alloc = false;
+        num_old_alloc += num_alloc;
+
+        num_alloc = 0;
+        b_count_alloc = true;
+        t_start = std::chrono::steady_clock::now();
+        new_observer.tick(in, tau);
+        new_latency.add(elapsedNs(t_start));
+        b_count_alloc = false;
+        num_new_alloc += num_alloc;
+
+        for (int i(0); i < ANYmal::n_leg; ++i) {
+            double error = (old_observer.getGRFDesired(i) - new_observer.getGRFDesired(i))
+                               .cwiseAbs().maxCoeff();
+            max_error = std::max(max_error, error);
+        }
+    }
+
+    printf("%d ticks, %d dof\n", num, ANYmal::n_dof);
+    printf("%-22s %9s %9s %9s %9s %9s\n", "[us]", "count", "mean", "p50", "p99",
+           "p99.9");
+    old_latency.print("std::map, VectorXd");
+    new_latency.print("fixed arrays");
+    printf("allocations per tick %.1f -> %.1f, max grf difference %g\n",
+           (double)num_old_alloc / num, (double)num_new_alloc / num, max_error);
+    bool b_ok = num_new_alloc == 0 && max_error < 1e-9;
+    printf("%s\n", b_ok ? "OK" : "FAILED");
+    return b_ok ? 0 : 1;
+}
@@ -20,6 +20,8 @@ class RobotSystem {
     Eigen::MatrixXd I_cent_;
     Eigen::MatrixXd J_cent_;
     Eigen::MatrixXd A_cent_;
+    // number of updateSystem calls
+    long num_update_;
 
     /*
      * Update I_cent_, A_cent_, J_cent_
@@ -85,11 +87,12 @@ class RobotSystem {
         return skel_ptr_->getPositionUpperLimits();
     }
 
-    Eigen::MatrixXd getMassMatrix();
-    Eigen::MatrixXd getInvMassMatrix();
-    Eigen::VectorXd getGravity();
-    Eigen::VectorXd getCoriolis();
-    Eigen::VectorXd getCoriolisGravity();
+    // references to the skeleton caches, valid until the next update
+    const Eigen::MatrixXd& getMassMatrix();
+    const Eigen::MatrixXd& getInvMassMatrix();
+    const Eigen::VectorXd& getGravity();
+    const Eigen::VectorXd& getCoriolis();
+    const Eigen::VectorXd& getCoriolisGravity();
 
     Eigen::MatrixXd getCentroidJacobian();
     Eigen::MatrixXd getCentroidInertiaTimesJacobian();
@@ -108,6 +111,8 @@ class RobotSystem {
         dart::dynamics::Frame* wrt_ = dart::dynamics::Frame::World());
     void updateSystem(const Eigen::VectorXd& q_, const Eigen::VectorXd& qdot_,
                       bool isUpdatingCentroid_ = true);
+    // changes at every updateSystem, e.g. to reuse kinematics within a tick
+    long getNumUpdate() { return num_update_; }
 
     Eigen::Isometry3d getBodyNodeIsometry(
         const std::string& name_,
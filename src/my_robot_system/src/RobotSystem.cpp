@@ -18,6 +18,7 @@ RobotSystem::RobotSystem(int numVirtual_, std::string file) {
     I_cent_ = Eigen::MatrixXd::Zero(6, 6);
     J_cent_ = Eigen::MatrixXd::Zero(6, num_dof_);
     A_cent_ = Eigen::MatrixXd::Zero(6, num_dof_);
+    num_update_ = 0;
     
     setActuatedJoint();
 }
@@ -42,22 +43,22 @@ Eigen::VectorXd RobotSystem::getActiveJointValue(const Eigen::VectorXd& q_full)
     return  q_a;
 }
 
-Eigen::MatrixXd RobotSystem::getMassMatrix() {
+const Eigen::MatrixXd& RobotSystem::getMassMatrix() {
     return skel_ptr_->getMassMatrix();
 }
 
-Eigen::MatrixXd RobotSystem::getInvMassMatrix() {
+const Eigen::MatrixXd& RobotSystem::getInvMassMatrix() {
     return skel_ptr_->getInvMassMatrix();
 }
-Eigen::VectorXd RobotSystem::getCoriolisGravity() {
+const Eigen::VectorXd& RobotSystem::getCoriolisGravity() {
     return skel_ptr_->getCoriolisAndGravityForces();
 }
 
-Eigen::VectorXd RobotSystem::getCoriolis() {
+const Eigen::VectorXd& RobotSystem::getCoriolis() {
     return skel_ptr_->getCoriolisForces();
 }
 
-Eigen::VectorXd RobotSystem::getGravity() {
+const Eigen::VectorXd& RobotSystem::getGravity() {
     return skel_ptr_->getGravityForces();
 }
 
@@ -338,6 +339,7 @@ void RobotSystem::updateSystem(const Eigen::VectorXd& q_,
     skel_ptr_->setVelocities(qdot_);
     if (isUpdatingCentroid) _updateCentroidFrame(q_, qdot_);
     skel_ptr_->computeForwardKinematics();
+    ++num_update_;
 }
 
 void RobotSystem::_updateCentroidFrame(const Eigen::VectorXd& q_,
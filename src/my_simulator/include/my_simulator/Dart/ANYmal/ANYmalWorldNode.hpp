@@ -2,6 +2,7 @@
 
 #include <Eigen/Dense>
 #include <queue> 
+#include <random>
 #include <dart/dart.hpp>
 #include <dart/gui/GLFuncs.hpp>
 #include <dart/gui/osg/osg.hpp>
@@ -13,12 +14,14 @@
 class EnvInterface;
 class ANYmalSensorData;
 class ANYmalCommand;
+class ANYmalShmClient;
 
 class ANYmalWorldNode : public dart::gui::osg::WorldNode {
    private:
     void UpdateContactDistance_();
     void UpdateContactSwitchData_();
     void UpdateContactWrenchData_();
+    void UpdateImuData_();
     
     void PlotResult_();
     void PlotFootStepResult_();
@@ -30,7 +33,10 @@ class ANYmalWorldNode : public dart::gui::osg::WorldNode {
 
     void saveData();
 
+    // controller in the simulator, or in its own process through the
+    // shared memory (controller_transport: shm), only one is set
     EnvInterface* interface_;
+    ANYmalShmClient* shm_client_;
     ANYmalSensorData* sensor_data_;
     ANYmalCommand* command_;
 
@@ -60,6 +66,12 @@ class ANYmalWorldNode : public dart::gui::osg::WorldNode {
 
     bool b_plot_result_;
 
+    // simulated imu noise (std)
+    double imu_acc_noise_;
+    double imu_gyro_noise_;
+    std::mt19937 imu_noise_gen_;
+    std::normal_distribution<double> imu_noise_;
+
    public:
     ANYmalWorldNode(const dart::simulation::WorldPtr& world);
     virtual ~ANYmalWorldNode();
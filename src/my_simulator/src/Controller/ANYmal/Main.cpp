@@ -0,0 +1,78 @@
+#include <unistd.h>
+#include <atomic>
+#include <../my_utils/Configuration.h>
+#include <my_robot_core/anymal_core/anymal_shm_transport.hpp>
+#include <my_utils/IO/IOUtilities.hpp>
+#include <my_utils/IO/RtThread.hpp>
+
+// ticks of the controller at a fixed period on the latest sensor data
+class ControlTask : public my_utils::RtThread {
+   public:
+    ControlTask(ANYmalShmServer* server, double period)
+        : server_(server), period_(period), num_no_data_(0) {}
+    ~ControlTask() { stop(); }
+    uint64_t getNoDataCount() const { return num_no_data_; }
+
+   protected:
+    void step() {
+        // the sensor data of the tick may come within half of the period
+        if (!server_->spinOnce(0.5 * period_)) ++num_no_data_;
+    }
+
+   private:
+    ANYmalShmServer* server_;
+    double period_;
+    std::atomic<uint64_t> num_no_data_;
+};
+
+// ANYmal controller in its own process, for run_anymal with
+// controller_transport: shm in SIMULATION.yaml
+int main(int argc, char** argv) {
+    my_utils::ShmWakeup shm_wakeup = my_utils::ShmWakeup::Futex;
+    my_utils::RtThreadConfig rt_config;
+    rt_config.name = "controller";
+    try {
+        YAML::Node simulation_cfg =
+            YAML::LoadFile(THIS_COM "config/ANYmal/SIMULATION.yaml");
+        std::string wakeup;
+        my_utils::readParameter(simulation_cfg, "shm_wakeup", wakeup);
+        if (!my_utils::parseShmWakeup(wakeup, shm_wakeup))
+            throw std::runtime_error("shm_wakeup");
+        YAML::Node rt_cfg = simulation_cfg["controller_rt"];
+        my_utils::readParameter(rt_cfg, "period", rt_config.period);
+        my_utils::readParameter(rt_cfg, "priority", rt_config.priority);
+        my_utils::readParameter(rt_cfg, "cpu", rt_config.cpu);
+        my_utils::readParameter(rt_cfg, "lock_memory", rt_config.b_lock_memory);
+    } catch (std::runtime_error& e) {
+        std::cout << "Error reading parameter [" << e.what() << "] at file: ["
+                  << __FILE__ << "]" << std::endl
+                  << std::endl;
+        exit(0);
+    }
+
+    ANYmalShmServer server(shm_wakeup);
+    server.connect();
+    if (rt_config.period > 0.) {
+        ControlTask task(&server, rt_config.period);
+        if (!task.start(rt_config)) return 1;
+        while (true) {
+            sleep(1);
+            my_utils::RtThreadStats stats = task.getStats();
+            std::cout << "controller ("
+                      << (task.isRealTime() ? "SCHED_FIFO" : "default scheduler")
+                      << ") cycles " << stats.num_cycles << " overruns "
+                      << stats.num_overruns << " missed " << stats.num_missed
+                      << " no sensor data " << task.getNoDataCount()
+                      << " max wakeup [us] " << 1e-3 * stats.max_wakeup_ns
+                      << std::endl;
+        }
+    }
+
+    // on each sensor data, in this thread
+    my_utils::RtThread::configureCurrentThread(rt_config);
+    while (true) {
+        if (!server.spinOnce(1.))
+            std::cout << "no sensor data from the simulator for 1 s" << std::endl;
+    }
+    return 0;
+}
@@ -1,8 +1,20 @@
 #include <../my_utils/Configuration.h>
 #include <my_robot_core/anymal_core/anymal_interface.hpp>
+#include <my_robot_core/anymal_core/anymal_shm_transport.hpp>
 #include <my_simulator/Dart/ANYmal/ANYmalWorldNode.hpp>
 
 #include <my_utils/Math/MathUtilities.hpp>
+#include <my_utils/IO/LogChannel.hpp>
+
+MY_LOG_CHANNEL(log_qdot_sen, "qdot_sen_simulation", ANYmal::n_adof, 1, true);
+MY_LOG_CHANNEL(log_qdot_cmd, "qdot_cmd_simulation", ANYmal::n_adof, 1, true);
+MY_LOG_CHANNEL(log_q_sen, "q_sen_simulation", ANYmal::n_adof, 1, true);
+MY_LOG_CHANNEL(log_q_cmd, "q_cmd_simulation", ANYmal::n_adof, 1, true);
+MY_LOG_CHANNEL(log_jtrq, "jtrq_simulation", ANYmal::n_adof, 1, true);
+MY_LOG_CHANNEL(log_jtrq_cmd, "jtrq_cmd_simulation", ANYmal::n_dof, 1, true);
+MY_LOG_CHANNEL(log_com, "com_simulation", 3, 1, true);
+static const std::array<my_utils::LogChannel, ANYmal::n_leg> log_wrench =
+    my_utils::makeLogChannels(ANYmalFoot::Names, "_wrench_local", 6);
 
 
 ANYmalWorldNode::ANYmalWorldNode(const dart::simulation::WorldPtr& _world)
@@ -35,14 +47,21 @@ ANYmalWorldNode::ANYmalWorldNode(const dart::simulation::WorldPtr& _world)
     }
     trq_cmd_ = Eigen::VectorXd::Zero(n_dof_);
 
-    // ---- SET INTERFACE
-    interface_ = new ANYmalInterface();
+    // imu noise
+    imu_acc_noise_ = 0.;
+    imu_gyro_noise_ = 0.;
+    imu_noise_ = std::normal_distribution<double>(0., 1.);
+
+    // ---- SET INTERFACE : @ setParameters
+    interface_ = NULL;
+    shm_client_ = NULL;
     sensor_data_ = new ANYmalSensorData();
     command_ = new ANYmalCommand();
 }
 
 ANYmalWorldNode::~ANYmalWorldNode() {
     delete interface_;
+    delete shm_client_;
     delete sensor_data_;
     delete command_;
 }
@@ -71,7 +90,10 @@ void ANYmalWorldNode::customPostStep(){
 
 void ANYmalWorldNode::enableButtonFlag(uint16_t key) {
     std::cout << "button(" << (char)key << ") pressed handled @ ANYmalWorldNode::enableButtonFlag" << std::endl;
-    ((ANYmalInterface*)interface_) -> interrupt_ -> setFlags(key);    
+    if (shm_client_)
+        shm_client_->setButton(key);
+    else
+        ((ANYmalInterface*)interface_) -> interrupt_ -> setFlags(key);    
 }
 
 void ANYmalWorldNode::customPreStep() {
@@ -100,11 +122,17 @@ void ANYmalWorldNode::customPreStep() {
     UpdateContactSwitchData_();
     // update sensor_data_->foot_wrench
     UpdateContactWrenchData_();
+    // update sensor_data_->imu_
+    UpdateImuData_();
 
     // --------------------------------------------------------------
     //          COMPUTE COMMAND - desired joint acc/trq etc
     // --------------------------------------------------------------
-    ((ANYmalInterface*)interface_)->getCommand(sensor_data_, command_);    
+    // the command of the last tick is held if the controller process is late
+    if (shm_client_)
+        shm_client_->exchange(sensor_data_, command_);
+    else
+        ((ANYmalInterface*)interface_)->getCommand(sensor_data_, command_);    
 
     trq_cmd_.setZero();
     for(int i=0; i< ANYmal::n_adof; ++i) {
@@ -135,7 +163,8 @@ void ANYmalWorldNode::customPreStep() {
     //          Plot
     // --------------------------------------------------------------
 
-    if (b_plot_result_) {
+    // the planners of the controller process are not reachable
+    if (b_plot_result_ && interface_) {
         if (((ANYmalInterface*)interface_)->IsPlannerUpdated()) {
             PlotResult_();
         }
@@ -151,12 +180,12 @@ void ANYmalWorldNode::customPreStep() {
 void ANYmalWorldNode::saveData() {
 
     // joint command
-    my_utils::saveVector(sensor_data_->qdot, "qdot_sen_simulation");
-    my_utils::saveVector(command_->qdot, "qdot_cmd_simulation");
-    my_utils::saveVector(sensor_data_->q, "q_sen_simulation");
-    my_utils::saveVector(command_->q, "q_cmd_simulation");
-    my_utils::saveVector(command_->jtrq, "jtrq_simulation");    
-    my_utils::saveVector(trq_cmd_, "jtrq_cmd_simulation");    
+    MY_LOG(log_qdot_sen, sensor_data_->qdot);
+    MY_LOG(log_qdot_cmd, command_->qdot);
+    MY_LOG(log_q_sen, sensor_data_->q);
+    MY_LOG(log_q_cmd, command_->q);
+    MY_LOG(log_jtrq, command_->jtrq);
+    MY_LOG(log_jtrq_cmd, trq_cmd_);
     // my_utils::pretty_print(command_->jtrq, std::cout, "command_->jtrq");
     // my_utils::pretty_print(command_->qdot,std::cout, "command_->qdot");
     // my_utils::pretty_print(sensor_data_->qdot, std::cout, "sensor_data_->qdot");
@@ -167,15 +196,11 @@ void ANYmalWorldNode::saveData() {
     // std::cout<<"----------------"<<std::endl;
 
     // contact force
-    std::string filename;
-    for(int ii(0); ii<ANYmal::n_leg;++ii){
-        filename = ANYmalFoot::Names[ii] + "_wrench_local";  
-        my_utils::saveVector(sensor_data_->foot_wrench[ii],filename);
-    }
+    for(int ii(0); ii<ANYmal::n_leg; ++ii)
+        MY_LOG(log_wrench[ii], sensor_data_->foot_wrench[ii]);
 
     // com position
-    Eigen::Vector3d pcom = robot_->getCOM();
-    my_utils::saveVector(pcom, "com_simulation");  
+    MY_LOG(log_com, robot_->getCOM());
 
 }
 
@@ -330,6 +355,9 @@ void ANYmalWorldNode::PlotFootStepResult_() {
 
 void ANYmalWorldNode::setParameters(const YAML::Node& simulation_cfg) {
     // will be called @ Main.cpp, after created
+    std::string controller_transport = "local";
+    my_utils::ShmWakeup shm_wakeup = my_utils::ShmWakeup::Futex;
+    double shm_timeout(0.);
     try {
         my_utils::readParameter(simulation_cfg, "servo_rate", servo_rate_);
         my_utils::readParameter(simulation_cfg["control_configuration"], "kp", kp_);
@@ -339,7 +367,17 @@ void ANYmalWorldNode::setParameters(const YAML::Node& simulation_cfg) {
         
         // setting 
         my_utils::readParameter(simulation_cfg["contact_params"], "friction", coef_fric_);
-
+        my_utils::readParameter(simulation_cfg["imu_params"], "acc_noise", imu_acc_noise_);
+        my_utils::readParameter(simulation_cfg["imu_params"], "gyro_noise", imu_gyro_noise_);
+
+        my_utils::readParameter(simulation_cfg, "controller_transport", controller_transport);
+        if (controller_transport == "shm") {
+            std::string wakeup;
+            my_utils::readParameter(simulation_cfg, "shm_wakeup", wakeup);
+            my_utils::readParameter(simulation_cfg, "shm_timeout", shm_timeout);
+            if (!my_utils::parseShmWakeup(wakeup, shm_wakeup))
+                throw std::runtime_error("shm_wakeup");
+        }
     } 
     catch (std::runtime_error& e) {
         std::cout << "Error reading parameter [" << e.what() << "] at file: ["
@@ -359,6 +397,14 @@ void ANYmalWorldNode::setParameters(const YAML::Node& simulation_cfg) {
     // my_utils::pretty_print(coef_fric_, std::cout, "sim : coef_fric_");
 
     setFrictionCoeff();
+
+    // ---- SET INTERFACE
+    if (controller_transport == "shm") {
+        shm_client_ = new ANYmalShmClient(shm_wakeup, shm_timeout);
+        shm_client_->connect();
+    } else {
+        interface_ = new ANYmalInterface();
+    }
 }
 
 void ANYmalWorldNode::UpdateContactDistance_() {
@@ -459,3 +505,24 @@ void ANYmalWorldNode::UpdateContactWrenchData_() {
     sensor_data_->foot_wrench = wrench_local_list;  
     // sensor_data_->foot_wrench = wrench_global_list;
 }
+
+void ANYmalWorldNode::UpdateImuData_() {
+    // imu at the base link origin, the accelerations are the ones
+    // of the last simulation step
+    dart::dynamics::BodyNode* base =
+        robot_->getBodyNode(ANYmalBodyNode::base);
+    Eigen::Matrix3d R_wb = base->getWorldTransform().linear();
+
+    Eigen::Vector3d ang_vel = base->getAngularVelocity(
+        dart::dynamics::Frame::World(), base);
+    Eigen::Vector3d acc = R_wb.transpose() *
+        (base->getLinearAcceleration() - world_->getGravity());
+
+    for(int i(0); i<3; ++i) {
+        ang_vel[i] += imu_gyro_noise_ * imu_noise_(imu_noise_gen_);
+        acc[i] += imu_acc_noise_ * imu_noise_(imu_noise_gen_);
+    }
+    sensor_data_->imu_quat = Eigen::Quaterniond(R_wb);
+    sensor_data_->imu_ang_vel = ang_vel;
+    sensor_data_->imu_acc = acc;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <array>
+
+// Fixed capacity ring buffer, the oldest element is overwritten when a
+// new one is pushed into a full buffer. Nothing is allocated after the
+// construction. Index 0 is the oldest element.
+template <typename T, int N>
+class CircularBuffer {
+    public:
+    CircularBuffer() : head_(0), size_(0) {}
+    ~CircularBuffer() {}
+
+    void push_back(const T& val) {
+        buffer_[(head_ + size_) % N] = val;
+        if(size_ < N) ++size_;
+        else head_ = (head_ + 1) % N;
+    }
+    void pop_front() {
+        if(size_ == 0) return;
+        head_ = (head_ + 1) % N;
+        --size_;
+    }
+    void clear() { head_ = 0; size_ = 0; }
+
+    int size() const { return size_; }
+    static constexpr int capacity() { return N; }
+    bool empty() const { return size_ == 0; }
+    bool full() const { return size_ == N; }
+
+    T& operator[](int i) { return buffer_[(head_ + i) % N]; }
+    const T& operator[](int i) const { return buffer_[(head_ + i) % N]; }
+    T& front() { return buffer_[head_]; }
+    T& back() { return buffer_[(head_ + size_ - 1) % N]; }
+
+    private:
+    std::array<T, N> buffer_;
+    int head_;
+    int size_;
+};
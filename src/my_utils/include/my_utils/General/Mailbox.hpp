@@ -0,0 +1,47 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+
+// Lock-free single slot mailbox between one producer and one consumer.
+// Three buffers: the producer fills its own buffer and exchanges it with
+// the slot, the consumer exchanges its buffer with the slot when a new
+// message is posted. Neither side waits, an unread message is replaced
+// by the next post.
+template <typename T>
+class Mailbox {
+    public:
+    Mailbox() : write_idx_(0), slot_(1), read_idx_(2) {}
+    ~Mailbox() {}
+
+    // producer
+    T& getWriteBuffer() { return buffers_[write_idx_]; }
+    // return false if an unread message was replaced
+    bool post() {
+        int prev = slot_.exchange(write_idx_ | new_flag,
+                                std::memory_order_acq_rel);
+        write_idx_ = prev & idx_mask;
+        return !(prev & new_flag);
+    }
+
+    // consumer
+    bool hasMessage() const {
+        return slot_.load(std::memory_order_acquire) & new_flag; }
+    // take the latest message, false if nothing new is posted
+    bool fetch() {
+        if(!hasMessage()) return false;
+        read_idx_ = slot_.exchange(read_idx_,
+                                std::memory_order_acq_rel) & idx_mask;
+        return true;
+    }
+    T& getReadBuffer() { return buffers_[read_idx_]; }
+
+    private:
+    static constexpr int idx_mask = 3;
+    static constexpr int new_flag = 4;
+
+    std::array<T, 3> buffers_;
+    int write_idx_; // producer only
+    std::atomic<int> slot_;
+    int read_idx_; // consumer only
+};
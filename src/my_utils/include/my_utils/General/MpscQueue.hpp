@@ -0,0 +1,100 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <cstddef>
+
+// Bounded lock-free queue of preallocated slots from any number of
+// producers to one consumer, as the bounded queue of D. Vyukov : each
+// slot carries a sequence telling whether it is free or written, a
+// producer claims a position with a compare and swap, fills the slot and
+// publishes it with its sequence. Neither side waits or allocates, the
+// values are copy assigned into and out of the slots, and a full queue
+// is reported to the producer. A producer suspended between the claim
+// and the publication holds back the consumer, which sees the queue
+// empty until then.
+template <typename T>
+class MpscQueue {
+    public:
+    // the capacity is rounded up to a power of two
+    MpscQueue(int capacity) : head_(0), tail_(0) {
+        size_ = 1;
+        while(size_ < (size_t)capacity) size_ <<= 1;
+        mask_ = size_ - 1;
+        slots_ = new Slot[size_];
+        for(size_t i(0); i < size_; ++i)
+            slots_[i].seq.store(i, std::memory_order_relaxed);
+    }
+    ~MpscQueue() { delete[] slots_; }
+
+    int capacity() const { return (int)size_; }
+
+    // producers, false if full
+    bool push(const T& value) {
+        size_t pos = head_.load(std::memory_order_relaxed);
+        Slot* slot;
+        while(true) {
+            slot = &slots_[pos & mask_];
+            intptr_t dif = (intptr_t)slot->seq.load(std::memory_order_acquire)
+                           - (intptr_t)pos;
+            if(dif == 0) {
+                if(head_.compare_exchange_weak(pos, pos + 1,
+                                               std::memory_order_relaxed))
+                    break;
+            } else if(dif < 0) {
+                return false;
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+        slot->value = value;
+        slot->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer, false if empty
+    bool pop(T& value) {
+        Slot& slot = slots_[tail_ & mask_];
+        if(slot.seq.load(std::memory_order_acquire) != tail_ + 1) return false;
+        value = slot.value;
+        slot.seq.store(tail_ + size_, std::memory_order_release);
+        ++tail_;
+        return true;
+    }
+    // f(T&) on up to max_num values in their slots, number consumed
+    template <typename F>
+    int consume(F f, int max_num) {
+        int n(0);
+        for(; n < max_num; ++n) {
+            Slot& slot = slots_[tail_ & mask_];
+            if(slot.seq.load(std::memory_order_acquire) != tail_ + 1) break;
+            f(slot.value);
+            slot.seq.store(tail_ + size_, std::memory_order_release);
+            ++tail_;
+        }
+        return n;
+    }
+    // consumer, values pushed and not popped, including those being written
+    int size() const {
+        return (int)(head_.load(std::memory_order_relaxed) - tail_); }
+
+    private:
+    MpscQueue(const MpscQueue&);
+    MpscQueue& operator=(const MpscQueue&);
+
+    struct Slot {
+        std::atomic<size_t> seq;
+        T value;
+    };
+
+    Slot* slots_;
+    size_t size_;
+    size_t mask_;
+
+    // the positions grow without bound, padded to their own cache lines
+    char pad0_[64];
+    std::atomic<size_t> head_;
+    char pad1_[64];
+    size_t tail_; // consumer only
+    char pad2_[64];
+};
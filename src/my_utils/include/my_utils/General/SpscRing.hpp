@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+// Lock-free ring of preallocated slots between one producer and one
+// consumer. The producer fills the slots after the head and publishes
+// them at once with commitWrite, the consumer reads the slots after the
+// tail and releases them with commitRead. Neither side waits, a full
+// ring is reported to the producer.
+template <typename T>
+class SpscRing {
+    public:
+    // the capacity is rounded up to a power of two
+    SpscRing(int capacity) : head_(0), tail_cache_(0), tail_(0) {
+        size_ = 1;
+        while(size_ < (size_t)capacity) size_ <<= 1;
+        mask_ = size_ - 1;
+        slots_ = new T[size_];
+    }
+    ~SpscRing() { delete[] slots_; }
+
+    int capacity() const { return (int)size_; }
+
+    // producer
+    bool canWrite(int n) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if(head + n - tail_cache_ <= size_) return true;
+        tail_cache_ = tail_.load(std::memory_order_acquire);
+        return head + n - tail_cache_ <= size_;
+    }
+    // i-th free slot, valid for i < n after canWrite(n)
+    T& writeSlot(int i) {
+        return slots_[(head_.load(std::memory_order_relaxed) + i) & mask_]; }
+    void commitWrite(int n) {
+        head_.store(head_.load(std::memory_order_relaxed) + n,
+                    std::memory_order_release);
+    }
+
+    // consumer
+    int readable() {
+        return (int)(head_.load(std::memory_order_acquire)
+                    - tail_.load(std::memory_order_relaxed));
+    }
+    // i-th written slot, valid for i < readable()
+    T& readSlot(int i) {
+        return slots_[(tail_.load(std::memory_order_relaxed) + i) & mask_]; }
+    void commitRead(int n) {
+        tail_.store(tail_.load(std::memory_order_relaxed) + n,
+                    std::memory_order_release);
+    }
+    // position of the last write, to wait for the records written so far
+    size_t getWritePosition() const {
+        return head_.load(std::memory_order_acquire); }
+    size_t getReadPosition() const {
+        return tail_.load(std::memory_order_acquire); }
+
+    private:
+    SpscRing(const SpscRing&);
+    SpscRing& operator=(const SpscRing&);
+
+    T* slots_;
+    size_t size_;
+    size_t mask_;
+
+    // the indices grow without bound, padded to their own cache lines
+    char pad0_[64];
+    std::atomic<size_t> head_;
+    size_t tail_cache_; // producer only
+    char pad1_[64];
+    std::atomic<size_t> tail_;
+    char pad2_[64];
+};
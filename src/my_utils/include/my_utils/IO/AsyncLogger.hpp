@@ -0,0 +1,157 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <Eigen/Dense>
+
+#include "my_utils/General/SpscRing.hpp"
+#include "my_utils/IO/ColumnarLog.hpp"
+
+namespace my_utils
+{
+    // Fixed size binary record, a vector longer than record_size spans
+    // consecutive records of the same channel.
+    struct LogRecord {
+        static constexpr int record_size = 30;
+        int32_t channel;
+        int16_t size; // values in this record
+        int16_t b_last; // last record of the vector
+        double time;
+        double data[record_size];
+    };
+
+    // text : <name>.txt as saveVector
+    // float64, float32 : <name>.bin in ColumnarLog with the time of the
+    // records, the dimension is the one of the first record
+    enum class LogFormat { Text, Float64, Float32 };
+
+    // Asynchronous data logger. The logging threads copy the vectors into
+    // preallocated lock-free rings, one ring per thread, and a background
+    // thread writes them out in batches, to <name>.txt in the format of
+    // saveVector or to a columnar <name>.bin. Logging does no file I/O and does not allocate once the
+    // channel and the ring of the thread are registered. A vector which
+    // does not fit in the ring is dropped and counted. The ring of a thread
+    // goes to the next thread once it exits, at most max_threads threads
+    // log at the same time, the others drop.
+    class AsyncLogger {
+    public:
+        static constexpr int max_channels = 1024;
+        static constexpr int max_threads = 16;
+        static constexpr int ring_capacity = 4096; // records per thread
+        static constexpr int write_period_ms = 5;
+
+        static AsyncLogger* getLogger();
+        ~AsyncLogger();
+
+        // channel id of the file name, registered on the first call,
+        // -1 if the channel table is full
+        int getChannel(const std::string& name, bool b_param = false);
+        // the same, cached by the address of the name, for the literals
+        int getChannel(const char* name, bool b_param = false);
+
+        // format and nominal rate [Hz] of the channels registered afterwards
+        void setFileFormat(LogFormat format) {
+            std::lock_guard<std::mutex> lock(register_mutex_);
+            format_ = format;
+        }
+        void setRate(double rate) {
+            std::lock_guard<std::mutex> lock(register_mutex_);
+            rate_ = rate;
+        }
+        // time of the next records, the steady clock if never set
+        void setTime(double time) {
+            time_.store(time, std::memory_order_relaxed);
+            b_time_set_.store(true, std::memory_order_relaxed);
+        }
+
+        bool log(int channel, const double* data, int size);
+        template <typename Derived>
+        bool log(int channel, const Eigen::MatrixBase<Derived>& vec) {
+            return push_(channel, (int)vec.size(), vec.derived());
+        }
+        bool log(int channel, double value) { return log(channel, &value, 1); }
+
+        // blocks until the records logged so far are written
+        void flush();
+
+        uint64_t getDroppedCount() const;
+        uint64_t getDroppedCount(int channel) const;
+        uint64_t getWrittenCount() const {
+            return num_written_.load(std::memory_order_relaxed); }
+
+    private:
+        struct Channel {
+            std::string name;
+            std::string file_name;
+            LogFormat format;
+            double rate;
+            // writer thread only
+            std::ofstream file;
+            ColumnarLogWriter columnar;
+            std::vector<double> row;
+            std::atomic<uint64_t> num_dropped;
+        };
+        typedef SpscRing<LogRecord> Ring;
+
+        AsyncLogger();
+        AsyncLogger(const AsyncLogger&);
+        AsyncLogger& operator=(const AsyncLogger&);
+
+        Ring* getThreadRing_();
+        bool drop_(int channel);
+        double now_() const;
+        void write_(Channel& ch, const LogRecord& rec);
+        void flushFiles_();
+        bool drain_();
+        void run_();
+
+        template <typename VecType>
+        bool push_(int channel, int size, const VecType& vec) {
+            if(channel < 0) return drop_(channel);
+            Ring* ring = getThreadRing_();
+            int n_record = size > 0 ?
+                (size + LogRecord::record_size - 1)/LogRecord::record_size : 1;
+            if(!ring || !ring->canWrite(n_record)) return drop_(channel);
+            double time = now_();
+            for(int r(0), i(0); r < n_record; ++r) {
+                LogRecord& rec = ring->writeSlot(r);
+                rec.channel = channel;
+                rec.time = time;
+                rec.size = 0;
+                for(; rec.size < LogRecord::record_size && i < size; ++rec.size, ++i)
+                    rec.data[rec.size] = coeff_(vec, i);
+                rec.b_last = (r == n_record-1);
+            }
+            ring->commitWrite(n_record);
+            return true;
+        }
+        template <typename Derived>
+        static double coeff_(const Eigen::MatrixBase<Derived>& vec, int i) {
+            return vec(i); }
+        static double coeff_(const double* vec, int i) { return vec[i]; }
+
+        Channel channels_[max_channels];
+        std::atomic<int> num_channels_;
+        Ring* rings_[max_threads];
+        std::atomic<bool> b_ring_free_[max_threads]; // its thread exited
+        std::atomic<int> num_rings_;
+        std::mutex register_mutex_;
+        LogFormat format_;
+        double rate_;
+        std::atomic<double> time_;
+        std::atomic<bool> b_time_set_;
+        std::chrono::steady_clock::time_point t_start_;
+
+        std::atomic<uint64_t> num_dropped_; // no channel or no ring
+        std::atomic<uint64_t> num_written_;
+        std::atomic<bool> b_running_;
+        std::thread writer_;
+    };
+
+} /* my_utils */
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+
+namespace my_utils
+{
+    // Columnar binary log of one channel, <name>.bin
+    //   header (256 bytes) : schema and number of rows
+    //   chunks of chunk_rows rows, in each chunk the columns are contiguous
+    //     time[chunk_rows] (float64), value_0[chunk_rows] (dtype), ...
+    //     value_dim-1[chunk_rows] (dtype)
+    // The file is append only, the writer grows it by preallocated segments
+    // of chunks mapped in memory and the header counts the rows written so
+    // far, so a file is readable while it is written or after a crash.
+    // The reader maps the file, the element (row, col) is found in O(1).
+    enum class LogDType : uint32_t { Float64 = 0, Float32 = 1 };
+
+    struct ColumnarLogHeader {
+        static constexpr int name_size = 216;
+        char magic[8]; // "MYLOGCOL"
+        uint32_t version;
+        LogDType dtype;
+        uint32_t dim;
+        uint32_t chunk_rows;
+        double rate; // nominal rows per second, 0 if irregular
+        uint64_t num_rows;
+        char name[name_size];
+    };
+    static_assert(sizeof(ColumnarLogHeader) == 256, "header of 256 bytes");
+
+    class ColumnarLogWriter {
+    public:
+        ColumnarLogWriter();
+        ~ColumnarLogWriter();
+
+        // the file is truncated, false if it cannot be created
+        bool open(const std::string& file_name, const std::string& name,
+                  int dim, LogDType dtype, double rate,
+                  int chunk_rows = 1024, int segment_chunks = 16);
+        // values beyond dim are ignored, missing values are NaN
+        bool append(double time, const double* data, int size);
+        // trims the file to the rows written
+        void close();
+
+        bool isOpen() const { return fd_ >= 0; }
+        int getDim() const { return dim_; }
+        uint64_t getNumRows() const;
+
+    private:
+        ColumnarLogWriter(const ColumnarLogWriter&);
+        ColumnarLogWriter& operator=(const ColumnarLogWriter&);
+        bool map_(size_t file_size);
+
+        int fd_;
+        char* base_;
+        size_t file_size_;
+        size_t segment_size_;
+        size_t chunk_size_;
+        size_t element_size_;
+        int dim_;
+        int chunk_rows_;
+        LogDType dtype_;
+    };
+
+    class ColumnarLogReader {
+    public:
+        ColumnarLogReader();
+        ~ColumnarLogReader();
+
+        // false if the file is not a columnar log
+        bool open(const std::string& file_name);
+        void close();
+
+        bool isOpen() const { return base_ != NULL; }
+        std::string getName() const;
+        int getDim() const { return dim_; }
+        LogDType getDType() const { return dtype_; }
+        double getRate() const { return rate_; }
+        // rows written when the file was opened
+        uint64_t getNumRows() const { return num_rows_; }
+
+        double getTime(uint64_t row) const {
+            return ((const double*)chunk_(row))[row % chunk_rows_]; }
+        double getValue(uint64_t row, int col) const {
+            const char* col_base = chunk_(row) + chunk_rows_*sizeof(double)
+                                    + (size_t)col*chunk_rows_*element_size_;
+            size_t i = row % chunk_rows_;
+            return dtype_ == LogDType::Float64 ? ((const double*)col_base)[i]
+                                            : ((const float*)col_base)[i];
+        }
+        void getRow(uint64_t row, double* data) const {
+            for(int col(0); col<dim_; ++col) data[col] = getValue(row, col); }
+        // last row at or before time, 0 if the log starts later.
+        // O(1) on a log at its nominal rate, a binary search otherwise
+        uint64_t findRow(double time) const;
+
+    private:
+        ColumnarLogReader(const ColumnarLogReader&);
+        ColumnarLogReader& operator=(const ColumnarLogReader&);
+        const char* chunk_(uint64_t row) const {
+            return base_ + sizeof(ColumnarLogHeader)
+                    + (row / chunk_rows_)*chunk_size_; }
+
+        const char* base_;
+        size_t file_size_;
+        size_t chunk_size_;
+        size_t element_size_;
+        int dim_;
+        int chunk_rows_;
+        LogDType dtype_;
+        double rate_;
+        uint64_t num_rows_;
+    };
+
+    // writes the values in the text layout of saveVector,
+    // with the time as the first column if b_time
+    bool exportColumnarLogToText(const std::string& bin_file,
+                                 const std::string& txt_file,
+                                 bool b_time = false);
+
+} /* my_utils */
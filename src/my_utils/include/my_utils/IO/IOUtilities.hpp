@@ -8,6 +8,7 @@
 #include <Eigen/Dense>
 #include "../my_utils/Configuration.h"
 #include "myYaml/yaml.h"
+#include "my_utils/IO/AsyncLogger.hpp"
 
 enum myColor {
     Red=0,
@@ -28,14 +29,33 @@ namespace my_utils
 {
     // =========================================================================
     // Save Vector
+    // queued to AsyncLogger, <name_>.txt is written by its writer thread,
+    // a literal name is looked up without a std::string
     // =========================================================================
-    void saveVector(const Eigen::VectorXd & vec_,
-                    std::string name_,
-                    bool b_param = false);
-    void saveMatrix(const Eigen::MatrixXd& mtx_, std::string name_, bool b_param = false);
-    void saveVector(double * _vec, std::string _name, int size, bool b_param = false);
-    void saveVector(const std::vector<double> & _vec, std::string _name, bool b_param = false);
-    void saveValue(double _value, std::string _name, bool b_param = false);
+    template <typename Derived>
+    void saveVector(const Eigen::MatrixBase<Derived> & vec_,
+                    const std::string& name_,
+                    bool b_param = false) {
+        AsyncLogger* logger = AsyncLogger::getLogger();
+        logger->log(logger->getChannel(name_, b_param), vec_);
+    }
+    template <typename Derived>
+    void saveVector(const Eigen::MatrixBase<Derived> & vec_,
+                    const char* name_,
+                    bool b_param = false) {
+        AsyncLogger* logger = AsyncLogger::getLogger();
+        logger->log(logger->getChannel(name_, b_param), vec_);
+    }
+    void saveMatrix(const Eigen::MatrixXd& mtx_, const std::string& name_, bool b_param = false);
+    void saveMatrix(const Eigen::MatrixXd& mtx_, const char* name_, bool b_param = false);
+    void saveVector(double * _vec, const std::string& _name, int size, bool b_param = false);
+    void saveVector(double * _vec, const char* _name, int size, bool b_param = false);
+    void saveVector(const std::vector<double> & _vec, const std::string& _name, bool b_param = false);
+    void saveVector(const std::vector<double> & _vec, const char* _name, bool b_param = false);
+    void saveValue(double _value, const std::string& _name, bool b_param = false);
+    void saveValue(double _value, const char* _name, bool b_param = false);
+    // blocks until the saved data are written
+    void flushSavedData();
     void cleaningFile(std::string file_name_,
                       std::string & ret_file_,
                       bool b_param);
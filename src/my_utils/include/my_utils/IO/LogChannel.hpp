@@ -0,0 +1,159 @@
+#pragma once
+
+#include <stdint.h>
+#include <array>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <Eigen/Dense>
+
+#include "myYaml/yaml.h"
+#include "my_utils/IO/AsyncLogger.hpp"
+
+// Declares a log channel once, at file scope or as a local static
+//   MY_LOG_CHANNEL(log_com_pos_des, "com_pos_des_", 3, 1, true);
+// and logs through it
+//   MY_LOG(log_com_pos_des, com_pos_des_);
+// A disabled channel costs the test of its bit in the enable mask.
+#define MY_LOG_CHANNEL(var, name, dim, decimation, b_enabled) \
+    static const my_utils::LogChannel var(name, dim, decimation, b_enabled)
+#define MY_LOG(channel, vec) \
+    do { if ((channel).isEnabled()) (channel).log(vec); } while (0)
+
+namespace my_utils
+{
+    // Registry of the log channels. A channel has an id, the bit of the
+    // id in the enable mask and a decimation, both of which are tuned at
+    // runtime by configure, before or after the channel is declared.
+    // The channel 0 is always disabled.
+    class LogChannelRegistry {
+    public:
+        static constexpr int max_channels = 512;
+
+        static LogChannelRegistry* getRegistry();
+
+        // id of the channel, the same for every declaration of the name
+        int registerChannel(const std::string& name, int dim,
+                            int decimation, bool b_enabled, bool b_param);
+
+        static bool isEnabled(int id) {
+            return (enable_mask_[id >> 6].load(std::memory_order_relaxed)
+                    >> (id & 63)) & 1u;
+        }
+        void setEnabled(const std::string& name, bool b_enabled);
+        void setEnabledAll(bool b_enabled);
+        void setDecimation(const std::string& name, int decimation);
+
+        // log_channels:
+        //   enable_all: true # false : only the channels in enabled
+        //   enabled: [name, ...] # on, also the channels declared off
+        //   disabled: [name, ...]
+        //   decimation: {name: n, ...} # one sample of n
+        void configure(const YAML::Node& node);
+
+        // decimation, true if this sample of the channel is logged,
+        // one of decimation samples also from several threads
+        bool sample(int id) {
+            Channel& ch = channels_[id];
+            int decimation = ch.decimation.load(std::memory_order_relaxed);
+            if (decimation <= 1) return true;
+            return (ch.count.fetch_add(1, std::memory_order_relaxed) + 1)
+                   % decimation == 0;
+        }
+        // AsyncLogger channel, registered at the first sample so that the
+        // file format is the configured one. Threads racing on the first
+        // sample get the same channel of the name, the first publishes it.
+        int getLoggerChannel(int id) {
+            Channel& ch = channels_[id];
+            int channel = ch.logger_channel.load(std::memory_order_acquire);
+            if (channel >= 0) return channel;
+            channel = AsyncLogger::getLogger()->getChannel(ch.name, ch.b_param);
+            int unset = -1;
+            ch.logger_channel.compare_exchange_strong(unset, channel,
+                                                      std::memory_order_acq_rel);
+            return channel;
+        }
+        int getDim(int id) const { return channels_[id].dim; }
+        const std::string& getName(int id) const { return channels_[id].name; }
+        int getNumChannels() const { return num_channels_; }
+        void countDimMismatch(int id) {
+            channels_[id].num_dim_mismatch.fetch_add(1, std::memory_order_relaxed); }
+        uint64_t getNumDimMismatch(int id) const {
+            return channels_[id].num_dim_mismatch.load(std::memory_order_relaxed); }
+
+    private:
+        struct Channel {
+            std::string name;
+            int dim;
+            int declared_decimation;
+            bool b_declared_enabled;
+            bool b_param;
+            // set by configure, read and counted by the logging threads
+            std::atomic<int> decimation;
+            std::atomic<uint64_t> count;
+            std::atomic<int> logger_channel;
+            std::atomic<uint64_t> num_dim_mismatch;
+        };
+        struct Setting {
+            Setting() : b_enabled(-1), decimation(-1) {}
+            int b_enabled; // -1 : as declared
+            int decimation; // -1 : as declared
+        };
+
+        LogChannelRegistry();
+        int find_(const std::string& name) const;
+        void setEnabled_(int id, bool b_enabled);
+        void apply_(int id);
+
+        // constant initialized, valid before any registration
+        static std::atomic<uint64_t> enable_mask_[max_channels / 64];
+
+        Channel channels_[max_channels];
+        int num_channels_;
+        bool b_enable_all_; // false : only the channels set enabled
+        std::map<std::string, Setting> settings_;
+        std::mutex mutex_;
+    };
+
+    // Handle of a registered channel, cheap to copy
+    class LogChannel {
+    public:
+        LogChannel() : id_(0) {}
+        LogChannel(const std::string& name, int dim, int decimation = 1,
+                   bool b_enabled = true, bool b_param = false)
+            : id_(LogChannelRegistry::getRegistry()->registerChannel(
+                  name, dim, decimation, b_enabled, b_param)) {}
+
+        int id() const { return id_; }
+        bool isEnabled() const { return LogChannelRegistry::isEnabled(id_); }
+
+        template <typename Derived>
+        void log(const Eigen::MatrixBase<Derived>& vec) const {
+            LogChannelRegistry* registry = LogChannelRegistry::getRegistry();
+            if (!registry->sample(id_)) return;
+            if (vec.size() != registry->getDim(id_))
+                registry->countDimMismatch(id_);
+            AsyncLogger::getLogger()->log(registry->getLoggerChannel(id_), vec);
+        }
+        void log(double value) const {
+            log(Eigen::Matrix<double, 1, 1>::Constant(value));
+        }
+
+    private:
+        int id_;
+    };
+
+    // one channel per name, <names[i]><suffix>
+    template <int N>
+    std::array<LogChannel, N> makeLogChannels(const std::string (&names)[N],
+                                              const std::string& suffix,
+                                              int dim, int decimation = 1,
+                                              bool b_enabled = true) {
+        std::array<LogChannel, N> channels;
+        for (int i(0); i < N; ++i)
+            channels[i] = LogChannel(names[i] + suffix, dim, decimation, b_enabled);
+        return channels;
+    }
+
+} /* my_utils */
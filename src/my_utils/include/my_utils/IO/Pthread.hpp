@@ -7,6 +7,7 @@
 #include <stdlib.h>
 #include <unistd.h>
  
+// runs run() once in a thread, RtThread for a periodic real-time loop
 class Pthread{
 protected:
     pthread_t sejong_thread;
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <pthread.h>
+#include <stdint.h>
+#include <atomic>
+#include <string>
+
+// Periodic real-time task
+//   class ControlTask : public my_utils::RtThread {
+//       void step() { interface->getCommand(data, cmd); }
+//   };
+//   RtThreadConfig config; config.name = "control"; config.period = 0.001;
+//   config.priority = 80; config.cpu = 3; config.b_lock_memory = true;
+//   task.start(config);
+// The thread wakes at absolute deadlines of clock_nanosleep on the
+// monotonic clock, so the period does not drift with the time of step.
+// Its wakeup latency past the deadline and the time of step are recorded
+// in the stages <name>_wakeup and <name>_step of StageTiming, read by
+// timing_monitor, a step beyond the period is an overrun and the
+// deadlines it missed are skipped. Without the privileges for SCHED_FIFO
+// or mlockall, e.g. no CAP_SYS_NICE or a low RLIMIT_MEMLOCK, the thread
+// runs with what it got and tells so.
+namespace my_utils
+{
+    struct RtThreadConfig {
+        RtThreadConfig()
+            : name("rt_thread"), period(0.001), priority(0), cpu(-1),
+              b_lock_memory(false), stack_prefault(256 * 1024) {}
+        std::string name;
+        double period; // [s]
+        int priority; // SCHED_FIFO, 1 to 99, 0 : SCHED_OTHER
+        int cpu; // pinned to it, -1 : any
+        bool b_lock_memory; // mlockall of the process
+        int stack_prefault; // [byte] of the stack touched before the loop
+    };
+
+    struct RtThreadStats {
+        uint64_t num_cycles;
+        uint64_t num_overruns; // steps ending past the next deadline
+        uint64_t num_missed; // deadlines skipped after the overruns
+        uint64_t max_wakeup_ns;
+        uint64_t max_step_ns;
+    };
+
+    class RtThread {
+    public:
+        RtThread();
+        virtual ~RtThread();
+
+        // false if the thread cannot be created, a missing privilege only
+        // degrades it
+        bool start(const RtThreadConfig& config);
+        // after the current step
+        void stop();
+        bool isRunning() const { return b_running_.load(); }
+        // SCHED_FIFO granted
+        bool isRealTime() const { return b_realtime_.load(); }
+        RtThreadStats getStats() const;
+
+        // priority, cpu, memory lock and stack prefault of config applied
+        // to the calling thread, e.g. an event driven loop. false if one
+        // of them is not granted, which is printed.
+        static bool configureCurrentThread(const RtThreadConfig& config);
+
+    protected:
+        // once per period, in the thread. A derived class calls stop in
+        // its destructor, step is not called once it is destroyed.
+        virtual void step() = 0;
+
+    private:
+        RtThread(const RtThread&);
+        RtThread& operator=(const RtThread&);
+
+        static void* run_(void* arg);
+        void loop_();
+
+        RtThreadConfig config_;
+        pthread_t thread_;
+        std::atomic<bool> b_running_;
+        std::atomic<bool> b_realtime_;
+        int stage_wakeup_;
+        int stage_step_;
+
+        std::atomic<uint64_t> num_cycles_;
+        std::atomic<uint64_t> num_overruns_;
+        std::atomic<uint64_t> num_missed_;
+        std::atomic<uint64_t> max_wakeup_ns_;
+        std::atomic<uint64_t> max_step_ns_;
+    };
+
+} /* my_utils */
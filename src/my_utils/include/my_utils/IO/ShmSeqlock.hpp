@@ -0,0 +1,79 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+
+// Latest value of a fixed size payload shared between processes
+//   writer : ShmSeqlock pub; pub.open("/anymal_command", sizeof(Pod), true);
+//            pub.write(&pod);
+//   reader : ShmSeqlock sub; sub.open("/anymal_command", sizeof(Pod), false);
+//            uint32_t seq = 0; sub.waitRead(&pod, seq, 0.1);
+// One writer publishes with a seqlock : the sequence is odd while the
+// payload is copied, a reader retries the copies which overlap a write.
+// The reader never blocks the writer and the payload must be plain data.
+namespace my_utils
+{
+    enum class ShmWakeup {
+        BusyPoll, // spins on the sequence, lowest latency on a core of its own
+        Futex     // sleeps on the sequence, woken by the writer
+    };
+    // busy_poll, futex, false if the name is none of them
+    bool parseShmWakeup(const std::string& name, ShmWakeup& wakeup);
+
+    // header of the shared memory segment, followed by the payload
+    struct ShmSeqlockHeader {
+        char magic[8]; // "MYSEQLCK"
+        uint32_t version;
+        uint32_t payload_size;
+        uint32_t seq; // even : stable, also the futex word
+        uint32_t num_waiters; // readers asleep on the futex
+        uint32_t pid; // of the writer
+        uint32_t padding_;
+    };
+
+    class ShmSeqlock {
+    public:
+        ShmSeqlock();
+        ~ShmSeqlock();
+
+        // b_create : a new segment of the writer, replacing any previous
+        // one, otherwise the segment of the writer, false if there is none
+        // yet, its writer is gone or its payload size differs
+        bool open(const std::string& name, size_t payload_size, bool b_create);
+        // the writer removes its segment
+        void close();
+        bool isOpen() const { return header_ != NULL; }
+
+        void setWakeup(ShmWakeup wakeup) { wakeup_ = wakeup; }
+        ShmWakeup getWakeup() const { return wakeup_; }
+
+        void write(const void* data);
+        // copy of the latest payload, false if nothing is published yet.
+        // seq : sequence of the copy
+        bool read(void* data, uint32_t* seq = NULL) const;
+        // waits for a payload published after last_seq, updated to the one
+        // read, false after timeout [s]
+        bool waitRead(void* data, uint32_t& last_seq, double timeout);
+
+        uint32_t getSequence() const;
+        int getWriterPid() const { return header_ ? (int)header_->pid : 0; }
+        // false once the writer process exits, a restarted writer
+        // publishes in a new segment
+        bool isWriterAlive() const;
+
+    private:
+        ShmSeqlock(const ShmSeqlock&);
+        ShmSeqlock& operator=(const ShmSeqlock&);
+
+        bool tryRead_(void* data, uint32_t seq) const;
+        void sleep_(uint32_t seq, int64_t timeout_ns);
+
+        ShmSeqlockHeader* header_;
+        char* payload_;
+        size_t segment_size_;
+        std::string name_;
+        bool b_writer_;
+        ShmWakeup wakeup_;
+    };
+
+} /* my_utils */
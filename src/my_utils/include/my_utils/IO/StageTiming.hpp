@@ -0,0 +1,174 @@
+#pragma once
+
+#include <stdint.h>
+#include <chrono>
+#include <mutex>
+#include <string>
+
+// Timing of the stages of the control loop
+//   MY_TIMING_STAGE(timing_wbc, "wbc", 0.5); // budget [ms], 0 : none
+//   { MY_TIMING_PROBE(timing_wbc); wbc_controller->getCommand(_command); }
+// The probe records the time of its scope in the latency histogram of
+// the stage, which lives in the shared memory segment timing_shm_name
+// read by the timing_monitor tool. A second process, e.g. the controller
+// of a simulator, records in timing_shm_name_<program>.
+#define MY_TIMING_STAGE(var, name, budget_ms) \
+    static const int var =                    \
+        my_utils::StageTiming::getStageTiming()->registerStage(name, budget_ms)
+#define MY_TIMING_PROBE(var) my_utils::TimingProbe my_timing_probe_##var(var)
+
+namespace my_utils
+{
+    // Log-linear latency histogram in ns, as HdrHistogram: 2^sub_bits
+    // linear buckets per power of two, a relative error below 2^-sub_bits.
+    // Plain data, updated with atomic builtins so that another process
+    // reads it through the shared memory while it is written.
+    struct LatencyHistogram {
+        static constexpr int sub_bits = 5;
+        static constexpr int sub_count = 1 << sub_bits;
+        static constexpr int max_bits = 37; // up to 2^37 ns, 137 s
+        static constexpr int num_buckets = (max_bits - sub_bits + 1) * sub_count;
+
+        static int bucketIndex(uint64_t ns) {
+            if (ns < (uint64_t)sub_count) return (int)ns;
+            int msb = 63 - __builtin_clzll(ns);
+            if (msb >= max_bits) return num_buckets - 1;
+            int shift = msb - sub_bits;
+            return ((shift + 1) << sub_bits) + (int)((ns >> shift) - sub_count);
+        }
+        // smallest value of the bucket
+        static uint64_t bucketValue(int index) {
+            if (index < sub_count) return index;
+            int shift = (index >> sub_bits) - 1;
+            return (uint64_t)(sub_count + (index & (sub_count - 1))) << shift;
+        }
+        // value below which the fraction q of the samples lies, upper
+        // bound of its bucket
+        static uint64_t quantile(const uint64_t* buckets, uint64_t count, double q);
+    };
+
+    struct TimingStageData {
+        static constexpr int name_size = 48;
+        char name[name_size];
+        uint64_t budget_ns; // 0 : no budget
+        uint64_t count;
+        uint64_t sum_ns;
+        uint64_t max_ns;
+        uint64_t last_ns;
+        uint64_t num_overrun; // samples above the budget
+        uint64_t buckets[LatencyHistogram::num_buckets];
+    };
+
+    // header of the shared memory segment, followed by max_stages stages
+    struct TimingSegmentHeader {
+        char magic[8]; // "MYTIMING"
+        uint32_t version;
+        uint32_t max_stages;
+        uint32_t num_buckets;
+        uint32_t sub_bits;
+        uint32_t num_stages; // stages registered so far
+        uint32_t pid; // of the writer
+    };
+
+    // Stage registry of the process. The segment is created at the first
+    // call, timing_shm_name or, if that one belongs to another running
+    // process, timing_shm_name_<program name>. On the heap, and said so,
+    // if neither is available. Recording
+    // is lock-free, atomic adds to the histogram of the stage, so a stage
+    // may be recorded from several threads.
+    class StageTiming {
+    public:
+        static constexpr int max_stages = 32;
+        static constexpr const char* timing_shm_name = "/my_utils_timing";
+
+        static StageTiming* getStageTiming();
+        ~StageTiming();
+
+        // id of the stage, the same for every registration of the name,
+        // -1 if the table is full
+        int registerStage(const std::string& name, double budget_ms);
+        void setBudget(int stage, double budget_ms);
+
+        void record(int stage, uint64_t ns) {
+            if (stage < 0) return;
+            TimingStageData& s = stages_[stage];
+            __atomic_fetch_add(&s.count, 1, __ATOMIC_RELAXED);
+            __atomic_fetch_add(&s.sum_ns, ns, __ATOMIC_RELAXED);
+            __atomic_fetch_add(&s.buckets[LatencyHistogram::bucketIndex(ns)], 1,
+                               __ATOMIC_RELAXED);
+            __atomic_store_n(&s.last_ns, ns, __ATOMIC_RELAXED);
+            uint64_t max_ns = __atomic_load_n(&s.max_ns, __ATOMIC_RELAXED);
+            while (ns > max_ns &&
+                   !__atomic_compare_exchange_n(&s.max_ns, &max_ns, ns, true,
+                                                __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {}
+            uint64_t budget_ns = __atomic_load_n(&s.budget_ns, __ATOMIC_RELAXED);
+            if (budget_ns > 0 && ns > budget_ns)
+                __atomic_fetch_add(&s.num_overrun, 1, __ATOMIC_RELAXED);
+        }
+
+        bool isShared() const { return b_shared_; }
+        // of the segment, empty on the heap
+        const std::string& getShmName() const { return shm_name_; }
+        const TimingStageData& getStage(int stage) const { return stages_[stage]; }
+
+    private:
+        StageTiming();
+        StageTiming(const StageTiming&);
+        StageTiming& operator=(const StageTiming&);
+
+        static bool isWriterAlive_(const std::string& shm_name);
+        void* createSegment_(const std::string& shm_name);
+
+        TimingSegmentHeader* header_;
+        TimingStageData* stages_;
+        size_t segment_size_;
+        bool b_shared_;
+        std::string shm_name_;
+        std::mutex register_mutex_;
+    };
+
+    // Times its scope
+    class TimingProbe {
+    public:
+        explicit TimingProbe(int stage)
+            : stage_(stage), t_start_(std::chrono::steady_clock::now()) {}
+        ~TimingProbe() {
+            StageTiming::getStageTiming()->record(stage_,
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - t_start_).count());
+        }
+
+    private:
+        TimingProbe(const TimingProbe&);
+        TimingProbe& operator=(const TimingProbe&);
+
+        int stage_;
+        std::chrono::steady_clock::time_point t_start_;
+    };
+
+    // Read side of the segment, for the monitors
+    class StageTimingReader {
+    public:
+        StageTimingReader();
+        ~StageTimingReader();
+
+        // false if no process has created the segment
+        bool open(const std::string& shm_name = StageTiming::timing_shm_name);
+        void close();
+
+        int getNumStages() const;
+        int getWriterPid() const { return header_ ? (int)header_->pid : 0; }
+        // copy of the stage, the counters of a stage being recorded are
+        // read one by one
+        void getStage(int stage, TimingStageData& data) const;
+
+    private:
+        StageTimingReader(const StageTimingReader&);
+        StageTimingReader& operator=(const StageTimingReader&);
+
+        const TimingSegmentHeader* header_;
+        const TimingStageData* stages_;
+        size_t segment_size_;
+    };
+
+} /* my_utils */
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "my_utils/General/SpscRing.hpp"
+
+// Binary telemetry over a ZMQ PUB socket
+//   TelemetryPublisher pub;
+//   int state = pub.addTopic("robot_state", {{"q", 12}, {"qdot", 12}}, 4);
+//   pub.start("ipc:///tmp/anymal_telemetry");
+//   pub.publish(state, values, 24, time);   // control loop
+// A message is three frames : the topic name, to subscribe by prefix, a
+// TelemetryFrameHeader and the values as float64, sent without a copy
+// from a pool of blocks. The schema of a topic, its fields as the text
+// "q:12,qdot:12", is sent as a message of its own type at the start and
+// then every schema_period so that a late subscriber decodes the values.
+// Without ZMQ at build time start fails and nothing is sent.
+namespace my_utils
+{
+    enum class TelemetryFrameType : uint16_t { Data = 0, Schema = 1 };
+
+    struct TelemetryFrameHeader {
+        char magic[4]; // "MYTM"
+        uint16_t version;
+        uint16_t type; // TelemetryFrameType
+        uint32_t topic_id;
+        uint32_t size; // values of a data frame, bytes of a schema frame
+        uint64_t seq; // per topic, from 1, a gap is a dropped sample
+        double time;
+    };
+
+    struct TelemetryField {
+        std::string name;
+        int size;
+    };
+
+    class TelemetryPublisher {
+    public:
+        static constexpr int max_topics = 16;
+        static constexpr int max_values = 64; // per sample
+        static constexpr int ring_capacity = 1024; // samples
+        static constexpr int pool_size = 256; // blocks in flight in ZMQ
+        static constexpr int poll_period_us = 200;
+        static constexpr double schema_period = 1.; // [s]
+
+        TelemetryPublisher();
+        ~TelemetryPublisher();
+
+        // id of the topic, -1 if the table is full or the fields are more
+        // than max_values. One sample out of decimation is published.
+        int addTopic(const std::string& name,
+                     const std::vector<TelemetryField>& fields,
+                     int decimation = 1);
+
+        // binds the socket and starts the publishing thread, false if ZMQ
+        // is missing or the endpoint cannot be bound. high_water_mark :
+        // messages queued per subscriber before ZMQ drops, 0 : no limit
+        bool start(const std::string& endpoint, int high_water_mark = 1000);
+        void stop();
+        bool isRunning() const { return b_running_.load(); }
+        // ZMQ context of the socket, for inproc:// subscribers, whose
+        // sockets are closed before stop
+        void* getContext() const;
+
+        // From one thread, the control loop. Copies the values into the
+        // ring, false if it is full. size is the one of the schema.
+        bool publish(int topic, const double* data, int size, double time);
+
+        // per topic or of all topics : samples sent, dropped in the ring,
+        // the pool or ZMQ, and skipped by the decimation
+        uint64_t getSentCount(int topic = -1) const;
+        uint64_t getDroppedCount(int topic = -1) const;
+        uint64_t getDecimatedCount(int topic = -1) const;
+
+    private:
+        struct Sample {
+            int32_t topic;
+            int32_t size;
+            uint64_t seq;
+            double time;
+            double data[max_values];
+        };
+        struct Topic {
+            std::string name;
+            std::string schema;
+            int size;
+            int decimation;
+            // control loop only
+            int count;
+            uint64_t seq;
+            std::atomic<uint64_t> num_sent;
+            std::atomic<uint64_t> num_dropped;
+            std::atomic<uint64_t> num_decimated;
+        };
+        struct Impl;
+
+        TelemetryPublisher(const TelemetryPublisher&);
+        TelemetryPublisher& operator=(const TelemetryPublisher&);
+
+        double* acquireBlock_();
+        static void releaseBlock_(void* data, void* hint);
+        // b_pooled : size values in a block of the pool, which ZMQ gives
+        // back, otherwise size bytes copied
+        bool send_(int topic_id, TelemetryFrameType type, uint64_t seq,
+                   double time, void* data, int size, bool b_pooled);
+        void sendSchemas_(int first_topic, int num_topics);
+        void run_();
+
+        Topic topics_[max_topics];
+        std::atomic<int> num_topics_;
+        std::mutex register_mutex_;
+        SpscRing<Sample> ring_;
+
+        // blocks of max_values, handed to ZMQ and given back by its
+        // I/O thread once sent
+        std::vector<double> pool_;
+        std::vector<double*> free_blocks_;
+        std::mutex pool_mutex_;
+
+        Impl* impl_;
+        std::atomic<bool> b_running_;
+        std::thread publisher_;
+        std::chrono::steady_clock::time_point t_schema_;
+    };
+
+} /* my_utils */
@@ -0,0 +1,227 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <Eigen/Dense>
+
+#include "my_utils/General/SpscRing.hpp"
+
+// Traces from the control loop, in place of std::cout
+//   MY_TRACE_INFO("swing replan / passed_time= {}", passed_time);
+//   MY_TRACE_DEBUG("pc_goal {}", pc_goal);
+// The call site copies its arguments into a ring of the thread, a
+// background sink formats them, replacing each {} of the format by the
+// next argument, and writes them to the console. The format must be a
+// string literal. The traces of a severity below MY_TRACE_MIN_LEVEL are
+// compiled out, e.g. -DMY_TRACE_MIN_LEVEL=0 keeps the debug traces.
+#define MY_TRACE_LEVEL_DEBUG 0
+#define MY_TRACE_LEVEL_INFO 1
+#define MY_TRACE_LEVEL_WARN 2
+#define MY_TRACE_LEVEL_ERROR 3
+#ifndef MY_TRACE_MIN_LEVEL
+#define MY_TRACE_MIN_LEVEL MY_TRACE_LEVEL_INFO
+#endif
+
+#define MY_TRACE_(level, format, ...)                                        \
+    do {                                                                     \
+        static my_utils::TraceSite my_trace_site_(__FILE__, __LINE__,        \
+                                                  level, format);            \
+        my_utils::Tracer::getTracer()->trace(my_trace_site_, ##__VA_ARGS__); \
+    } while (0)
+
+#if MY_TRACE_MIN_LEVEL <= MY_TRACE_LEVEL_DEBUG
+#define MY_TRACE_DEBUG(format, ...) \
+    MY_TRACE_(my_utils::TraceLevel::Debug, format, ##__VA_ARGS__)
+#else
+#define MY_TRACE_DEBUG(format, ...) do {} while (0)
+#endif
+#if MY_TRACE_MIN_LEVEL <= MY_TRACE_LEVEL_INFO
+#define MY_TRACE_INFO(format, ...) \
+    MY_TRACE_(my_utils::TraceLevel::Info, format, ##__VA_ARGS__)
+#else
+#define MY_TRACE_INFO(format, ...) do {} while (0)
+#endif
+#if MY_TRACE_MIN_LEVEL <= MY_TRACE_LEVEL_WARN
+#define MY_TRACE_WARN(format, ...) \
+    MY_TRACE_(my_utils::TraceLevel::Warn, format, ##__VA_ARGS__)
+#else
+#define MY_TRACE_WARN(format, ...) do {} while (0)
+#endif
+#define MY_TRACE_ERROR(format, ...) \
+    MY_TRACE_(my_utils::TraceLevel::Error, format, ##__VA_ARGS__)
+
+namespace my_utils
+{
+    enum class TraceLevel : int {
+        Debug = MY_TRACE_LEVEL_DEBUG,
+        Info = MY_TRACE_LEVEL_INFO,
+        Warn = MY_TRACE_LEVEL_WARN,
+        Error = MY_TRACE_LEVEL_ERROR
+    };
+    // debug, info, warn, error, false if the name is none of them
+    bool parseTraceLevel(const std::string& name, TraceLevel& level);
+
+    // Call site of a trace, a local static of the macro. It keeps the
+    // count of its traces in the current second for the rate limit.
+    struct TraceSite {
+        TraceSite(const char* _file, int _line, TraceLevel _level,
+                  const char* _format)
+            : file(_file), line(_line), level(_level), format(_format),
+              window_start(0), num_in_window(0), num_suppressed(0) {}
+
+        const char* file;
+        int line;
+        TraceLevel level;
+        const char* format;
+        std::atomic<int64_t> window_start; // [ns]
+        std::atomic<int> num_in_window;
+        std::atomic<uint32_t> num_suppressed; // since the last trace
+    };
+
+    struct TraceArg {
+        enum Type { Int, Double, Text, Vector };
+        Type type;
+        int32_t size; // values of Vector, characters of Text
+        union {
+            int64_t i;
+            double d;
+            int32_t offset; // in the values or text of the record
+        };
+    };
+
+    // Fixed size record, the arguments beyond the capacity are cut
+    struct TraceRecord {
+        static constexpr int max_args = 8;
+        static constexpr int max_values = 48;
+        static constexpr int max_text = 128;
+        const TraceSite* site;
+        double time;
+        uint32_t num_suppressed;
+        int16_t num_args;
+        int16_t num_values;
+        int16_t num_text;
+        TraceArg args[max_args];
+        double values[max_values];
+        char text[max_text];
+    };
+
+    // Tracer of the process with one ring per thread and a sink thread
+    // which writes the traces every sink_period_ms. A trace does no
+    // formatting, no I/O and no allocation once the ring of the thread is
+    // registered. A trace which does not fit in the ring is dropped and
+    // counted, a call site traces at most rate_limit times per second and
+    // the next trace reports the ones suppressed.
+    class Tracer {
+    public:
+        static constexpr int max_threads = 16;
+        static constexpr int ring_capacity = 256; // records per thread
+        static constexpr int sink_period_ms = 10;
+
+        static Tracer* getTracer();
+        ~Tracer();
+
+        // runtime threshold, above the compile time one
+        void setLevel(TraceLevel level) {
+            level_.store((int)level, std::memory_order_relaxed); }
+        TraceLevel getLevel() const {
+            return (TraceLevel)level_.load(std::memory_order_relaxed); }
+        // traces per second and call site, 0 : no limit
+        void setRateLimit(int rate_limit) {
+            rate_limit_.store(rate_limit, std::memory_order_relaxed); }
+
+        template <typename... Args>
+        void trace(TraceSite& site, const Args&... args) {
+            if ((int)site.level < level_.load(std::memory_order_relaxed))
+                return;
+            int64_t now = now_();
+            uint32_t num_suppressed = 0;
+            if (!allow_(site, now, num_suppressed)) return;
+            Ring* ring = getThreadRing_();
+            if (!ring || !ring->canWrite(1)) {
+                num_dropped_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            TraceRecord& rec = ring->writeSlot(0);
+            rec.site = &site;
+            rec.time = 1e-9 * now;
+            rec.num_suppressed = num_suppressed;
+            rec.num_args = rec.num_values = rec.num_text = 0;
+            pack_(rec, args...);
+            ring->commitWrite(1);
+        }
+
+        // blocks until the traces so far are written
+        void flush();
+
+        uint64_t getDroppedCount() const {
+            return num_dropped_.load(std::memory_order_relaxed); }
+
+    private:
+        typedef SpscRing<TraceRecord> Ring;
+
+        Tracer();
+        Tracer(const Tracer&);
+        Tracer& operator=(const Tracer&);
+
+        int64_t now_() const {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - t_start_).count(); }
+        bool allow_(TraceSite& site, int64_t now, uint32_t& num_suppressed);
+        Ring* getThreadRing_();
+        void write_(const TraceRecord& rec, std::string& line) const;
+        bool drain_();
+        void run_();
+
+        static void pack_(TraceRecord& rec) {}
+        template <typename T, typename... Args>
+        static void pack_(TraceRecord& rec, const T& arg, const Args&... args) {
+            if (rec.num_args < TraceRecord::max_args) add_(rec, arg);
+            pack_(rec, args...);
+        }
+        static TraceArg& next_(TraceRecord& rec, TraceArg::Type type) {
+            TraceArg& arg = rec.args[rec.num_args++];
+            arg.type = type;
+            arg.size = 0;
+            return arg;
+        }
+        static void add_(TraceRecord& rec, bool v) { next_(rec, TraceArg::Int).i = v; }
+        static void add_(TraceRecord& rec, int v) { next_(rec, TraceArg::Int).i = v; }
+        static void add_(TraceRecord& rec, unsigned int v) { next_(rec, TraceArg::Int).i = v; }
+        static void add_(TraceRecord& rec, long v) { next_(rec, TraceArg::Int).i = v; }
+        static void add_(TraceRecord& rec, unsigned long v) { next_(rec, TraceArg::Int).i = (int64_t)v; }
+        static void add_(TraceRecord& rec, long long v) { next_(rec, TraceArg::Int).i = v; }
+        static void add_(TraceRecord& rec, float v) { next_(rec, TraceArg::Double).d = v; }
+        static void add_(TraceRecord& rec, double v) { next_(rec, TraceArg::Double).d = v; }
+        static void add_(TraceRecord& rec, const char* v);
+        static void add_(TraceRecord& rec, const std::string& v) { add_(rec, v.c_str()); }
+        template <typename Derived>
+        static void add_(TraceRecord& rec, const Eigen::MatrixBase<Derived>& v) {
+            TraceArg& arg = next_(rec, TraceArg::Vector);
+            arg.offset = rec.num_values;
+            for (int i(0); i < v.size() && rec.num_values < TraceRecord::max_values;
+                 ++i, ++arg.size)
+                rec.values[rec.num_values++] = v(i);
+        }
+        // w, x, y, z as pretty_print
+        template <typename Derived>
+        static void add_(TraceRecord& rec, const Eigen::QuaternionBase<Derived>& v) {
+            add_(rec, Eigen::Vector4d(v.w(), v.x(), v.y(), v.z()));
+        }
+
+        Ring* rings_[max_threads];
+        std::atomic<int> num_rings_;
+        std::mutex register_mutex_;
+        std::atomic<int> level_;
+        std::atomic<int> rate_limit_;
+        std::chrono::steady_clock::time_point t_start_;
+
+        std::atomic<uint64_t> num_dropped_;
+        std::atomic<bool> b_running_;
+        std::thread sink_;
+    };
+
+} /* my_utils */
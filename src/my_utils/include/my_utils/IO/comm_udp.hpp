@@ -1,7 +1,12 @@
 #ifndef COMM_UDP
 #define COMM_UDP
 
+#include <netinet/in.h>
+#include <stdint.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
 #include <string>
+#include <vector>
 
 namespace COMM{
     void receive_data(int &socket, int port, void* data, int data_size, const char* ip_addr);
@@ -10,6 +15,86 @@ namespace COMM{
 
     void receive_data_unix(const char* server_name, void* data, int data_size);
     void send_data_unix   (const char* server_name, void* data, int data_size);
+
+    // prefix of the datagrams of UdpEndpoint
+    struct UdpHeader {
+        uint64_t seq; // from 1, per sender
+    };
+
+    struct UdpStats {
+        uint64_t num_sent;
+        uint64_t num_received;
+        uint64_t num_dropped; // sequence gaps, less the late arrivals
+        uint64_t num_reordered; // arrived after a later one
+        uint64_t num_duplicates; // sequence received before
+        uint64_t num_resyncs; // sender restarted, counting from its sequence
+    };
+
+    // UDP socket opened once, sending to one remote address and receiving
+    // on a local port, e.g. for a robot streaming its states
+    //   COMM::UdpEndpoint ep;
+    //   ep.open(50001, "127.0.0.1", 50002);
+    //   ep.setReceiveTimeout(0.001);
+    //   ep.send(&cmd, sizeof(cmd)); ep.receive(&state, sizeof(state));
+    // Each datagram carries a sequence number so that the receiver counts
+    // the drops, the reordering and the duplicates of a sender over the
+    // last seq_window sequences. The sequence 1 again, or one older than
+    // the window, is a restarted sender and the counting starts over from
+    // it.
+    class UdpEndpoint {
+    public:
+        static constexpr int seq_window = 64;
+
+        UdpEndpoint();
+        ~UdpEndpoint();
+
+        // local_port : 0, no bind, only sending. remote_ip NULL : no
+        // destination, only receiving. buffer sizes [byte], 0 : default
+        bool open(int local_port, const char* remote_ip, int remote_port,
+                  int recv_buffer_size = 0, int send_buffer_size = 0);
+        void close();
+        bool isOpen() const { return socket_ >= 0; }
+
+        // [s], < 0 : blocks, 0 : non-blocking, > 0 : waits up to it
+        void setReceiveTimeout(double timeout) { timeout_ = timeout; }
+
+        bool send(const void* data, int data_size);
+        // num messages in one sendmmsg, number sent
+        int sendBatch(const void* const* data, const int* data_size, int num);
+
+        // payload size of the datagram, -1 if none within the timeout.
+        // A payload beyond max_size is cut.
+        int receive(void* data, int max_size);
+        // up to max_num datagrams in one recvmmsg, message i in
+        // data + i * max_size of size data_size[i]. Waits for the first
+        // one as receive, number received
+        int receiveBatch(void* data, int max_size, int* data_size, int max_num);
+
+        const UdpStats& getStats() const { return stats_; }
+        void resetStats();
+
+    private:
+        UdpEndpoint(const UdpEndpoint&);
+        UdpEndpoint& operator=(const UdpEndpoint&);
+
+        bool wait_();
+        void reserve_(int num);
+        void count_(uint64_t seq);
+
+        int socket_;
+        bool b_remote_;
+        sockaddr_in remote_addr_;
+        double timeout_;
+        uint64_t send_seq_;
+        uint64_t last_seq_; // highest received
+        uint64_t seq_mask_; // bit i : last_seq_ - i received
+        UdpStats stats_;
+
+        // of the batches, grown to the largest one
+        std::vector<mmsghdr> msgs_;
+        std::vector<iovec> iovs_;
+        std::vector<UdpHeader> headers_;
+    };
 }
 
 #endif
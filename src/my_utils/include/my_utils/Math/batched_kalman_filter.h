@@ -0,0 +1,163 @@
+#ifndef BATCHED_KALMAN_FILTER
+#define BATCHED_KALMAN_FILTER
+
+#include <Eigen/Dense>
+
+// Channels independent linear kalman filters sharing the same model
+//   x(k+1) = F*x(k) + w(k), w(k)~N(0,Q)
+//   z(k) = h'*x(k) + v(k), v(k)~N(0,R_c), R_c per channel
+// stored as structure of arrays : state(c, i) is the i-th state of the
+// channel c and cov(c, i*StateDim+j) the (i,j) covariance, i.e. every
+// entry is one contiguous array over the channels. Predict and update are
+// single loops over the channels with the small per channel algebra
+// unrolled inside, which the compiler vectorizes across the channels.
+// The covariance update is in Joseph form,
+//   P = (I-Kh')P(I-Kh')' + K R K'
+// which keeps P symmetric positive semi-definite.
+// Nothing is allocated after the construction.
+template <int Channels, int StateDim>
+class BatchedKalmanFilter{
+public:
+    typedef Eigen::Array<double, Channels, 1> ChannelArray;
+    typedef Eigen::Array<double, Channels, StateDim> StateArray;
+    typedef Eigen::Array<double, Channels, StateDim*StateDim> CovarianceArray;
+    typedef Eigen::Matrix<double, StateDim, StateDim> StateMatrix;
+    typedef Eigen::Matrix<double, StateDim, 1> StateVector;
+
+    BatchedKalmanFilter() {
+        F_.setIdentity();
+        Q_.setZero();
+        h_.setZero();
+        h_[0] = 1.;
+        R_.setOnes();
+        initialize(StateVector::Zero(), StateMatrix::Identity());
+        y_.setZero();
+        s_.setZero();
+    }
+    ~BatchedKalmanFilter() {}
+
+    void setSystem(const StateMatrix& F, const StateMatrix& Q) {
+        F_ = F;
+        Q_ = Q;
+    }
+    void setMeasurement(const StateVector& h) { h_ = h; }
+    void setMeasurementNoise(double r) { R_.setConstant(r); }
+    void setMeasurementNoise(int c, double r) { R_[c] = r; }
+
+    // every channel starts from x0, P0
+    void initialize(const StateVector& x0, const StateMatrix& P0) {
+        for(int i(0); i<StateDim; ++i) {
+            x_.col(i).setConstant(x0[i]);
+            for(int j(0); j<StateDim; ++j)
+                P_.col(i*StateDim+j).setConstant(P0(i,j));
+        }
+    }
+    void initialize(int c, const StateVector& x0, const StateMatrix& P0) {
+        for(int i(0); i<StateDim; ++i) {
+            x_(c, i) = x0[i];
+            for(int j(0); j<StateDim; ++j)
+                P_(c, i*StateDim+j) = P0(i,j);
+        }
+    }
+
+    // x = F x, P = F P F' + Q
+    void predict() {
+        // the members do not overlap
+        const double* F = F_.data(); // column major
+        const double* Q = Q_.data();
+        double* __restrict__ x = x_.data();
+        double* __restrict__ P = P_.data();
+        for(int c = 0; c < Channels; ++c) {
+            double xc[StateDim], FP[StateDim][StateDim];
+            for(int i(0); i<StateDim; ++i) {
+                xc[i] = 0.;
+                for(int k(0); k<StateDim; ++k)
+                    xc[i] += F[k*StateDim+i]*x[k*Channels+c];
+            }
+            for(int i(0); i<StateDim; ++i)
+                for(int l(0); l<StateDim; ++l) {
+                    FP[i][l] = 0.;
+                    for(int k(0); k<StateDim; ++k)
+                        FP[i][l] += F[k*StateDim+i]*P[(k*StateDim+l)*Channels+c];
+                }
+            for(int i(0); i<StateDim; ++i) {
+                x[i*Channels+c] = xc[i];
+                for(int j(0); j<StateDim; ++j) {
+                    double Pij = Q[j*StateDim+i];
+                    for(int l(0); l<StateDim; ++l)
+                        Pij += FP[i][l]*F[l*StateDim+j];
+                    P[(i*StateDim+j)*Channels+c] = Pij;
+                }
+            }
+        }
+    }
+
+    // z(c) : measurement of the channel c
+    void update(const ChannelArray& z) {
+        const double* h = h_.data();
+        const double* R = R_.data();
+        // the members do not overlap
+        double* __restrict__ x = x_.data();
+        double* __restrict__ P = P_.data();
+        double* __restrict__ y = y_.data();
+        double* __restrict__ s = s_.data();
+        for(int c = 0; c < Channels; ++c) {
+            // Ph = P*h, s = h'Ph + R, K = Ph/s
+            double Ph[StateDim], K[StateDim];
+            double sc = R[c], yc = z[c];
+            for(int i(0); i<StateDim; ++i) {
+                Ph[i] = 0.;
+                for(int j(0); j<StateDim; ++j)
+                    Ph[i] += P[(i*StateDim+j)*Channels+c]*h[j];
+                sc += h[i]*Ph[i];
+                yc -= h[i]*x[i*Channels+c];
+            }
+            for(int i(0); i<StateDim; ++i) {
+                K[i] = Ph[i]/sc;
+                // x = x + K y
+                x[i*Channels+c] += K[i]*yc;
+            }
+            // AP = (I-Kh')P, P = AP*A' + K R K' = AP - (AP h) K' + K R K'
+            double AP[StateDim][StateDim], APh[StateDim];
+            for(int i(0); i<StateDim; ++i) {
+                APh[i] = 0.;
+                for(int l(0); l<StateDim; ++l) {
+                    AP[i][l] = P[(i*StateDim+l)*Channels+c] - K[i]*Ph[l];
+                    APh[i] += AP[i][l]*h[l];
+                }
+            }
+            for(int i(0); i<StateDim; ++i)
+                for(int j(0); j<StateDim; ++j)
+                    P[(i*StateDim+j)*Channels+c] = AP[i][j]
+                        - APh[i]*K[j] + K[i]*R[c]*K[j];
+            y[c] = yc;
+            s[c] = sc;
+        }
+    }
+
+    const StateArray& getState() const { return x_; }
+    double getState(int c, int i) const { return x_(c, i); }
+    double getCovariance(int c, int i, int j) const {
+        return P_(c, i*StateDim+j); }
+    // last innovation and its variance
+    const ChannelArray& getInnovation() const { return y_; }
+    const ChannelArray& getInnovationCovariance() const { return s_; }
+    static constexpr int channels() { return Channels; }
+
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+private:
+    StateMatrix F_;
+    StateMatrix Q_;
+    StateVector h_;
+    ChannelArray R_;
+
+    StateArray x_;
+    CovarianceArray P_;
+
+    // last innovation
+    ChannelArray s_;
+    ChannelArray y_;
+};
+
+#endif
@@ -69,4 +69,70 @@ private:
     Eigen::VectorXd input_val_2;
 };
 
+// LowPassFilter2 of a fixed dimension, update does not allocate
+template <int Dim>
+class LowPassFilter2Fixed{
+public:
+    typedef Eigen::Matrix<double, Dim, 1> VectorType;
+
+    LowPassFilter2Fixed(){
+        zeta = 0.9;
+        Ts=0.001;
+        b_initialized = false;
+    }
+    ~LowPassFilter2Fixed() {}
+
+    void initialize(double cutoff) {
+        cut_off_frequency=cutoff;
+        double Wn = cut_off_frequency*2.*M_PI;
+        cDen[0] = 4.0+4.0*zeta*Ts*Wn + Ts*Wn*Ts*Wn;
+        cDen[1] = 2.0*Ts*Wn*Ts*Wn - 8.0;
+        cDen[2] = 4.0-4.0*zeta*Ts*Wn + Ts*Wn*Ts*Wn;
+        cNum[0] = Ts*Ts*Wn*Wn;
+        cNum[1] = 2.0*Ts*Ts*Wn*Wn;
+        cNum[2] = Ts*Ts*Wn*Wn;
+        filtered_val_0.setZero();
+        filtered_val_1.setZero();
+        filtered_val_2.setZero();
+        input_val_0.setZero();
+        input_val_1.setZero();
+        input_val_2.setZero();
+        b_initialized = true;
+    }
+    const VectorType& update(const VectorType & s_in){
+        if(!b_initialized){
+            std::cout<<"LowPassFilter2Fixed didn't initialized"<< std::endl;
+            initialize(30.);
+        }
+        input_val_0 = s_in;
+        filtered_val_0 = ( cNum[0]*input_val_0 + cNum[1]*input_val_1 + cNum[2]*input_val_2
+                            - cDen[1]*filtered_val_1 - cDen[2]*filtered_val_2) / cDen[0];
+
+        filtered_val_2 = filtered_val_1;
+        filtered_val_1 = filtered_val_0;
+        input_val_2 = input_val_1;
+        input_val_1 = input_val_0;
+
+        return filtered_val_0;
+    }
+public:
+    double cut_off_frequency;
+    double zeta;
+    double Ts;
+
+private:
+    bool b_initialized;
+
+    Eigen::Vector3d cDen; // denominator coeff
+    Eigen::Vector3d cNum; // numerator coeff
+
+    VectorType filtered_val_0;
+    VectorType filtered_val_1;
+    VectorType filtered_val_2;
+
+    VectorType input_val_0;
+    VectorType input_val_1;
+    VectorType input_val_2;
+};
+
 #endif
\ No newline at end of file
@@ -0,0 +1,70 @@
+#ifndef RECURSIVE_LEAST_SQUARES
+#define RECURSIVE_LEAST_SQUARES
+
+#include <Eigen/Dense>
+
+// Recursive least squares of y = phi'*theta + e with exponential
+// forgetting, the samples of k ticks ago are weighted by lambda^k.
+// The covariance is bounded by max_trace, so that it does not wind up
+// while the regressor is not exciting.
+// Fixed size, an update costs O(Dim^2) and does not allocate.
+template <int Dim>
+class RecursiveLeastSquares{
+public:
+    typedef Eigen::Matrix<double, Dim, 1> VectorType;
+    typedef Eigen::Matrix<double, Dim, Dim> MatrixType;
+
+    RecursiveLeastSquares() {
+        lambda_ = 0.99;
+        max_trace_ = 1e6;
+        initialize(VectorType::Zero(), MatrixType::Identity());
+    }
+    ~RecursiveLeastSquares() {}
+
+    void initialize(const VectorType& theta0, const MatrixType& P0) {
+        theta_ = theta0;
+        P_ = P0;
+        num_update_ = 0;
+    }
+    void setForgettingFactor(double lambda) { lambda_ = lambda; }
+    void setMaxCovarianceTrace(double max_trace) { max_trace_ = max_trace; }
+
+    // return the prediction error before the update
+    double update(const VectorType& phi, double y) {
+        Pphi_.noalias() = P_*phi;
+        double denom = lambda_ + phi.dot(Pphi_);
+        K_ = Pphi_/denom;
+        double err = y - phi.dot(theta_);
+        theta_ += K_*err;
+
+        P_.noalias() -= K_*Pphi_.transpose();
+        P_ /= lambda_;
+        P_ = 0.5*(P_ + P_.transpose()).eval();
+        double trace = P_.trace();
+        if(trace > max_trace_) P_ *= max_trace_/trace;
+
+        ++num_update_;
+        return err;
+    }
+
+    const VectorType& getParameters() const { return theta_; }
+    double getParameter(int i) const { return theta_[i]; }
+    const MatrixType& getCovariance() const { return P_; }
+    int getNumUpdate() const { return num_update_; }
+
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+private:
+    double lambda_;
+    double max_trace_;
+    int num_update_;
+
+    VectorType theta_;
+    MatrixType P_;
+
+    // workspace
+    VectorType Pphi_;
+    VectorType K_;
+};
+
+#endif
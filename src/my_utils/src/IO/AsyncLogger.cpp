@@ -0,0 +1,209 @@
+#include "my_utils/IO/AsyncLogger.hpp"
+#include "my_utils/IO/IOUtilities.hpp"
+#include <unordered_map>
+
+namespace my_utils {
+
+AsyncLogger* AsyncLogger::getLogger() {
+    static AsyncLogger logger_;
+    return &logger_;
+}
+
+AsyncLogger::AsyncLogger()
+    : num_channels_(0), num_rings_(0), format_(LogFormat::Text), rate_(0.),
+      time_(0.), b_time_set_(false), num_dropped_(0), num_written_(0),
+      b_running_(true) {
+    t_start_ = std::chrono::steady_clock::now();
+    for (int i(0); i < max_channels; ++i) channels_[i].num_dropped = 0;
+    for (int i(0); i < max_threads; ++i) {
+        rings_[i] = NULL;
+        b_ring_free_[i] = false;
+    }
+    writer_ = std::thread(&AsyncLogger::run_, this);
+}
+
+AsyncLogger::~AsyncLogger() {
+    // write out what is left
+    b_running_ = false;
+    writer_.join();
+    drain_();
+    int num_channels = num_channels_.load(std::memory_order_acquire);
+    for (int i(0); i < num_channels; ++i) channels_[i].columnar.close();
+    for (int i(0); i < max_threads; ++i) delete rings_[i];
+}
+
+int AsyncLogger::getChannel(const std::string& name, bool b_param) {
+    // the lookup of a thread does not lock once the name is cached
+    static thread_local std::unordered_map<std::string, int> channel_cache;
+    std::unordered_map<std::string, int>::const_iterator it =
+        channel_cache.find(name);
+    if (it != channel_cache.end()) return it->second;
+
+    std::lock_guard<std::mutex> lock(register_mutex_);
+    int num_channels = num_channels_.load(std::memory_order_relaxed);
+    int channel = -1;
+    for (int i(0); i < num_channels; ++i)
+        if (channels_[i].name == name) channel = i;
+    if (channel < 0 && num_channels < max_channels) {
+        channel = num_channels;
+        channels_[channel].name = name;
+        // as cleaningFile, the file is truncated by the writer at the
+        // first record
+        channels_[channel].file_name =
+            b_param ? THIS_COM : THIS_COM "experiment_data/";
+        channels_[channel].format = format_;
+        channels_[channel].rate = rate_;
+        channels_[channel].file_name +=
+            name + (format_ == LogFormat::Text ? ".txt" : ".bin");
+        num_channels_.store(num_channels + 1, std::memory_order_release);
+    }
+    if (channel >= 0) channel_cache[name] = channel;
+    return channel;
+}
+
+int AsyncLogger::getChannel(const char* name, bool b_param) {
+    // no std::string for the name once cached, a name at an address which
+    // held another one before is checked against the registered name
+    static thread_local std::unordered_map<const char*, int> channel_cache;
+    std::unordered_map<const char*, int>::const_iterator it =
+        channel_cache.find(name);
+    if (it != channel_cache.end() && channels_[it->second].name == name)
+        return it->second;
+
+    int channel = getChannel(std::string(name), b_param);
+    if (channel >= 0) channel_cache[name] = channel;
+    return channel;
+}
+
+bool AsyncLogger::log(int channel, const double* data, int size) {
+    return push_(channel, size, data);
+}
+
+AsyncLogger::Ring* AsyncLogger::getThreadRing_() {
+    // frees the ring when the thread exits, the records left in it are
+    // still written, in order with the ones of the next thread
+    struct RingRelease {
+        RingRelease() : b_free(NULL) {}
+        ~RingRelease() {
+            if (b_free) b_free->store(true, std::memory_order_release);
+        }
+        std::atomic<bool>* b_free;
+    };
+    static thread_local Ring* ring = NULL;
+    if (ring) return ring;
+    static thread_local RingRelease release;
+
+    std::lock_guard<std::mutex> lock(register_mutex_);
+    int num_rings = num_rings_.load(std::memory_order_relaxed);
+    int r(0);
+    while (r < num_rings && !b_ring_free_[r].load(std::memory_order_acquire))
+        ++r;
+    if (r < num_rings) {
+        b_ring_free_[r].store(false, std::memory_order_relaxed);
+    } else {
+        if (num_rings == max_threads) return NULL;
+        rings_[r] = new Ring(ring_capacity);
+        num_rings_.store(num_rings + 1, std::memory_order_release);
+    }
+    ring = rings_[r];
+    release.b_free = &b_ring_free_[r];
+    return ring;
+}
+
+double AsyncLogger::now_() const {
+    if (b_time_set_.load(std::memory_order_relaxed))
+        return time_.load(std::memory_order_relaxed);
+    return std::chrono::duration<double>(std::chrono::steady_clock::now()
+                                         - t_start_).count();
+}
+
+bool AsyncLogger::drop_(int channel) {
+    if (channel < 0)
+        num_dropped_.fetch_add(1, std::memory_order_relaxed);
+    else
+        channels_[channel].num_dropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+uint64_t AsyncLogger::getDroppedCount() const {
+    uint64_t num_dropped = num_dropped_.load(std::memory_order_relaxed);
+    int num_channels = num_channels_.load(std::memory_order_acquire);
+    for (int i(0); i < num_channels; ++i)
+        num_dropped += channels_[i].num_dropped.load(std::memory_order_relaxed);
+    return num_dropped;
+}
+
+uint64_t AsyncLogger::getDroppedCount(int channel) const {
+    return channels_[channel].num_dropped.load(std::memory_order_relaxed);
+}
+
+bool AsyncLogger::drain_() {
+    bool b_written = false;
+    int n_read[max_threads];
+    int num_rings = num_rings_.load(std::memory_order_acquire);
+    for (int r(0); r < num_rings; ++r) {
+        Ring* ring = rings_[r];
+        int n_record = n_read[r] = ring->readable();
+        for (int i(0); i < n_record; ++i) {
+            const LogRecord& rec = ring->readSlot(i);
+            write_(channels_[rec.channel], rec);
+            if (rec.b_last) num_written_.fetch_add(1, std::memory_order_relaxed);
+        }
+        b_written = b_written || n_record > 0;
+    }
+    if (!b_written) return false;
+
+    // one flush per batch, the records are released once on the disk
+    flushFiles_();
+    for (int r(0); r < num_rings; ++r) rings_[r]->commitRead(n_read[r]);
+    return true;
+}
+
+void AsyncLogger::write_(Channel& ch, const LogRecord& rec) {
+    if (ch.format == LogFormat::Text) {
+        if (!ch.file.is_open())
+            ch.file.open(ch.file_name.c_str(), std::ios::trunc);
+        for (int j(0); j < rec.size; ++j) ch.file << rec.data[j] << "\t";
+        if (rec.b_last) ch.file << "\n";
+        return;
+    }
+
+    // a row of the columnar log once the vector is complete
+    ch.row.insert(ch.row.end(), rec.data, rec.data + rec.size);
+    if (!rec.b_last) return;
+    if (!ch.columnar.isOpen())
+        ch.columnar.open(ch.file_name, ch.name, (int)ch.row.size(),
+                         ch.format == LogFormat::Float64 ? LogDType::Float64
+                                                         : LogDType::Float32,
+                         ch.rate);
+    ch.columnar.append(rec.time, ch.row.data(), (int)ch.row.size());
+    ch.row.clear();
+}
+
+void AsyncLogger::flushFiles_() {
+    // the columnar logs are mapped, the page cache writes them out
+    int num_channels = num_channels_.load(std::memory_order_acquire);
+    for (int i(0); i < num_channels; ++i)
+        if (channels_[i].file.is_open()) channels_[i].file.flush();
+}
+
+void AsyncLogger::run_() {
+    // batches of write_period_ms
+    while (b_running_.load(std::memory_order_relaxed)) {
+        drain_();
+        std::this_thread::sleep_for(std::chrono::milliseconds(write_period_ms));
+    }
+}
+
+void AsyncLogger::flush() {
+    // positions of the last records of every ring
+    size_t target[max_threads];
+    int num_rings = num_rings_.load(std::memory_order_acquire);
+    for (int r(0); r < num_rings; ++r)
+        target[r] = rings_[r]->getWritePosition();
+    for (int r(0); r < num_rings; ++r)
+        while (rings_[r]->getReadPosition() < target[r])
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+}  // namespace my_utils
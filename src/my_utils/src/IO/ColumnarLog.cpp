@@ -0,0 +1,219 @@
+#include "my_utils/IO/ColumnarLog.hpp"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+namespace my_utils {
+
+static const char columnar_log_magic[8] = {'M', 'Y', 'L', 'O', 'G', 'C', 'O', 'L'};
+static const uint32_t columnar_log_version = 1;
+
+static size_t elementSize(LogDType dtype) {
+    return dtype == LogDType::Float64 ? sizeof(double) : sizeof(float);
+}
+
+// =============================================================================
+// ColumnarLogWriter
+// =============================================================================
+ColumnarLogWriter::ColumnarLogWriter()
+    : fd_(-1), base_(NULL), file_size_(0), segment_size_(0), chunk_size_(0),
+      element_size_(0), dim_(0), chunk_rows_(0), dtype_(LogDType::Float64) {}
+
+ColumnarLogWriter::~ColumnarLogWriter() { close(); }
+
+bool ColumnarLogWriter::open(const std::string& file_name,
+                             const std::string& name, int dim, LogDType dtype,
+                             double rate, int chunk_rows, int segment_chunks) {
+    close();
+    fd_ = ::open(file_name.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0) return false;
+
+    dim_ = dim;
+    dtype_ = dtype;
+    chunk_rows_ = chunk_rows;
+    element_size_ = elementSize(dtype);
+    chunk_size_ = chunk_rows_ * (sizeof(double) + dim_ * element_size_);
+    segment_size_ = segment_chunks * chunk_size_;
+    if (!map_(sizeof(ColumnarLogHeader) + segment_size_)) {
+        close();
+        return false;
+    }
+
+    ColumnarLogHeader* header = (ColumnarLogHeader*)base_;
+    memcpy(header->magic, columnar_log_magic, sizeof(header->magic));
+    header->version = columnar_log_version;
+    header->dtype = dtype_;
+    header->dim = dim_;
+    header->chunk_rows = chunk_rows_;
+    header->rate = rate;
+    header->num_rows = 0;
+    memset(header->name, 0, ColumnarLogHeader::name_size);
+    strncpy(header->name, name.c_str(), ColumnarLogHeader::name_size - 1);
+    return true;
+}
+
+bool ColumnarLogWriter::map_(size_t file_size) {
+    if (base_) munmap(base_, file_size_);
+    base_ = NULL;
+    if (ftruncate(fd_, file_size) != 0) return false;
+    void* base = mmap(NULL, file_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (base == MAP_FAILED) return false;
+    base_ = (char*)base;
+    file_size_ = file_size;
+    return true;
+}
+
+uint64_t ColumnarLogWriter::getNumRows() const {
+    return base_ ? ((const ColumnarLogHeader*)base_)->num_rows : 0;
+}
+
+bool ColumnarLogWriter::append(double time, const double* data, int size) {
+    if (!base_) return false;
+    uint64_t row = ((ColumnarLogHeader*)base_)->num_rows;
+    size_t chunk_offset = sizeof(ColumnarLogHeader) + (row / chunk_rows_) * chunk_size_;
+    // next segment
+    if (chunk_offset + chunk_size_ > file_size_ &&
+        !map_(file_size_ + segment_size_))
+        return false;
+
+    char* chunk = base_ + chunk_offset;
+    size_t i = row % chunk_rows_;
+    ((double*)chunk)[i] = time;
+    char* col_base = chunk + chunk_rows_ * sizeof(double);
+    for (int col(0); col < dim_; ++col, col_base += chunk_rows_ * element_size_) {
+        double value = col < size ? data[col]
+                                  : std::numeric_limits<double>::quiet_NaN();
+        if (dtype_ == LogDType::Float64)
+            ((double*)col_base)[i] = value;
+        else
+            ((float*)col_base)[i] = (float)value;
+    }
+    // the row is complete before it is counted
+    __atomic_store_n(&((ColumnarLogHeader*)base_)->num_rows, row + 1,
+                     __ATOMIC_RELEASE);
+    return true;
+}
+
+void ColumnarLogWriter::close() {
+    if (fd_ < 0) return;
+    if (base_) {
+        uint64_t num_rows = ((ColumnarLogHeader*)base_)->num_rows;
+        uint64_t num_chunks = (num_rows + chunk_rows_ - 1) / chunk_rows_;
+        munmap(base_, file_size_);
+        base_ = NULL;
+        if (ftruncate(fd_, sizeof(ColumnarLogHeader) + num_chunks * chunk_size_) != 0) {
+            // the file keeps the preallocated chunks, still readable
+        }
+    }
+    ::close(fd_);
+    fd_ = -1;
+    file_size_ = 0;
+}
+
+// =============================================================================
+// ColumnarLogReader
+// =============================================================================
+ColumnarLogReader::ColumnarLogReader()
+    : base_(NULL), file_size_(0), chunk_size_(0), element_size_(0), dim_(0),
+      chunk_rows_(1), dtype_(LogDType::Float64), rate_(0.), num_rows_(0) {}
+
+ColumnarLogReader::~ColumnarLogReader() { close(); }
+
+bool ColumnarLogReader::open(const std::string& file_name) {
+    close();
+    int fd = ::open(file_name.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(ColumnarLogHeader)) {
+        ::close(fd);
+        return false;
+    }
+    void* base = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) return false;
+    base_ = (const char*)base;
+    file_size_ = st.st_size;
+
+    const ColumnarLogHeader* header = (const ColumnarLogHeader*)base_;
+    if (memcmp(header->magic, columnar_log_magic, sizeof(header->magic)) != 0 ||
+        header->version != columnar_log_version || header->chunk_rows == 0) {
+        close();
+        return false;
+    }
+    dim_ = header->dim;
+    dtype_ = header->dtype;
+    chunk_rows_ = header->chunk_rows;
+    rate_ = header->rate;
+    element_size_ = elementSize(dtype_);
+    chunk_size_ = chunk_rows_ * (sizeof(double) + dim_ * element_size_);
+    num_rows_ = __atomic_load_n(&header->num_rows, __ATOMIC_ACQUIRE);
+    // the rows of the mapped chunks only
+    uint64_t num_chunks = (file_size_ - sizeof(ColumnarLogHeader)) / chunk_size_;
+    if (num_rows_ > num_chunks * chunk_rows_) num_rows_ = num_chunks * chunk_rows_;
+    return true;
+}
+
+void ColumnarLogReader::close() {
+    if (base_) munmap((void*)base_, file_size_);
+    base_ = NULL;
+    file_size_ = 0;
+    num_rows_ = 0;
+}
+
+std::string ColumnarLogReader::getName() const {
+    if (!base_) return std::string();
+    const ColumnarLogHeader* header = (const ColumnarLogHeader*)base_;
+    return std::string(header->name, strnlen(header->name, ColumnarLogHeader::name_size));
+}
+
+uint64_t ColumnarLogReader::findRow(double time) const {
+    if (num_rows_ == 0 || time <= getTime(0)) return 0;
+    uint64_t lo = 0, hi = num_rows_ - 1;
+    if (time >= getTime(hi)) return hi;
+
+    // guess from the nominal rate, a few rows around it
+    if (rate_ > 0.) {
+        double guess = std::floor((time - getTime(0)) * rate_ + 0.5);
+        uint64_t row = guess < (double)hi ? (uint64_t)guess : hi - 1;
+        for (int k(0); k < 4; ++k) {
+            if (getTime(row) > time) {
+                if (row == 0) break;
+                --row;
+            } else if (getTime(row + 1) <= time) {
+                ++row;
+                if (row == hi) break;
+            } else {
+                return row;
+            }
+        }
+    }
+    // getTime(lo) <= time < getTime(hi)
+    while (hi - lo > 1) {
+        uint64_t mid = lo + (hi - lo) / 2;
+        if (getTime(mid) <= time) lo = mid;
+        else hi = mid;
+    }
+    return lo;
+}
+
+bool exportColumnarLogToText(const std::string& bin_file,
+                             const std::string& txt_file, bool b_time) {
+    ColumnarLogReader reader;
+    if (!reader.open(bin_file)) return false;
+    std::ofstream savefile(txt_file.c_str(), std::ios::trunc);
+    if (!savefile.is_open()) return false;
+    for (uint64_t row(0); row < reader.getNumRows(); ++row) {
+        if (b_time) savefile << reader.getTime(row) << "\t";
+        for (int col(0); col < reader.getDim(); ++col)
+            savefile << reader.getValue(row, col) << "\t";
+        savefile << "\n";
+    }
+    return true;
+}
+
+}  // namespace my_utils
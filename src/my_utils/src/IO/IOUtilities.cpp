@@ -8,57 +8,61 @@
 
 namespace my_utils {
 
-void saveVector(const Eigen::VectorXd& vec_, std::string name_, bool b_param) {
-    std::string file_name;
-    cleaningFile(name_, file_name, b_param);
-
-    std::ofstream savefile(file_name.c_str(), std::ios::app);
-    for (int i(0); i < vec_.rows(); ++i) {
-        savefile << vec_(i) << "\t";
-    }
-    savefile << "\n";
-    savefile.flush();
-}
-
-void saveMatrix(const Eigen::MatrixXd& mtx_, std::string name_, bool b_param) {
+void saveMatrix(const Eigen::MatrixXd& mtx_, const std::string& name_,
+                bool b_param) {
+    AsyncLogger* logger = AsyncLogger::getLogger();
+    int channel = logger->getChannel(name_, b_param);
     for(int j=0; j<mtx_.rows(); ++j)  {
-        saveVector(mtx_.row(j), name_ , b_param);
+        logger->log(channel, mtx_.row(j));
     }
 }
 
-void saveValue(double _value, std::string _name, bool b_param) {
-    std::string file_name;
-    cleaningFile(_name, file_name, b_param);
-    std::ofstream savefile(file_name.c_str(), std::ios::app);
+void saveValue(double _value, const std::string& _name, bool b_param) {
+    AsyncLogger* logger = AsyncLogger::getLogger();
+    logger->log(logger->getChannel(_name, b_param), _value);
+}
 
-    savefile << _value << "\n";
-    savefile.flush();
+void saveVector(double* _vec, const std::string& _name, int size,
+                bool b_param) {
+    AsyncLogger* logger = AsyncLogger::getLogger();
+    logger->log(logger->getChannel(_name, b_param), _vec, size);
 }
 
-void saveVector(double* _vec, std::string _name, int size, bool b_param) {
-    std::string file_name;
-    cleaningFile(_name, file_name, b_param);
-    std::ofstream savefile(file_name.c_str(), std::ios::app);
+void saveVector(const std::vector<double>& _vec, const std::string& _name,
+                bool b_param) {
+    AsyncLogger* logger = AsyncLogger::getLogger();
+    logger->log(logger->getChannel(_name, b_param), _vec.data(),
+                (int)_vec.size());
+}
 
-    for (int i(0); i < size; ++i) {
-        savefile << _vec[i] << "\t";
+void saveMatrix(const Eigen::MatrixXd& mtx_, const char* name_,
+                bool b_param) {
+    AsyncLogger* logger = AsyncLogger::getLogger();
+    int channel = logger->getChannel(name_, b_param);
+    for(int j=0; j<mtx_.rows(); ++j)  {
+        logger->log(channel, mtx_.row(j));
     }
-    savefile << "\n";
-    savefile.flush();
 }
 
-void saveVector(const std::vector<double>& _vec, std::string _name,
+void saveValue(double _value, const char* _name, bool b_param) {
+    AsyncLogger* logger = AsyncLogger::getLogger();
+    logger->log(logger->getChannel(_name, b_param), _value);
+}
+
+void saveVector(double* _vec, const char* _name, int size, bool b_param) {
+    AsyncLogger* logger = AsyncLogger::getLogger();
+    logger->log(logger->getChannel(_name, b_param), _vec, size);
+}
+
+void saveVector(const std::vector<double>& _vec, const char* _name,
                 bool b_param) {
-    std::string file_name;
-    cleaningFile(_name, file_name, b_param);
-    std::ofstream savefile(file_name.c_str(), std::ios::app);
-    for (int i(0); i < _vec.size(); ++i) {
-        savefile << _vec[i] << "\t";
-    }
-    savefile << "\n";
-    savefile.flush();
+    AsyncLogger* logger = AsyncLogger::getLogger();
+    logger->log(logger->getChannel(_name, b_param), _vec.data(),
+                (int)_vec.size());
 }
 
+void flushSavedData() { AsyncLogger::getLogger()->flush(); }
+
 void cleaningFile(std::string _file_name, std::string& _ret_file,
                   bool b_param) {
     if (b_param)
@@ -0,0 +1,118 @@
+#include "my_utils/IO/LogChannel.hpp"
+#include "my_utils/IO/IOUtilities.hpp"
+#include <vector>
+
+namespace my_utils {
+
+std::atomic<uint64_t>
+    LogChannelRegistry::enable_mask_[LogChannelRegistry::max_channels / 64];
+
+LogChannelRegistry* LogChannelRegistry::getRegistry() {
+    static LogChannelRegistry registry_;
+    return &registry_;
+}
+
+LogChannelRegistry::LogChannelRegistry() : num_channels_(1), b_enable_all_(true) {
+    // the channel 0 of the default handles, never enabled
+    channels_[0].name = "";
+    channels_[0].dim = 0;
+    channels_[0].declared_decimation = 1;
+    channels_[0].decimation = 1;
+    channels_[0].b_declared_enabled = false;
+    channels_[0].count = 0;
+    channels_[0].b_param = false;
+    channels_[0].logger_channel = -1;
+    channels_[0].num_dim_mismatch = 0;
+}
+
+int LogChannelRegistry::find_(const std::string& name) const {
+    for (int id(1); id < num_channels_; ++id)
+        if (channels_[id].name == name) return id;
+    return 0;
+}
+
+int LogChannelRegistry::registerChannel(const std::string& name, int dim,
+                                        int decimation, bool b_enabled,
+                                        bool b_param) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int id = find_(name);
+    if (id > 0) return id;
+    if (num_channels_ == max_channels) return 0;
+
+    id = num_channels_++;
+    Channel& ch = channels_[id];
+    ch.name = name;
+    ch.dim = dim;
+    ch.declared_decimation = decimation;
+    ch.b_declared_enabled = b_enabled;
+    ch.b_param = b_param;
+    ch.logger_channel = -1;
+    ch.num_dim_mismatch = 0;
+    apply_(id);
+    return id;
+}
+
+void LogChannelRegistry::setEnabled_(int id, bool b_enabled) {
+    uint64_t bit = (uint64_t)1 << (id & 63);
+    if (b_enabled)
+        enable_mask_[id >> 6].fetch_or(bit, std::memory_order_relaxed);
+    else
+        enable_mask_[id >> 6].fetch_and(~bit, std::memory_order_relaxed);
+}
+
+void LogChannelRegistry::apply_(int id) {
+    Channel& ch = channels_[id];
+    bool b_enabled = b_enable_all_ && ch.b_declared_enabled;
+    int decimation = ch.declared_decimation;
+    std::map<std::string, Setting>::const_iterator it = settings_.find(ch.name);
+    if (it != settings_.end()) {
+        if (it->second.b_enabled >= 0) b_enabled = it->second.b_enabled;
+        if (it->second.decimation > 0) decimation = it->second.decimation;
+    }
+    ch.decimation = decimation;
+    ch.count = 0;
+    setEnabled_(id, b_enabled);
+}
+
+void LogChannelRegistry::setEnabled(const std::string& name, bool b_enabled) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    settings_[name].b_enabled = b_enabled;
+    int id = find_(name);
+    if (id > 0) apply_(id);
+}
+
+void LogChannelRegistry::setEnabledAll(bool b_enabled) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    b_enable_all_ = b_enabled;
+    for (int id(1); id < num_channels_; ++id) apply_(id);
+}
+
+void LogChannelRegistry::setDecimation(const std::string& name,
+                                       int decimation) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    settings_[name].decimation = decimation;
+    int id = find_(name);
+    if (id > 0) apply_(id);
+}
+
+void LogChannelRegistry::configure(const YAML::Node& node) {
+    bool b_enable_all;
+    std::vector<std::string> enabled, disabled;
+    std::map<std::string, int> decimation;
+    readParameter(node, "enable_all", b_enable_all);
+    readParameter(node, "enabled", enabled);
+    readParameter(node, "disabled", disabled);
+    readParameter(node, "decimation", decimation);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    b_enable_all_ = b_enable_all;
+    settings_.clear();
+    for (int i(0); i < (int)enabled.size(); ++i) settings_[enabled[i]].b_enabled = 1;
+    for (int i(0); i < (int)disabled.size(); ++i) settings_[disabled[i]].b_enabled = 0;
+    for (std::map<std::string, int>::const_iterator it = decimation.begin();
+         it != decimation.end(); ++it)
+        settings_[it->first].decimation = it->second;
+    for (int id(1); id < num_channels_; ++id) apply_(id);
+}
+
+}  // namespace my_utils
@@ -0,0 +1,161 @@
+#include "my_utils/IO/RtThread.hpp"
+#include "my_utils/IO/IOUtilities.hpp"
+#include "my_utils/IO/StageTiming.hpp"
+#include <alloca.h>
+#include <errno.h>
+#include <sched.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+
+namespace my_utils {
+
+static uint64_t toNs(const timespec& t) {
+    return (uint64_t)t.tv_sec * 1000000000ull + t.tv_nsec;
+}
+
+static timespec fromNs(uint64_t ns) {
+    timespec t;
+    t.tv_sec = ns / 1000000000ull;
+    t.tv_nsec = ns % 1000000000ull;
+    return t;
+}
+
+static uint64_t nowNs() {
+    timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return toNs(t);
+}
+
+static void updateMax(std::atomic<uint64_t>& max, uint64_t value) {
+    if (value > max.load(std::memory_order_relaxed))
+        max.store(value, std::memory_order_relaxed);
+}
+
+// the pages of the stack used by the loop are mapped before it, not at
+// its first deep call
+static void __attribute__((noinline)) prefaultStack(int size) {
+    if (size <= 0) return;
+    volatile char* stack = (volatile char*)alloca(size);
+    for (int i(0); i < size; i += 4096) stack[i] = 0;
+}
+
+RtThread::RtThread()
+    : thread_(), b_running_(false), b_realtime_(false), stage_wakeup_(-1),
+      stage_step_(-1), num_cycles_(0), num_overruns_(0), num_missed_(0),
+      max_wakeup_ns_(0), max_step_ns_(0) {}
+
+RtThread::~RtThread() { stop(); }
+
+bool RtThread::configureCurrentThread(const RtThreadConfig& config) {
+    bool b_granted = true;
+    if (config.b_lock_memory && mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        std::cout << "[" << config.name << "] mlockall failed : "
+                  << strerror(errno) << ", page faults may stall the loop"
+                  << std::endl;
+        b_granted = false;
+    }
+    if (config.cpu >= 0) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(config.cpu, &cpus);
+        int err = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+        if (err != 0) {
+            std::cout << "[" << config.name << "] cpu " << config.cpu
+                      << " not set : " << strerror(err) << std::endl;
+            b_granted = false;
+        }
+    }
+    if (config.priority > 0) {
+        sched_param param;
+        param.sched_priority = config.priority;
+        int err = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if (err != 0) {
+            std::cout << "[" << config.name << "] SCHED_FIFO " << config.priority
+                      << " not set : " << strerror(err)
+                      << ", running with the default scheduler" << std::endl;
+            b_granted = false;
+        }
+    }
+    prefaultStack(config.stack_prefault);
+    return b_granted;
+}
+
+bool RtThread::start(const RtThreadConfig& config) {
+    if (b_running_) return true;
+    config_ = config;
+    StageTiming* timing = StageTiming::getStageTiming();
+    stage_wakeup_ = timing->registerStage(config.name + "_wakeup", 0.);
+    stage_step_ = timing->registerStage(config.name + "_step", 1e3 * config.period);
+
+    b_running_ = true;
+    int err = pthread_create(&thread_, NULL, &RtThread::run_, this);
+    if (err != 0) {
+        std::cout << "[" << config.name << "] thread not created : "
+                  << strerror(err) << std::endl;
+        b_running_ = false;
+        return false;
+    }
+    return true;
+}
+
+void RtThread::stop() {
+    if (!b_running_) return;
+    b_running_ = false;
+    pthread_join(thread_, NULL);
+}
+
+RtThreadStats RtThread::getStats() const {
+    RtThreadStats stats;
+    stats.num_cycles = num_cycles_.load(std::memory_order_relaxed);
+    stats.num_overruns = num_overruns_.load(std::memory_order_relaxed);
+    stats.num_missed = num_missed_.load(std::memory_order_relaxed);
+    stats.max_wakeup_ns = max_wakeup_ns_.load(std::memory_order_relaxed);
+    stats.max_step_ns = max_step_ns_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void* RtThread::run_(void* arg) {
+    RtThread* thread = static_cast<RtThread*>(arg);
+    configureCurrentThread(thread->config_);
+    int policy;
+    sched_param param;
+    pthread_getschedparam(pthread_self(), &policy, &param);
+    thread->b_realtime_ = policy == SCHED_FIFO;
+    thread->loop_();
+    return NULL;
+}
+
+void RtThread::loop_() {
+    StageTiming* timing = StageTiming::getStageTiming();
+    uint64_t period_ns = (uint64_t)(1e9 * config_.period);
+    uint64_t deadline_ns = nowNs();
+    while (b_running_.load(std::memory_order_relaxed)) {
+        deadline_ns += period_ns;
+        timespec deadline = fromNs(deadline_ns);
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline,
+                               NULL) == EINTR) {}
+
+        uint64_t wakeup_ns = nowNs();
+        uint64_t latency_ns = wakeup_ns > deadline_ns ? wakeup_ns - deadline_ns : 0;
+        timing->record(stage_wakeup_, latency_ns);
+        updateMax(max_wakeup_ns_, latency_ns);
+
+        step();
+
+        uint64_t end_ns = nowNs();
+        timing->record(stage_step_, end_ns - wakeup_ns);
+        updateMax(max_step_ns_, end_ns - wakeup_ns);
+        num_cycles_.fetch_add(1, std::memory_order_relaxed);
+        if (end_ns > deadline_ns + period_ns) {
+            // the next deadline is the first one ahead, not a burst of
+            // the late ones
+            uint64_t num_missed = (end_ns - deadline_ns) / period_ns;
+            num_overruns_.fetch_add(1, std::memory_order_relaxed);
+            num_missed_.fetch_add(num_missed, std::memory_order_relaxed);
+            deadline_ns += num_missed * period_ns;
+        }
+    }
+}
+
+} /* my_utils */
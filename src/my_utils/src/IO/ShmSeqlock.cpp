@@ -0,0 +1,196 @@
+#include "my_utils/IO/ShmSeqlock.hpp"
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sched.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <climits>
+#include <cstring>
+#include <ctime>
+
+namespace my_utils {
+
+static const char seqlock_magic[8] = {'M', 'Y', 'S', 'E', 'Q', 'L', 'C', 'K'};
+static const uint32_t seqlock_version = 1;
+
+static inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+static inline int64_t nowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+bool parseShmWakeup(const std::string& name, ShmWakeup& wakeup) {
+    if (name == "busy_poll") wakeup = ShmWakeup::BusyPoll;
+    else if (name == "futex") wakeup = ShmWakeup::Futex;
+    else return false;
+    return true;
+}
+
+ShmSeqlock::ShmSeqlock()
+    : header_(NULL), payload_(NULL), segment_size_(0), b_writer_(false),
+      wakeup_(ShmWakeup::Futex) {}
+
+ShmSeqlock::~ShmSeqlock() { close(); }
+
+bool ShmSeqlock::open(const std::string& name, size_t payload_size,
+                      bool b_create) {
+    close();
+    size_t segment_size = sizeof(ShmSeqlockHeader) + payload_size;
+    int fd;
+    if (b_create) {
+        shm_unlink(name.c_str());
+        fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd >= 0 && ftruncate(fd, segment_size) != 0) {
+            ::close(fd);
+            shm_unlink(name.c_str());
+            return false;
+        }
+    } else {
+        fd = shm_open(name.c_str(), O_RDWR, 0);
+        struct stat st;
+        if (fd >= 0 && (fstat(fd, &st) != 0 || (size_t)st.st_size != segment_size)) {
+            ::close(fd);
+            return false;
+        }
+    }
+    if (fd < 0) return false;
+    // the readers write num_waiters
+    void* base = mmap(NULL, segment_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        if (b_create) shm_unlink(name.c_str());
+        return false;
+    }
+    header_ = (ShmSeqlockHeader*)base;
+    payload_ = (char*)base + sizeof(ShmSeqlockHeader);
+    segment_size_ = segment_size;
+    name_ = name;
+    b_writer_ = b_create;
+
+    if (b_create) {
+        header_->version = seqlock_version;
+        header_->payload_size = (uint32_t)payload_size;
+        header_->pid = (uint32_t)getpid();
+        // the segment is valid once the magic is set
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+        memcpy(header_->magic, seqlock_magic, sizeof(header_->magic));
+    } else {
+        bool b_valid = memcmp(header_->magic, seqlock_magic, sizeof(header_->magic)) == 0;
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (!b_valid || header_->version != seqlock_version ||
+            header_->payload_size != (uint32_t)payload_size || !isWriterAlive()) {
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+void ShmSeqlock::close() {
+    if (!header_) return;
+    munmap(header_, segment_size_);
+    if (b_writer_) shm_unlink(name_.c_str());
+    header_ = NULL;
+    payload_ = NULL;
+    segment_size_ = 0;
+    b_writer_ = false;
+}
+
+bool ShmSeqlock::isWriterAlive() const {
+    if (!header_) return false;
+    pid_t pid = (pid_t)header_->pid;
+    return pid > 0 && (kill(pid, 0) == 0 || errno == EPERM);
+}
+
+uint32_t ShmSeqlock::getSequence() const {
+    if (!header_) return 0;
+    return __atomic_load_n(&header_->seq, __ATOMIC_ACQUIRE);
+}
+
+void ShmSeqlock::write(const void* data) {
+    // the only writer of seq
+    uint32_t seq = __atomic_load_n(&header_->seq, __ATOMIC_RELAXED);
+    __atomic_store_n(&header_->seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy(payload_, data, header_->payload_size);
+    // 0 is left to the segment with no payload yet
+    uint32_t next = seq + 2 == 0 ? 2 : seq + 2;
+    // sequentially consistent with the waiters which register then check
+    // seq, so that a waiter is either seen here or sees the new seq
+    __atomic_store_n(&header_->seq, next, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&header_->num_waiters, __ATOMIC_SEQ_CST) > 0)
+        syscall(SYS_futex, &header_->seq, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+bool ShmSeqlock::tryRead_(void* data, uint32_t seq) const {
+    memcpy(data, payload_, header_->payload_size);
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&header_->seq, __ATOMIC_RELAXED) == seq;
+}
+
+bool ShmSeqlock::read(void* data, uint32_t* seq_read) const {
+    while (true) {
+        uint32_t seq = __atomic_load_n(&header_->seq, __ATOMIC_ACQUIRE);
+        if (seq == 0) return false;
+        if (seq & 1) {
+            cpuRelax();
+            continue;
+        }
+        if (tryRead_(data, seq)) {
+            if (seq_read) *seq_read = seq;
+            return true;
+        }
+    }
+}
+
+void ShmSeqlock::sleep_(uint32_t seq, int64_t timeout_ns) {
+    __atomic_add_fetch(&header_->num_waiters, 1, __ATOMIC_SEQ_CST);
+    // the futex sleeps only if seq is unchanged since the registration
+    if (__atomic_load_n(&header_->seq, __ATOMIC_SEQ_CST) == seq) {
+        struct timespec ts;
+        ts.tv_sec = timeout_ns / 1000000000;
+        ts.tv_nsec = timeout_ns % 1000000000;
+        // not private, the segment is shared between processes
+        syscall(SYS_futex, &header_->seq, FUTEX_WAIT, seq, &ts, NULL, 0);
+    }
+    __atomic_sub_fetch(&header_->num_waiters, 1, __ATOMIC_SEQ_CST);
+}
+
+bool ShmSeqlock::waitRead(void* data, uint32_t& last_seq, double timeout) {
+    int64_t deadline = nowNs() + (int64_t)(timeout * 1e9);
+    for (int n_poll(0);; ++n_poll) {
+        uint32_t seq = __atomic_load_n(&header_->seq, __ATOMIC_ACQUIRE);
+        if (seq != last_seq && seq != 0 && !(seq & 1)) {
+            if (tryRead_(data, seq)) {
+                last_seq = seq;
+                return true;
+            }
+            continue;
+        }
+        if (wakeup_ == ShmWakeup::BusyPoll) {
+            cpuRelax();
+            // the clock is read every few polls, the core is yielded now
+            // and then to a peer which shares it
+            if ((n_poll & 1023) == 1023) {
+                if (nowNs() > deadline) return false;
+                sched_yield();
+            }
+        } else {
+            int64_t timeout_ns = deadline - nowNs();
+            if (timeout_ns <= 0) return false;
+            sleep_(seq, timeout_ns);
+        }
+    }
+}
+
+}  // namespace my_utils
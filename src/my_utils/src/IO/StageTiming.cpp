@@ -0,0 +1,194 @@
+#include "my_utils/IO/StageTiming.hpp"
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace my_utils {
+
+static const char timing_magic[8] = {'M', 'Y', 'T', 'I', 'M', 'I', 'N', 'G'};
+static const uint32_t timing_version = 1;
+
+constexpr const char* StageTiming::timing_shm_name;
+
+uint64_t LatencyHistogram::quantile(const uint64_t* buckets, uint64_t count,
+                                    double q) {
+    if (count == 0) return 0;
+    uint64_t rank = (uint64_t)(q * (double)count);
+    if (rank >= count) rank = count - 1;
+    uint64_t sum = 0;
+    for (int i(0); i < num_buckets; ++i) {
+        sum += buckets[i];
+        if (sum > rank)
+            return i + 1 < num_buckets ? bucketValue(i + 1) - 1 : bucketValue(i);
+    }
+    return bucketValue(num_buckets - 1);
+}
+
+// =============================================================================
+// StageTiming
+// =============================================================================
+StageTiming* StageTiming::getStageTiming() {
+    static StageTiming stage_timing_;
+    return &stage_timing_;
+}
+
+StageTiming::StageTiming() : b_shared_(false) {
+    segment_size_ = sizeof(TimingSegmentHeader) + max_stages * sizeof(TimingStageData);
+    // a new segment per run, the monitors reopen it. The segment of
+    // another running process, e.g. the controller of a simulator in a
+    // separate process, is left to it and this one takes its own.
+    std::string shm_name = timing_shm_name;
+    void* base = createSegment_(shm_name);
+    if (!base) {
+        shm_name = std::string(timing_shm_name) + "_" + program_invocation_short_name;
+        base = createSegment_(shm_name);
+        if (base)
+            printf("[StageTiming] %s belongs to another process, the stages "
+                   "of this one are in %s\n", timing_shm_name, shm_name.c_str());
+    }
+    if (base) {
+        b_shared_ = true;
+        shm_name_ = shm_name;
+    } else {
+        // recorded all the same, not exported
+        printf("[StageTiming] no shared memory segment, the stages of this "
+               "process are not visible to timing_monitor\n");
+        base = calloc(1, segment_size_);
+    }
+    header_ = (TimingSegmentHeader*)base;
+    stages_ = (TimingStageData*)((char*)base + sizeof(TimingSegmentHeader));
+
+    memset(base, 0, segment_size_);
+    header_->version = timing_version;
+    header_->max_stages = max_stages;
+    header_->num_buckets = LatencyHistogram::num_buckets;
+    header_->sub_bits = LatencyHistogram::sub_bits;
+    header_->pid = (uint32_t)getpid();
+    // the segment is valid once the magic is set
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy(header_->magic, timing_magic, sizeof(header_->magic));
+}
+
+// mapped segment, NULL if it belongs to another running process or
+// cannot be created
+void* StageTiming::createSegment_(const std::string& shm_name) {
+    if (isWriterAlive_(shm_name)) return NULL;
+    shm_unlink(shm_name.c_str());
+    int fd = shm_open(shm_name.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return NULL;
+    void* base = NULL;
+    if (ftruncate(fd, segment_size_) == 0) {
+        base = mmap(NULL, segment_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (base == MAP_FAILED) base = NULL;
+    }
+    ::close(fd);
+    if (!base) shm_unlink(shm_name.c_str());
+    return base;
+}
+
+bool StageTiming::isWriterAlive_(const std::string& shm_name) {
+    StageTimingReader reader;
+    if (!reader.open(shm_name)) return false;
+    pid_t pid = (pid_t)reader.getWriterPid();
+    return pid > 0 && pid != getpid() && (kill(pid, 0) == 0 || errno == EPERM);
+}
+
+StageTiming::~StageTiming() {
+    // the segment stays readable after the run until the next one
+    if (b_shared_)
+        munmap(header_, segment_size_);
+    else
+        free(header_);
+}
+
+int StageTiming::registerStage(const std::string& name, double budget_ms) {
+    std::unique_lock<std::mutex> lock(register_mutex_);
+    int num_stages = __atomic_load_n(&header_->num_stages, __ATOMIC_RELAXED);
+    int stage = -1;
+    for (int i(0); i < num_stages; ++i)
+        if (name.compare(0, TimingStageData::name_size - 1, stages_[i].name) == 0)
+            stage = i;
+    if (stage < 0 && num_stages < max_stages) {
+        stage = num_stages;
+        strncpy(stages_[stage].name, name.c_str(), TimingStageData::name_size - 1);
+        __atomic_store_n(&header_->num_stages, num_stages + 1, __ATOMIC_RELEASE);
+    }
+    lock.unlock();
+    setBudget(stage, budget_ms);
+    return stage;
+}
+
+void StageTiming::setBudget(int stage, double budget_ms) {
+    if (stage < 0 || budget_ms <= 0.) return;
+    __atomic_store_n(&stages_[stage].budget_ns, (uint64_t)(budget_ms * 1e6),
+                     __ATOMIC_RELAXED);
+}
+
+// =============================================================================
+// StageTimingReader
+// =============================================================================
+StageTimingReader::StageTimingReader()
+    : header_(NULL), stages_(NULL), segment_size_(0) {}
+
+StageTimingReader::~StageTimingReader() { close(); }
+
+bool StageTimingReader::open(const std::string& shm_name) {
+    close();
+    int fd = shm_open(shm_name.c_str(), O_RDONLY, 0);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(TimingSegmentHeader)) {
+        ::close(fd);
+        return false;
+    }
+    void* base = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) return false;
+    header_ = (const TimingSegmentHeader*)base;
+    stages_ = (const TimingStageData*)((const char*)base + sizeof(TimingSegmentHeader));
+    segment_size_ = st.st_size;
+
+    if (memcmp(header_->magic, timing_magic, sizeof(header_->magic)) != 0 ||
+        header_->version != timing_version ||
+        header_->num_buckets != (uint32_t)LatencyHistogram::num_buckets ||
+        segment_size_ < sizeof(TimingSegmentHeader)
+                        + header_->max_stages * sizeof(TimingStageData)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void StageTimingReader::close() {
+    if (header_) munmap((void*)header_, segment_size_);
+    header_ = NULL;
+    stages_ = NULL;
+    segment_size_ = 0;
+}
+
+int StageTimingReader::getNumStages() const {
+    if (!header_) return 0;
+    return (int)__atomic_load_n(&header_->num_stages, __ATOMIC_ACQUIRE);
+}
+
+void StageTimingReader::getStage(int stage, TimingStageData& data) const {
+    const TimingStageData& s = stages_[stage];
+    memcpy(data.name, s.name, TimingStageData::name_size);
+    data.name[TimingStageData::name_size - 1] = '\0';
+    data.budget_ns = __atomic_load_n(&s.budget_ns, __ATOMIC_RELAXED);
+    data.count = __atomic_load_n(&s.count, __ATOMIC_RELAXED);
+    data.sum_ns = __atomic_load_n(&s.sum_ns, __ATOMIC_RELAXED);
+    data.max_ns = __atomic_load_n(&s.max_ns, __ATOMIC_RELAXED);
+    data.last_ns = __atomic_load_n(&s.last_ns, __ATOMIC_RELAXED);
+    data.num_overrun = __atomic_load_n(&s.num_overrun, __ATOMIC_RELAXED);
+    for (int i(0); i < LatencyHistogram::num_buckets; ++i)
+        data.buckets[i] = __atomic_load_n(&s.buckets[i], __ATOMIC_RELAXED);
+}
+
+}  // namespace my_utils
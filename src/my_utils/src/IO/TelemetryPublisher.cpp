@@ -0,0 +1,272 @@
+#include "my_utils/IO/TelemetryPublisher.hpp"
+#include "my_utils/IO/IOUtilities.hpp"
+#include <cstring>
+#include <sstream>
+
+#ifdef MY_UTILS_HAS_ZMQ
+#include <zmq.h>
+#endif
+
+namespace my_utils {
+
+static const char telemetry_magic[4] = {'M', 'Y', 'T', 'M'};
+static const uint16_t telemetry_version = 1;
+
+struct TelemetryPublisher::Impl {
+    Impl() : context(NULL), socket(NULL) {}
+    void* context;
+    void* socket;
+};
+
+TelemetryPublisher::TelemetryPublisher()
+    : num_topics_(0), ring_(ring_capacity),
+      pool_((size_t)pool_size * max_values), impl_(new Impl()),
+      b_running_(false) {
+    my_utils::pretty_constructor(1, "Telemetry Publisher");
+    for (int i(0); i < max_topics; ++i) {
+        topics_[i].num_sent = 0;
+        topics_[i].num_dropped = 0;
+        topics_[i].num_decimated = 0;
+    }
+    free_blocks_.reserve(pool_size);
+    for (int i(0); i < pool_size; ++i)
+        free_blocks_.push_back(pool_.data() + (size_t)i * max_values);
+}
+
+TelemetryPublisher::~TelemetryPublisher() {
+    stop();
+    delete impl_;
+}
+
+int TelemetryPublisher::addTopic(const std::string& name,
+                                 const std::vector<TelemetryField>& fields,
+                                 int decimation) {
+    std::lock_guard<std::mutex> lock(register_mutex_);
+    int num_topics = num_topics_.load(std::memory_order_relaxed);
+    if (num_topics == max_topics) return -1;
+    int size = 0;
+    std::ostringstream schema;
+    for (size_t i(0); i < fields.size(); ++i) {
+        schema << (i > 0 ? "," : "") << fields[i].name << ":" << fields[i].size;
+        size += fields[i].size;
+    }
+    if (size > max_values) return -1;
+
+    Topic& topic = topics_[num_topics];
+    topic.name = name;
+    topic.schema = schema.str();
+    topic.size = size;
+    topic.decimation = decimation > 1 ? decimation : 1;
+    topic.count = 0;
+    topic.seq = 0;
+    num_topics_.store(num_topics + 1, std::memory_order_release);
+    return num_topics;
+}
+
+bool TelemetryPublisher::publish(int topic_id, const double* data, int size,
+                                 double time) {
+    if (topic_id < 0 || !b_running_.load(std::memory_order_relaxed))
+        return false;
+    Topic& topic = topics_[topic_id];
+    if (topic.count++ % topic.decimation != 0) {
+        topic.num_decimated.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    // a sample lost here is a gap in the sequence of the subscribers
+    ++topic.seq;
+    if (size != topic.size || !ring_.canWrite(1)) {
+        topic.num_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    Sample& sample = ring_.writeSlot(0);
+    sample.topic = topic_id;
+    sample.size = size;
+    sample.seq = topic.seq;
+    sample.time = time;
+    memcpy(sample.data, data, size * sizeof(double));
+    ring_.commitWrite(1);
+    return true;
+}
+
+uint64_t TelemetryPublisher::getSentCount(int topic) const {
+    if (topic >= 0) return topics_[topic].num_sent.load(std::memory_order_relaxed);
+    uint64_t num = 0;
+    int num_topics = num_topics_.load(std::memory_order_acquire);
+    for (int i(0); i < num_topics; ++i)
+        num += topics_[i].num_sent.load(std::memory_order_relaxed);
+    return num;
+}
+
+uint64_t TelemetryPublisher::getDroppedCount(int topic) const {
+    if (topic >= 0)
+        return topics_[topic].num_dropped.load(std::memory_order_relaxed);
+    uint64_t num = 0;
+    int num_topics = num_topics_.load(std::memory_order_acquire);
+    for (int i(0); i < num_topics; ++i)
+        num += topics_[i].num_dropped.load(std::memory_order_relaxed);
+    return num;
+}
+
+uint64_t TelemetryPublisher::getDecimatedCount(int topic) const {
+    if (topic >= 0)
+        return topics_[topic].num_decimated.load(std::memory_order_relaxed);
+    uint64_t num = 0;
+    int num_topics = num_topics_.load(std::memory_order_acquire);
+    for (int i(0); i < num_topics; ++i)
+        num += topics_[i].num_decimated.load(std::memory_order_relaxed);
+    return num;
+}
+
+double* TelemetryPublisher::acquireBlock_() {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    if (free_blocks_.empty()) return NULL;
+    double* block = free_blocks_.back();
+    free_blocks_.pop_back();
+    return block;
+}
+
+void TelemetryPublisher::releaseBlock_(void* data, void* hint) {
+    // from the I/O thread of ZMQ once the frame is sent or dropped
+    TelemetryPublisher* publisher = static_cast<TelemetryPublisher*>(hint);
+    std::lock_guard<std::mutex> lock(publisher->pool_mutex_);
+    publisher->free_blocks_.push_back(static_cast<double*>(data));
+}
+
+#ifdef MY_UTILS_HAS_ZMQ
+
+void* TelemetryPublisher::getContext() const { return impl_->context; }
+
+bool TelemetryPublisher::start(const std::string& endpoint,
+                               int high_water_mark) {
+    if (b_running_) return true;
+    impl_->context = zmq_ctx_new();
+    impl_->socket = zmq_socket(impl_->context, ZMQ_PUB);
+    int linger_ms = 100;
+    zmq_setsockopt(impl_->socket, ZMQ_SNDHWM, &high_water_mark,
+                   sizeof(high_water_mark));
+    zmq_setsockopt(impl_->socket, ZMQ_LINGER, &linger_ms, sizeof(linger_ms));
+    if (zmq_bind(impl_->socket, endpoint.c_str()) != 0) {
+        std::cout << "Error binding the telemetry publisher [" << endpoint
+                  << "] : " << zmq_strerror(zmq_errno()) << std::endl;
+        zmq_close(impl_->socket);
+        zmq_ctx_term(impl_->context);
+        impl_->socket = impl_->context = NULL;
+        return false;
+    }
+    b_running_ = true;
+    publisher_ = std::thread(&TelemetryPublisher::run_, this);
+    return true;
+}
+
+void TelemetryPublisher::stop() {
+    if (!b_running_) return;
+    b_running_ = false;
+    publisher_.join();
+    // waits up to the linger for the frames in flight, whose blocks are
+    // given back before the pool goes
+    zmq_close(impl_->socket);
+    zmq_ctx_term(impl_->context);
+    impl_->socket = impl_->context = NULL;
+}
+
+bool TelemetryPublisher::send_(int topic_id, TelemetryFrameType type,
+                               uint64_t seq, double time, void* data,
+                               int size, bool b_pooled) {
+    const Topic& topic = topics_[topic_id];
+    TelemetryFrameHeader header;
+    memcpy(header.magic, telemetry_magic, sizeof(header.magic));
+    header.version = telemetry_version;
+    header.type = (uint16_t)type;
+    header.topic_id = topic_id;
+    header.size = size;
+    header.seq = seq;
+    header.time = time;
+
+    zmq_msg_t payload;
+    if (b_pooled) {
+        zmq_msg_init_data(&payload, data, size * sizeof(double),
+                          &TelemetryPublisher::releaseBlock_, this);
+    } else {
+        zmq_msg_init_size(&payload, size);
+        memcpy(zmq_msg_data(&payload), data, size);
+    }
+    // a PUB socket does not block, it drops past the high water mark
+    if (zmq_send(impl_->socket, topic.name.data(), topic.name.size(),
+                 ZMQ_SNDMORE) < 0 ||
+        zmq_send(impl_->socket, &header, sizeof(header), ZMQ_SNDMORE) < 0 ||
+        zmq_msg_send(&payload, impl_->socket, 0) < 0) {
+        zmq_msg_close(&payload);
+        return false;
+    }
+    return true;
+}
+
+#else
+
+void* TelemetryPublisher::getContext() const { return NULL; }
+
+bool TelemetryPublisher::start(const std::string& endpoint, int) {
+    std::cout << "Telemetry publisher [" << endpoint
+              << "] not started : my_utils is built without ZMQ" << std::endl;
+    return false;
+}
+
+void TelemetryPublisher::stop() {}
+
+bool TelemetryPublisher::send_(int, TelemetryFrameType, uint64_t, double,
+                               void*, int, bool) {
+    return false;
+}
+
+#endif
+
+void TelemetryPublisher::sendSchemas_(int first_topic, int num_topics) {
+    for (int i(first_topic); i < num_topics; ++i) {
+        std::string& schema = topics_[i].schema;
+        send_(i, TelemetryFrameType::Schema, 0, 0., &schema[0],
+              (int)schema.size(), false);
+    }
+    t_schema_ = std::chrono::steady_clock::now();
+}
+
+void TelemetryPublisher::run_() {
+    int num_schemas = num_topics_.load(std::memory_order_acquire);
+    sendSchemas_(0, num_schemas);
+    while (true) {
+        bool b_running = b_running_.load(std::memory_order_acquire);
+        int num_topics = num_topics_.load(std::memory_order_acquire);
+        if (num_topics > num_schemas) {
+            sendSchemas_(num_schemas, num_topics);
+            num_schemas = num_topics;
+        }
+        if (std::chrono::steady_clock::now() - t_schema_ >
+            std::chrono::duration<double>(schema_period))
+            sendSchemas_(0, num_topics);
+
+        int n_sample = ring_.readable();
+        for (int i(0); i < n_sample; ++i) {
+            const Sample& sample = ring_.readSlot(i);
+            Topic& topic = topics_[sample.topic];
+            double* block = acquireBlock_();
+            if (block) {
+                memcpy(block, sample.data, sample.size * sizeof(double));
+                if (send_(sample.topic, TelemetryFrameType::Data, sample.seq,
+                          sample.time, block, sample.size, true)) {
+                    topic.num_sent.fetch_add(1, std::memory_order_relaxed);
+                    continue;
+                }
+            }
+            topic.num_dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+        ring_.commitRead(n_sample);
+
+        // what is left in the ring is sent before stopping
+        if (n_sample == 0) {
+            if (!b_running) break;
+            std::this_thread::sleep_for(
+                std::chrono::microseconds(poll_period_us));
+        }
+    }
+}
+
+} /* my_utils */
@@ -0,0 +1,169 @@
+#include "my_utils/IO/Trace.hpp"
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+
+namespace my_utils {
+
+bool parseTraceLevel(const std::string& name, TraceLevel& level) {
+    if (name == "debug") level = TraceLevel::Debug;
+    else if (name == "info") level = TraceLevel::Info;
+    else if (name == "warn") level = TraceLevel::Warn;
+    else if (name == "error") level = TraceLevel::Error;
+    else return false;
+    return true;
+}
+
+Tracer* Tracer::getTracer() {
+    static Tracer tracer_;
+    return &tracer_;
+}
+
+Tracer::Tracer()
+    : num_rings_(0), level_((int)TraceLevel::Info), rate_limit_(10),
+      num_dropped_(0), b_running_(true) {
+    t_start_ = std::chrono::steady_clock::now();
+    for (int i(0); i < max_threads; ++i) rings_[i] = NULL;
+    sink_ = std::thread(&Tracer::run_, this);
+}
+
+Tracer::~Tracer() {
+    b_running_ = false;
+    sink_.join();
+    drain_();
+    for (int i(0); i < max_threads; ++i) delete rings_[i];
+}
+
+bool Tracer::allow_(TraceSite& site, int64_t now, uint32_t& num_suppressed) {
+    int rate_limit = rate_limit_.load(std::memory_order_relaxed);
+    if (rate_limit > 0) {
+        // windows of one second
+        if (now - site.window_start.load(std::memory_order_relaxed) >= 1000000000) {
+            site.window_start.store(now, std::memory_order_relaxed);
+            site.num_in_window.store(0, std::memory_order_relaxed);
+        }
+        if (site.num_in_window.fetch_add(1, std::memory_order_relaxed) >= rate_limit) {
+            site.num_suppressed.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    }
+    num_suppressed = site.num_suppressed.exchange(0, std::memory_order_relaxed);
+    return true;
+}
+
+Tracer::Ring* Tracer::getThreadRing_() {
+    static thread_local Ring* ring = NULL;
+    if (ring) return ring;
+
+    std::lock_guard<std::mutex> lock(register_mutex_);
+    int num_rings = num_rings_.load(std::memory_order_relaxed);
+    if (num_rings == max_threads) return NULL;
+    ring = new Ring(ring_capacity);
+    rings_[num_rings] = ring;
+    num_rings_.store(num_rings + 1, std::memory_order_release);
+    return ring;
+}
+
+void Tracer::add_(TraceRecord& rec, const char* v) {
+    TraceArg& arg = next_(rec, TraceArg::Text);
+    arg.offset = rec.num_text;
+    int size = v ? (int)strlen(v) : 0;
+    if (size > TraceRecord::max_text - rec.num_text)
+        size = TraceRecord::max_text - rec.num_text;
+    memcpy(rec.text + rec.num_text, v, size);
+    rec.num_text += size;
+    arg.size = size;
+}
+
+void Tracer::write_(const TraceRecord& rec, std::string& line) const {
+    static const char* level_names[4] = {"DEBUG", "INFO ", "WARN ", "ERROR"};
+    const TraceSite& site = *rec.site;
+    std::ostringstream os;
+    char stamp[32];
+    snprintf(stamp, sizeof(stamp), "[%s %9.4f] ", level_names[(int)site.level],
+             rec.time);
+    os << stamp;
+
+    // each {} of the format is the next argument
+    int i_arg = 0;
+    for (const char* c = site.format; *c; ++c) {
+        if (c[0] != '{' || c[1] != '}' || i_arg == rec.num_args) {
+            os << *c;
+            continue;
+        }
+        const TraceArg& arg = rec.args[i_arg++];
+        switch (arg.type) {
+            case TraceArg::Int:
+                os << arg.i;
+                break;
+            case TraceArg::Double:
+                os << arg.d;
+                break;
+            case TraceArg::Text:
+                os.write(rec.text + arg.offset, arg.size);
+                break;
+            case TraceArg::Vector:
+                // as pretty_print, whose buffer is not shared with the sink
+                for (int i(0); i < arg.size; ++i) {
+                    char value[32];
+                    snprintf(value, sizeof(value), "% 6.6f  ",
+                             rec.values[arg.offset + i]);
+                    os << value;
+                }
+                break;
+        }
+        ++c;
+    }
+    if (rec.num_suppressed > 0)
+        os << " (" << rec.num_suppressed << " suppressed)";
+    if (site.level >= TraceLevel::Warn)
+        os << " (" << site.file << ":" << site.line << ")";
+
+    switch (site.level) {
+        case TraceLevel::Warn:
+            line += "\033[1;33m" + os.str() + "\033[0m\n";
+            break;
+        case TraceLevel::Error:
+            line += "\033[1;31m" + os.str() + "\033[0m\n";
+            break;
+        default:
+            line += os.str() + "\n";
+    }
+}
+
+bool Tracer::drain_() {
+    // formatted in a batch, one console write
+    std::string lines;
+    int n_read[max_threads];
+    int num_rings = num_rings_.load(std::memory_order_acquire);
+    for (int r(0); r < num_rings; ++r) {
+        Ring* ring = rings_[r];
+        int n_record = n_read[r] = ring->readable();
+        for (int i(0); i < n_record; ++i) write_(ring->readSlot(i), lines);
+    }
+    if (!lines.empty()) {
+        fwrite(lines.data(), 1, lines.size(), stdout);
+        fflush(stdout);
+    }
+    for (int r(0); r < num_rings; ++r) rings_[r]->commitRead(n_read[r]);
+    return !lines.empty();
+}
+
+void Tracer::run_() {
+    while (b_running_.load(std::memory_order_relaxed)) {
+        drain_();
+        std::this_thread::sleep_for(std::chrono::milliseconds(sink_period_ms));
+    }
+}
+
+void Tracer::flush() {
+    size_t target[max_threads];
+    int num_rings = num_rings_.load(std::memory_order_acquire);
+    for (int r(0); r < num_rings; ++r)
+        target[r] = rings_[r]->getWritePosition();
+    for (int r(0); r < num_rings; ++r)
+        while (rings_[r]->getReadPosition() < target[r])
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+}  // namespace my_utils
@@ -2,6 +2,7 @@
 
 #include <arpa/inet.h>
 #include <netinet/in.h>
+#include <poll.h>
 #include <stdio.h>
 #include <string.h>
 #include <sys/socket.h>
@@ -122,4 +123,212 @@ void send_data_unix(const char* server_name, void* data, int data_size) {
     }
     close(sock);
 }
+
+// =============================================================================
+// UdpEndpoint
+// =============================================================================
+constexpr int UdpEndpoint::seq_window;
+
+UdpEndpoint::UdpEndpoint()
+    : socket_(-1), b_remote_(false), timeout_(-1.), send_seq_(0), last_seq_(0),
+      seq_mask_(0) {
+    memset(&remote_addr_, 0, sizeof(remote_addr_));
+    memset(&stats_, 0, sizeof(stats_));
+}
+
+UdpEndpoint::~UdpEndpoint() { close(); }
+
+bool UdpEndpoint::open(int local_port, const char* remote_ip, int remote_port,
+                       int recv_buffer_size, int send_buffer_size) {
+    close();
+    if ((socket_ = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP)) < 0) {
+        perror("[UdpEndpoint] fail to make socket");
+        return false;
+    }
+    if (recv_buffer_size > 0 &&
+        setsockopt(socket_, SOL_SOCKET, SO_RCVBUF, &recv_buffer_size,
+                   sizeof(recv_buffer_size)) < 0)
+        perror("[UdpEndpoint] receive buffer size");
+    if (send_buffer_size > 0 &&
+        setsockopt(socket_, SOL_SOCKET, SO_SNDBUF, &send_buffer_size,
+                   sizeof(send_buffer_size)) < 0)
+        perror("[UdpEndpoint] send buffer size");
+
+    if (local_port > 0) {
+        struct sockaddr_in si_me;
+        memset((char*)&si_me, 0, sizeof(si_me));
+        si_me.sin_family = AF_INET;
+        si_me.sin_port = htons(local_port);
+        si_me.sin_addr.s_addr = htonl(INADDR_ANY);
+        if (bind(socket_, (const sockaddr*)&si_me, sizeof(si_me)) < 0) {
+            perror("[UdpEndpoint] binding socket");
+            close();
+            return false;
+        }
+    }
+    b_remote_ = remote_ip != NULL;
+    if (b_remote_) {
+        memset((char*)&remote_addr_, 0, sizeof(remote_addr_));
+        remote_addr_.sin_family = AF_INET;
+        remote_addr_.sin_port = htons(remote_port);
+        if (inet_pton(AF_INET, remote_ip, &remote_addr_.sin_addr) != 1) {
+            printf("[UdpEndpoint] invalid address %s\n", remote_ip);
+            close();
+            return false;
+        }
+    }
+    send_seq_ = 0;
+    resetStats();
+    return true;
+}
+
+void UdpEndpoint::close() {
+    if (socket_ >= 0) ::close(socket_);
+    socket_ = -1;
+    b_remote_ = false;
+}
+
+void UdpEndpoint::resetStats() {
+    memset(&stats_, 0, sizeof(stats_));
+    last_seq_ = 0;
+    seq_mask_ = 0;
+}
+
+void UdpEndpoint::reserve_(int num) {
+    if ((int)msgs_.size() >= num) return;
+    msgs_.resize(num);
+    iovs_.resize(2 * num);
+    headers_.resize(num);
+}
+
+void UdpEndpoint::count_(uint64_t seq) {
+    ++stats_.num_received;
+    if (seq > last_seq_) {
+        uint64_t shift = seq - last_seq_;
+        stats_.num_dropped += shift - 1;
+        seq_mask_ = shift < (uint64_t)seq_window ? (seq_mask_ << shift) | 1 : 1;
+        last_seq_ = seq;
+        return;
+    }
+    uint64_t age = last_seq_ - seq;
+    bool b_seen = age < (uint64_t)seq_window && ((seq_mask_ >> age) & 1);
+    if (age >= (uint64_t)seq_window || (seq == 1 && b_seen)) {
+        // restarted sender, its gap is not a drop
+        ++stats_.num_resyncs;
+        seq_mask_ = 1;
+        last_seq_ = seq;
+    } else if (b_seen) {
+        ++stats_.num_duplicates;
+    } else {
+        // counted as dropped when the later one came
+        seq_mask_ |= (uint64_t)1 << age;
+        ++stats_.num_reordered;
+        if (stats_.num_dropped > 0) --stats_.num_dropped;
+    }
+}
+
+bool UdpEndpoint::wait_() {
+    struct pollfd pfd;
+    pfd.fd = socket_;
+    pfd.events = POLLIN;
+    struct timespec ts;
+    ts.tv_sec = (time_t)timeout_;
+    ts.tv_nsec = (long)((timeout_ - (double)ts.tv_sec) * 1e9);
+    return ppoll(&pfd, 1, timeout_ < 0. ? NULL : &ts, NULL) > 0;
+}
+
+bool UdpEndpoint::send(const void* data, int data_size) {
+    if (!b_remote_) return false;
+    UdpHeader header;
+    header.seq = send_seq_ + 1;
+    struct iovec iov[2];
+    iov[0].iov_base = &header;
+    iov[0].iov_len = sizeof(header);
+    iov[1].iov_base = (void*)data;
+    iov[1].iov_len = data_size;
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_name = &remote_addr_;
+    msg.msg_namelen = sizeof(remote_addr_);
+    msg.msg_iov = iov;
+    msg.msg_iovlen = 2;
+    if (sendmsg(socket_, &msg, 0) != (ssize_t)(sizeof(header) + data_size))
+        return false;
+    ++send_seq_;
+    ++stats_.num_sent;
+    return true;
+}
+
+int UdpEndpoint::sendBatch(const void* const* data, const int* data_size,
+                           int num) {
+    if (!b_remote_ || num <= 0) return 0;
+    reserve_(num);
+    for (int i(0); i < num; ++i) {
+        headers_[i].seq = send_seq_ + 1 + i;
+        iovs_[2 * i].iov_base = &headers_[i];
+        iovs_[2 * i].iov_len = sizeof(UdpHeader);
+        iovs_[2 * i + 1].iov_base = (void*)data[i];
+        iovs_[2 * i + 1].iov_len = data_size[i];
+        memset(&msgs_[i], 0, sizeof(mmsghdr));
+        msgs_[i].msg_hdr.msg_name = &remote_addr_;
+        msgs_[i].msg_hdr.msg_namelen = sizeof(remote_addr_);
+        msgs_[i].msg_hdr.msg_iov = &iovs_[2 * i];
+        msgs_[i].msg_hdr.msg_iovlen = 2;
+    }
+    int num_sent = sendmmsg(socket_, msgs_.data(), num, 0);
+    if (num_sent <= 0) return 0;
+    send_seq_ += num_sent;
+    stats_.num_sent += num_sent;
+    return num_sent;
+}
+
+int UdpEndpoint::receive(void* data, int max_size) {
+    UdpHeader header;
+    struct iovec iov[2];
+    iov[0].iov_base = &header;
+    iov[0].iov_len = sizeof(header);
+    iov[1].iov_base = data;
+    iov[1].iov_len = max_size;
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = 2;
+    // polled only if nothing is queued
+    ssize_t n = recvmsg(socket_, &msg, MSG_DONTWAIT);
+    if (n < 0 && timeout_ != 0. && wait_())
+        n = recvmsg(socket_, &msg, MSG_DONTWAIT);
+    // not from an UdpEndpoint
+    if (n < (ssize_t)sizeof(header)) return -1;
+    count_(header.seq);
+    return (int)(n - sizeof(header));
+}
+
+int UdpEndpoint::receiveBatch(void* data, int max_size, int* data_size,
+                              int max_num) {
+    if (max_num <= 0) return 0;
+    reserve_(max_num);
+    for (int i(0); i < max_num; ++i) {
+        iovs_[2 * i].iov_base = &headers_[i];
+        iovs_[2 * i].iov_len = sizeof(UdpHeader);
+        iovs_[2 * i + 1].iov_base = (char*)data + (size_t)i * max_size;
+        iovs_[2 * i + 1].iov_len = max_size;
+        memset(&msgs_[i], 0, sizeof(mmsghdr));
+        msgs_[i].msg_hdr.msg_iov = &iovs_[2 * i];
+        msgs_[i].msg_hdr.msg_iovlen = 2;
+    }
+    int num = recvmmsg(socket_, msgs_.data(), max_num, MSG_DONTWAIT, NULL);
+    if (num <= 0 && timeout_ != 0. && wait_())
+        num = recvmmsg(socket_, msgs_.data(), max_num, MSG_DONTWAIT, NULL);
+    if (num <= 0) return 0;
+    for (int i(0); i < num; ++i) {
+        // -1 : not from an UdpEndpoint
+        if (msgs_[i].msg_len < sizeof(UdpHeader)) {
+            data_size[i] = -1;
+            continue;
+        }
+        count_(headers_[i].seq);
+        data_size[i] = (int)(msgs_[i].msg_len - sizeof(UdpHeader));
+    }
+    return num;
+}
 }  // namespace COMM
@@ -0,0 +1,149 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "my_utils/Math/batched_kalman_filter.h"
+#include "my_utils/Math/simple_kalman_filter.h"
+
+// batched_kalman_bench [-n ticks]
+// runs the [velocity, acceleration] filter of the slip observer, constant
+// acceleration with white noise jerk and the velocity measured, on 4 to 96
+// channels of noisy measurements through BatchedKalmanFilter, through a
+// fixed size Joseph form filter per channel and through a
+// SimpleKalmanFilter per channel. Prints the time per tick of each and the
+// largest relative difference of the batched states and covariances to the
+// fixed size reference. Exits with 1 if it is above 1e-10 or the batched
+// filter allocates.
+static const double dt = 0.001;
+static const double jerk_noise = 100.;
+static const double meas_noise = 0.005;
+
+static bool b_count_alloc = false;
+static uint64_t num_alloc = 0;
+
+// malloc of glibc counted, operator new and the Eigen storage go through it
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* malloc(size_t size) {
+    if (b_count_alloc) ++num_alloc;
+    return __libc_malloc(size);
+}
+
+static double elapsedNs(const std::chrono::steady_clock::time_point& t_start) {
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t_start)
+        .count();
+}
+
+// relative difference to the reference
+template <int Channels>
+static double run(int num) {
+    typedef BatchedKalmanFilter<Channels, 2> Batched;
+    Eigen::Matrix2d F, Q, P0;
+    double r = meas_noise * meas_noise;
+    F << 1., dt, 0., 1.;
+    Q << jerk_noise * dt * dt * dt / 3., jerk_noise * dt * dt / 2.,
+        jerk_noise * dt * dt / 2., jerk_noise * dt;
+    P0 << r, 0., 0., jerk_noise * dt;
+
+    std::mt19937 gen(1);
+    std::normal_distribution<double> normal(0., 1.);
+    std::vector<typename Batched::ChannelArray> z(num);
+    for (int k(0); k < num; ++k)
+        for (int c(0); c < Channels; ++c)
+            z[k][c] = 0.1 * std::sin(2. * M_PI * k * dt + c) + meas_noise * normal(gen);
+
+    Batched* batched = new Batched();
+    batched->setSystem(F, Q);
+    batched->setMeasurement(Eigen::Vector2d(1., 0.));
+    batched->setMeasurementNoise(r);
+    batched->initialize(Eigen::Vector2d::Zero(), P0);
+    num_alloc = 0;
+    b_count_alloc = true;
+    auto t_start = std::chrono::steady_clock::now();
+    for (int k(0); k < num; ++k) {
+        batched->predict();
+        batched->update(z[k]);
+    }
+    double t_batched = elapsedNs(t_start) / num;
+    b_count_alloc = false;
+    uint64_t num_batched_alloc = num_alloc;
+
+    std::vector<Eigen::Vector2d> x(Channels, Eigen::Vector2d::Zero());
+    std::vector<Eigen::Matrix2d> P(Channels, P0);
+    Eigen::RowVector2d h(1., 0.);
+    t_start = std::chrono::steady_clock::now();
+    for (int k(0); k < num; ++k) {
+        for (int c(0); c < Channels; ++c) {
+            x[c] = F * x[c];
+            P[c] = F * P[c] * F.transpose() + Q;
+            double s = (h * P[c] * h.transpose())(0) + r;
+            Eigen::Vector2d K = P[c] * h.transpose() / s;
+            x[c] += K * (z[k][c] - x[c][0]);
+            Eigen::Matrix2d A = Eigen::Matrix2d::Identity() - K * h;
+            P[c] = A * P[c] * A.transpose() + K * r * K.transpose();
+        }
+    }
+    double t_fixed = elapsedNs(t_start) / num;
+
+    SimpleSystemParam sys;
+    sys.F = F;
+    sys.Q = Q;
+    sys.H = Eigen::MatrixXd::Zero(1, 2);
+    sys.H(0, 0) = 1.;
+    sys.R = Eigen::MatrixXd::Constant(1, 1, r);
+    std::vector<SimpleKalmanFilter> simple(Channels);
+    for (int c(0); c < Channels; ++c) simple[c].initialize(Eigen::Vector2d::Zero(), P0);
+    Eigen::VectorXd zc(1), xhat(2);
+    t_start = std::chrono::steady_clock::now();
+    for (int k(0); k < num; ++k) {
+        for (int c(0); c < Channels; ++c) {
+            zc[0] = z[k][c];
+            simple[c].propagate(zc, xhat, &sys);
+        }
+    }
+    double t_simple = elapsedNs(t_start) / num;
+
+    double diff = 0.;
+    for (int c(0); c < Channels; ++c) {
+        for (int i(0); i < 2; ++i) {
+            diff = std::max(diff, std::fabs(batched->getState(c, i) - x[c][i]) /
+                                      x[c].cwiseAbs().maxCoeff());
+            for (int j(0); j < 2; ++j)
+                diff = std::max(diff, std::fabs(batched->getCovariance(c, i, j) - P[c](i, j)) /
+                                          P[c].cwiseAbs().maxCoeff());
+        }
+    }
+    printf("%9d %9.0f %9.0f %9.0f %9.1e %9llu\n", Channels, t_batched, t_fixed, t_simple, diff,
+           (unsigned long long)num_batched_alloc);
+    delete batched;
+    return num_batched_alloc == 0 ? diff : 1.;
+}
+
+int main(int argc, char** argv) {
+    int num = 20000;
+    for (int i(1); i < argc; ++i) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            num = atoi(argv[++i]);
+        } else {
+            printf("usage: batched_kalman_bench [-n ticks]\n");
+            return 1;
+        }
+    }
+
+    printf("%d ticks, [ns] per predict + update\n", num);
+    printf("%9s %9s %9s %9s %9s %9s\n", "channels", "batched", "fixed", "simple", "diff",
+           "alloc");
+    double diff = 0.;
+    diff = std::max(diff, run<4>(num));
+    diff = std::max(diff, run<12>(num));
+    diff = std::max(diff, run<24>(num));
+    diff = std::max(diff, run<48>(num));
+    diff = std::max(diff, run<96>(num));
+    bool b_ok = diff < 1e-10;
+    printf("%s\n", b_ok ? "OK" : "FAILED");
+    return b_ok ? 0 : 1;
+}
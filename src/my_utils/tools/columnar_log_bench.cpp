@@ -0,0 +1,180 @@
+#include <sys/stat.h>
+#include <unistd.h>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "my_utils/IO/ColumnarLog.hpp"
+
+// columnar_log_bench [-n rows] [-d dim] [-o directory]
+// writes rows of dim noisy sines, 5 minutes at 1 kHz by default, as the
+// text of saveVector and as float64 and float32 columnar logs in
+// directory, then loads them all back and looks up 1e6 random times with
+// findRow, on the regular log and on one with every 7th period 4 times
+// longer. Prints the time and the size of each, checks the rows found,
+// the float32 values against the float64 ones and the float64 log exported
+// to text against the text written directly, exits with 1 on a mismatch.
+// The files are removed at the end.
+static const int num_queries = 1000000;
+
+static double elapsedS(const std::chrono::steady_clock::time_point& t_start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t_start).count();
+}
+
+static double fileMB(const std::string& file_name) {
+    struct stat st;
+    return stat(file_name.c_str(), &st) == 0 ? st.st_size / 1e6 : 0.;
+}
+
+static bool sameFiles(const std::string& a, const std::string& b) {
+    std::ifstream fa(a.c_str(), std::ios::binary), fb(b.c_str(), std::ios::binary);
+    std::istreambuf_iterator<char> ia(fa), ib(fb), end;
+    for (; ia != end && ib != end; ++ia, ++ib)
+        if (*ia != *ib) return false;
+    return ia == end && ib == end;
+}
+
+// number of rows found which are not the last one at or before the time
+static int checkFindRow(const my_utils::ColumnarLogReader& reader, std::mt19937& gen,
+                        double& ns_per_query) {
+    uint64_t num_rows = reader.getNumRows();
+    std::uniform_real_distribution<double> uniform(reader.getTime(0),
+                                                   reader.getTime(num_rows - 1) + 0.01);
+    int num_bad = 0;
+    auto t_start = std::chrono::steady_clock::now();
+    for (int q(0); q < num_queries; ++q) {
+        double t = uniform(gen);
+        uint64_t row = reader.findRow(t);
+        if (reader.getTime(row) > t || (row + 1 < num_rows && reader.getTime(row + 1) <= t))
+            ++num_bad;
+    }
+    ns_per_query = 1e9 * elapsedS(t_start) / num_queries;
+    return num_bad;
+}
+
+int main(int argc, char** argv) {
+    int num = 300000;
+    int dim = 24;
+    std::string dir = "/tmp";
+    for (int i(1); i < argc; ++i) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            num = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
+            dim = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            dir = argv[++i];
+        } else {
+            printf("usage: columnar_log_bench [-n rows] [-d dim] [-o directory]\n");
+            return 1;
+        }
+    }
+    std::string text_file = dir + "/columnar_log_bench.txt";
+    std::string f64_file = dir + "/columnar_log_bench_f64.bin";
+    std::string f32_file = dir + "/columnar_log_bench_f32.bin";
+    std::string irregular_file = dir + "/columnar_log_bench_irregular.bin";
+    std::string export_file = dir + "/columnar_log_bench_export.txt";
+
+    std::mt19937 gen(1);
+    std::normal_distribution<double> normal(0., 1.);
+    std::vector<double> data((size_t)num * dim);
+    for (int k(0); k < num; ++k)
+        for (int i(0); i < dim; ++i)
+            data[(size_t)k * dim + i] = std::sin(1e-3 * k * (i + 1)) + 1e-3 * normal(gen);
+
+    // as the writer thread of AsyncLogger
+    auto t_start = std::chrono::steady_clock::now();
+    {
+        std::ofstream file(text_file.c_str(), std::ios::trunc);
+        for (int k(0); k < num; ++k) {
+            for (int i(0); i < dim; ++i) file << data[(size_t)k * dim + i] << "\t";
+            file << "\n";
+        }
+    }
+    double t_text = elapsedS(t_start);
+    double t_write[2];
+    const char* bin_files[2] = {f64_file.c_str(), f32_file.c_str()};
+    my_utils::LogDType dtypes[2] = {my_utils::LogDType::Float64, my_utils::LogDType::Float32};
+    bool b_ok = true;
+    for (int f(0); f < 2; ++f) {
+        my_utils::ColumnarLogWriter writer;
+        t_start = std::chrono::steady_clock::now();
+        b_ok = writer.open(bin_files[f], "columnar_log_bench", dim, dtypes[f], 1000.) && b_ok;
+        for (int k(0); k < num; ++k) writer.append(1e-3 * k, &data[(size_t)k * dim], dim);
+        writer.close();
+        t_write[f] = elapsedS(t_start);
+    }
+
+    t_start = std::chrono::steady_clock::now();
+    double sum_text = 0.;
+    {
+        std::ifstream file(text_file.c_str());
+        double value;
+        while (file >> value) sum_text += value;
+    }
+    double t_text_load = elapsedS(t_start);
+    my_utils::ColumnarLogReader reader, reader32;
+    b_ok = reader.open(f64_file) && reader32.open(f32_file) && b_ok;
+    if (!b_ok || (int)reader.getNumRows() != num || reader.getDim() != dim) {
+        printf("cannot write the logs in %s\n", dir.c_str());
+        return 1;
+    }
+    t_start = std::chrono::steady_clock::now();
+    double sum = 0.;
+    for (int k(0); k < num; ++k)
+        for (int i(0); i < dim; ++i) sum += reader.getValue(k, i);
+    double t_load = elapsedS(t_start);
+    double max_err32 = 0.;
+    for (int k(0); k < num; ++k)
+        for (int i(0); i < dim; ++i)
+            max_err32 = std::max(max_err32,
+                                 std::fabs(reader32.getValue(k, i) - reader.getValue(k, i)));
+
+    double ns_regular, ns_irregular;
+    int num_bad = checkFindRow(reader, gen, ns_regular);
+    {
+        my_utils::ColumnarLogWriter writer;
+        writer.open(irregular_file, "irregular", 1, my_utils::LogDType::Float64, 1000.);
+        double t = 0.;
+        for (int k(0); k < num; ++k) {
+            t += 1e-3 * (k % 7 == 0 ? 4. : 1.);
+            double value = k;
+            writer.append(t, &value, 1);
+        }
+        writer.close();
+    }
+    my_utils::ColumnarLogReader irregular;
+    b_ok = irregular.open(irregular_file) && b_ok;
+    num_bad += checkFindRow(irregular, gen, ns_irregular);
+
+    b_ok = my_utils::exportColumnarLogToText(f64_file, export_file) && b_ok;
+    bool b_same = sameFiles(export_file, text_file);
+
+    printf("%d rows of %d values\n", num, dim);
+    printf("%-22s %9s %9s %9s\n", "", "write [s]", "size [MB]", "load [s]");
+    printf("%-22s %9.3f %9.1f %9.3f\n", "text", t_text, fileMB(text_file), t_text_load);
+    printf("%-22s %9.3f %9.1f %9.3f\n", "float64", t_write[0], fileMB(f64_file), t_load);
+    printf("%-22s %9.3f %9.1f %9s\n", "float32", t_write[1], fileMB(f32_file), "");
+    printf("findRow [ns] regular %.1f, irregular %.1f, %d wrong rows\n", ns_regular,
+           ns_irregular, num_bad);
+    printf("float32 largest error %.1e, export %s the text (%.0f %.0f)\n", max_err32,
+           b_same ? "same as" : "differs from", sum, sum_text);
+
+    reader.close();
+    reader32.close();
+    irregular.close();
+    unlink(text_file.c_str());
+    unlink(f64_file.c_str());
+    unlink(f32_file.c_str());
+    unlink(irregular_file.c_str());
+    unlink(export_file.c_str());
+
+    b_ok = b_ok && num_bad == 0 && b_same && max_err32 < 1e-6;
+    printf("%s\n", b_ok ? "OK" : "FAILED");
+    return b_ok ? 0 : 1;
+}
@@ -0,0 +1,34 @@
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "my_utils/IO/ColumnarLog.hpp"
+
+// log_to_text [-t] <name>.bin ...
+// writes <name>.txt next to every columnar log, in the layout of
+// saveVector, with the time as the first column if -t
+int main(int argc, char** argv) {
+    bool b_time = false;
+    int num_failed = 0;
+    for (int i(1); i < argc; ++i) {
+        if (strcmp(argv[i], "-t") == 0) {
+            b_time = true;
+            continue;
+        }
+        std::string bin_file(argv[i]);
+        std::string txt_file = bin_file;
+        size_t ext = txt_file.rfind(".bin");
+        if (ext != std::string::npos && ext + 4 == txt_file.size())
+            txt_file.erase(ext);
+        txt_file += ".txt";
+
+        if (my_utils::exportColumnarLogToText(bin_file, txt_file, b_time)) {
+            printf("%s -> %s\n", bin_file.c_str(), txt_file.c_str());
+        } else {
+            printf("cannot convert %s\n", bin_file.c_str());
+            ++num_failed;
+        }
+    }
+    if (argc < 2) printf("usage: log_to_text [-t] <name>.bin ...\n");
+    return num_failed;
+}
@@ -0,0 +1,162 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "my_utils/General/MpscQueue.hpp"
+#include "my_utils/IO/StageTiming.hpp"
+
+using my_utils::LatencyHistogram;
+
+// mpsc_queue_bench [-p producers] [-n values_per_producer] [-b drain_batch]
+// producer threads push to a consumer which drains at most drain_batch
+// values per round as the control thread per tick, through MpscQueue and
+// through a std::deque under a mutex. Checks that every value comes once
+// and in the order of its producer, exits with 1 otherwise.
+static const int queue_capacity = 256;
+
+struct Latency {
+    Latency() : buckets(LatencyHistogram::num_buckets, 0), count(0), sum_ns(0) {}
+    void add(uint64_t ns) {
+        ++buckets[LatencyHistogram::bucketIndex(ns)];
+        ++count;
+        sum_ns += ns;
+    }
+    void merge(const Latency& other) {
+        for (size_t i(0); i < buckets.size(); ++i) buckets[i] += other.buckets[i];
+        count += other.count;
+        sum_ns += other.sum_ns;
+    }
+    void print(const char* name) const {
+        printf("%-22s %9llu %9.3f %9.3f %9.3f %9.3f\n", name,
+               (unsigned long long)count, count ? 1e-3 * sum_ns / count : 0.,
+               1e-3 * LatencyHistogram::quantile(buckets.data(), count, 0.5),
+               1e-3 * LatencyHistogram::quantile(buckets.data(), count, 0.99),
+               1e-3 * LatencyHistogram::quantile(buckets.data(), count, 0.999));
+    }
+    std::vector<uint64_t> buckets;
+    uint64_t count, sum_ns;
+};
+
+static uint64_t elapsedNs(const std::chrono::steady_clock::time_point& t_start) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - t_start).count();
+}
+
+// bounded as MpscQueue, for the comparison
+class LockedQueue {
+   public:
+    bool push(uint64_t value) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (queue_.size() >= (size_t)queue_capacity) return false;
+        queue_.push_back(value);
+        return true;
+    }
+    template <typename F>
+    int consume(F f, int max_num) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        int n(0);
+        for (; n < max_num && !queue_.empty(); ++n) {
+            f(queue_.front());
+            queue_.pop_front();
+        }
+        return n;
+    }
+
+   private:
+    std::mutex mutex_;
+    std::deque<uint64_t> queue_;
+};
+
+template <typename Queue>
+static bool run(const char* name, int num_producers, int num, int batch) {
+    Queue queue;
+    std::vector<Latency> push_latency(num_producers);
+    std::vector<uint64_t> num_full(num_producers, 0);
+    std::vector<std::thread> producers;
+    auto t_start = std::chrono::steady_clock::now();
+    for (int p(0); p < num_producers; ++p) {
+        producers.push_back(std::thread([&, p]() {
+            for (uint64_t i(0); i < (uint64_t)num;) {
+                auto t_push = std::chrono::steady_clock::now();
+                bool b_pushed = queue.push(((uint64_t)p << 32) | i);
+                push_latency[p].add(elapsedNs(t_push));
+                if (b_pushed) {
+                    ++i;
+                } else {
+                    ++num_full[p];
+                    std::this_thread::yield();
+                }
+            }
+        }));
+    }
+
+    std::vector<uint64_t> next(num_producers, 0);
+    Latency drain_latency;
+    uint64_t num_received = 0, num_disordered = 0;
+    uint64_t total = (uint64_t)num_producers * num;
+    while (num_received < total) {
+        auto t_drain = std::chrono::steady_clock::now();
+        int n = queue.consume([&](uint64_t value) {
+            int p = (int)(value >> 32);
+            if ((value & 0xffffffffull) != next[p]++) ++num_disordered;
+        }, batch);
+        if (n == 0) {
+            std::this_thread::yield();
+            continue;
+        }
+        drain_latency.add(elapsedNs(t_drain));
+        num_received += n;
+    }
+    double t = 1e-9 * elapsedNs(t_start);
+    for (int p(0); p < num_producers; ++p) producers[p].join();
+
+    Latency latency;
+    uint64_t full = 0;
+    for (int p(0); p < num_producers; ++p) {
+        latency.merge(push_latency[p]);
+        full += num_full[p];
+    }
+    printf("%s : %.2f M values/s, queue full %llu, out of order %llu\n", name,
+           1e-6 * total / t, (unsigned long long)full,
+           (unsigned long long)num_disordered);
+    latency.print("  push");
+    drain_latency.print("  drain");
+    return num_disordered == 0;
+}
+
+struct LockFreeQueue : public MpscQueue<uint64_t> {
+    LockFreeQueue() : MpscQueue<uint64_t>(queue_capacity) {}
+};
+
+int main(int argc, char** argv) {
+    int num_producers = 4;
+    int num = 200000;
+    int batch = 32;
+    for (int i(1); i < argc; ++i) {
+        if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
+            num_producers = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            num = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) {
+            batch = atoi(argv[++i]);
+        } else {
+            printf("usage: mpsc_queue_bench [-p producers] "
+                   "[-n values_per_producer] [-b drain_batch]\n");
+            return 1;
+        }
+    }
+
+    printf("%d producers, %d values each, drain batch %d, capacity %d\n",
+           num_producers, num, batch, queue_capacity);
+    printf("%-22s %9s %9s %9s %9s %9s\n", "[us]", "count", "mean", "p50", "p99",
+           "p99.9");
+    bool b_ok = run<LockFreeQueue>("MpscQueue", num_producers, num, batch);
+    b_ok = run<LockedQueue>("mutex + std::deque", num_producers, num, batch) && b_ok;
+    printf("%s\n", b_ok ? "OK" : "FAILED");
+    return b_ok ? 0 : 1;
+}
@@ -0,0 +1,91 @@
+#include <unistd.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "my_utils/IO/RtThread.hpp"
+#include "my_utils/IO/StageTiming.hpp"
+
+using my_utils::LatencyHistogram;
+using my_utils::RtThread;
+using my_utils::RtThreadConfig;
+using my_utils::RtThreadStats;
+using my_utils::StageTiming;
+
+// rt_jitter [-p period_us] [-t seconds] [-w work_us] [-P priority] [-c cpu] [-m]
+// runs an RtThread whose step spins for the work time, as cyclictest, and
+// prints its wakeup latency and overruns. -m locks the memory. Without
+// the privileges the thread runs degraded and says so.
+class SpinTask : public RtThread {
+   public:
+    explicit SpinTask(double work) : work_(work) {}
+    ~SpinTask() { stop(); }
+
+   protected:
+    void step() {
+        auto t_start = std::chrono::steady_clock::now();
+        while (std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                             t_start).count() < work_) {}
+    }
+
+   private:
+    double work_;
+};
+
+static void printStage(const char* name) {
+    StageTiming* timing = StageTiming::getStageTiming();
+    const my_utils::TimingStageData& s =
+        timing->getStage(timing->registerStage(name, 0.));
+    printf("%-22s %9llu %9.2f %9.2f %9.2f %9.2f %9.2f\n", name,
+           (unsigned long long)s.count, s.count ? 1e-3 * s.sum_ns / s.count : 0.,
+           1e-3 * LatencyHistogram::quantile(s.buckets, s.count, 0.5),
+           1e-3 * LatencyHistogram::quantile(s.buckets, s.count, 0.99),
+           1e-3 * LatencyHistogram::quantile(s.buckets, s.count, 0.999),
+           1e-3 * s.max_ns);
+}
+
+int main(int argc, char** argv) {
+    RtThreadConfig config;
+    config.name = "rt_jitter";
+    double duration = 10.;
+    double work = 0.;
+    for (int i(1); i < argc; ++i) {
+        if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
+            config.period = 1e-6 * atof(argv[++i]);
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            duration = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+            work = 1e-6 * atof(argv[++i]);
+        } else if (strcmp(argv[i], "-P") == 0 && i + 1 < argc) {
+            config.priority = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+            config.cpu = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-m") == 0) {
+            config.b_lock_memory = true;
+        } else {
+            printf("usage: rt_jitter [-p period_us] [-t seconds] [-w work_us] "
+                   "[-P priority] [-c cpu] [-m]\n");
+            return 1;
+        }
+    }
+
+    SpinTask task(work);
+    if (!task.start(config)) return 1;
+    usleep((useconds_t)(1e6 * duration));
+    task.stop();
+
+    RtThreadStats stats = task.getStats();
+    printf("period %.0f us, work %.0f us, %s\n", 1e6 * config.period, 1e6 * work,
+           task.isRealTime() ? "SCHED_FIFO" : "default scheduler");
+    printf("%-22s %9s %9s %9s %9s %9s %9s\n", "[us]", "count", "mean", "p50",
+           "p99", "p99.9", "max");
+    printStage("rt_jitter_wakeup");
+    printStage("rt_jitter_step");
+    printf("cycles %llu overruns %llu missed %llu\n",
+           (unsigned long long)stats.num_cycles,
+           (unsigned long long)stats.num_overruns,
+           (unsigned long long)stats.num_missed);
+    return 0;
+}
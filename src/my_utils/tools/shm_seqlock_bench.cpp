@@ -0,0 +1,121 @@
+#include <sys/wait.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "my_utils/IO/ShmSeqlock.hpp"
+#include "my_utils/IO/StageTiming.hpp"
+
+using my_utils::LatencyHistogram;
+using my_utils::ShmSeqlock;
+using my_utils::ShmWakeup;
+
+// shm_seqlock_bench [-m busy_poll|futex] [-s payload_bytes] [-n round_trips]
+// round trips between this process and a forked echo process through two
+// seqlock segments, as a sensor data and its command. Without -m both
+// wakeup modes are measured.
+static bool openPeer(ShmSeqlock& sub, const std::string& name, size_t size) {
+    for (int i(0); i < 1000; ++i) {
+        if (sub.open(name, size, false)) return true;
+        usleep(1000);
+    }
+    return false;
+}
+
+static int echo(const std::string& ping, const std::string& pong, size_t size,
+                ShmWakeup wakeup, int num_round_trips) {
+    ShmSeqlock pub, sub;
+    if (!pub.open(pong, size, true) || !openPeer(sub, ping, size)) return 1;
+    sub.setWakeup(wakeup);
+    std::vector<char> payload(size);
+    uint32_t seq = 0;
+    for (int i(0); i < num_round_trips; ++i) {
+        if (!sub.waitRead(payload.data(), seq, 1.)) return 1;
+        pub.write(payload.data());
+    }
+    // the segment of the echo stays until the last reply is read
+    usleep(100000);
+    return 0;
+}
+
+static bool measure(ShmWakeup wakeup, size_t size, int num_round_trips) {
+    char ping[64], pong[64];
+    snprintf(ping, sizeof(ping), "/shm_seqlock_bench_%d_ping", (int)getpid());
+    snprintf(pong, sizeof(pong), "/shm_seqlock_bench_%d_pong", (int)getpid());
+    ShmSeqlock pub, sub;
+    if (!pub.open(ping, size, true)) return false;
+    pid_t child = fork();
+    if (child == 0) _exit(echo(ping, pong, size, wakeup, num_round_trips));
+    if (!openPeer(sub, pong, size)) return false;
+    sub.setWakeup(wakeup);
+
+    std::vector<char> payload(size, 0), reply(size, 0);
+    std::vector<uint64_t> buckets(LatencyHistogram::num_buckets, 0);
+    uint64_t sum_ns = 0, max_ns = 0, count = 0;
+    uint32_t seq = 0;
+    for (uint64_t tick(1); tick <= (uint64_t)num_round_trips; ++tick) {
+        memcpy(payload.data(), &tick, sizeof(tick));
+        auto t_start = std::chrono::steady_clock::now();
+        pub.write(payload.data());
+        uint64_t reply_tick = 0;
+        while (reply_tick != tick) {
+            if (!sub.waitRead(reply.data(), seq, 1.)) {
+                printf("no reply to round trip %llu\n", (unsigned long long)tick);
+                waitpid(child, NULL, 0);
+                return false;
+            }
+            memcpy(&reply_tick, reply.data(), sizeof(reply_tick));
+        }
+        uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - t_start).count();
+        // the first ones warm up the caches
+        if (tick <= 1000) continue;
+        ++buckets[LatencyHistogram::bucketIndex(ns)];
+        sum_ns += ns;
+        max_ns = ns > max_ns ? ns : max_ns;
+        ++count;
+    }
+    waitpid(child, NULL, 0);
+
+    printf("%-10s %9zu %9llu %9.2f %9.2f %9.2f %9.2f %9.2f\n",
+           wakeup == ShmWakeup::BusyPoll ? "busy_poll" : "futex", size,
+           (unsigned long long)count, count ? 1e-3 * sum_ns / count : 0.,
+           1e-3 * LatencyHistogram::quantile(buckets.data(), count, 0.5),
+           1e-3 * LatencyHistogram::quantile(buckets.data(), count, 0.99),
+           1e-3 * LatencyHistogram::quantile(buckets.data(), count, 0.999),
+           1e-3 * max_ns);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    std::vector<ShmWakeup> wakeups = {ShmWakeup::BusyPoll, ShmWakeup::Futex};
+    size_t size = 1024;
+    int num_round_trips = 100000;
+    for (int i(1); i < argc; ++i) {
+        ShmWakeup wakeup;
+        if (strcmp(argv[i], "-m") == 0 && i + 1 < argc &&
+            my_utils::parseShmWakeup(argv[i + 1], wakeup)) {
+            wakeups.assign(1, wakeup);
+            ++i;
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            size = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            num_round_trips = atoi(argv[++i]);
+        } else {
+            printf("usage: shm_seqlock_bench [-m busy_poll|futex] "
+                   "[-s payload_bytes] [-n round_trips]\n");
+            return 1;
+        }
+    }
+    if (size < sizeof(uint64_t)) size = sizeof(uint64_t);
+
+    printf("%-10s %9s %9s %9s %9s %9s %9s %9s\n", "wakeup", "bytes",
+           "count", "mean[us]", "p50", "p99", "p99.9", "max");
+    for (size_t i(0); i < wakeups.size(); ++i)
+        if (!measure(wakeups[i], size, num_round_trips)) return 1;
+    return 0;
+}
@@ -0,0 +1,235 @@
+#include <zmq.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "my_utils/IO/StageTiming.hpp"
+#include "my_utils/IO/TelemetryPublisher.hpp"
+
+using my_utils::LatencyHistogram;
+using my_utils::TelemetryFrameHeader;
+using my_utils::TelemetryFrameType;
+using my_utils::TelemetryPublisher;
+
+// telemetry_bench [-e endpoint] [-n samples] [-r rate_hz] [-d decimation]
+// publishes the ANYmal topics to a subscriber thread over inproc:// (the
+// default) or ipc://, measures the cost of publish in the loop and the
+// throughput, and checks the frames : schema, sequence and values. Exits
+// with 1 if a sent frame is not received intact. rate 0 : flat out.
+static const int num_topics = 3;
+
+struct Latency {
+    Latency() : buckets(LatencyHistogram::num_buckets, 0), count(0), sum_ns(0) {}
+    void add(uint64_t ns) {
+        ++buckets[LatencyHistogram::bucketIndex(ns)];
+        ++count;
+        sum_ns += ns;
+    }
+    void print(const char* name) const {
+        printf("%-22s %9llu %9.3f %9.3f %9.3f %9.3f\n", name,
+               (unsigned long long)count, count ? 1e-3 * sum_ns / count : 0.,
+               1e-3 * LatencyHistogram::quantile(buckets.data(), count, 0.5),
+               1e-3 * LatencyHistogram::quantile(buckets.data(), count, 0.99),
+               1e-3 * LatencyHistogram::quantile(buckets.data(), count, 0.999));
+    }
+    std::vector<uint64_t> buckets;
+    uint64_t count, sum_ns;
+};
+
+struct Subscriber {
+    Subscriber()
+        : num_received(0), num_bytes(0), num_gaps(0), num_corrupted(0),
+          num_schemas(0), last_seq(num_topics, 0), size(num_topics, -1),
+          b_stop(false) {}
+    std::atomic<uint64_t> num_received;
+    uint64_t num_bytes, num_gaps, num_corrupted, num_schemas;
+    std::vector<uint64_t> last_seq;
+    std::vector<int> size; // of the schemas
+    std::chrono::steady_clock::time_point t_first, t_last;
+    std::atomic<bool> b_stop;
+};
+
+// values of sample seq of a topic
+static double value(int topic, uint64_t seq, int i) {
+    return 1000. * topic + seq + 1e-3 * i;
+}
+
+// total of "name:size,..."
+static int schemaSize(const std::string& schema) {
+    int size = 0;
+    for (size_t pos(0); (pos = schema.find(':', pos)) != std::string::npos;)
+        size += atoi(schema.c_str() + ++pos);
+    return size;
+}
+
+static bool receiveFrame(void* socket, zmq_msg_t& msg) {
+    zmq_msg_close(&msg);
+    zmq_msg_init(&msg);
+    return zmq_msg_recv(&msg, socket, 0) >= 0;
+}
+
+static void subscribe(void* context, const std::string& endpoint,
+                      Subscriber* sub) {
+    void* socket = zmq_socket(context, ZMQ_SUB);
+    int hwm = 0, timeout_ms = 100;
+    zmq_setsockopt(socket, ZMQ_RCVHWM, &hwm, sizeof(hwm));
+    zmq_setsockopt(socket, ZMQ_RCVTIMEO, &timeout_ms, sizeof(timeout_ms));
+    zmq_setsockopt(socket, ZMQ_SUBSCRIBE, "", 0);
+    zmq_connect(socket, endpoint.c_str());
+
+    zmq_msg_t topic, header, payload;
+    zmq_msg_init(&topic);
+    zmq_msg_init(&header);
+    zmq_msg_init(&payload);
+    while (true) {
+        if (!receiveFrame(socket, topic)) {
+            if (sub->b_stop) break;
+            continue;
+        }
+        if (!zmq_msg_more(&topic) || !receiveFrame(socket, header) ||
+            !zmq_msg_more(&header) || !receiveFrame(socket, payload) ||
+            zmq_msg_size(&header) != sizeof(TelemetryFrameHeader)) {
+            ++sub->num_corrupted;
+            continue;
+        }
+        TelemetryFrameHeader h;
+        memcpy(&h, zmq_msg_data(&header), sizeof(h));
+        if (memcmp(h.magic, "MYTM", 4) != 0 || h.topic_id >= num_topics) {
+            ++sub->num_corrupted;
+            continue;
+        }
+        if (h.type == (uint16_t)TelemetryFrameType::Schema) {
+            std::string schema((const char*)zmq_msg_data(&payload),
+                               zmq_msg_size(&payload));
+            sub->size[h.topic_id] = schemaSize(schema);
+            ++sub->num_schemas;
+            continue;
+        }
+
+        const double* data = (const double*)zmq_msg_data(&payload);
+        bool b_intact = (int)h.size == sub->size[h.topic_id] &&
+                        zmq_msg_size(&payload) == h.size * sizeof(double);
+        for (uint32_t i(0); b_intact && i < h.size; ++i)
+            b_intact = data[i] == value(h.topic_id, h.seq, i);
+        if (!b_intact) ++sub->num_corrupted;
+        uint64_t& last_seq = sub->last_seq[h.topic_id];
+        if (h.seq > last_seq + 1) sub->num_gaps += h.seq - last_seq - 1;
+        last_seq = h.seq;
+
+        sub->t_last = std::chrono::steady_clock::now();
+        if (sub->num_received++ == 0) sub->t_first = sub->t_last;
+        sub->num_bytes += zmq_msg_size(&topic) + zmq_msg_size(&header) +
+                          zmq_msg_size(&payload);
+    }
+    zmq_msg_close(&topic);
+    zmq_msg_close(&header);
+    zmq_msg_close(&payload);
+    zmq_close(socket);
+}
+
+int main(int argc, char** argv) {
+    std::string endpoint = "inproc://telemetry_bench";
+    int num = 200000;
+    double rate = 0.;
+    int decimation = 1;
+    for (int i(1); i < argc; ++i) {
+        if (strcmp(argv[i], "-e") == 0 && i + 1 < argc) {
+            endpoint = argv[++i];
+        } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            num = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            rate = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
+            decimation = atoi(argv[++i]);
+        } else {
+            printf("usage: telemetry_bench [-e inproc://..|ipc://..] "
+                   "[-n samples] [-r rate_hz] [-d decimation]\n");
+            return 1;
+        }
+    }
+
+    // no limit in ZMQ, a drop is the one of the ring or the pool
+    TelemetryPublisher pub;
+    if (!pub.start(endpoint, 0)) return 1;
+    bool b_inproc = endpoint.compare(0, 9, "inproc://") == 0;
+    void* context = b_inproc ? pub.getContext() : zmq_ctx_new();
+    Subscriber sub;
+    std::thread subscriber(subscribe, context, endpoint, &sub);
+    // the topics come once the subscriber is connected, with their schemas
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    int topics[num_topics] = {
+        pub.addTopic("robot_state", {{"q", 18}, {"qdot", 18}}, decimation),
+        pub.addTopic("contact_forces", {{"wrench", 24}, {"contact", 4}},
+                     decimation),
+        pub.addTopic("wbc_command", {{"jpos", 12}, {"jvel", 12}, {"jtrq", 12}},
+                     decimation)};
+    int sizes[num_topics] = {36, 28, 36};
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    // the values of the sequence number the sample will have
+    std::vector<double> data(TelemetryPublisher::max_values);
+    std::vector<uint64_t> seq(num_topics, 0);
+    Latency latency;
+    uint64_t num_rejected = 0;
+    auto t_start = std::chrono::steady_clock::now();
+    for (int n(0); n < num; ++n) {
+        if (rate > 0.)
+            std::this_thread::sleep_until(
+                t_start + std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              std::chrono::duration<double>(n / rate)));
+        int t = n % num_topics;
+        if (n / num_topics % decimation == 0) ++seq[t];
+        for (int i(0); i < sizes[t]; ++i) data[i] = value(t, seq[t], i);
+        auto t_push = std::chrono::steady_clock::now();
+        bool b_pushed = pub.publish(topics[t], data.data(), sizes[t], 1e-3 * n);
+        latency.add(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - t_push).count());
+        if (!b_pushed) ++num_rejected;
+    }
+    double t_publish = std::chrono::duration<double>(
+                           std::chrono::steady_clock::now() - t_start).count();
+    // the subscriber gets the rest of the ring, its socket is closed before
+    // the context of the publisher is
+    for (uint64_t num_received(0);;) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        if (sub.num_received == num_received) break;
+        num_received = sub.num_received;
+    }
+    sub.b_stop = true;
+    subscriber.join();
+    pub.stop();
+    if (!b_inproc) zmq_ctx_term(context);
+
+    printf("%s, %d samples, rate %s, decimation %d\n", endpoint.c_str(), num,
+           rate > 0. ? std::to_string((int)rate).c_str() : "max", decimation);
+    printf("%-22s %9s %9s %9s %9s %9s\n", "", "count", "mean[us]", "p50", "p99",
+           "p99.9");
+    latency.print("publish");
+    double t_receive =
+        std::chrono::duration<double>(sub.t_last - sub.t_first).count();
+    printf("\npublished %.0f /s, received %.0f /s, %.1f MB/s\n",
+           num / t_publish, t_receive > 0. ? sub.num_received / t_receive : 0.,
+           t_receive > 0. ? 1e-6 * sub.num_bytes / t_receive : 0.);
+    printf("sent %llu decimated %llu dropped %llu (rejected %llu)\n",
+           (unsigned long long)pub.getSentCount(),
+           (unsigned long long)pub.getDecimatedCount(),
+           (unsigned long long)pub.getDroppedCount(),
+           (unsigned long long)num_rejected);
+    printf("received %llu schemas %llu gaps %llu corrupted %llu\n",
+           (unsigned long long)sub.num_received,
+           (unsigned long long)sub.num_schemas,
+           (unsigned long long)sub.num_gaps,
+           (unsigned long long)sub.num_corrupted);
+
+    // the drops are gaps, but for those after the last frame of a topic
+    bool b_ok = sub.num_received == pub.getSentCount() &&
+                sub.num_corrupted == 0 &&
+                sub.num_gaps <= pub.getDroppedCount() && sub.num_schemas > 0;
+    printf("%s\n", b_ok ? "OK" : "FAILED");
+    return b_ok ? 0 : 1;
+}
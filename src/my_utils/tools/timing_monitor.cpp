@@ -0,0 +1,108 @@
+#include <unistd.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "my_utils/IO/StageTiming.hpp"
+
+using my_utils::LatencyHistogram;
+using my_utils::StageTimingReader;
+using my_utils::TimingStageData;
+
+// timing_monitor [-c] [-p period_s] [-n num_prints] [-s shm_name]
+// prints the stage timings of the running controller every period, the
+// samples of the last period or, with -c, all the samples of the run.
+// shm_name is /my_utils_timing by default, /my_utils_timing_<program> for
+// a second process, e.g. /my_utils_timing_anymal_controller.
+// It only maps the segment read-only, the controller is not affected.
+static void readStages(const StageTimingReader& reader,
+                       std::vector<TimingStageData>& stages) {
+    stages.resize(reader.getNumStages());
+    for (size_t s(0); s < stages.size(); ++s) reader.getStage(s, stages[s]);
+}
+
+static void printStages(const std::vector<TimingStageData>& curr,
+                        const std::vector<TimingStageData>& prev,
+                        bool b_cumulative) {
+    printf("%-24s %9s %9s %9s %9s %9s %9s %9s %12s\n", "stage [us]", "count",
+           "mean", "p50", "p99", "p99.9", "max", "budget", "overrun");
+    std::vector<uint64_t> buckets(LatencyHistogram::num_buckets);
+    for (size_t s(0); s < curr.size(); ++s) {
+        const TimingStageData& c = curr[s];
+        bool b_diff = !b_cumulative && s < prev.size();
+        uint64_t count = 0, sum_ns = c.sum_ns, num_overrun = c.num_overrun;
+        for (int i(0); i < LatencyHistogram::num_buckets; ++i) {
+            buckets[i] = c.buckets[i] - (b_diff ? prev[s].buckets[i] : 0);
+            count += buckets[i];
+        }
+        if (b_diff) {
+            sum_ns -= prev[s].sum_ns;
+            num_overrun -= prev[s].num_overrun;
+        }
+        // the exact maximum of the run, the bucket of the maximum of a period
+        uint64_t max_ns = b_diff ? LatencyHistogram::quantile(buckets.data(), count, 1.)
+                                 : c.max_ns;
+        printf("%-24s %9llu %9.1f %9.1f %9.1f %9.1f %9.1f ", c.name,
+               (unsigned long long)count, count ? 1e-3 * sum_ns / count : 0.,
+               1e-3 * LatencyHistogram::quantile(buckets.data(), count, 0.5),
+               1e-3 * LatencyHistogram::quantile(buckets.data(), count, 0.99),
+               1e-3 * LatencyHistogram::quantile(buckets.data(), count, 0.999),
+               1e-3 * max_ns);
+        if (c.budget_ns > 0)
+            printf("%9.1f %12llu\n", 1e-3 * c.budget_ns,
+                   (unsigned long long)num_overrun);
+        else
+            printf("%9s %12s\n", "-", "-");
+    }
+    printf("\n");
+    fflush(stdout);
+}
+
+int main(int argc, char** argv) {
+    bool b_cumulative = false;
+    double period = 1.;
+    int num_prints = -1;
+    std::string shm_name = my_utils::StageTiming::timing_shm_name;
+    for (int i(1); i < argc; ++i) {
+        if (strcmp(argv[i], "-c") == 0) {
+            b_cumulative = true;
+        } else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
+            period = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            num_prints = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            shm_name = argv[++i];
+        } else {
+            printf("usage: timing_monitor [-c] [-p period_s] [-n num_prints] "
+                   "[-s shm_name]\n");
+            return 1;
+        }
+    }
+
+    StageTimingReader reader;
+    if (!reader.open(shm_name)) {
+        printf("no timing segment %s, is the controller running?\n",
+               shm_name.c_str());
+        return 1;
+    }
+    int pid = reader.getWriterPid();
+    std::vector<TimingStageData> curr, prev;
+    if (!b_cumulative) readStages(reader, prev);
+    for (int n(0); num_prints < 0 || n < num_prints; ++n) {
+        if (n > 0 || !b_cumulative) usleep((useconds_t)(period * 1e6));
+        // a new run creates a new segment
+        StageTimingReader next;
+        if (next.open(shm_name) && next.getWriterPid() != pid) {
+            reader.open(shm_name);
+            pid = reader.getWriterPid();
+            prev.clear();
+        }
+        readStages(reader, curr);
+        printf("pid %d\n", pid);
+        printStages(curr, prev, b_cumulative);
+        prev.swap(curr);
+    }
+    return 0;
+}
@@ -0,0 +1,243 @@
+#include <arpa/inet.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "my_utils/IO/StageTiming.hpp"
+#include "my_utils/IO/comm_udp.hpp"
+
+using my_utils::LatencyHistogram;
+
+// udp_bench [-s payload_bytes] [-n messages] [-p base_port]
+// localhost round trips and one way throughput of COMM::send_data /
+// receive_data and of COMM::UdpEndpoint, single and batched, between
+// this process and a forked one. Before them, checks the drop, reorder,
+// duplicate and restart counts of UdpEndpoint on a scripted sequence,
+// exits with 1 if they are off.
+static const char* localhost = "127.0.0.1";
+static const int batch_size = 32;
+
+static double elapsed(const std::chrono::steady_clock::time_point& t_start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t_start)
+        .count();
+}
+
+struct Latency {
+    Latency() : buckets(LatencyHistogram::num_buckets, 0), count(0), sum_ns(0) {}
+    void add(uint64_t ns) {
+        ++buckets[LatencyHistogram::bucketIndex(ns)];
+        ++count;
+        sum_ns += ns;
+    }
+    void print(const char* name) const {
+        printf("%-22s %9llu %9.2f %9.2f %9.2f %9.2f\n", name,
+               (unsigned long long)count, count ? 1e-3 * sum_ns / count : 0.,
+               1e-3 * LatencyHistogram::quantile(buckets.data(), count, 0.5),
+               1e-3 * LatencyHistogram::quantile(buckets.data(), count, 0.99),
+               1e-3 * LatencyHistogram::quantile(buckets.data(), count, 0.999));
+    }
+    std::vector<uint64_t> buckets;
+    uint64_t count, sum_ns;
+};
+
+// ---- round trips ------------------------------------------------------------
+// socket bound as by the first receive_data, whose next binds fail, so that
+// no datagram comes before the bind
+static int legacyBind(int port) {
+    int rx = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    struct sockaddr_in si_me;
+    memset((char*)&si_me, 0, sizeof(si_me));
+    si_me.sin_family = AF_INET;
+    si_me.sin_port = htons(port);
+    si_me.sin_addr.s_addr = htonl(INADDR_ANY);
+    bind(rx, (const sockaddr*)&si_me, sizeof(si_me));
+    return rx;
+}
+
+static void legacyRoundTrips(int port, int size, int num) {
+    std::vector<char> buf(size, 0);
+    pid_t child = fork();
+    if (child == 0) {
+        int rx(legacyBind(port + 1)), tx(0);
+        for (int i(0); i < num; ++i) {
+            COMM::receive_data(rx, port + 1, buf.data(), size, localhost);
+            COMM::send_data(tx, port, buf.data(), size, localhost);
+        }
+        _exit(0);
+    }
+    int rx(legacyBind(port)), tx(0);
+    usleep(100000);
+    Latency latency;
+    for (int i(0); i < num; ++i) {
+        auto t_start = std::chrono::steady_clock::now();
+        COMM::send_data(tx, port + 1, buf.data(), size, localhost);
+        COMM::receive_data(rx, port, buf.data(), size, localhost);
+        latency.add((uint64_t)(1e9 * elapsed(t_start)));
+    }
+    waitpid(child, NULL, 0);
+    latency.print("send_data/receive_data");
+}
+
+static void endpointRoundTrips(int port, int size, int num) {
+    std::vector<char> buf(size, 0);
+    pid_t child = fork();
+    if (child == 0) {
+        COMM::UdpEndpoint ep;
+        if (!ep.open(port + 1, localhost, port)) _exit(1);
+        ep.setReceiveTimeout(1.);
+        for (int i(0); i < num; ++i) {
+            if (ep.receive(buf.data(), size) < 0) _exit(1);
+            ep.send(buf.data(), size);
+        }
+        _exit(0);
+    }
+    COMM::UdpEndpoint ep;
+    if (!ep.open(port, localhost, port + 1)) return;
+    ep.setReceiveTimeout(1.);
+    usleep(100000);
+    Latency latency;
+    for (int i(0); i < num; ++i) {
+        auto t_start = std::chrono::steady_clock::now();
+        ep.send(buf.data(), size);
+        if (ep.receive(buf.data(), size) < 0) {
+            printf("no reply to round trip %d\n", i);
+            break;
+        }
+        latency.add((uint64_t)(1e9 * elapsed(t_start)));
+    }
+    waitpid(child, NULL, 0);
+    latency.print("UdpEndpoint");
+}
+
+// ---- sequence accounting ----------------------------------------------------
+// 1 2 3 5 4 4 6, restart 1 2 3, jump to 100, restart from 7 : 4 late,
+// 4 twice, 96 dropped, two restarts
+static bool checkSequences(int port) {
+    static const uint64_t seqs[] = {1, 2, 3, 5, 4, 4, 6, 1, 2, 3, 100, 7, 8};
+    static const int num = sizeof(seqs) / sizeof(seqs[0]);
+    COMM::UdpEndpoint ep;
+    if (!ep.open(port, NULL, 0)) return false;
+    ep.setReceiveTimeout(0.2);
+    int tx(0);
+    uint64_t seq;
+    for (int i(0); i < num; ++i) {
+        seq = seqs[i];
+        COMM::send_data(tx, port, &seq, sizeof(seq), localhost);
+        if (ep.receive(&seq, sizeof(seq)) < 0) return false;
+    }
+    const COMM::UdpStats& stats = ep.getStats();
+    printf("sequence check : %llu received, %llu dropped, %llu reordered, "
+           "%llu duplicates, %llu resyncs\n",
+           (unsigned long long)stats.num_received, (unsigned long long)stats.num_dropped,
+           (unsigned long long)stats.num_reordered,
+           (unsigned long long)stats.num_duplicates, (unsigned long long)stats.num_resyncs);
+    return stats.num_received == (uint64_t)num && stats.num_dropped == 96 &&
+           stats.num_reordered == 1 && stats.num_duplicates == 1 && stats.num_resyncs == 2;
+}
+
+// ---- one way throughput -----------------------------------------------------
+enum SendMode { Legacy, Single, Batch };
+
+static void sender(SendMode mode, int port, int size, int num) {
+    std::vector<char> buf(sizeof(COMM::UdpHeader) + size, 0);
+    COMM::UdpEndpoint ep;
+    ep.open(0, localhost, port);
+    std::vector<const void*> data(batch_size, buf.data());
+    std::vector<int> data_size(batch_size, size);
+    int tx(0);
+    auto t_start = std::chrono::steady_clock::now();
+    for (int i(0); i < num;) {
+        if (mode == Legacy) {
+            // the sequence number in front as the header of UdpEndpoint
+            uint64_t seq = i + 1;
+            memcpy(buf.data(), &seq, sizeof(seq));
+            COMM::send_data(tx, port, buf.data(), (int)buf.size(), localhost);
+            ++i;
+        } else if (mode == Single) {
+            i += ep.send(buf.data(), size) ? 1 : 0;
+        } else {
+            i += ep.sendBatch(data.data(), data_size.data(),
+                              std::min(batch_size, num - i));
+        }
+    }
+    double t = elapsed(t_start);
+    printf("%9.0f ", num / t);
+    fflush(stdout);
+}
+
+static void throughput(const char* name, SendMode mode, int port, int size,
+                       int num, bool b_batch_receive) {
+    COMM::UdpEndpoint ep;
+    if (!ep.open(port, NULL, 0, 8 << 20)) return;
+    ep.setReceiveTimeout(0.2);
+    printf("%-22s ", name);
+    fflush(stdout);
+    pid_t child = fork();
+    if (child == 0) {
+        sender(mode, port, size, num);
+        _exit(0);
+    }
+    std::vector<char> buf((size_t)batch_size * size);
+    std::vector<int> data_size(batch_size);
+    auto t_start = std::chrono::steady_clock::now();
+    auto t_last = t_start;
+    while (true) {
+        int n = b_batch_receive
+                    ? ep.receiveBatch(buf.data(), size, data_size.data(), batch_size)
+                    : (ep.receive(buf.data(), size) < 0 ? 0 : 1);
+        if (n <= 0) break;
+        t_last = std::chrono::steady_clock::now();
+    }
+    waitpid(child, NULL, 0);
+    const COMM::UdpStats& stats = ep.getStats();
+    double t = std::chrono::duration<double>(t_last - t_start).count();
+    printf("%9.0f %9llu %9llu %9llu %9llu\n", t > 0. ? stats.num_received / t : 0.,
+           (unsigned long long)stats.num_received,
+           (unsigned long long)stats.num_dropped,
+           (unsigned long long)stats.num_reordered,
+           (unsigned long long)stats.num_duplicates);
+}
+
+int main(int argc, char** argv) {
+    int size = 256;
+    int num = 100000;
+    int port = 47000;
+    for (int i(1); i < argc; ++i) {
+        if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            size = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            num = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
+            port = atoi(argv[++i]);
+        } else {
+            printf("usage: udp_bench [-s payload_bytes] [-n messages] "
+                   "[-p base_port]\n");
+            return 1;
+        }
+    }
+
+    if (!checkSequences(port + 8)) {
+        printf("FAILED\n");
+        return 1;
+    }
+
+    printf("\nround trips, %d bytes\n", size);
+    printf("%-22s %9s %9s %9s %9s %9s\n", "", "count", "mean[us]", "p50",
+           "p99", "p99.9");
+    legacyRoundTrips(port, size, num / 10);
+    endpointRoundTrips(port + 2, size, num / 10);
+
+    printf("\none way, %d bytes, %d messages\n", size, num);
+    printf("%-22s %9s %9s %9s %9s %9s %9s\n", "sender / receiver", "sent/s",
+           "recv/s", "received", "dropped", "reordered", "duplicate");
+    throughput("send_data / batch", Legacy, port + 4, size, num, true);
+    throughput("send / receive", Single, port + 5, size, num, false);
+    throughput("send / batch", Single, port + 6, size, num, true);
+    throughput("sendBatch / batch", Batch, port + 7, size, num, true);
+    return 0;
+}
@@ -46,6 +46,10 @@ template<typename T>
 void print_vector(char* name, const GVect<T>& v, int n = -1);
 
 // The Solving function, implementing the Goldfarb-Idnani method
+double solve_quadprog_(GMatr<double>& G, GVect<double>& g0,
+                       const GMatr<double>& CE, const GVect<double>& ce0,
+                       const GMatr<double>& CI, const GVect<double>& ci0,
+                       GVect<double>& x, std::vector<int>* active_set);
 
 double solve_quadprog(Eigen::MatrixXd& _G, Eigen::VectorXd& _g0,
                       const Eigen::MatrixXd& _CE, const Eigen::VectorXd& _ce0,
@@ -108,6 +112,22 @@ double solve_quadprog(GMatr<double>& G, GVect<double>& g0,
                       const GMatr<double>& CE, const GVect<double>& ce0,
                       const GMatr<double>& CI, const GVect<double>& ci0,
                       GVect<double>& x)
+{
+  return solve_quadprog_(G, g0, CE, ce0, CI, ci0, x, NULL);
+}
+
+double solve_quadprog(GMatr<double>& G, GVect<double>& g0,
+                      const GMatr<double>& CE, const GVect<double>& ce0,
+                      const GMatr<double>& CI, const GVect<double>& ci0,
+                      GVect<double>& x, std::vector<int>& active_set)
+{
+  return solve_quadprog_(G, g0, CE, ce0, CI, ci0, x, &active_set);
+}
+
+double solve_quadprog_(GMatr<double>& G, GVect<double>& g0,
+                       const GMatr<double>& CE, const GVect<double>& ce0,
+                       const GMatr<double>& CI, const GVect<double>& ci0,
+                       GVect<double>& x, std::vector<int>* active_set)
 {
   std::ostringstream msg;
   int n = G.ncols(), p = CE.ncols(), m = CI.ncols();
@@ -303,6 +323,12 @@ l1:	iter++;
   {
     /* numerically there are not infeasibilities anymore */
     q = iq;
+    if (active_set)
+    {
+      active_set->clear();
+      for (i = p; i < iq; i++)
+        active_set->push_back(A[i]);
+    }
 
     return f_value;
   }
@@ -329,6 +355,12 @@ l2: /* Step 2: check for feasibility and determine a new S-pair */
   if (ss >= 0.0)
   {
     q = iq;
+    if (active_set)
+    {
+      active_set->clear();
+      for (i = p; i < iq; i++)
+        active_set->push_back(A[i]);
+    }
 
     return f_value;
   }
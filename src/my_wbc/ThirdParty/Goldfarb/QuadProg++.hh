@@ -67,6 +67,7 @@ s.t.
 #endif  // #if __cplusplus > 199711L
 
 #include "Array.hh"
+#include <vector>
 #include <Eigen/Dense>
 
 using namespace GolDIdnani;
@@ -76,6 +77,13 @@ double solve_quadprog(GMatr<double>& G, GVect<double>& g0,
                       const GMatr<double>& CI, const GVect<double>& ci0,
                       GVect<double>& x);
 
+// also returns the active inequalities of the solution, linearly
+// independent and with nonnegative multipliers
+double solve_quadprog(GMatr<double>& G, GVect<double>& g0,
+                      const GMatr<double>& CE, const GVect<double>& ce0,
+                      const GMatr<double>& CI, const GVect<double>& ci0,
+                      GVect<double>& x, std::vector<int>& active_set);
+
 double solve_quadprog(Eigen::MatrixXd& G, Eigen::VectorXd& g0,
                       const Eigen::MatrixXd& CE, const Eigen::VectorXd& ce0,
                       const Eigen::MatrixXd& CI, const Eigen::VectorXd& ci0,
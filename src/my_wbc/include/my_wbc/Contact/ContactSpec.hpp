@@ -39,14 +39,25 @@ class ContactSpec {
     double getFrictionCoeff() { return mu_*sqrt(2.0); } 
     void setFrictionCoeff(double _mu) { mu_ = _mu/sqrt(2.0); }
     void setMaxFz(double max_fz) { max_Fz_ = max_fz; }    
+    double getMaxFz() { return max_Fz_; }
 
     bool updateContactSpec() {
+        updateContactKinematics();
+        updateContactConstraint();
+        return true;
+    }
+    // Jc, JcDotQdot, JcQdot : only change with the robot state
+    bool updateContactKinematics() {
         _UpdateJc();
         _UpdateJcDotQdot();
         _UpdateJcQdot();
+        b_set_contact_ = true;
+        return true;
+    }
+    // Uf, ieq_vec : only change with mu and max_Fz
+    bool updateContactConstraint() {
         _UpdateUf();
         _UpdateInequalityVector();
-        b_set_contact_ = true;
         return true;
     }
 
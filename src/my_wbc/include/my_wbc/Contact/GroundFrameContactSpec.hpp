@@ -21,4 +21,8 @@ class GroundFramePointContactSpec : public ContactSpec {
     virtual bool _UpdateInequalityVector();
     void _setU(double mu, Eigen::MatrixXd& U);
     void _setIeqVec(double max_Fz, Eigen::VectorXd& ieq_vec);
+
+    // Uf_ and ieq_vec_ are only rebuilt when these change
+    double mu_Uf_;
+    double max_Fz_ieq_;
 };
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 // Quadratic Programming Solver Utilities
 
+#include <vector>
 #include <my_utils/IO/IOUtilities.hpp>
 #include "Goldfarb/QuadProg++.hh"
 
@@ -10,24 +11,49 @@ class QuadProgSolver{
     QuadProgSolver();
     ~QuadProgSolver() {};
 
-    void setProblem(const Eigen::MatrixXd& _H,
-                    const Eigen::VectorXd& _f,
-                    const Eigen::MatrixXd& _Aieq,
-                    const Eigen::VectorXd& _bieq,
-                    const Eigen::MatrixXd& _Aeq,
-                    const Eigen::VectorXd& _beq);
-    void setProblem(const Eigen::MatrixXd& _H,
-                    const Eigen::VectorXd& _f,
-                    const Eigen::MatrixXd& _Aieq,
-                    const Eigen::VectorXd& _bieq);
-    void solveProblem(Eigen::VectorXd& _x);
+    void setProblem(const Eigen::Ref<const Eigen::MatrixXd>& _H,
+                    const Eigen::Ref<const Eigen::VectorXd>& _f,
+                    const Eigen::Ref<const Eigen::MatrixXd>& _Aieq,
+                    const Eigen::Ref<const Eigen::VectorXd>& _bieq,
+                    const Eigen::Ref<const Eigen::MatrixXd>& _Aeq,
+                    const Eigen::Ref<const Eigen::VectorXd>& _beq);
+    void setProblem(const Eigen::Ref<const Eigen::MatrixXd>& _H,
+                    const Eigen::Ref<const Eigen::VectorXd>& _f,
+                    const Eigen::Ref<const Eigen::MatrixXd>& _Aieq,
+                    const Eigen::Ref<const Eigen::VectorXd>& _bieq);
+    // returns the optimal cost, infinity when infeasible
+    double solveProblem(Eigen::VectorXd& _x);
+    void setVerbose(bool _b_verbose) { b_verbose = _b_verbose; }
 
+    // warm start from the active set of the previous solution
+    // when the problem dimension is unchanged
+    void setWarmStart(bool _b_warm_start);
+    bool isWarmStarted() { return b_warm_solved; }
+
+
+protected:
+    bool _solveActiveSet(Eigen::VectorXd& _x, double& _f);
+    void _resizeWorkspace();
 
 protected:
     bool b_initialized;
+    bool b_verbose;
+    bool b_warm_start;
+    bool b_warm_solved;
+    std::vector<int> active_set;
+    int m_active; // m, p of the active set
+    int p_active;
     int n; // dim_opt_
     int m; // dim_ieq_cstr_
     int p; // dim_eq_cstr_
+    // warm start workspace, sized at setProblem, n x n at most as the
+    // active set is linearly independent
+    Eigen::MatrixXd chol_G; // L of G = L L'
+    Eigen::MatrixXd active_A; // columns of the equality and active rows
+    Eigen::MatrixXd schur; // A' G^-1 A
+    Eigen::VectorXd x0; // -G^-1 g0
+    Eigen::VectorXd schur_u;
+    Eigen::VectorXd warm_x;
     // --------------------------
     //  Optimization parameters
     // --------------------------
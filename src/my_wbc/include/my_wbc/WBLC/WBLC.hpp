@@ -16,6 +16,9 @@ class WBLC_ExtraData{
         Eigen::VectorXd W_qddot_;
         Eigen::VectorXd W_rf_;
         Eigen::VectorXd W_xddot_;
+        // desired reaction force, W_rf_ weights the error from it
+        // (empty: regularized to zero)
+        Eigen::VectorXd F_des_;
 
 
         WBLC_ExtraData(){}
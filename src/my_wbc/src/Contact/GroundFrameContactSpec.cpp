@@ -6,6 +6,8 @@ GroundFramePointContactSpec::GroundFramePointContactSpec(RobotSystem* robot,
     : ContactSpec(robot, 3, _link_idx, _mu) {
     my_utils::pretty_constructor(3, "Ground Frame Point Contact Spec");
 
+    mu_Uf_ = -1.;
+    max_Fz_ieq_ = -1.;
     updateContactSpec();
 }
 
@@ -39,12 +41,17 @@ bool GroundFramePointContactSpec::_UpdateJcQdot() {
 }
 
 bool GroundFramePointContactSpec::_UpdateUf() {
+    // the cone is expressed in the ground frame, it only depends on mu
+    if(mu_ == mu_Uf_) return true;
     _setU(mu_, Uf_);
+    mu_Uf_ = mu_;
     return true;
 }
 
 bool GroundFramePointContactSpec::_UpdateInequalityVector() {
+    if(max_Fz_ == max_Fz_ieq_) return true;
     _setIeqVec(max_Fz_, ieq_vec_);
+    max_Fz_ieq_ = max_Fz_;
     return true;
 }
 
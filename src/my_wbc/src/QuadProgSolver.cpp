@@ -1,10 +1,28 @@
 // #include <Eigen/LU>
 // #include <Eigen/SVD>
 
+#include <algorithm>
 #include <my_wbc/QuadProgSolver.hpp>
+#include <my_utils/IO/Trace.hpp>
 
 QuadProgSolver::QuadProgSolver() { 
     b_initialized = false;
+    b_verbose = true;
+    b_warm_start = false;
+    b_warm_solved = false;
+    m_active = -1;
+    p_active = -1;
+    n = 0;
+    m = 0;
+    p = 0;
+}
+
+void QuadProgSolver::setWarmStart(bool _b_warm_start) {
+    b_warm_start = _b_warm_start;
+    active_set.clear();
+    m_active = -1;
+    p_active = -1;
+    if(b_initialized) _resizeWorkspace();
 }
 
 // same setting to Matlab "x = quadprog(H,f,A,b,Aeq,beq)"
@@ -13,12 +31,12 @@ QuadProgSolver::QuadProgSolver() {
 // s.t.
 //      Ax <= b
 //      Aeq*x = beq
-void QuadProgSolver::setProblem(const Eigen::MatrixXd& _H,
-                                const Eigen::VectorXd& _f,
-                                const Eigen::MatrixXd& _Aieq,
-                                const Eigen::VectorXd& _bieq,
-                                const Eigen::MatrixXd& _Aeq,
-                                const Eigen::VectorXd& _beq){
+void QuadProgSolver::setProblem(const Eigen::Ref<const Eigen::MatrixXd>& _H,
+                                const Eigen::Ref<const Eigen::VectorXd>& _f,
+                                const Eigen::Ref<const Eigen::MatrixXd>& _Aieq,
+                                const Eigen::Ref<const Eigen::VectorXd>& _bieq,
+                                const Eigen::Ref<const Eigen::MatrixXd>& _Aeq,
+                                const Eigen::Ref<const Eigen::VectorXd>& _beq){
     n = _f.size();
     m = _bieq.size();
     p = _beq.size();
@@ -55,14 +73,15 @@ void QuadProgSolver::setProblem(const Eigen::MatrixXd& _H,
         }
         ci0[i] = _bieq[i];
     }
+    _resizeWorkspace();
 
     b_initialized = true;
 }
 
-void QuadProgSolver::setProblem(const Eigen::MatrixXd& _H,
-                    const Eigen::VectorXd& _f,
-                    const Eigen::MatrixXd& _Aieq,
-                    const Eigen::VectorXd& _bieq){
+void QuadProgSolver::setProblem(const Eigen::Ref<const Eigen::MatrixXd>& _H,
+                    const Eigen::Ref<const Eigen::VectorXd>& _f,
+                    const Eigen::Ref<const Eigen::MatrixXd>& _Aieq,
+                    const Eigen::Ref<const Eigen::VectorXd>& _bieq){
     n = _f.size();
     m = _bieq.size();
     p = 0;
@@ -95,25 +114,129 @@ void QuadProgSolver::setProblem(const Eigen::MatrixXd& _H,
         }
         ci0[i] = _bieq[i];
     }
+    _resizeWorkspace();
     b_initialized = true;
 }
 
-void QuadProgSolver::solveProblem(Eigen::VectorXd& _x){
+// no allocation while the problem dimensions are unchanged
+void QuadProgSolver::_resizeWorkspace(){
+    if(!b_warm_start) return;
+    if(chol_G.rows() != n) {
+        chol_G.resize(n, n);
+        active_A.resize(n, n);
+        schur.resize(n, n);
+        x0.resize(n);
+        schur_u.resize(n);
+        warm_x.resize(n);
+    }
+    active_set.reserve(m);
+}
+
+double QuadProgSolver::solveProblem(Eigen::VectorXd& _x){
     if(!b_initialized){
-        std::cout << " setProblem required " << std::endl;
-        return;
+        MY_TRACE_WARN(" setProblem required ");
+        return std::numeric_limits<double>::infinity();
+    }
+    double f;
+    b_warm_solved = false;
+    if(b_warm_start && _solveActiveSet(_x, f)) {
+        b_warm_solved = true;
+        return f;
     }
-    double f = solve_quadprog(G, g0, CE, ce0, CI, ci0, x);
+    if(b_warm_start) f = solve_quadprog(G, g0, CE, ce0, CI, ci0, x, active_set);
+    else f = solve_quadprog(G, g0, CE, ce0, CI, ci0, x);
     // std::cout<<" solve_quadprog done"<< std::endl;
     _x = Eigen::VectorXd::Zero(n);
-    if(f == std::numeric_limits<double>::infinity())  {
-        std::cout << "Infeasible Solution f: " << f << std::endl;
-        std::cout << "x: " << x << std::endl;
+    if(b_verbose && f == std::numeric_limits<double>::infinity())  {
+        MY_TRACE_WARN("Infeasible Solution f: {}\nx: {}", f,
+                      Eigen::Map<const Eigen::VectorXd>(&x[0], x.size()));
         // exit(0.0);        
     }
     // else{
     //     for(int i(0); i<n; ++i) _x[i] = x[i];
     // }
     for(int i(0); i<n; ++i) _x[i] = x[i];
-    
-}
\ No newline at end of file
+    if(b_warm_start) {
+        // the active set of Goldfarb-Idnani, invalid if infeasible
+        m_active = std::isfinite(f) ? m : -1;
+        p_active = p;
+    }
+    return f;
+}
+
+// solve the KKT system with the previous active set,
+// accept only if primal and dual feasible
+//  [ G  A ] [x]   [ -g0 ]
+//  [ A' 0 ] [u] = [ -c  ],  A : equalities and active inequalities
+// through the Schur complement on the Cholesky factor of G,
+//  x0 = -G^-1 g0,  (A' G^-1 A) u = A' x0 + c,  x = x0 - G^-1 A u
+bool QuadProgSolver::_solveActiveSet(Eigen::VectorXd& _x, double& _f){
+    if(m != m_active || p != p_active) return false;
+
+    int k = p + active_set.size();
+    for (int i(0); i < n; ++i) {
+        for (int j(0); j <= i; ++j) chol_G(i, j) = G[i][j];
+        x0[i] = -g0[i];
+    }
+    Eigen::Ref<Eigen::MatrixXd> L(chol_G);
+    Eigen::LLT<Eigen::Ref<Eigen::MatrixXd> > llt_G(L);
+    if(llt_G.info() != Eigen::Success) return false;
+    llt_G.solveInPlace(x0);
+
+    Eigen::Ref<Eigen::MatrixXd> A(active_A.leftCols(k));
+    Eigen::Ref<Eigen::VectorXd> u(schur_u.head(k));
+    for (int l(0); l < p; ++l) {
+        for (int j(0); j < n; ++j) A(j, l) = CE[j][l];
+        u[l] = ce0[l];
+    }
+    for (int l(0); l < (int)active_set.size(); ++l) {
+        for (int j(0); j < n; ++j) A(j, p+l) = CI[j][active_set[l]];
+        u[p+l] = ci0[active_set[l]];
+    }
+    if(k > 0) {
+        u.noalias() += A.transpose() * x0;
+        // W = L^-1 A, S = W' W
+        llt_G.matrixL().solveInPlace(A);
+        Eigen::Ref<Eigen::MatrixXd> S(schur.topLeftCorner(k, k));
+        S.noalias() = A.transpose() * A;
+        Eigen::LLT<Eigen::Ref<Eigen::MatrixXd> > llt_S(S);
+        if(llt_S.info() != Eigen::Success) return false;
+        llt_S.solveInPlace(u);
+    }
+
+    // dual feasibility, G x + g0 = CI u with u >= 0
+    const double tol = 1e-8;
+    for (int l(0); l < (int)active_set.size(); ++l) {
+        if(-u[p+l] < -tol) return false;
+    }
+    Eigen::VectorXd& sol = warm_x;
+    if(k > 0) {
+        sol.noalias() = A * u;
+        llt_G.matrixU().solveInPlace(sol);
+        sol = x0 - sol;
+    } else {
+        sol = x0;
+    }
+    // primal feasibility as Goldfarb-Idnani stops, the sum of the
+    // violations below its threshold
+    double c1(0.), c2(0.), psi(0.), ci;
+    for (int i(0); i < n; ++i) {
+        c1 += G[i][i];
+        c2 += 1./chol_G(i, i);
+    }
+    for (int i(0); i < m; ++i) {
+        ci = ci0[i];
+        for (int j(0); j < n; ++j) ci += CI[j][i]*sol[j];
+        psi += std::min(0., ci);
+    }
+    if(-psi > m*std::numeric_limits<double>::epsilon()*c1*c2*100.) return false;
+
+    _x.resize(n);
+    _x = sol;
+    _f = 0.;
+    for (int i(0); i < n; ++i) {
+        for (int j(0); j < n; ++j) _f += 0.5*_x[i]*G[i][j]*_x[j];
+        _f += g0[i]*_x[i];
+    }
+    return true;
+}
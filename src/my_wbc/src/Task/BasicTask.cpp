@@ -3,6 +3,10 @@
 #include <../my_utils/Configuration.h>
 #include <my_wbc/Task/BasicTask.hpp>
 #include <my_utils/IO/IOUtilities.hpp>
+#include <my_utils/IO/LogChannel.hpp>
+#include <my_utils/IO/Trace.hpp>
+
+MY_LOG_CHANNEL(log_link_pos_err, "pos_err", 3, 1, false);
 
 BasicTask::BasicTask(RobotSystem* _robot, const BasicTaskType& _taskType,
                      const int& _dim, const int& _link_idx)
@@ -77,7 +81,7 @@ BasicTask::BasicTask(RobotSystem* _robot, const BasicTaskType& _taskType,
             }
             break;
         default:
-            std::cout << "[BasicTask] Type is not Specified" << std::endl;
+            MY_TRACE_ERROR("[BasicTask] Type is not Specified");
     }
     my_utils::pretty_constructor(3, "Basic Task " + task_type_string_ + std::to_string(link_idx_));
 }
@@ -133,7 +137,7 @@ bool BasicTask::_UpdateCommand(const Eigen::VectorXd& _pos_des,
             // vel_act
             vel_act = robot_->getBodyNodeCoMSpatialVelocity(link_idx_).tail(3);
 
-            //0112 my_utils::saveVector(pos_err, "pos_err");
+            MY_LOG(log_link_pos_err, pos_err);
             break;
         }
         case BasicTaskType::CENTROID: {
@@ -153,7 +157,7 @@ bool BasicTask::_UpdateCommand(const Eigen::VectorXd& _pos_des,
             break;
         }
         default:
-            std::cout << "[BasicTask] Type is not Specified" << std::endl;
+            MY_TRACE_ERROR("[BasicTask] Type is not Specified");
     }
 
     // op_cmd
@@ -212,7 +216,7 @@ bool BasicTask::_UpdateTaskJacobian() {
             break;
         }
         default: {
-            std::cout << "[BasicTask] Type is not Specified" << std::endl;
+            MY_TRACE_ERROR("[BasicTask] Type is not Specified");
         }
     }
     return true;
@@ -262,7 +266,7 @@ bool BasicTask::_UpdateTaskJDotQdot() {
             break;
         }
         default: {
-            std::cout << "[BasicTask] Type is not Specified" << std::endl;
+            MY_TRACE_ERROR("[BasicTask] Type is not Specified");
         }
     }
     return true;
@@ -4,6 +4,7 @@
 
 #include <my_wbc/WBLC/WBLC.hpp>
 #include <my_utils/IO/IOUtilities.hpp>
+#include <my_utils/IO/Trace.hpp>
 
 WBLC::WBLC(const std::vector<bool>& act_list)
     : WBC(act_list) {
@@ -34,7 +35,7 @@ void WBLC::makeTorqueGivenRef(const Eigen::VectorXd& des_jacc_cmd,
                            const std::vector<ContactSpec*>& contact_list,
                            Eigen::VectorXd& cmd, void* extra_input) {
     if (!b_updatesetting_) {
-        printf("[Warning] WBLC setting is not done\n");
+        MY_TRACE_WARN("[Warning] WBLC setting is not done");
     }
     if (extra_input) data_ = static_cast<WBLC_ExtraData*>(extra_input);
 
@@ -55,8 +56,8 @@ void WBLC::makeTorqueGivenRef(const Eigen::VectorXd& des_jacc_cmd,
     double f = solve_quadprog(G, g0, CE, ce0, CI, ci0, z);
 
     if(f == std::numeric_limits<double>::infinity())  {
-        std::cout << "Infeasible Solution f: " << f << std::endl;
-        std::cout << "x: " << z << std::endl;
+        MY_TRACE_WARN("Infeasible Solution f: {}\nx: {}", f,
+                      Eigen::Map<const Eigen::VectorXd>(&z[0], z.size()));
         // exit(0.0);
     }
 
@@ -203,8 +204,10 @@ void WBLC::_OptimizationPreparation(const Eigen::MatrixXd& Aeq,
         G[i][i] = data_->W_qddot_[i];
     }
     int idx_offset = num_qdot_;
+    bool b_rf_des = (data_->F_des_.size() == dim_rf_);
     for (int i(0); i < dim_rf_; ++i) {
         G[i + idx_offset][i + idx_offset] = data_->W_rf_[i];
+        if(b_rf_des) g0[i + idx_offset] = -data_->W_rf_[i]*data_->F_des_[i];
     }
     idx_offset += dim_rf_;
     for (int i(0); i < dim_rf_; ++i) {
@@ -4,6 +4,7 @@
 #include <Eigen/SVD>
 
 #include <my_wbc/WBQPD/WBQPD.hpp>
+#include <my_utils/IO/Trace.hpp>
 
 WBQPD::WBQPD(const Eigen::MatrixXd& Sa, 
             const Eigen::MatrixXd& Sv) {
@@ -120,8 +121,8 @@ double WBQPD::computeTorque(void* result){
     double f = solve_quadprog(G, g0, CE, ce0, CI, ci0, x);
 
     if(f == std::numeric_limits<double>::infinity())  {
-        std::cout << "Infeasible Solution f: " << f << std::endl;
-        std::cout << "x: " << x << std::endl;
+        MY_TRACE_WARN("Infeasible Solution f: {}\nx: {}", f,
+                      Eigen::Map<const Eigen::VectorXd>(&x[0], x.size()));
         result_->b_reachable = false;
         // exit(0.0);
     }